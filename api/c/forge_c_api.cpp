@@ -599,6 +599,12 @@ FORGE_API ForgeError forge_buffer_clear_gradients(ForgeBufferHandle buffer) {
     return FORGE_SUCCESS;
 }
 
+FORGE_API ForgeError forge_buffer_reset(ForgeBufferHandle buffer) {
+    if (!buffer || !buffer->buffer) return FORGE_ERROR_NULL_HANDLE;
+    buffer->buffer->reset();
+    return FORGE_SUCCESS;
+}
+
 FORGE_API int forge_buffer_get_vector_width(ForgeBufferHandle buffer) {
     if (!buffer || !buffer->buffer) return 0;
     return buffer->buffer->getVectorWidth();
@@ -397,10 +397,17 @@ FORGE_API ForgeError forge_buffer_get_gradient_lanes(
     double* output);
 
 /**
- * Clear all gradients to zero.
+ * Clear all gradients to zero. Optional: forge_execute() writes every
+ * gradient it reads, so no clearing is needed between evaluations.
  */
 FORGE_API ForgeError forge_buffer_clear_gradients(ForgeBufferHandle buffer);
 
+/**
+ * Prepare the buffer for the next evaluation without reallocating: zero the
+ * slots the kernel reads before writing (its inputs).
+ */
+FORGE_API ForgeError forge_buffer_reset(ForgeBufferHandle buffer);
+
 /**
  * Get the vector width of a buffer.
  */
@@ -54,8 +54,8 @@ InputHandle fdouble::markInputAndDiff() {
     if (GraphRecorder::isAnyRecording()) {
         auto* recorder = GraphRecorder::active();
         auto& graph = recorder->graph();
-        graph.nodes[activeNode_].isActive = true;
-        graph.nodes[activeNode_].needsGradient = true;
+        graph.node(activeNode_).isActive = true;
+        graph.node(activeNode_).needsGradient = true;
         graph.diff_inputs.push_back(activeNode_);
     }
     return handle;
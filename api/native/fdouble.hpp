@@ -10,10 +10,12 @@ namespace forge {
 // Forward declarations
 class fbool;
 class fint;
+class ffunction;
 
 class fdouble {
     friend class fbool;  // Allow fbool to access private members
     friend class fint;   // Allow fint to access private members
+    friend class ffunction;  // Records call arguments
 private:
     double passiveValue_;
     NodeId activeNode_;
@@ -0,0 +1,78 @@
+#include "ffunction.hpp"
+#include <stdexcept>
+
+namespace forge {
+
+namespace {
+
+std::vector<fdouble> passiveCopies(const std::vector<fdouble>& args) {
+    std::vector<fdouble> copies;
+    copies.reserve(args.size());
+    for (const fdouble& arg : args) {
+        copies.emplace_back(arg.value());
+    }
+    return copies;
+}
+
+} // namespace
+
+std::vector<fdouble> ffunction::operator()(const std::vector<fdouble>& args) {
+    GraphRecorder* recorder = GraphRecorder::active();
+    if (!recorder) {
+        return body_(args);
+    }
+    if (recorder->isRecordingFunction()) {
+        throw std::runtime_error("ffunction called inside a function body");
+    }
+    
+    std::vector<fdouble> results;
+    if (recorder_ != recorder || session_ != recorder->session()) {
+        // First call in this recording: record the body with fresh parameters
+        function_ = recorder->beginFunction();
+        try {
+            std::vector<fdouble> params = passiveCopies(args);
+            for (fdouble& param : params) {
+                param.markInputAndDiff();
+            }
+            results = body_(params);
+            for (fdouble& result : results) {
+                result.markOutput();
+            }
+        } catch (...) {
+            try { recorder->endFunction(); } catch (...) {}
+            throw;
+        }
+        recorder->endFunction();
+        recorder_ = recorder;
+        session_ = recorder->session();
+    } else {
+        // Already recorded: only the results' values are needed
+        RecorderRegistry::clearActive();
+        try {
+            results = body_(passiveCopies(args));
+        } catch (...) {
+            RecorderRegistry::setActive(recorder);
+            throw;
+        }
+        RecorderRegistry::setActive(recorder);
+    }
+    
+    std::vector<NodeId> argNodes;
+    argNodes.reserve(args.size());
+    for (const fdouble& arg : args) {
+        argNodes.push_back(arg.ensureNode());
+    }
+    Graph& graph = recorder->graph();
+    NodeId call = graph.addCall(function_, argNodes);
+    const bool needsGrad = graph.node(call).needsGradient;
+    
+    std::vector<fdouble> outputs;
+    outputs.reserve(results.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+        NodeId id = (i == 0) ? call : graph.addCallResult(call, static_cast<uint32_t>(i));
+        outputs.push_back(fdouble::fromNode(id, results[i].value(), true, needsGrad));
+    }
+    return outputs;
+}
+
+} // namespace forge
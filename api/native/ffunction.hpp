@@ -0,0 +1,44 @@
+#pragma once
+
+#include "fdouble.hpp"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace forge {
+
+/**
+ * Record-once subgraph function
+ *
+ * Wraps code called many times with the same structure, such as one time step
+ * of a Monte Carlo path. The first call in a recording records the body into
+ * Graph::functions; every call then records a single Call node, so the kernel
+ * contains the body's code once however often it is called. Outside a
+ * recording the body is simply evaluated.
+ *
+ * The body must only use its arguments and passive values: an fdouble captured
+ * from the surrounding recording refers to a node of the caller's graph.
+ *
+ * @code
+ * ffunction step([](const std::vector<fdouble>& s) {
+ *     return std::vector<fdouble>{s[0] * exp(s[1]), s[1] * 0.99};
+ * });
+ * for (int t = 0; t < steps; ++t) state = step(state);
+ * @endcode
+ */
+class ffunction {
+public:
+    using Body = std::function<std::vector<fdouble>(const std::vector<fdouble>&)>;
+    
+    explicit ffunction(Body body) : body_(std::move(body)) {}
+    
+    std::vector<fdouble> operator()(const std::vector<fdouble>& args);
+    
+private:
+    Body body_;
+    const GraphRecorder* recorder_ = nullptr;  // Recording session the body was recorded in
+    uint64_t session_ = 0;
+    uint32_t function_ = 0;
+};
+
+} // namespace forge
@@ -70,6 +70,13 @@ extern "C" void call_vcos4d(const double* input, double* out) {
     _mm256_storeu_pd(out, result);
 }
 
+extern "C" void call_vsincos4d(const double* input, double* sinOut, double* cosOut) {
+    __m256d vinput = _mm256_loadu_pd(input);
+    Sleef___m256d_2 result = Sleef_sincosd4_u10avx2(vinput);
+    _mm256_storeu_pd(sinOut, result.x);
+    _mm256_storeu_pd(cosOut, result.y);
+}
+
 extern "C" void call_vtan4d(const double* input, double* out) {
     __m256d vinput = _mm256_loadu_pd(input);
     __m256d result = Sleef_tand4_u10avx2(vinput);
@@ -132,7 +139,7 @@ void AVX2InstructionSet::emitLoad(asmjit::x86::Assembler& a, int dstReg, forge::
     
     // AVX2: Load 4 doubles from workspace (RDI points to workspace values)
     // Memory layout: 4 doubles per node for SIMD vectorization
-    size_t offset = nodeId * 4 * sizeof(double);  // 4 doubles per node
+    size_t offset = nodeOffset(nodeId);  // 4 doubles per vector, getLaneBlocks() vectors per node
     
     // Load 256 bits (4 doubles) into YMM register
     if ((offset & 31) == 0) {
@@ -167,7 +174,7 @@ void AVX2InstructionSet::emitStore(asmjit::x86::Assembler& a, int srcReg, forge:
     tracer.emitTraceYMM(a, getYmmRegister(srcReg), OperationType::STORE, 4, nodeId, srcReg, -1);
     
     // AVX2: Store 4 doubles to workspace
-    size_t offset = nodeId * 4 * sizeof(double);  // 4 doubles per node
+    size_t offset = nodeOffset(nodeId);  // 4 doubles per vector, getLaneBlocks() vectors per node
     
     // Store 256 bits (4 doubles) from YMM register
     if ((offset & 31) == 0) {
@@ -699,19 +706,19 @@ void AVX2InstructionSet::emitOptimizedStore(asmjit::x86::Assembler& a, int srcRe
 // Gradient operations
 void AVX2InstructionSet::emitLoadGradient(asmjit::x86::Assembler& a, int dstReg, forge::NodeId nodeId) {
     // Load 4 gradient values from workspace (RSI points to gradients)
-    size_t offset = nodeId * 4 * sizeof(double);  // 4 doubles per node
+    size_t offset = nodeOffset(nodeId);  // 4 doubles per vector, getLaneBlocks() vectors per node
     a.vmovupd(getYmmRegister(dstReg), asmjit::x86::ymmword_ptr(asmjit::x86::rsi, offset));
 }
 
 void AVX2InstructionSet::emitStoreGradient(asmjit::x86::Assembler& a, int srcReg, forge::NodeId nodeId) {
     // Store 4 gradient values to workspace
-    size_t offset = nodeId * 4 * sizeof(double);  // 4 doubles per node
+    size_t offset = nodeOffset(nodeId);  // 4 doubles per vector, getLaneBlocks() vectors per node
     a.vmovupd(asmjit::x86::ymmword_ptr(asmjit::x86::rsi, offset), getYmmRegister(srcReg));
 }
 
 void AVX2InstructionSet::emitAccumulateGradient(asmjit::x86::Assembler& a, int srcReg, forge::NodeId nodeId, int tempReg) {
     // Load existing gradient, add to it, store back (AVX2: 4 doubles)
-    size_t offset = nodeId * 4 * sizeof(double);  // 4 doubles per node
+    size_t offset = nodeOffset(nodeId);  // 4 doubles per vector, getLaneBlocks() vectors per node
     auto temp = getYmmRegister(tempReg);
     a.vmovupd(temp, asmjit::x86::ymmword_ptr(asmjit::x86::rsi, offset));
     a.vaddpd(temp, temp, getYmmRegister(srcReg));
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "compiler/x86/common/x86_instruction_set_base.hpp"
+#include "compiler/x86/common/external_calls.hpp"
 #include "compiler/x86/common/register_allocator_base.hpp"
 #include "avx2_transcendental_helpers.hpp"  // For helper functions
 #include "compiler/x86/common/instruction_tracer.hpp"  // For runtime tracing
@@ -19,6 +20,7 @@ extern "C" void call_vexp4d(const double* input, double* out);
 extern "C" void call_vlog4d(const double* input, double* out);
 extern "C" void call_vsin4d(const double* input, double* out);
 extern "C" void call_vcos4d(const double* input, double* out);
+extern "C" void call_vsincos4d(const double* input, double* sinOut, double* cosOut);
 extern "C" void call_vtan4d(const double* input, double* out);
 extern "C" void call_vpow4d(const double* base, const double* exp, double* out);
 
@@ -72,6 +74,13 @@ public:
     
     // AVX2 processes four doubles at a time (256 bits / 64 bits per double)
     int getVectorWidth() const override { return 4; }
+
+    // Lane blocks: 2 or 4 YMM vectors per node (8 or 16 scenarios)
+    bool setLaneBlocks(int blocks) override {
+        if (blocks != 1 && blocks != 2 && blocks != 4) return false;
+        laneBlocks_ = blocks;
+        return true;
+    }
     
     bool supportsOperation(forge::OpCode op) const override {
         // AVX2 supports all current operations
@@ -244,8 +253,7 @@ private:
             a.sub(rsp, 8);
             
             // Call the external function
-            a.mov(rax, funcAddr);
-            a.call(rax);
+            emitExternalCall(a, funcAddr);
             
             // Restore stack alignment
             a.add(rsp, 8);
@@ -345,8 +353,7 @@ private:
 #endif
 
         // Call the vectorized function (ONE call for all 4 doubles!)
-        a.mov(rax, funcAddr);
-        a.call(rax);
+        emitExternalCall(a, funcAddr);
 
 #ifndef _WIN32
         a.pop(rsi);  // Restore old RSP holder
@@ -433,8 +440,7 @@ private:
 #endif
 
         // Call the vectorized function (ONE call for all 4 doubles!)
-        a.mov(rax, funcAddr);
-        a.call(rax);
+        emitExternalCall(a, funcAddr);
 
 #ifndef _WIN32
         a.pop(rsi);  // Restore old RSP holder
@@ -517,8 +523,7 @@ private:
             beginFunctionCall(a);
 
             // Call
-            a.mov(rax, funcAddr);
-            a.call(rax);
+            emitExternalCall(a, funcAddr);
 
             // Restore platform-specific state
             endFunctionCall(a);
@@ -561,6 +566,68 @@ private:
         auto tan_addr = reinterpret_cast<uint64_t>(&call_vtan4d);
         emitVectorizedMathCall1Arg(a, dstReg, srcReg, regState, tan_addr);
     }
+
+    // Fused sin/cos: one SLEEF sincos call, one result to dstReg, the other to a value slot
+    void emitSinCos(asmjit::x86::Assembler& a, int dstReg, int srcReg, forge::NodeId otherSlot,
+                    bool cosToDst, IRegisterAllocator& regState) override {
+        using namespace asmjit::x86;
+
+        // Same frame as emitVectorizedMathCall2Args, with [input][sin][cos] slots
+        a.push(rax);
+        a.push(rdi);
+        a.push(rsi);
+        a.mov(rdi, rsp);
+        a.and_(rsp, -32);
+#ifdef _WIN32
+        constexpr int kInputOffset = 32;   // shadow(32)
+        constexpr int kSinOffset = 64;
+        constexpr int kCosOffset = 96;
+        constexpr int kTotalStack = 128;
+#else
+        constexpr int kInputOffset = 0;
+        constexpr int kSinOffset = 32;
+        constexpr int kCosOffset = 64;
+        constexpr int kTotalStack = 96;
+#endif
+        a.sub(rsp, kTotalStack);
+        a.vmovupd(ymmword_ptr(rsp, kInputOffset), ymm(srcReg));
+
+#ifdef _WIN32
+        a.lea(rcx, ptr(rsp, kInputOffset));
+        a.lea(rdx, ptr(rsp, kSinOffset));
+        a.lea(r8, ptr(rsp, kCosOffset));
+#else
+        a.mov(rsi, rdi);  // Save old RSP to RSI temporarily
+        a.lea(rdi, ptr(rsp, kInputOffset));
+        a.push(rsi);
+        a.lea(rsi, ptr(rsp, kSinOffset + 8));  // +8 for the push
+        a.lea(rdx, ptr(rsp, kCosOffset + 8));
+#endif
+
+        emitExternalCall(a, reinterpret_cast<uint64_t>(&call_vsincos4d));
+
+#ifndef _WIN32
+        a.pop(rsi);
+#endif
+
+        // Both results leave the frame in volatile registers; the other one is
+        // stored once RDI points at the values again
+        const int otherReg = (dstReg == 0) ? 1 : 0;
+        a.vmovupd(ymm(dstReg), ymmword_ptr(rsp, cosToDst ? kCosOffset : kSinOffset));
+        a.vmovupd(ymm(otherReg), ymmword_ptr(rsp, cosToDst ? kSinOffset : kCosOffset));
+
+#ifdef _WIN32
+        a.mov(rsp, rdi);
+#else
+        a.mov(rsp, rsi);
+#endif
+        a.pop(rsi);
+        a.pop(rdi);
+        a.pop(rax);
+
+        regState.invalidateVolatileRegisters();
+        emitStore(a, otherReg, otherSlot);
+    }
     
     void emitPow(asmjit::x86::Assembler& a, int dstReg, int baseReg, int expReg, IRegisterAllocator& regState) override {
         // Use vectorized SLEEF implementation: ONE call for all 4 doubles!
@@ -60,7 +60,6 @@ int main() {
         for (double x_val : test_points) {
             // Set input value
             buffer->setValue(graph.diff_inputs[0], x_val);
-            buffer->clearGradients();
 
             // Execute (automatically computes both function and gradient)
             kernel->execute(*buffer);
@@ -140,7 +139,6 @@ int main() {
         for (const auto& pt : test_points) {
             // Set input value
             buffer->setValue(graph.diff_inputs[0], pt.x);
-            buffer->clearGradients();
 
             // Execute
             kernel->execute(*buffer);
@@ -205,7 +203,6 @@ int main() {
         for (double x_val : test_points) {
             // Set input value
             buffer->setValue(graph.diff_inputs[0], x_val);
-            buffer->clearGradients();
 
             // Execute
             kernel->execute(*buffer);
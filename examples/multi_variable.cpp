@@ -71,7 +71,6 @@ int main() {
             // Set input values
             buffer->setValue(graph.diff_inputs[0], pt.x);  // x
             buffer->setValue(graph.diff_inputs[1], pt.y);  // y
-            buffer->clearGradients();
 
             // Execute (automatically computes both function and gradients)
             kernel->execute(*buffer);
@@ -151,7 +150,6 @@ int main() {
         buffer->setValue(graph.diff_inputs[0], x_val);
         buffer->setValue(graph.diff_inputs[1], y_val);
         buffer->setValue(graph.diff_inputs[2], z_val);
-        buffer->clearGradients();
 
         kernel->execute(*buffer);
 
@@ -214,7 +212,6 @@ int main() {
 
         buffer->setValue(graph.diff_inputs[0], x_val);
         buffer->setValue(graph.diff_inputs[1], y_val);
-        buffer->clearGradients();
 
         kernel->execute(*buffer);
 
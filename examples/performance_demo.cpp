@@ -126,12 +126,10 @@ int main() {
         // Prepare unoptimized buffer
         noOptBuffer->setValue(graph.diff_inputs[0], x_val);
         noOptBuffer->setValue(graph.diff_inputs[1], y_val);
-        noOptBuffer->clearGradients();
 
         // Prepare optimized buffer
         optBuffer->setValue(graph.diff_inputs[0], x_val);
         optBuffer->setValue(graph.diff_inputs[1], y_val);
-        optBuffer->clearGradients();
 
         // Measure unoptimized execution (1000 iterations for accurate timing)
         double noOptTime = measureTime([&]() {
@@ -188,7 +186,6 @@ int main() {
     for (int i = 0; i < numEvals; ++i) {
         optBuffer->setValue(graph.diff_inputs[0], x_values[i]);
         optBuffer->setValue(graph.diff_inputs[1], y_values[i]);
-        optBuffer->clearGradients();
         optKernel->execute(*optBuffer);
     }
     auto endThroughput = high_resolution_clock::now();
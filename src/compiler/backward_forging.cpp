@@ -44,6 +44,22 @@ const char* opName(OpCode op) {
 
 // All helper methods have been removed - using instruction set abstraction instead
 
+void AdjointWrites::accumulate(x86::Assembler& a, IInstructionSet* instructionSet, int srcReg, NodeId slot, int tempReg) {
+    if (written(slot)) {
+        instructionSet->emitAccumulateGradient(a, srcReg, slot, tempReg);
+        return;
+    }
+    instructionSet->emitStoreGradient(a, srcReg, slot);
+    markWritten(slot);
+}
+
+void AdjointWrites::ensureWritten(x86::Assembler& a, IInstructionSet* instructionSet, NodeId slot, int zeroReg) {
+    if (written(slot)) return;
+    instructionSet->emitZero(a, zeroReg);
+    instructionSet->emitStoreGradient(a, zeroReg, slot);
+    markWritten(slot);
+}
+
 void BackwardForging::generateGradientOperation(
     x86::Assembler& a,
     const Node& node,
@@ -53,11 +69,26 @@ void BackwardForging::generateGradientOperation(
     const std::unordered_map<NodeId, ForgeEngine::ConstantInfo>& constantMap,
     const Label& constPoolLabel,
     IInstructionSet* instructionSet,
-    const CompilerConfig* config) {
+    const CompilerConfig* config,
+    const std::vector<NodeId>* derivativeSlots,
+    AdjointWrites* adjointWrites) {
+    
+    // Slot holding this node's derivative factor, if the forward pass kept one
+    const NodeId derivativeSlot =
+        (derivativeSlots && nodeId < derivativeSlots->size()) ? (*derivativeSlots)[nodeId] : UINT32_MAX;
     
     // Only process if node needs gradient
     if (!node.needsGradient) return;
     
+    // grad[target] += srcReg, a plain store for the target's first contribution
+    auto accumulate = [&](int srcReg, NodeId target) {
+        if (adjointWrites) {
+            adjointWrites->accumulate(a, instructionSet, srcReg, target);
+        } else {
+            instructionSet->emitAccumulateGradient(a, srcReg, target);
+        }
+    };
+    
     switch(node.op) {
         case OpCode::Add:
             // grad[a] += grad[nodeId]
@@ -73,13 +104,13 @@ void BackwardForging::generateGradientOperation(
             
             instructionSet->emitLoadGradient(a, 0, nodeId);  // Load gradient into XMM0
             if (node.a < graph.nodes.size() && graph.nodes[node.a].needsGradient) {
-                instructionSet->emitAccumulateGradient(a, 0, node.a);  // Accumulate XMM0 to gradient[node.a]
+                accumulate(0, node.a);  // Accumulate XMM0 to gradient[node.a]
                 if (config && config->printGradientDebug) {
                     std::cout << "      Accumulating gradient to node.a (" << node.a << ")" << std::endl;
                 }
             }
             if (node.b < graph.nodes.size() && graph.nodes[node.b].needsGradient) {
-                instructionSet->emitAccumulateGradient(a, 0, node.b);  // Accumulate XMM0 to gradient[node.b]
+                accumulate(0, node.b);  // Accumulate XMM0 to gradient[node.b]
                 if (config && config->printGradientDebug) {
                     std::cout << "      Accumulating gradient to node.b (" << node.b << ")" << std::endl;
                 }
@@ -92,13 +123,13 @@ void BackwardForging::generateGradientOperation(
             // grad[b] -= grad[nodeId]
             instructionSet->emitLoadGradient(a, 0, nodeId);  // Load gradient into XMM0
             if (node.a < graph.nodes.size() && graph.nodes[node.a].needsGradient) {
-                instructionSet->emitAccumulateGradient(a, 0, node.a);
+                accumulate(0, node.a);
             }
             // For subtraction, negate before accumulating to b
             instructionSet->emitMove(a, 1, 0);  // Copy XMM0 to XMM1
             instructionSet->emitNeg(a, 1, 2);   // Negate XMM1, using XMM2 as temp
             if (node.b < graph.nodes.size() && graph.nodes[node.b].needsGradient) {
-                instructionSet->emitAccumulateGradient(a, 1, node.b);
+                accumulate(1, node.b);
             }
             break;
         }
@@ -110,13 +141,13 @@ void BackwardForging::generateGradientOperation(
             if (node.a < graph.nodes.size() && graph.nodes[node.a].needsGradient) {
                 instructionSet->emitLoadValueForGradient(a, 1, node.b, graph, &constantMap, constPoolLabel);
                 instructionSet->emitMul(a, 1, 0);  // xmm1 = grad[nodeId] * value[b]
-                instructionSet->emitAccumulateGradient(a, 1, node.a);
+                accumulate(1, node.a);
             }
             
             if (node.b < graph.nodes.size() && graph.nodes[node.b].needsGradient) {
                 instructionSet->emitLoadValueForGradient(a, 1, node.a, graph, &constantMap, constPoolLabel);
                 instructionSet->emitMul(a, 1, 0);  // xmm1 = grad[nodeId] * value[a]
-                instructionSet->emitAccumulateGradient(a, 1, node.b);
+                accumulate(1, node.b);
             }
             break;
             
@@ -140,7 +171,7 @@ void BackwardForging::generateGradientOperation(
             if (node.a < graph.nodes.size() && graph.nodes[node.a].needsGradient) {
                 instructionSet->emitMove(a, 2, 0);  // Copy grad[nodeId] to XMM2
                 instructionSet->emitDiv(a, 2, 1);   // xmm2 = grad[nodeId] / value[b]
-                instructionSet->emitAccumulateGradient(a, 2, node.a);
+                accumulate(2, node.a);
                 
                 if (config && config->printGradientDebug) {
                     std::cout << "      Accumulating gradient to node.a (" << node.a << ")" << std::endl;
@@ -158,7 +189,7 @@ void BackwardForging::generateGradientOperation(
                 instructionSet->emitDiv(a, 2, 1);    // xmm2 = grad[nodeId] * value[a] / (value[b]^2)
                 // Negate and accumulate
                 instructionSet->emitNeg(a, 2, 3);    // Negate xmm2, using xmm3 as temp
-                instructionSet->emitAccumulateGradient(a, 2, node.b);
+                accumulate(2, node.b);
                 
                 if (config && config->printGradientDebug) {
                     std::cout << "      Accumulating gradient to node.b (" << node.b << ")" << std::endl;
@@ -176,7 +207,7 @@ void BackwardForging::generateGradientOperation(
             if (node.a < graph.nodes.size() && graph.nodes[node.a].needsGradient) {
                 instructionSet->emitLoadGradient(a, 0, nodeId);
                 instructionSet->emitNeg(a, 0, 1);  // Negate xmm0, using xmm1 as temp
-                instructionSet->emitAccumulateGradient(a, 0, node.a);
+                accumulate(0, node.a);
             }
             break;
         }
@@ -215,7 +246,7 @@ void BackwardForging::generateGradientOperation(
 
                 // Multiply gradient by sign
                 instructionSet->emitMul(a, 0, 5);  // grad[nodeId] * sign(value[a])
-                instructionSet->emitAccumulateGradient(a, 0, node.a);
+                accumulate(0, node.a);
             }
             break;
             
@@ -226,7 +257,7 @@ void BackwardForging::generateGradientOperation(
                 instructionSet->emitLoadValueForGradient(a, 1, node.a, graph, &constantMap, constPoolLabel);
                 instructionSet->emitAdd(a, 1, 1);  // xmm1 = 2 * value[a]
                 instructionSet->emitMul(a, 1, 0);  // xmm1 = 2 * value[a] * grad[nodeId]
-                instructionSet->emitAccumulateGradient(a, 1, node.a);
+                accumulate(1, node.a);
             }
             break;
             
@@ -237,7 +268,7 @@ void BackwardForging::generateGradientOperation(
                 instructionSet->emitLoadValueForGradient(a, 1, nodeId, graph, &constantMap, constPoolLabel);  // Load sqrt result
                 instructionSet->emitAdd(a, 1, 1);    // xmm1 = 2 * sqrt(x)
                 instructionSet->emitDiv(a, 0, 1);    // xmm0 = grad / (2 * sqrt(x))
-                instructionSet->emitAccumulateGradient(a, 0, node.a);
+                accumulate(0, node.a);
             }
             break;
             
@@ -247,7 +278,7 @@ void BackwardForging::generateGradientOperation(
                 instructionSet->emitLoadGradient(a, 0, nodeId);
                 instructionSet->emitLoadValueForGradient(a, 1, nodeId, graph, &constantMap, constPoolLabel);  // exp(x) result
                 instructionSet->emitMul(a, 0, 1);
-                instructionSet->emitAccumulateGradient(a, 0, node.a);
+                accumulate(0, node.a);
             }
             break;
             
@@ -257,7 +288,7 @@ void BackwardForging::generateGradientOperation(
                 instructionSet->emitLoadGradient(a, 0, nodeId);
                 instructionSet->emitLoadValueForGradient(a, 1, node.a, graph, &constantMap, constPoolLabel);
                 instructionSet->emitDiv(a, 0, 1);
-                instructionSet->emitAccumulateGradient(a, 0, node.a);
+                accumulate(0, node.a);
             }
             break;
             
@@ -290,7 +321,7 @@ void BackwardForging::generateGradientOperation(
                 instructionSet->emitMul(a, 5, 2);  // reg 5 = x^(y-1) * y
                 instructionSet->emitMul(a, 5, 0);  // reg 5 = grad[nodeId] * y * x^(y-1)
                 
-                instructionSet->emitAccumulateGradient(a, 5, node.a);
+                accumulate(5, node.a);
             }
             
             // Gradient for y (exponent): grad[nodeId] * x^y * log(x)
@@ -309,7 +340,7 @@ void BackwardForging::generateGradientOperation(
                 instructionSet->emitMul(a, 7, 6);  // reg 7 = x^y * log(x)
                 instructionSet->emitMul(a, 7, 0);  // reg 7 = grad[nodeId] * x^y * log(x)
                 
-                instructionSet->emitAccumulateGradient(a, 7, node.b);
+                accumulate(7, node.b);
             }
             break;
         }
@@ -317,11 +348,15 @@ void BackwardForging::generateGradientOperation(
         case OpCode::Sin:
             // grad[a] += grad[nodeId] * cos(value[a])
             if (node.a < graph.nodes.size() && graph.nodes[node.a].needsGradient) {
-                instructionSet->emitLoadValueForGradient(a, 1, node.a, graph, &constantMap, constPoolLabel);
-                instructionSet->emitCos(a, 2, 1, regState);  // xmm2 = cos(value[a])
+                if (derivativeSlot != UINT32_MAX) {
+                    instructionSet->emitLoad(a, 2, derivativeSlot);  // xmm2 = cos(value[a]) from the forward pass
+                } else {
+                    instructionSet->emitLoadValueForGradient(a, 1, node.a, graph, &constantMap, constPoolLabel);
+                    instructionSet->emitCos(a, 2, 1, regState);  // xmm2 = cos(value[a])
+                }
                 instructionSet->emitLoadGradient(a, 0, nodeId);  // Load gradient after cos call
                 instructionSet->emitMul(a, 0, 2);  // xmm0 = grad[nodeId] * cos(value[a])
-                instructionSet->emitAccumulateGradient(a, 0, node.a);
+                accumulate(0, node.a);
             }
             break;
             
@@ -329,12 +364,16 @@ void BackwardForging::generateGradientOperation(
         {
             // grad[a] -= grad[nodeId] * sin(value[a])
             if (node.a < graph.nodes.size() && graph.nodes[node.a].needsGradient) {
-                instructionSet->emitLoadValueForGradient(a, 1, node.a, graph, &constantMap, constPoolLabel);
-                instructionSet->emitSin(a, 2, 1, regState);  // xmm2 = sin(value[a])
+                if (derivativeSlot != UINT32_MAX) {
+                    instructionSet->emitLoad(a, 2, derivativeSlot);  // xmm2 = sin(value[a]) from the forward pass
+                } else {
+                    instructionSet->emitLoadValueForGradient(a, 1, node.a, graph, &constantMap, constPoolLabel);
+                    instructionSet->emitSin(a, 2, 1, regState);  // xmm2 = sin(value[a])
+                }
                 instructionSet->emitLoadGradient(a, 0, nodeId);  // Load gradient after sin call
                 instructionSet->emitMul(a, 0, 2);  // xmm0 = grad[nodeId] * sin(value[a])
                 instructionSet->emitNeg(a, 0, 3);  // xmm0 = -grad[nodeId] * sin(value[a]), using xmm3 as temp
-                instructionSet->emitAccumulateGradient(a, 0, node.a);
+                accumulate(0, node.a);
             }
             break;
         }
@@ -363,7 +402,7 @@ void BackwardForging::generateGradientOperation(
                 instructionSet->emitMul(a, 0, 2);  // reg0 = grad[nodeId] * sec²(x)
 
                 // Accumulate to grad[a]
-                instructionSet->emitAccumulateGradient(a, 0, node.a);
+                accumulate(0, node.a);
             }
             break;
         }
@@ -384,13 +423,13 @@ void BackwardForging::generateGradientOperation(
             // Gradient for true branch: condition * grad[result]
             instructionSet->emitMove(a, 2, 0);
             instructionSet->emitMul(a, 2, 1);
-            instructionSet->emitAccumulateGradient(a, 2, node.b);
+            accumulate(2, node.b);
             
             // Gradient for false branch: (1 - condition) * grad[result]
             instructionSet->emitLoadImmediate(a, 2, 1.0);  // Load 1.0 into register 2
             instructionSet->emitSub(a, 2, 0);  // 1.0 - condition  
             instructionSet->emitMul(a, 2, 1);
-            instructionSet->emitAccumulateGradient(a, 2, node.c);
+            accumulate(2, node.c);
             break;
         }
             
@@ -406,7 +445,7 @@ void BackwardForging::generateGradientOperation(
                 // Compare and create mask: a <= b
                 instructionSet->emitCmpLE(a, 3, 0, 1, regState);  // Compare a with b, store result in reg 3
                 instructionSet->emitAndPD(a, 2, 3);  // Mask gradient with comparison result
-                instructionSet->emitAccumulateGradient(a, 2, node.a);
+                accumulate(2, node.a);
                 
                 // For b: b < a (opposite condition)
                 instructionSet->emitLoadValueForGradient(a, 0, node.a, graph, &constantMap, constPoolLabel);
@@ -414,7 +453,7 @@ void BackwardForging::generateGradientOperation(
                 instructionSet->emitLoadGradient(a, 2, nodeId);
                 instructionSet->emitCmpLT(a, 3, 1, 0, regState);  // Compare b with a, store result in reg 3
                 instructionSet->emitAndPD(a, 2, 3);
-                instructionSet->emitAccumulateGradient(a, 2, node.b);
+                accumulate(2, node.b);
             }
             break;
             
@@ -430,7 +469,7 @@ void BackwardForging::generateGradientOperation(
                 // Compare and create mask for a: a >= b
                 instructionSet->emitCmpGE(a, 3, 0, 1, regState);  // Compare a with b, store result in reg 3
                 instructionSet->emitAndPD(a, 2, 3);  // Mask gradient with comparison result
-                instructionSet->emitAccumulateGradient(a, 2, node.a);
+                accumulate(2, node.a);
                 
                 // For b: b > a (opposite condition)
                 instructionSet->emitLoadValueForGradient(a, 0, node.a, graph, &constantMap, constPoolLabel);
@@ -438,7 +477,7 @@ void BackwardForging::generateGradientOperation(
                 instructionSet->emitLoadGradient(a, 2, nodeId);
                 instructionSet->emitCmpGT(a, 3, 1, 0, regState);  // Compare b with a, store result in reg 3
                 instructionSet->emitAndPD(a, 2, 3);
-                instructionSet->emitAccumulateGradient(a, 2, node.b);
+                accumulate(2, node.b);
             }
             break;
             
@@ -451,7 +490,7 @@ void BackwardForging::generateGradientOperation(
                 instructionSet->emitMul(a, 1, 1);  // xmm1 = value[a] * value[a]
                 instructionSet->emitDiv(a, 0, 1);  // xmm0 = grad[nodeId] / (value[a]²)
                 instructionSet->emitNeg(a, 0, 2);  // xmm0 = -grad[nodeId] / (value[a]²), using xmm2 as temp
-                instructionSet->emitAccumulateGradient(a, 0, node.a);
+                accumulate(0, node.a);
             }
             break;
             
@@ -461,7 +500,7 @@ void BackwardForging::generateGradientOperation(
             // Note: This is approximate due to discontinuities in modulo
             if (node.a < graph.nodes.size() && graph.nodes[node.a].needsGradient) {
                 instructionSet->emitLoadGradient(a, 0, nodeId);
-                instructionSet->emitAccumulateGradient(a, 0, node.a);  // grad[a] += grad[nodeId]
+                accumulate(0, node.a);  // grad[a] += grad[nodeId]
             }
             
             if (node.b < graph.nodes.size() && graph.nodes[node.b].needsGradient) {
@@ -494,13 +533,22 @@ void BackwardForging::forgeBackwardPass(
     const Label& constPoolLabel,
     IRegisterAllocator& regState,
     IInstructionSet* instructionSet,
-    const CompilerConfig* config) {
+    const CompilerConfig* config,
+    const std::vector<NodeId>* derivativeSlots,
+    const FunctionForging::CallLayout* callLayout,
+    const std::vector<NodeId>* seededAdjoints) {
+    
+    AdjointWrites adjointWrites;
+    if (seededAdjoints) {
+        for (NodeId slot : *seededAdjoints) adjointWrites.markWritten(slot);
+    }
     
     // First, set gradient of output nodes to 1.0
     for (NodeId outputNode : graph.outputs) {
         if (outputNode < graph.nodes.size() && graph.nodes[outputNode].needsGradient) {
             instructionSet->emitLoadImmediate(a, 0, 1.0);  // Load 1.0 into register 0
             instructionSet->emitStoreGradient(a, 0, outputNode);
+            adjointWrites.markWritten(outputNode);
             
             if (config && config->printGradientDebug) {
                 std::cout << "  Setting initial gradient for output node " << outputNode << " to 1.0" << std::endl;
@@ -535,9 +583,39 @@ void BackwardForging::forgeBackwardPass(
             std::cout << "  Processing gradient for node " << nodeId << " (" << opName(node.op) << ")" << std::endl;
         }
         
+        // A node no live path reaches has an adjoint of zero
+        adjointWrites.ensureWritten(a, instructionSet, nodeId, 0);
+        
         // Generate gradient operation
-        generateGradientOperation(a, node, nodeId, regState, graph, constantMap, constPoolLabel, instructionSet, config);
+        if (callLayout && !callLayout->empty() && (node.op == OpCode::Call || node.op == OpCode::CallResult)) {
+            FunctionForging::forgeCallBackward(a, nodeId, graph, *callLayout, regState, instructionSet, adjointWrites);
+        } else {
+            generateGradientOperation(a, node, nodeId, regState, graph, constantMap, constPoolLabel, instructionSet, config, derivativeSlots, &adjointWrites);
+        }
+    }
+    
+    // Adjoints read after the sweep (inputs without contributions, dead nodes, parameters) are zero
+    for (NodeId id = 0; id < graph.nodes.size(); ++id) {
+        if (graph.nodes[id].needsGradient) adjointWrites.ensureWritten(a, instructionSet, id, 0);
+    }
+    for (NodeId input : graph.diff_inputs) {
+        if (input < graph.nodes.size()) adjointWrites.ensureWritten(a, instructionSet, input, 0);
+    }
+}
+
+std::vector<NodeId> BackwardForging::assignDerivativeSlots(const Graph& graph) {
+    std::vector<NodeId> slots(graph.nodes.size(), UINT32_MAX);
+    NodeId next = static_cast<NodeId>(graph.nodes.size());
+    for (NodeId id = 0; id < graph.nodes.size(); ++id) {
+        const Node& node = graph.nodes[id];
+        if (node.isDead || !node.needsGradient) continue;
+        if (node.op != OpCode::Sin && node.op != OpCode::Cos) continue;
+        // Same condition under which generateGradientOperation emits the adjoint
+        if (node.a < graph.nodes.size() && graph.nodes[node.a].needsGradient) {
+            slots[id] = next++;
+        }
     }
+    return slots;
 }
 
 } // namespace forge
\ No newline at end of file
@@ -12,6 +12,11 @@
  * the computational graph in reverse topological order and accumulates partial
  * derivatives.
  *
+ * The sweep is straight-line code, so the first contribution to each adjoint
+ * is known while forging: it is stored, only later ones are accumulated
+ * (AdjointWrites). Every gradient slot the kernel or the caller reads is
+ * written by the sweep, so gradients need no clearing before a run.
+ *
  * Thread Safety: Static methods are not thread-safe (use from single thread)
  */
 
@@ -22,11 +27,39 @@
 #include "x86/common/compiler_config.hpp"
 #include "forge_engine.hpp"
 #include "interfaces/instruction_set.hpp"
+#include "function_forging.hpp"
 #include <asmjit/x86.h>
 #include <unordered_map>
+#include <vector>
 
 namespace forge {
 
+/**
+ * @brief Gradient slots the reverse sweep has written so far
+ *
+ * Turns the first contribution to a slot into a plain store and zeroes slots
+ * that are read without having received one.
+ */
+class AdjointWrites {
+public:
+    bool written(forge::NodeId slot) const { return slot < written_.size() && written_[slot]; }
+
+    void markWritten(forge::NodeId slot) {
+        if (slot >= written_.size()) written_.resize(static_cast<size_t>(slot) + 1, 0);
+        written_[slot] = 1;
+    }
+
+    /** @brief grad[slot] = srcReg on the first write, grad[slot] += srcReg afterwards */
+    void accumulate(asmjit::x86::Assembler& a, IInstructionSet* instructionSet, int srcReg, forge::NodeId slot,
+                    int tempReg = 3);
+
+    /** @brief Zero grad[slot] through zeroReg unless it was written */
+    void ensureWritten(asmjit::x86::Assembler& a, IInstructionSet* instructionSet, forge::NodeId slot, int zeroReg);
+
+private:
+    std::vector<char> written_;
+};
+
 /**
  * @brief Code generator for backward pass (gradient computation) (backpropagation)
  *
@@ -53,6 +86,8 @@ public:
      * @param constPoolLabel Label for constant pool in generated code
      * @param instructionSet Instruction set implementation (SSE2/AVX2)
      * @param config Optional compiler configuration for debug output
+     * @param derivativeSlots Slots filled by the forward pass (nullptr if none)
+     * @param adjointWrites Slots written so far (nullptr: always accumulate, gradients must be zeroed)
      *
      * Thread Safety: Not thread-safe
      */
@@ -65,7 +100,9 @@ public:
         const std::unordered_map<forge::NodeId, ForgeEngine::ConstantInfo>& constantMap,
         const asmjit::Label& constPoolLabel,
         IInstructionSet* instructionSet,
-        const CompilerConfig* config = nullptr
+        const CompilerConfig* config = nullptr,
+        const std::vector<forge::NodeId>* derivativeSlots = nullptr,
+        AdjointWrites* adjointWrites = nullptr
     );
 
     /**
@@ -82,6 +119,9 @@ public:
      * @param regState Register allocator state
      * @param instructionSet Instruction set implementation (SSE2/AVX2)
      * @param config Optional compiler configuration for debug output
+     * @param derivativeSlots Slots filled by the forward pass (nullptr if none)
+     * @param callLayout Call frames of subgraph functions (nullptr if none)
+     * @param seededAdjoints Slots the caller has written instead of seeding the outputs with 1.0
      *
      * Thread Safety: Not thread-safe
      */
@@ -92,8 +132,23 @@ public:
         const asmjit::Label& constPoolLabel,
         IRegisterAllocator& regState,  // Changed to use interface
         IInstructionSet* instructionSet,
-        const CompilerConfig* config = nullptr
+        const CompilerConfig* config = nullptr,
+        const std::vector<forge::NodeId>* derivativeSlots = nullptr,
+        const FunctionForging::CallLayout* callLayout = nullptr,
+        const std::vector<forge::NodeId>* seededAdjoints = nullptr
     );
+
+    /**
+     * @brief Assign value slots for derivative factors computed in the forward pass
+     *
+     * Sin and Cos nodes on the adjoint path get a slot after the graph's nodes;
+     * the forward pass stores cos(x) resp. sin(x) there (fused with the primal
+     * call) so the reverse sweep never calls a transcendental again.
+     *
+     * @param graph Computational graph to compile
+     * @return Slot per node ID, UINT32_MAX for nodes without one
+     */
+    static std::vector<forge::NodeId> assignDerivativeSlots(const forge::Graph& graph);
     
     // No private helper methods - all operations go through instruction set abstraction
 };
@@ -0,0 +1,122 @@
+// This file is part of Forge <https://github.com/da-roth/forge>
+//
+// See LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+/**
+ * @file compile_stats.cpp
+ * @brief Resident set size sampling and the compile phase recorder
+ */
+
+#include "compile_stats.hpp"
+#include <cstdio>
+#include <cstring>
+
+#ifdef __linux__
+#include <unistd.h>
+#elif defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#include <sys/resource.h>
+#endif
+
+namespace forge {
+
+size_t currentRssBytes() {
+#ifdef __linux__
+    FILE* file = std::fopen("/proc/self/statm", "r");
+    if (!file) return 0;
+    unsigned long long size = 0;
+    unsigned long long resident = 0;
+    const int fields = std::fscanf(file, "%llu %llu", &size, &resident);
+    std::fclose(file);
+    return fields == 2 ? static_cast<size_t>(resident) * static_cast<size_t>(sysconf(_SC_PAGESIZE)) : 0;
+#elif defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    return GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) ? counters.WorkingSetSize : 0;
+#elif defined(__APPLE__)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS) {
+        return 0;
+    }
+    return info.resident_size;
+#else
+    return 0;
+#endif
+}
+
+size_t peakRssBytes() {
+#ifdef __linux__
+    // VmHWM honours clear_refs resets, unlike getrusage's ru_maxrss
+    FILE* file = std::fopen("/proc/self/status", "r");
+    if (!file) return 0;
+    char line[256];
+    size_t peak = 0;
+    while (std::fgets(line, sizeof(line), file)) {
+        unsigned long long kilobytes = 0;
+        if (std::strncmp(line, "VmHWM:", 6) == 0 && std::sscanf(line + 6, "%llu", &kilobytes) == 1) {
+            peak = static_cast<size_t>(kilobytes) * 1024;
+            break;
+        }
+    }
+    std::fclose(file);
+    return peak;
+#elif defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    return GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) ? counters.PeakWorkingSetSize : 0;
+#elif defined(__APPLE__)
+    rusage usage;
+    return getrusage(RUSAGE_SELF, &usage) == 0 ? static_cast<size_t>(usage.ru_maxrss) : 0;  // Bytes on macOS
+#else
+    return 0;
+#endif
+}
+
+bool resetPeakRss() {
+#ifdef __linux__
+    FILE* file = std::fopen("/proc/self/clear_refs", "w");
+    if (!file) return false;
+    const bool ok = std::fputs("5", file) >= 0;
+    return std::fclose(file) == 0 && ok;
+#else
+    return false;
+#endif
+}
+
+CompileStatsRecorder::CompileStatsRecorder(bool enabled) : enabled_(enabled) {
+    if (!enabled_) return;
+    stats_.perPhasePeaks = resetPeakRss();
+    start_ = phaseStart_ = Clock::now();
+}
+
+void CompileStatsRecorder::endPhase(const char* name) {
+    if (!enabled_) return;
+    const Clock::time_point now = Clock::now();
+    CompileStats::Phase phase;
+    phase.name = name;
+    phase.timeMs = std::chrono::duration<double, std::milli>(now - phaseStart_).count();
+    phase.rssBytes = currentRssBytes();
+    phase.peakRssBytes = peakRssBytes();
+    stats_.phases.push_back(std::move(phase));
+    if (stats_.perPhasePeaks) resetPeakRss();
+    // Sampling is not charged to the next phase
+    phaseStart_ = Clock::now();
+}
+
+CompileStats CompileStatsRecorder::finish(size_t graphNodes, size_t workingNodes, size_t codeSize) {
+    if (enabled_) {
+        stats_.totalMs = std::chrono::duration<double, std::milli>(Clock::now() - start_).count();
+        stats_.graphNodes = graphNodes;
+        stats_.workingNodes = workingNodes;
+        stats_.codeSize = codeSize;
+    }
+    return std::move(stats_);
+}
+
+} // namespace forge
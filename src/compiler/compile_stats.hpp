@@ -0,0 +1,91 @@
+// This file is part of Forge <https://github.com/da-roth/forge>
+//
+// See LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+/**
+ * @file compile_stats.hpp
+ * @brief Per-phase compile time and memory of ForgeEngine::compile()
+ *
+ * With CompilerConfig::collectCompileStats, compile() records for each phase
+ * its wall time, the resident set size at its end and the peak resident set
+ * size reached during it:
+ *
+ * - optimize:  GraphOptimizer passes (identity mapping when optimizations are off)
+ * - prepare:   output pruning, uniform hoisting analysis, working graph setup
+ * - forward:   code holder, constant pool, prologue and forward forging
+ * - backward:  backward forging
+ * - finalize:  epilogue, function bodies, constant pool embedding
+ * - runtime:   JitRuntime::add (relocation and copy into executable memory)
+ *
+ * Per-phase peaks rely on resetting the kernel's high-water mark through
+ * /proc/self/clear_refs (Linux 4.0+); elsewhere peakRssBytes is the process
+ * peak so far and CompileStats::perPhasePeaks is false.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace forge {
+
+struct CompileStats {
+    struct Phase {
+        std::string name;
+        double timeMs = 0.0;
+        size_t rssBytes = 0;       ///< Resident set size at the end of the phase (0 if unknown)
+        size_t peakRssBytes = 0;   ///< Peak resident set size during the phase (0 if unknown)
+    };
+
+    std::vector<Phase> phases;     ///< In compile order
+    double totalMs = 0.0;
+    size_t graphNodes = 0;         ///< Nodes of the input graph
+    size_t workingNodes = 0;       ///< Nodes after optimization
+    size_t codeSize = 0;           ///< Bytes of machine code
+    bool perPhasePeaks = false;    ///< Peaks were reset between phases
+
+    /** @brief Phase by name (nullptr if not recorded) */
+    const Phase* phase(const std::string& name) const {
+        for (const Phase& p : phases) {
+            if (p.name == name) return &p;
+        }
+        return nullptr;
+    }
+};
+
+/** @brief Current resident set size of the process in bytes (0 if unavailable) */
+size_t currentRssBytes();
+
+/** @brief Peak resident set size in bytes since start or the last resetPeakRss() (0 if unavailable) */
+size_t peakRssBytes();
+
+/** @brief Restart peak tracking at the current RSS; false if the platform cannot */
+bool resetPeakRss();
+
+/**
+ * @brief Splits a compilation into phases (no-op when disabled)
+ */
+class CompileStatsRecorder {
+public:
+    explicit CompileStatsRecorder(bool enabled);
+
+    /** @brief Close the phase that started at the previous call (or construction) */
+    void endPhase(const char* name);
+
+    /** @brief Stats with totals; the recorder should not be used afterwards */
+    CompileStats finish(size_t graphNodes, size_t workingNodes, size_t codeSize);
+
+    bool enabled() const { return enabled_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    bool enabled_;
+    Clock::time_point start_;
+    Clock::time_point phaseStart_;
+    CompileStats stats_;
+};
+
+} // namespace forge
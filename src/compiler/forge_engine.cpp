@@ -13,8 +13,13 @@
 
 #include "forge_engine.hpp"
 #include "../graph/graph_optimizer.hpp"
+#include "../graph/optimizations/loop_rerolling.hpp"
 #include "backward_forging.hpp"
 #include "forward_forging.hpp"
+#include "function_forging.hpp"
+#include "io_binding.hpp"
+#include "perf_jit_map.hpp"
+#include "x86/common/external_calls.hpp"
 #include "x86/double/scalar/sse2_scalar_instruction_set.hpp"
 #include <iostream>
 #include <iomanip>
@@ -34,8 +39,17 @@ namespace forge {
 using namespace asmjit;
 using namespace forge;
 
+// Large-page code memory when FORGE_HUGE_PAGES asks for huge pages (see huge_pages.hpp);
+// AsmJit falls back to regular pages when none can be allocated
+static const JitAllocator::CreateParams* jitAllocatorParams() {
+    static JitAllocator::CreateParams params{};
+    if (hugePagePolicyFromEnvironment() == HugePagePolicy::Off) return nullptr;
+    params.options = JitAllocatorOptions::kUseLargePages | JitAllocatorOptions::kAlignBlockSizeToLargePage;
+    return &params;
+}
+
 // Define the static JitRuntime (shared across all compilers)
-asmjit::JitRuntime ForgeEngine::s_runtime;
+asmjit::JitRuntime ForgeEngine::s_runtime(jitAllocatorParams());
 
 ForgeEngine::ForgeEngine() : config_(CompilerConfig::Default()) {
 #ifdef FORGE_BUNDLE_AVX2
@@ -61,6 +75,10 @@ ForgeEngine::ForgeEngine(const CompilerConfig& config) : config_(config) {
         // Use enum-based selection (built-in instruction sets)
         instructionSet_ = InstructionSetFactory::create(config_.instructionSet, config_);
     }
+    if (!instructionSet_->setLaneBlocks(config_.laneBlocks)) {
+        throw std::runtime_error("CompilerConfig::laneBlocks = " + std::to_string(config_.laneBlocks) +
+                                 " is not supported by " + instructionSet_->getName());
+    }
     // Initialize with default policy
     policy_ = std::make_unique<DefaultCompilationPolicy>();
 }
@@ -128,11 +146,118 @@ static std::string getOpName(forge::OpCode op) {
     }
 }
 
+// Output-driven pruning: nodes no output depends on get neither forward nor
+// adjoint code, and adjoint code is only kept for nodes that also depend on a
+// differentiated input. Node IDs are unchanged, so buffers and mappings stay valid.
+// Inputs are never pruned (they carry no code but are bound by ID).
+static void pruneToOutputs(Graph& graph, size_t& forwardPruned, size_t& adjointPruned) {
+    const size_t n = graph.nodes.size();
+    
+    // Backward reachability from outputs over operand edges
+    std::vector<uint8_t> live(n, 0);
+    std::vector<NodeId> stack;
+    auto mark = [&](NodeId id) {
+        if (id < n && !live[id] && !graph.nodes[id].isDead) {
+            live[id] = 1;
+            stack.push_back(id);
+        }
+    };
+    for (NodeId id : graph.outputs) mark(id);
+    while (!stack.empty()) {
+        const Node& node = graph.nodes[stack.back()];
+        stack.pop_back();
+        const NodeId operands[3] = {node.a, node.b, node.c};
+        for (int k = 0; k < operandCount(node.op); ++k) {
+            mark(operands[k]);
+        }
+    }
+    
+    // Forward sweep (operands precede users): which live nodes depend on a diff input
+    std::vector<uint8_t> fromDiff(n, 0);
+    for (NodeId id : graph.diff_inputs) {
+        if (id < n) fromDiff[id] = 1;
+    }
+    for (NodeId id = 0; id < n; ++id) {
+        Node& node = graph.nodes[id];
+        if (node.isDead) continue;
+        if (!live[id] && node.op != OpCode::Input) {
+            node.isDead = true;
+            forwardPruned++;
+            continue;
+        }
+        const NodeId operands[3] = {node.a, node.b, node.c};
+        for (int k = 0; k < operandCount(node.op); ++k) {
+            if (operands[k] < n && fromDiff[operands[k]]) fromDiff[id] = 1;
+        }
+        if (node.needsGradient && !fromDiff[id]) {
+            node.needsGradient = false;
+            adjointPruned++;
+        }
+    }
+}
+
+// Uniformity analysis: a node is uniform (identical in every lane/scenario) if it
+// is an Input marked NodeFlags::Uniform, a constant, or all of its operands are
+// uniform. Uniform nodes that carry code are flagged in 'hoisted' so they can be
+// computed once in the kernel prologue. Nothing is hoisted unless the graph has
+// at least one uniform input: constant-only subgraphs alone don't justify a prologue.
+static size_t markHoistableNodes(const Graph& graph, std::vector<uint8_t>& hoisted) {
+    const size_t n = graph.nodes.size();
+    hoisted.assign(n, 0);
+    std::vector<uint8_t> uniform(n, 0);
+    bool anyUniformInput = false;
+    size_t count = 0;
+    for (NodeId id = 0; id < n; ++id) {
+        const Node& node = graph.nodes[id];
+        if (node.isDead) continue;
+        switch (node.op) {
+            case OpCode::Input:
+                uniform[id] = (node.flags & NodeFlags::Uniform) != 0;
+                anyUniformInput = anyUniformInput || uniform[id];
+                continue;
+            case OpCode::Constant:
+            case OpCode::BoolConstant:
+            case OpCode::IntConstant:
+                uniform[id] = 1;
+                continue;
+            case OpCode::Call:
+            case OpCode::CallArg:
+            case OpCode::CallResult:
+                continue;  // Emitted by FunctionForging, never hoisted
+            default:
+                break;
+        }
+        bool allUniform = true;
+        const NodeId operands[3] = {node.a, node.b, node.c};
+        for (int k = 0; k < operandCount(node.op); ++k) {
+            allUniform = allUniform && operands[k] < n && uniform[operands[k]];
+        }
+        if (allUniform) {
+            uniform[id] = 1;
+            hoisted[id] = 1;
+            count++;
+        }
+    }
+    if (!anyUniformInput) {
+        hoisted.assign(n, 0);
+        return 0;
+    }
+    return count;
+}
+
+// Lane blocks (CompilerConfig::laneBlocks): code forged for block b runs with
+// the base pointers moved b vectors into every node
+static void moveLaneBlock(x86::Assembler& a, int32_t bytes, bool gradients) {
+    a.lea(x86::rdi, x86::ptr(x86::rdi, bytes));
+    if (gradients) a.lea(x86::rsi, x86::ptr(x86::rsi, bytes));
+}
+
 std::unique_ptr<ForgedKernel> ForgeEngine::compile(const Graph& graph) {
     using Clock = std::chrono::high_resolution_clock;
     using Duration = std::chrono::duration<double, std::milli>;
     
     auto totalStart = Clock::now();
+    CompileStatsRecorder compileStats(config_.collectCompileStats);
     
     // Phase 0: Apply graph-level optimizations before JIT compilation
     auto optimizationStart = Clock::now();
@@ -144,6 +269,7 @@ std::unique_ptr<ForgedKernel> ForgeEngine::compile(const Graph& graph) {
     optConfig.enableCSE = config_.enableCSE;
     optConfig.enableAlgebraicSimplification = config_.enableAlgebraicSimplification;
     optConfig.enableStabilityCleaning = config_.enableStabilityCleaning;
+    optConfig.enableDeadCodeElimination = config_.enableDeadCodeElimination;
     optConfig.maxOptimizationPasses = config_.maxOptimizationPasses;
     optConfig.printOriginalGraph = config_.printOriginalGraph;
     optConfig.printOptimizedGraph = config_.printOptimizedGraph;
@@ -154,6 +280,14 @@ std::unique_ptr<ForgedKernel> ForgeEngine::compile(const Graph& graph) {
     if (graph.outputs.empty()) {
         throw std::runtime_error("No outputs were marked on the graph. Ensure markOutput() is called.");
     }
+    if (config_.enableKernelExport && config_.printRuntimeTrace) {
+        // Trace code stores through the address of the in-process trace buffer
+        throw std::runtime_error("enableKernelExport cannot be combined with printRuntimeTrace");
+    }
+    if (config_.enableKernelExport && config_.profileNodesPerGroup > 0) {
+        // Profiling code updates an in-process counter table
+        throw std::runtime_error("enableKernelExport cannot be combined with profileNodesPerGroup");
+    }
 
     // Use the new mapping-based optimization
     GraphOptimizer::OptimizationResult optResult;
@@ -166,13 +300,14 @@ std::unique_ptr<ForgedKernel> ForgeEngine::compile(const Graph& graph) {
         optResult = GraphOptimizer::OptimizationResult{graph, std::move(identity)};
     }
     
-    Graph optimizedGraph = optResult.optimizedTape;
+    Graph optimizedGraph = std::move(optResult.optimizedTape);
     
     // Store the mapping for later use by NodeValueBuffer
     // This will be used when creating the ForgedKernel
     
     auto optimizationEnd = Clock::now();
     Duration optimizationTime = optimizationEnd - optimizationStart;
+    compileStats.endPhase("optimize");
     
     // Print optimization statistics
     const auto& stats = optimizer.getLastStats();
@@ -186,15 +321,13 @@ std::unique_ptr<ForgedKernel> ForgeEngine::compile(const Graph& graph) {
         std::cout << "  Algebraic simplifications: " << stats.algebraicSimplifications << std::endl;
         std::cout << "  Stability fixes applied: " << stats.stabilityFixes << std::endl;
         
-        // Count actual dead nodes in the graph
-        int actualDeadCount = 0;
-        for (const auto& node : optimizedGraph.nodes) {
-            if (node.isDead) actualDeadCount++;
-        }
-        std::cout << "  Dead nodes marked: " << actualDeadCount << std::endl;
-        std::cout << "  Effective nodes (not dead): " << (stats.originalNodeCount - actualDeadCount) << std::endl;
+        // Dead and unreachable nodes are compacted away, so the graph size tells the story
+        size_t removedCount = stats.originalNodeCount - std::min(stats.originalNodeCount, optimizedGraph.nodes.size());
+        std::cout << "  Unreachable nodes removed (DCE): " << stats.unreachableNodesRemoved << std::endl;
+        std::cout << "  Nodes removed: " << removedCount << std::endl;
+        std::cout << "  Effective nodes: " << optimizedGraph.nodes.size() << std::endl;
         std::cout << "  Optimization ratio: " << std::fixed << std::setprecision(1) 
-                  << (100.0 * actualDeadCount / stats.originalNodeCount) << "% nodes eliminated" << std::endl;
+                  << (100.0 * removedCount / std::max<size_t>(1, stats.originalNodeCount)) << "% nodes eliminated" << std::endl;
         std::cout << "  Optimization time: " << std::fixed << std::setprecision(2) 
                   << optimizationTime.count() << " ms" << std::endl;
         
@@ -291,6 +424,34 @@ std::unique_ptr<ForgedKernel> ForgeEngine::compile(const Graph& graph) {
         }
     }
     
+    // Loop rerolling: unrolled loops become calls of a function forged once.
+    // Nodes that now only exist inside a body drop out of the buffer mapping.
+    if (config_.enableLoopRerolling) {
+        auto regions = optimizations::LoopRerolling::findRegions(optimizedGraph);
+        if (!regions.empty()) {
+            std::vector<NodeId> rerolled = optimizations::LoopRerolling::reroll(optimizedGraph, regions);
+            for (NodeId& mapped : optResult.originalToOptimizedMapping) {
+                if (mapped < rerolled.size()) mapped = rerolled[mapped];
+            }
+        }
+        if (config_.printOptimizationStats) {
+            size_t blocks = 0;
+            for (const auto& region : regions) blocks += region.count;
+            std::cout << "  Loop rerolling: " << regions.size() << " regions, " << blocks << " blocks, "
+                      << optimizedGraph.nodes.size() << " nodes left" << std::endl;
+        }
+    }
+    
+    if (config_.enableOutputPruning) {
+        size_t forwardPruned = 0;
+        size_t adjointPruned = 0;
+        pruneToOutputs(optimizedGraph, forwardPruned, adjointPruned);
+        if (config_.printOptimizationStats) {
+            std::cout << "  Output pruning: " << forwardPruned << " nodes without forward code, "
+                      << adjointPruned << " more without adjoint code" << std::endl;
+        }
+    }
+    
     // Use the optimized graph for compilation
     const Graph& workingGraph = optimizedGraph;
     
@@ -321,6 +482,7 @@ std::unique_ptr<ForgedKernel> ForgeEngine::compile(const Graph& graph) {
     }
     
     // Start timing kernel stitching phase
+    compileStats.endPhase("prepare");
     auto stitchingStart = Clock::now();
     
     // Detailed timing for stitching phases
@@ -338,6 +500,24 @@ std::unique_ptr<ForgedKernel> ForgeEngine::compile(const Graph& graph) {
     
     // Use x86::Assembler directly - NO Compiler abstraction!
     x86::Assembler a(&code);
+
+    // Record external call sites for saveKernelObject()
+    std::unique_ptr<ExternalCallRecorder> callRecorder;
+    if (config_.enableKernelExport) {
+        callRecorder = std::make_unique<ExternalCallRecorder>();
+    }
+
+    // Record the code layout for perf symbols
+    std::unique_ptr<PerfKernelLayout> perfLayout;
+    if (config_.emitPerfMap || config_.emitJitDump) {
+        perfLayout = std::make_unique<PerfKernelLayout>();
+    }
+
+    // Cycle counters around node groups (profiling kernels only)
+    std::shared_ptr<KernelProfile> profile;
+    if (config_.profileNodesPerGroup > 0) {
+        profile = std::make_shared<KernelProfile>();
+    }
     
     // Enable validation to catch assembly errors (as suggested by specialist)
     a.addDiagnosticOptions(asmjit::DiagnosticOptions::kValidateAssembler);
@@ -381,17 +561,94 @@ std::unique_ptr<ForgedKernel> ForgeEngine::compile(const Graph& graph) {
     
     // Generate function prologue
     auto prologueStart = Clock::now();
+    if (perfLayout) perfLayout->mark(a.offset(), "prologue");
+    Label kernelEntryLabel = a.newLabel();
+    a.bind(kernelEntryLabel);
     instructionSet_->emitPrologue(a);
     Duration prologueTime = Clock::now() - prologueStart;
     
+    // Track maximum node ID accessed for proper buffer allocation
+    NodeId maxNodeIdAccessed = 0;
+    
+    // Derivative factors (cos/sin of trig arguments) the forward pass keeps for
+    // the adjoint, in value slots after the graph's nodes
+    std::vector<NodeId> derivativeSlots;
+    size_t derivativeSlotCount = 0;
+    if (needsGradient) {
+        derivativeSlots = BackwardForging::assignDerivativeSlots(workingGraph);
+        for (NodeId slot : derivativeSlots) {
+            if (slot != UINT32_MAX) derivativeSlotCount++;
+        }
+    }
+    auto derivativeSlotOf = [&](NodeId nodeId) {
+        return nodeId < derivativeSlots.size() ? derivativeSlots[nodeId] : UINT32_MAX;
+    };
+    
+    // Subgraph functions: every Call gets a frame of value slots after the
+    // derivative slots; bodies are emitted once, after the epilogue
+    FunctionForging::CallLayout callLayout = FunctionForging::assignCallFrames(
+        a, workingGraph, static_cast<NodeId>(workingGraph.nodes.size() + derivativeSlotCount), needsGradient);
+    if (!callLayout.empty() && config_.printOptimizationStats) {
+        size_t calls = 0;
+        for (NodeId frame : callLayout.frameBase) calls += frame != UINT32_MAX;
+        std::cout << "  Subgraph calls: " << calls << " calls, " << callLayout.slotCount << " frame slots" << std::endl;
+    }
+    
+    // UNIFORM HOISTING: nodes depending only on uniform inputs and constants are
+    // computed (and always stored) before the per-scenario body. The body gets a
+    // second entry point with its own copy of the prologue:
+    //   func:      prologue, hoisted nodes, jmp body
+    //   bodyEntry: prologue
+    //   body:      remaining forward nodes, backward pass, epilogue
+    std::vector<uint8_t> hoisted;
+    size_t hoistedCount = 0;
+    if (config_.enableUniformHoisting) {
+        hoistedCount = markHoistableNodes(workingGraph, hoisted);
+    }
+    // LANE BLOCKS: nodes span laneBlocks vectors. Forward nodes are forged in
+    // segments, each once per block with the base pointers moved one vector
+    // further, so the out-of-order core overlaps the blocks' independent chains.
+    // Registers are flushed between blocks; nothing stays cached across segments.
+    const int laneBlocks = instructionSet_->getLaneBlocks();
+    const int32_t laneBlockBytes = static_cast<int32_t>(instructionSet_->getVectorWidth() * sizeof(double));
+    
+    Label bodyEntryLabel;
+    if (hoistedCount > 0) {
+        DefaultCompilationPolicy hoistPolicy;
+        if (perfLayout) perfLayout->mark(a.offset(), "uniform");
+        const size_t uniformGroup = profile ? profile->beginGroup(a, "uniform") : 0;
+        for (int block = 0; block < laneBlocks; ++block) {
+            if (block > 0) moveLaneBlock(a, laneBlockBytes, false);
+            auto hoistRegState = createRegisterAllocator();
+            for (NodeId nodeId = 0; nodeId < workingGraph.nodes.size(); ++nodeId) {
+                if (!hoisted[nodeId]) continue;
+                if (perfLayout) perfLayout->markNode(a.offset(), nodeId);
+                if (profile && block == 0) profile->addNode(uniformGroup, nodeId, getOpName(workingGraph.nodes[nodeId].op));
+                ForwardForging::generateForwardOperation(a, workingGraph.nodes[nodeId], nodeId, workingGraph, constantMap, constPoolLabel, *hoistRegState, instructionSet_.get(), &hoistPolicy, false, derivativeSlotOf(nodeId));
+                maxNodeIdAccessed = std::max(maxNodeIdAccessed, nodeId);
+            }
+        }
+        if (laneBlocks > 1) moveLaneBlock(a, -laneBlockBytes * (laneBlocks - 1), false);
+        if (profile) profile->endGroup(a, uniformGroup);
+        
+        Label bodyLabel = a.newLabel();
+        bodyEntryLabel = a.newLabel();
+        a.jmp(bodyLabel);
+        if (perfLayout) perfLayout->mark(a.offset(), "body_entry");
+        a.bind(bodyEntryLabel);
+        instructionSet_->emitPrologue(a);
+        a.bind(bodyLabel);
+        
+        if (config_.printOptimizationStats) {
+            std::cout << "  Uniform hoisting: " << hoistedCount << " nodes moved to the batch prologue" << std::endl;
+        }
+    }
+    
     // Phase 2.3: Initialize register tracking state
     // Create appropriate allocator based on instruction set
     auto regStatePtr = createRegisterAllocator();
     IRegisterAllocator& regState = *regStatePtr;
     
-    // Track maximum node ID accessed for proper buffer allocation
-    NodeId maxNodeIdAccessed = 0;
-    
     // CONSTANT POOLING: Analyze constant usage frequency and preload hot constants
     std::unordered_map<double, int> constantFrequency;
     std::unordered_map<double, std::vector<NodeId>> constantNodes;
@@ -484,67 +741,170 @@ std::unique_ptr<ForgedKernel> ForgeEngine::compile(const Graph& graph) {
     auto codeGenStart = Clock::now();
     int nodesProcessed = 0;
 
+    // Forward-only kernels keep single-use intermediates register-only
+    ForwardOnlyPolicy forwardOnlyPolicy;
+    ICompilationPolicy* policy = policy_.get();
+    if (!needsGradient && config_.enableForwardOnlyStores && !customPolicy_) {
+        policy = &forwardOnlyPolicy;
+    }
+
     // Notify policy that compilation is beginning
-    policy_->onCompileBegin(workingGraph, a);
+    policy->onCompileBegin(workingGraph, a);
 
-    for (NodeId nodeId = 0; nodeId < workingGraph.nodes.size(); ++nodeId) {
+    size_t profileGroup = 0;
+    size_t profileGroupNodes = 0;  // Nodes in the open group, 0 when none is open
+
+    // Lane blocks: registers start out empty for every block, except for the
+    // pinned constants until a call clobbers them
+    bool pinnedConstantsLive = true;
+    auto resetLaneBlockRegisters = [&]() {
+        FunctionForging::flushRegisters(a, regState, instructionSet_.get());
+        regState.clear();
+        if (!pinnedConstantsLive) return;
+        for (const auto& [value, regIdx] : pinnedConstants) {
+            for (NodeId nid : constantNodes[value]) regState.setRegister(regIdx, nid, false);
+            regState.lock(regIdx);
+        }
+    };
+
+    auto forgeForwardNode = [&](NodeId nodeId) {
         const Node& node = workingGraph.nodes[nodeId];
-        if (node.isDead) continue;  // Skip dead nodes from optimization
+        if (perfLayout) perfLayout->markNode(a.offset(), nodeId);
 
         // Notify policy before node processing
-        policy_->onNodeBegin(nodeId, a);
+        policy->onNodeBegin(nodeId, a);
 
         // Track operation type timing
         auto opStart = Clock::now();
         std::string opName = getOpName(node.op);
 
         // Get store decision from policy (inverted: requiresStore=true means deferStore=false)
-        bool deferStore = !policy_->requiresStore(nodeId, workingGraph);
+        bool deferStore = !policy->requiresStore(nodeId, workingGraph);
 
         // Generate forward operation code
-        ForwardForging::generateForwardOperation(a, node, nodeId, workingGraph, constantMap, constPoolLabel, regState, instructionSet_.get(), policy_.get(), deferStore);
+        if (node.op == OpCode::Call || node.op == OpCode::CallResult) {
+            FunctionForging::forgeCallForward(a, nodeId, workingGraph, callLayout, constantMap, constPoolLabel, regState, instructionSet_.get());
+            pinnedConstantsLive = pinnedConstantsLive && node.op != OpCode::Call;
+        } else {
+            ForwardForging::generateForwardOperation(a, node, nodeId, workingGraph, constantMap, constPoolLabel, regState, instructionSet_.get(), policy, deferStore, derivativeSlotOf(nodeId));
+        }
 
         // Track maximum node ID
         maxNodeIdAccessed = std::max(maxNodeIdAccessed, nodeId);
 
         // Notify policy after node processing
         int resultReg = regState.findNodeInRegister(nodeId);
-        policy_->onNodeEnd(nodeId, resultReg, a);
+        policy->onNodeEnd(nodeId, resultReg, a);
 
         double opTime = Duration(Clock::now() - opStart).count();
         opTypeTime[opName] += opTime;
         opTypeCounts[opName]++;
         nodesProcessed++;
+    };
+
+    // Forward nodes of the current lane block segment
+    std::vector<NodeId> segment;
+    const size_t segmentNodes = std::max<size_t>(1, config_.laneBlockSegmentNodes);
+    auto forgeSegment = [&]() {
+        for (int block = 0; block < laneBlocks; ++block) {
+            if (block > 0) moveLaneBlock(a, laneBlockBytes, false);
+            for (NodeId nodeId : segment) forgeForwardNode(nodeId);
+            resetLaneBlockRegisters();
+        }
+        moveLaneBlock(a, -laneBlockBytes * (laneBlocks - 1), false);
+        segment.clear();
+    };
+
+    for (NodeId nodeId = 0; nodeId < workingGraph.nodes.size(); ++nodeId) {
+        const Node& node = workingGraph.nodes[nodeId];
+        if (node.isDead) continue;  // Skip dead nodes from optimization
+        if (hoistedCount > 0 && hoisted[nodeId]) continue;  // Computed in the uniform prologue
+        if (node.op == OpCode::CallArg) continue;  // Read by its Call
+
+        if (profile) {
+            if (profileGroupNodes == 0) profileGroup = profile->beginGroup(a, "forward");
+            profile->addNode(profileGroup, nodeId, getOpName(node.op));
+        }
+
+        if (laneBlocks == 1) {
+            forgeForwardNode(nodeId);
+        } else {
+            segment.push_back(nodeId);
+            // Profile groups close on segment boundaries
+            if (segment.size() == segmentNodes || (profile && profileGroupNodes + 1 == config_.profileNodesPerGroup)) {
+                forgeSegment();
+            }
+        }
+
+        if (profile && ++profileGroupNodes == config_.profileNodesPerGroup) {
+            profile->endGroup(a, profileGroup);
+            profileGroupNodes = 0;
+        }
+    }
+    if (!segment.empty()) forgeSegment();
+    if (profile && profileGroupNodes > 0) {
+        profile->endGroup(a, profileGroup);
     }
 
     // Notify policy that compilation is ending
-    policy_->onCompileEnd(a);
+    policy->onCompileEnd(a);
     
     // Generate function epilogue
     codeGenerationTime = Duration(Clock::now() - codeGenStart).count();
+    compileStats.endPhase("forward");
     
     // Generate backward pass if needed (reuse needsGradient flag from earlier check)
     if (needsGradient) {
+        if (perfLayout) perfLayout->mark(a.offset(), "backward");
         // Check if gradients pointer is not null at runtime
         // Note: After prologue, RSI contains the gradients pointer (moved from RDX)
         Label skipGradient = a.newLabel();
         a.test(x86::rsi, x86::rsi);  // RSI = gradients pointer (already set in prologue)
         a.jz(skipGradient);  // Jump if gradients == nullptr
         
-        // Generate gradient code (RSI already points to gradients)
-        BackwardForging::forgeBackwardPass(a, workingGraph, constantMap, constPoolLabel, regState, instructionSet_.get(), &config_);
+        // Generate gradient code (RSI already points to gradients), once per lane block
+        const size_t backwardGroup = profile ? profile->beginGroup(a, "backward") : 0;
+        for (int block = 0; block < laneBlocks; ++block) {
+            if (block > 0) moveLaneBlock(a, laneBlockBytes, true);
+            BackwardForging::forgeBackwardPass(a, workingGraph, constantMap, constPoolLabel, regState, instructionSet_.get(), &config_, &derivativeSlots, &callLayout);
+            if (laneBlocks > 1) resetLaneBlockRegisters();
+        }
+        if (laneBlocks > 1) moveLaneBlock(a, -laneBlockBytes * (laneBlocks - 1), true);
+        if (profile) profile->endGroup(a, backwardGroup);
         
         a.bind(skipGradient);
     }
+    compileStats.endPhase("backward");
     
     // Generate function epilogue
     auto epilogueStart = Clock::now();
+    if (perfLayout) perfLayout->mark(a.offset(), "epilogue");
     instructionSet_->emitEpilogue(a);
     Duration epilogueTime = Clock::now() - epilogueStart;
     
+    // Function bodies are only reached through call instructions
+    if (!callLayout.empty()) {
+        if (perfLayout) perfLayout->mark(a.offset(), "functions");
+        FunctionForging::forgeFunctionBodies(a, callLayout, constPool, constPoolLabel, instructionSet_.get(),
+                                             needsGradient, &config_, [this]() { return createRegisterAllocator(); });
+    }
+    
+    // Entry copying inputs/outputs from/to user arrays around a call of the kernel
+    Label boundEntryLabel;
+    KernelIoLayout ioLayout;
+    if (config_.enableIoBinding) {
+        ioLayout = KernelIoLayout::fromGraph(graph, optResult.originalToOptimizedMapping);
+        boundEntryLabel = a.newLabel();
+        if (perfLayout) perfLayout->mark(a.offset(), "io_binding");
+        a.align(AlignMode::kCode, 16);
+        a.bind(boundEntryLabel);
+        emitBoundEntry(a, kernelEntryLabel, ioLayout, instructionSet_->getVectorWidth() * laneBlocks);
+    }
+    
     // Phase 2.2: Embed constant pool after code with proper alignment
     auto embedStart = Clock::now();
     if (constPool.size() > 0) {
+        if (perfLayout) perfLayout->mark(a.offset(), "constants");
         // CRITICAL FIX: Don't manually bind! embedConstPool does align→bind→emit for us
         // a.align(AlignMode::kData, 32);  // Optional, embedConstPool handles alignment
         a.embedConstPool(constPoolLabel, constPool);  // This does align→bind→emit
@@ -553,6 +913,8 @@ std::unique_ptr<ForgedKernel> ForgeEngine::compile(const Graph& graph) {
     
     Duration embedTime = Clock::now() - embedStart;
     
+    compileStats.endPhase("finalize");
+    
     // Add the compiled function to runtime
     auto finalizeStart = Clock::now();
     ForgedKernel::KernelFunc func = nullptr;
@@ -564,7 +926,18 @@ std::unique_ptr<ForgedKernel> ForgeEngine::compile(const Graph& graph) {
         errorStr += errMsg ? errMsg : "Unknown error";
         throw std::runtime_error(errorStr);
     }
+    ForgedKernel::KernelFunc bodyFunc = nullptr;
+    if (hoistedCount > 0) {
+        bodyFunc = reinterpret_cast<ForgedKernel::KernelFunc>(
+            reinterpret_cast<uint8_t*>(func) + code.labelOffsetFromBase(bodyEntryLabel));
+    }
+    ForgedKernel::BoundKernelFunc boundFunc = nullptr;
+    if (config_.enableIoBinding) {
+        boundFunc = reinterpret_cast<ForgedKernel::BoundKernelFunc>(
+            reinterpret_cast<uint8_t*>(func) + code.labelOffsetFromBase(boundEntryLabel));
+    }
     assemblyFinalizationTime = Duration(Clock::now() - finalizeStart).count();
+    compileStats.endPhase("runtime");
     
     auto stitchingEnd = Clock::now();
     Duration stitchingTime = stitchingEnd - stitchingStart;
@@ -622,7 +995,47 @@ std::unique_ptr<ForgedKernel> ForgeEngine::compile(const Graph& graph) {
               << (workingGraph.nodes.size() * 1000.0 / totalTime.count()) << " nodes/sec" << std::endl;
     }
     
-    return std::make_unique<ForgedKernel>(func, s_runtime, optimizedGraph.nodes.size(), instructionSet_.get(), config_, optResult.originalToOptimizedMapping, maxNodeIdAccessed, workingGraph.nodes.size(), workingGraph.outputs);
+    // Buffers must also hold the derivative slots and call frames
+    size_t maxSlotAccessed = maxNodeIdAccessed;
+    const size_t extraSlots = derivativeSlotCount + callLayout.slotCount;
+    if (extraSlots > 0) {
+        maxSlotAccessed = workingGraph.nodes.size() + extraSlots - 1;
+    }
+    
+    auto kernel = std::make_unique<ForgedKernel>(func, s_runtime, optimizedGraph.nodes.size(), instructionSet_.get(), config_, optResult.originalToOptimizedMapping, maxSlotAccessed, workingGraph.nodes.size(), workingGraph.outputs, bodyFunc);
+    {
+        // Slots the code reads before writing: the inputs. The backward pass
+        // writes every adjoint before reading it (first-write stores)
+        auto liveIns = std::make_shared<KernelLiveIns>();
+        for (NodeId id = 0; id < workingGraph.nodes.size(); ++id) {
+            if (workingGraph.nodes[id].op == OpCode::Input) KernelLiveIns::add(liveIns->values, id, id + 1);
+        }
+        kernel->setLiveIns(std::move(liveIns));
+    }
+    if (boundFunc) {
+        kernel->setIoBinding(boundFunc, std::move(ioLayout));
+    }
+    kernel->setCodeSize(code.codeSize());
+    if (callRecorder) {
+        ForgedKernel::ExportInfo exportInfo;
+        exportInfo.codeSize = code.codeSize();
+        exportInfo.externalCallSites = callRecorder->sites();
+        kernel->setExportInfo(std::move(exportInfo));
+    }
+    if (profile) {
+        profile->setOriginalToOptimizedMapping(optResult.originalToOptimizedMapping);
+        kernel->setProfile(std::move(profile));
+    }
+    if (perfLayout) {
+        const std::string kernelName = PerfJitMap::nextKernelName();
+        const auto symbols = perfLayout->symbols(kernelName, code.codeSize(), config_.perfNodesPerSymbol);
+        if (config_.emitPerfMap) PerfJitMap::writePerfMap(reinterpret_cast<const void*>(func), symbols);
+        if (config_.emitJitDump) {
+            PerfJitMap::writeJitDump(reinterpret_cast<const void*>(func), symbols, perfLayout->lines(), kernelName + ".nodes");
+        }
+    }
+    lastCompileStats_ = compileStats.finish(graph.size(), workingGraph.nodes.size(), code.codeSize());
+    return kernel;
 }
 
 } // namespace forge
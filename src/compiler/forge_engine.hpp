@@ -28,13 +28,19 @@
 #include "interfaces/compilation_policy.hpp"
 #include "x86/common/instruction_set_factory.hpp"
 #include "runtime_trace.hpp"
+#include "kernel_profile.hpp"
+#include "compile_stats.hpp"
+#include "io_binding.hpp"
 #include <asmjit/x86.h>
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
 #include <cmath>
 #include <algorithm>
+#include <stdexcept>
 #include <iostream>
 #include <iomanip>
 #include <chrono>
@@ -114,11 +120,13 @@ public:
      *
      * Policies control register allocation and memory management decisions
      * during compilation. The default policy preserves standard behavior.
+     * A custom policy also disables the automatic ForwardOnlyPolicy.
      *
      * @param policy Custom policy (ownership transferred)
      */
     void setPolicy(std::unique_ptr<ICompilationPolicy> policy) {
         policy_ = std::move(policy);
+        customPolicy_ = true;
     }
 
     /**
@@ -127,6 +135,13 @@ public:
      */
     ICompilationPolicy* getPolicy() const { return policy_.get(); }
 
+    /**
+     * @brief Phase times and memory of the last successful compile()
+     *
+     * Empty unless CompilerConfig::collectCompileStats was set for it.
+     */
+    const CompileStats& getLastCompileStats() const { return lastCompileStats_; }
+
     /**
      * @brief Get the shared JIT runtime (for testing/debugging)
      * @return Reference to global JitRuntime instance
@@ -148,6 +163,9 @@ private:
 
     // Compilation policy for register allocation and store decisions
     std::unique_ptr<ICompilationPolicy> policy_;
+    bool customPolicy_ = false;  // Set by setPolicy(); keeps compile() from substituting ForwardOnlyPolicy
+
+    CompileStats lastCompileStats_;
     
     // Shared JitRuntime for all compilers - long-lived per Design v3
     // This ensures executable memory remains valid after compiler destruction
@@ -185,18 +203,29 @@ public:
     /** @brief Function signature for compiled kernels */
     using KernelFunc = void(*)(double* values, double* gradients, size_t count);
 
+    /** @brief Signature of the bound entry (CompilerConfig::enableIoBinding) */
+    using BoundKernelFunc = void(*)(double* values, double* gradients, const KernelIoBinding* io);
+
+    /**
+     * @brief Code layout kept for saveKernelObject() (CompilerConfig::enableKernelExport)
+     */
+    struct ExportInfo {
+        size_t codeSize = 0;                    ///< Bytes of code and constant pool starting at getFunction()
+        std::vector<size_t> externalCallSites;  ///< Offsets of the 64-bit external function addresses
+    };
+
     ForgedKernel(KernelFunc func, asmjit::JitRuntime& runtime, size_t num_nodes, const IInstructionSet* instructionSet, const CompilerConfig& config, size_t max_node_id = 0, size_t working_nodes = 0)
         : func_(func), runtime_(&runtime), num_nodes_(num_nodes),
-          vector_width_(instructionSet->getVectorWidth()),
+          vector_width_(instructionSet->getVectorWidth() * instructionSet->getLaneBlocks()),
           instruction_set_name_(instructionSet->getName()),
           config_(config), max_node_id_(max_node_id), working_nodes_(working_nodes > 0 ? working_nodes : num_nodes) {}
 
     // Constructor with node ID mapping
     ForgedKernel(KernelFunc func, asmjit::JitRuntime& runtime, size_t num_nodes, const IInstructionSet* instructionSet, const CompilerConfig& config,
                    const std::vector<forge::NodeId>& originalToOptimizedMapping, size_t max_node_id = 0, size_t working_nodes = 0,
-                   const std::vector<forge::NodeId>& outputNodes = {})
-        : func_(func), runtime_(&runtime), num_nodes_(num_nodes),
-          vector_width_(instructionSet->getVectorWidth()),
+                   const std::vector<forge::NodeId>& outputNodes = {}, KernelFunc bodyFunc = nullptr)
+        : func_(func), bodyFunc_(bodyFunc), runtime_(&runtime), num_nodes_(num_nodes),
+          vector_width_(instructionSet->getVectorWidth() * instructionSet->getLaneBlocks()),
           instruction_set_name_(instructionSet->getName()),
           config_(config),
           max_node_id_(max_node_id), working_nodes_(working_nodes > 0 ? working_nodes : num_nodes),
@@ -208,6 +237,17 @@ public:
         //           << ", getMaxNodeId()=" << getMaxNodeId() << std::endl;
     }
     
+    // Kernel loaded from a shared library (see loadKernelLibrary); keeps the library loaded
+    ForgedKernel(KernelFunc func, std::shared_ptr<void> library, size_t num_nodes, int vectorWidth, std::string instructionSetName,
+                   const CompilerConfig& config, const std::vector<forge::NodeId>& originalToOptimizedMapping,
+                   size_t max_node_id, size_t working_nodes, const std::vector<forge::NodeId>& outputNodes, KernelFunc bodyFunc = nullptr)
+        : func_(func), bodyFunc_(bodyFunc), runtime_(nullptr), library_(std::move(library)), num_nodes_(num_nodes),
+          vector_width_(vectorWidth),
+          instruction_set_name_(std::move(instructionSetName)),
+          config_(config),
+          max_node_id_(max_node_id), working_nodes_(working_nodes > 0 ? working_nodes : num_nodes),
+          originalToOptimizedMapping_(originalToOptimizedMapping), outputNodes_(outputNodes) {}
+
     ~ForgedKernel() {
         if (func_ && runtime_) {
             runtime_->release(func_);
@@ -227,9 +267,77 @@ public:
      * Thread Safety: Reentrant - safe to call concurrently
      */
     inline void executeDirect(double* values, double* gradients, size_t count) {
+        bindThreadTraceRing();
         func_(values, gradients, count);
     }
 
+    /**
+     * @brief Execute only the per-scenario body, skipping the uniform prologue
+     *
+     * Kernels compiled from graphs with uniform inputs (Graph::markUniform) compute
+     * every node that depends on nothing but uniform inputs and constants once, in
+     * a prologue. The body entry reuses the values the prologue stored, so it is
+     * only valid after a full execute() on the same buffer whose uniform inputs
+     * have not changed since. Without a prologue this is the same as executeDirect().
+     *
+     * @param values Pointer to node values array (must be properly aligned)
+     * @param gradients Pointer to gradient array (can be nullptr if no gradients)
+     * @param count Number of nodes in the arrays
+     */
+    inline void executeBodyDirect(double* values, double* gradients, size_t count) {
+        bindThreadTraceRing();
+        (bodyFunc_ ? bodyFunc_ : func_)(values, gradients, count);
+    }
+
+    /**
+     * @brief Buffer variant of executeBodyDirect()
+     * @param buffer Value buffer already run through execute() with the current uniform inputs
+     */
+    inline void executeBody(INodeValueBuffer& buffer) {
+        executeBodyDirect(buffer.getValuesPtr(), buffer.getGradientsPtr(), buffer.getNumNodes());
+    }
+
+    /**
+     * @brief Execute with inputs read from and results written to user-owned arrays
+     *
+     * Generated code copies io.inputs into the buffer, runs the full kernel and
+     * copies outputs and input gradients to io.outputs / io.inputGradients (see
+     * io_binding.hpp for the array layout). The buffer still holds every other
+     * value and must be sized for this kernel.
+     *
+     * @throws std::runtime_error if the kernel was compiled without CompilerConfig::enableIoBinding
+     *
+     * Thread Safety: Reentrant - safe to call concurrently with different buffers
+     */
+    inline void executeBound(INodeValueBuffer& buffer, const KernelIoBinding& io) {
+        if (!boundFunc_) {
+            throw std::runtime_error("Kernel has no bound entry: compile with CompilerConfig::enableIoBinding");
+        }
+        executeBoundDirect(buffer.getValuesPtr(), buffer.getGradientsPtr(), io);
+    }
+
+    /** @brief Raw-pointer variant of executeBound() (boundFunc must exist, see hasIoBinding()) */
+    inline void executeBoundDirect(double* values, double* gradients, const KernelIoBinding& io) {
+        bindThreadTraceRing();
+        boundFunc_(values, gradients, &io);
+    }
+
+    /** @brief Whether executeBound() is available */
+    bool hasIoBinding() const { return boundFunc_ != nullptr; }
+
+    /** @brief Buffer slots behind the binding arrays, nullptr without a bound entry */
+    const KernelIoLayout* getIoLayout() const { return boundFunc_ ? &ioLayout_ : nullptr; }
+    void setIoBinding(BoundKernelFunc func, KernelIoLayout layout) {
+        boundFunc_ = func;
+        ioLayout_ = std::move(layout);
+    }
+
+    /**
+     * @brief Whether uniform nodes were hoisted into a separate prologue
+     * @return true if executeBody() skips work compared to execute()
+     */
+    bool hasUniformPrologue() const { return bodyFunc_ != nullptr; }
+
     /**
      * @brief Execute kernel using a NodeValueBuffer
      *
@@ -266,6 +374,8 @@ public:
         if (func_ && buffer.getNumNodes() >= getRequiredNodes()) {
             // std::cout << "[KERNEL] Conditions met, executing kernel function..." << std::endl;
 
+            bindThreadTraceRing();
+
             // Pass gradient pointer if available, otherwise nullptr
             // std::cout << "[KERNEL] Calling func_ (the compiled kernel)..." << std::endl;
             auto execStart = std::chrono::high_resolution_clock::now();
@@ -338,7 +448,7 @@ public:
 
     /**
      * @brief Get SIMD vector width of this kernel
-     * @return Number of doubles processed per operation (1 for scalar, 4 for AVX2)
+     * @return Doubles per node in the buffer (1 for scalar, 4 for AVX2, 4 * CompilerConfig::laneBlocks)
      */
     int getVectorWidth() const { return vector_width_; }
 
@@ -369,6 +479,37 @@ public:
     const std::vector<forge::NodeId>& getOriginalToOptimizedMapping() const {
         return originalToOptimizedMapping_;
     }
+
+    /** @brief Original graph size the kernel was compiled from */
+    size_t getNumNodes() const { return num_nodes_; }
+
+    /** @brief Working graph size (after optimizations) */
+    size_t getWorkingNodes() const { return working_nodes_; }
+
+    /** @brief Output node IDs in the working graph */
+    const std::vector<forge::NodeId>& getOutputNodes() const { return outputNodes_; }
+
+    /** @brief Entry past the uniform prologue, nullptr without one */
+    KernelFunc getBodyFunction() const { return bodyFunc_; }
+
+    /** @brief Process-unique kernel id; unlike the address it is never reused after destruction */
+    uint64_t getId() const { return id_; }
+
+    /** @brief Bytes of code and constant pool starting at getFunction() (0 for loaded kernels) */
+    size_t getCodeSize() const { return codeSize_; }
+    void setCodeSize(size_t bytes) { codeSize_ = bytes; }
+
+    /** @brief Export layout, nullptr unless compiled with CompilerConfig::enableKernelExport */
+    const ExportInfo* getExportInfo() const { return exportInfo_.get(); }
+    void setExportInfo(ExportInfo info) { exportInfo_ = std::make_unique<ExportInfo>(std::move(info)); }
+
+    /** @brief Cycle counters, nullptr unless compiled with CompilerConfig::profileNodesPerGroup */
+    KernelProfile* getProfile() const { return profile_.get(); }
+    void setProfile(std::shared_ptr<KernelProfile> profile) { profile_ = std::move(profile); }
+
+    /** @brief Slots INodeValueBuffer::reset() must zero, nullptr if unknown (loaded kernels) */
+    const std::shared_ptr<const KernelLiveIns>& getLiveIns() const { return liveIns_; }
+    void setLiveIns(std::shared_ptr<const KernelLiveIns> liveIns) { liveIns_ = std::move(liveIns); }
     
     // Disable copy
     ForgedKernel(const ForgedKernel&) = delete;
@@ -376,14 +517,22 @@ public:
     
     // Enable move
     ForgedKernel(ForgedKernel&& other) noexcept
-        : func_(other.func_), runtime_(other.runtime_), num_nodes_(other.num_nodes_),
+        : func_(other.func_), bodyFunc_(other.bodyFunc_), runtime_(other.runtime_),
+          library_(std::move(other.library_)), num_nodes_(other.num_nodes_),
           vector_width_(other.vector_width_),
           instruction_set_name_(std::move(other.instruction_set_name_)),
           config_(other.config_),
           max_node_id_(other.max_node_id_), working_nodes_(other.working_nodes_),
           originalToOptimizedMapping_(std::move(other.originalToOptimizedMapping_)),
-          outputNodes_(std::move(other.outputNodes_)) {
+          outputNodes_(std::move(other.outputNodes_)),
+          exportInfo_(std::move(other.exportInfo_)),
+          profile_(std::move(other.profile_)),
+          liveIns_(std::move(other.liveIns_)),
+          boundFunc_(other.boundFunc_), ioLayout_(std::move(other.ioLayout_)),
+          codeSize_(other.codeSize_), id_(other.id_) {
         other.func_ = nullptr;
+        other.bodyFunc_ = nullptr;
+        other.boundFunc_ = nullptr;
         other.runtime_ = nullptr;
         other.vector_width_ = 0;
         other.max_node_id_ = 0;
@@ -391,8 +540,24 @@ public:
     }
 
 private:
+    // Traced kernels record into the calling thread's own ring; every entry
+    // point registers it first so no thread falls back to the shared ring.
+    // Untraced kernels only test a flag.
+    inline void bindThreadTraceRing() const {
+        if (config_.printRuntimeTrace && forge::isTracingEnabled()) {
+            forge::acquireThreadTraceBuffer();
+        }
+    }
+
+    static uint64_t nextId() {
+        static std::atomic<uint64_t> counter{0};
+        return ++counter;
+    }
+
     KernelFunc func_;
-    asmjit::JitRuntime* runtime_;  // Points to shared static runtime
+    KernelFunc bodyFunc_ = nullptr;  // Entry past the uniform prologue (inside func_'s code, not released separately)
+    asmjit::JitRuntime* runtime_;  // Points to shared static runtime (nullptr for loaded kernels)
+    std::shared_ptr<void> library_;  // Shared library holding the code of a loaded kernel
     size_t num_nodes_;              // Original graph size (for buffer compatibility)
     int vector_width_;              // SIMD vector width (1 for scalar, 4 for AVX2)
     std::string instruction_set_name_;  // Name of instruction set used
@@ -401,6 +566,13 @@ private:
     size_t working_nodes_;         // Working graph size (after optimizations)
     std::vector<forge::NodeId> originalToOptimizedMapping_;  // Node ID mapping
     std::vector<forge::NodeId> outputNodes_;  // Output node IDs (for debug display)
+    std::unique_ptr<ExportInfo> exportInfo_;  // Only with CompilerConfig::enableKernelExport
+    std::shared_ptr<KernelProfile> profile_;  // Counter table the code writes to (profiling kernels only)
+    std::shared_ptr<const KernelLiveIns> liveIns_;  // Read-before-write slots (buffer reset)
+    BoundKernelFunc boundFunc_ = nullptr;  // Entry taking a KernelIoBinding (inside func_'s code)
+    KernelIoLayout ioLayout_;
+    size_t codeSize_ = 0;
+    uint64_t id_ = nextId();  // Moved-to kernels keep the id (same kernel)
 };
 
 } // namespace forge
\ No newline at end of file
@@ -42,7 +42,8 @@ void ForwardForging::generateForwardOperation(
     IRegisterAllocator& regState,
     IInstructionSet* instructionSet,
     ICompilationPolicy* policy,
-    bool deferStore
+    bool deferStore,
+    forge::NodeId derivativeSlot
 ) {
     // Phase 1.4: Minimal set of operations for Linear function
     // Using XMM0-XMM3 as working registers
@@ -485,7 +486,12 @@ void ForwardForging::generateForwardOperation(
             }
 
             int resultRegIdx = regState.allocateAvoiding({});
-            instructionSet->emitSin(a, resultRegIdx, aRegIdx, regState);
+            if (derivativeSlot != UINT32_MAX) {
+                // Keep cos(x) for the adjoint from the same call
+                instructionSet->emitSinCos(a, resultRegIdx, aRegIdx, derivativeSlot, false, regState);
+            } else {
+                instructionSet->emitSin(a, resultRegIdx, aRegIdx, regState);
+            }
 
             regState.setRegister(resultRegIdx, nodeId, deferStore);
             if (!deferStore) {
@@ -501,7 +507,12 @@ void ForwardForging::generateForwardOperation(
             }
 
             int resultRegIdx = regState.allocateAvoiding({});
-            instructionSet->emitCos(a, resultRegIdx, aRegIdx, regState);
+            if (derivativeSlot != UINT32_MAX) {
+                // Keep sin(x) for the adjoint from the same call
+                instructionSet->emitSinCos(a, resultRegIdx, aRegIdx, derivativeSlot, true, regState);
+            } else {
+                instructionSet->emitCos(a, resultRegIdx, aRegIdx, regState);
+            }
 
             regState.setRegister(resultRegIdx, nodeId, deferStore);
             if (!deferStore) {
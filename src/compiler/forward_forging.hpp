@@ -55,6 +55,9 @@ public:
      * @param instructionSet Instruction set implementation (SSE2/AVX2)
      * @param policy Compilation policy for register decisions (nullptr for default)
      * @param deferStore If true, keep result in register without storing
+     * @param derivativeSlot Value slot receiving the node's derivative factor for the
+     *                       adjoint pass (see BackwardForging::assignDerivativeSlots),
+     *                       UINT32_MAX for none
      *
      * Thread Safety: Not thread-safe
      */
@@ -68,7 +71,8 @@ public:
         IRegisterAllocator& regState,
         IInstructionSet* instructionSet,
         ICompilationPolicy* policy = nullptr,
-        bool deferStore = false
+        bool deferStore = false,
+        forge::NodeId derivativeSlot = UINT32_MAX
     );
 
     /**
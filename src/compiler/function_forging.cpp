@@ -0,0 +1,282 @@
+// This file is part of Forge <https://github.com/da-roth/forge>
+//
+// See LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+/**
+ * @file function_forging.cpp
+ * @brief Implementation of subgraph function call code generation
+ */
+
+#include "function_forging.hpp"
+#include "backward_forging.hpp"
+#include "forward_forging.hpp"
+#include <limits>
+#include <stdexcept>
+
+namespace forge {
+
+using namespace asmjit;
+using namespace forge;
+
+FunctionForging::CallLayout FunctionForging::assignCallFrames(x86::Assembler& a, const Graph& graph,
+                                                              NodeId firstSlot, bool withGradient) {
+    CallLayout layout;
+    const size_t n = graph.nodes.size();
+    bool anyCall = false;
+    for (const Node& node : graph.nodes) {
+        anyCall = anyCall || (!node.isDead && node.op == OpCode::Call);
+    }
+    if (!anyCall) return layout;
+
+    const size_t count = graph.functions.size();
+    layout.bodies.resize(count);
+    layout.params.resize(count);
+    layout.results.resize(count);
+    layout.used.assign(count, 0);
+    layout.forwardEntry.resize(count);
+    layout.backwardEntry.resize(count);
+
+    // Bodies are differentiated with respect to all parameters: which arguments
+    // need an adjoint differs between call sites, the code does not
+    for (size_t f = 0; f < count; ++f) {
+        Graph body = graph.functions[f];
+        for (NodeId id = 0; id < body.nodes.size(); ++id) {
+            Node& node = body.nodes[id];
+            if (node.op == OpCode::Call) {
+                throw std::runtime_error("Function bodies cannot call other functions");
+            }
+            if (node.op == OpCode::Input) {
+                layout.params[f].push_back(id);
+                if (withGradient) {
+                    node.isActive = true;
+                    node.needsGradient = true;
+                }
+                continue;
+            }
+            if (!withGradient) continue;
+            const NodeId operands[3] = {node.a, node.b, node.c};
+            for (int k = 0; k < operandCount(node.op); ++k) {
+                if (operands[k] < id && body.nodes[operands[k]].needsGradient) {
+                    node.isActive = true;
+                    node.needsGradient = true;
+                }
+            }
+        }
+        layout.results[f] = body.outputs;
+        layout.bodies[f] = std::move(body);
+    }
+
+    layout.frameBase.assign(n, UINT32_MAX);
+    size_t next = firstSlot;
+    for (NodeId id = 0; id < n; ++id) {
+        const Node& node = graph.nodes[id];
+        if (node.isDead || node.op != OpCode::Call) continue;
+        size_t f = static_cast<size_t>(node.imm);
+        if (f >= count) {
+            throw std::runtime_error("Call to unknown function");
+        }
+        layout.frameBase[id] = static_cast<NodeId>(next);
+        next += layout.bodies[f].nodes.size();
+        layout.used[f] = 1;
+    }
+    if (next >= std::numeric_limits<NodeId>::max()) {
+        throw std::runtime_error("Call frames exceed the node ID range");
+    }
+    layout.slotCount = next - firstSlot;
+
+    for (size_t f = 0; f < count; ++f) {
+        if (!layout.used[f]) continue;
+        layout.forwardEntry[f] = a.newLabel();
+        if (withGradient) {
+            layout.backwardEntry[f] = a.newLabel();
+        }
+    }
+    return layout;
+}
+
+void FunctionForging::forgeCallForward(
+    x86::Assembler& a,
+    NodeId nodeId,
+    const Graph& graph,
+    const CallLayout& layout,
+    const std::unordered_map<NodeId, ForgeEngine::ConstantInfo>& constantMap,
+    const Label& constPoolLabel,
+    IRegisterAllocator& regState,
+    IInstructionSet* instructionSet) {
+
+    const Node& node = graph.nodes[nodeId];
+    const NodeId call = node.op == OpCode::Call ? nodeId : node.a;
+    const NodeId frame = layout.frameOf(call);
+    if (frame == UINT32_MAX) {
+        throw std::runtime_error("Call node without a frame");
+    }
+    const size_t f = static_cast<size_t>(graph.nodes[call].imm);
+    const size_t index = node.op == OpCode::Call ? 0 : static_cast<size_t>(node.imm);
+    if (index >= layout.results[f].size()) {
+        throw std::runtime_error("CallResult index out of range");
+    }
+
+    if (node.op == OpCode::Call) {
+        flushRegisters(a, regState, instructionSet);
+
+        // Arguments into the frame's parameter slots
+        const std::vector<NodeId> args = graph.callArguments(call);
+        const std::vector<NodeId>& params = layout.params[f];
+        if (args.size() != params.size()) {
+            throw std::runtime_error("Call argument count does not match the function's parameters");
+        }
+        for (size_t i = 0; i < args.size(); ++i) {
+            instructionSet->emitLoadValueForGradient(a, 0, args[i], graph, &constantMap, constPoolLabel);
+            instructionSet->emitStore(a, 0, frame + params[i]);
+        }
+
+        emitFrameCall(a, layout.forwardEntry[f], frame, instructionSet);
+        regState.clear();  // The body may use every vector register
+    }
+
+    // Results are read back from the frame (CallResult needs no call of its own)
+    int reg = regState.allocateRegister();
+    instructionSet->emitLoad(a, reg, frame + layout.results[f][index]);
+    instructionSet->emitStore(a, reg, nodeId);
+    regState.setRegister(reg, nodeId, false);
+}
+
+void FunctionForging::forgeCallBackward(
+    x86::Assembler& a,
+    NodeId nodeId,
+    const Graph& graph,
+    const CallLayout& layout,
+    IRegisterAllocator& regState,
+    IInstructionSet* instructionSet,
+    AdjointWrites& adjointWrites) {
+
+    const Node& node = graph.nodes[nodeId];
+    if (!node.needsGradient) return;
+    const NodeId call = node.op == OpCode::Call ? nodeId : node.a;
+    const NodeId frame = layout.frameOf(call);
+    if (frame == UINT32_MAX) {
+        throw std::runtime_error("Call node without a frame");
+    }
+    const size_t f = static_cast<size_t>(graph.nodes[call].imm);
+    const size_t index = node.op == OpCode::Call ? 0 : static_cast<size_t>(node.imm);
+
+    // grad[frame + result] += grad[nodeId]
+    // CallResult nodes follow their Call, so all results are seeded before the Call runs the body's adjoint
+    instructionSet->emitLoadGradient(a, 0, nodeId);
+    adjointWrites.accumulate(a, instructionSet, 0, frame + layout.results[f][index]);
+    if (node.op != OpCode::Call) return;
+
+    // The body's adjoint starts from all result slots (see emitBackwardSubroutine)
+    for (NodeId result : layout.results[f]) {
+        adjointWrites.ensureWritten(a, instructionSet, frame + result, 0);
+    }
+
+    emitFrameCall(a, layout.backwardEntry[f], frame, instructionSet);
+    regState.clear();
+
+    // grad[arg] += grad[frame + param]
+    const std::vector<NodeId> args = graph.callArguments(call);
+    const std::vector<NodeId>& params = layout.params[f];
+    for (size_t i = 0; i < args.size(); ++i) {
+        const NodeId arg = args[i];
+        if (arg >= graph.nodes.size() || !graph.nodes[arg].needsGradient) continue;
+        instructionSet->emitLoadGradient(a, 0, frame + params[i]);
+        adjointWrites.accumulate(a, instructionSet, 0, arg);
+    }
+}
+
+void FunctionForging::collectConstants(const Graph& body, ConstPool& constPool,
+                                       std::unordered_map<NodeId, ForgeEngine::ConstantInfo>& constantMap) {
+    for (NodeId id = 0; id < body.nodes.size(); ++id) {
+        const Node& node = body.nodes[id];
+        if (node.isDead || node.op != OpCode::Constant) continue;
+        size_t constIndex = static_cast<size_t>(node.imm);
+        if (constIndex >= body.constPool.size()) {
+            throw std::runtime_error("Invalid constant index");
+        }
+        size_t offset = 0;
+        constPool.add(&body.constPool[constIndex], sizeof(double), offset);
+        constantMap[id] = {offset, body.constPool[constIndex]};
+    }
+}
+
+void FunctionForging::emitForwardSubroutine(
+    x86::Assembler& a, const Graph& body, const Label& entry,
+    const std::unordered_map<NodeId, ForgeEngine::ConstantInfo>& constantMap,
+    const Label& constPoolLabel, IRegisterAllocator& regState, IInstructionSet* instructionSet) {
+
+    a.bind(entry);
+    // Library calls inside the body expect the aligned stack of the kernel prologue
+    a.push(x86::rbp);
+    a.mov(x86::rbp, x86::rsp);
+    a.and_(x86::rsp, -32);
+
+    DefaultCompilationPolicy policy;  // Every value is stored: results and the adjoint read the frame
+    for (NodeId id = 0; id < body.nodes.size(); ++id) {
+        const Node& node = body.nodes[id];
+        if (node.isDead) continue;
+        ForwardForging::generateForwardOperation(a, node, id, body, constantMap, constPoolLabel, regState, instructionSet, &policy, false);
+    }
+    // A constant result may have stayed in a register only
+    for (NodeId result : body.outputs) {
+        if (result < body.nodes.size() && body.nodes[result].op == OpCode::Constant) {
+            instructionSet->emitLoadValueForGradient(a, 0, result, body, &constantMap, constPoolLabel);
+            instructionSet->emitStore(a, 0, result);
+        }
+    }
+
+    a.mov(x86::rsp, x86::rbp);
+    a.pop(x86::rbp);
+    a.ret();
+}
+
+void FunctionForging::emitBackwardSubroutine(
+    x86::Assembler& a, const Graph& body, const Label& entry,
+    const std::unordered_map<NodeId, ForgeEngine::ConstantInfo>& constantMap,
+    const Label& constPoolLabel, IRegisterAllocator& regState, IInstructionSet* instructionSet,
+    const CompilerConfig* config) {
+
+    a.bind(entry);
+    a.push(x86::rbp);
+    a.mov(x86::rbp, x86::rsp);
+    a.and_(x86::rsp, -32);
+
+    // The caller seeds the results' adjoints, so the body's outputs must not be reset to 1.0.
+    // The sweep writes every parameter's adjoint, which the caller reads back.
+    Graph adjointBody = body;
+    adjointBody.outputs.clear();
+    BackwardForging::forgeBackwardPass(a, adjointBody, constantMap, constPoolLabel, regState, instructionSet, config,
+                                       nullptr, nullptr, &body.outputs);
+
+    a.mov(x86::rsp, x86::rbp);
+    a.pop(x86::rbp);
+    a.ret();
+}
+
+void FunctionForging::emitFrameCall(x86::Assembler& a, const Label& entry, NodeId frameBase,
+                                    IInstructionSet* instructionSet) {
+    const int64_t offset = static_cast<int64_t>(frameBase) * static_cast<int64_t>(sizeof(double)) *
+                           instructionSet->getVectorWidth() * instructionSet->getLaneBlocks();
+    if (offset > std::numeric_limits<int32_t>::max()) {
+        throw std::runtime_error("Call frame offset exceeds the 32-bit displacement range");
+    }
+    const int32_t disp = static_cast<int32_t>(offset);
+    a.lea(x86::rdi, x86::ptr(x86::rdi, disp));
+    a.lea(x86::rsi, x86::ptr(x86::rsi, disp));
+    a.call(entry);
+    a.lea(x86::rdi, x86::ptr(x86::rdi, -disp));
+    a.lea(x86::rsi, x86::ptr(x86::rsi, -disp));
+}
+
+void FunctionForging::flushRegisters(x86::Assembler& a, IRegisterAllocator& regState, IInstructionSet* instructionSet) {
+    for (int reg = 0; reg < regState.getNumRegisters(); ++reg) {
+        int held = regState.getNodeInRegister(reg);
+        if (held >= 0 && regState.isDirty(reg)) {
+            instructionSet->emitStore(a, reg, static_cast<NodeId>(held));
+            regState.markClean(reg);
+        }
+    }
+}
+
+} // namespace forge
@@ -0,0 +1,160 @@
+// This file is part of Forge <https://github.com/da-roth/forge>
+//
+// See LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+/**
+ * @file function_forging.hpp
+ * @brief Function forging - code generation for subgraph function calls
+ *
+ * Each function in Graph::functions is emitted once as a forward and (for
+ * gradient kernels) a backward subroutine. Every Call node owns a frame of
+ * value slots after the graph's nodes; the call site copies the arguments into
+ * the frame's parameter slots, moves the values/gradients pointers (RDI/RSI)
+ * to the frame and calls the subroutine, so the body addresses its nodes by
+ * their own IDs.
+ *
+ * Thread Safety: Static methods are not thread-safe (use from single thread)
+ */
+
+#pragma once
+
+#include "../graph/graph.hpp"
+#include "interfaces/register_allocator.hpp"
+#include "x86/common/compiler_config.hpp"
+#include "forge_engine.hpp"
+#include "interfaces/instruction_set.hpp"
+#include <asmjit/x86.h>
+#include <unordered_map>
+#include <vector>
+
+namespace forge {
+
+class AdjointWrites;
+
+/**
+ * @brief Code generator for Call, CallArg and CallResult nodes
+ *
+ * API Stability: Experimental
+ */
+class FunctionForging {
+public:
+    /** @brief Frames and entry points of the functions a graph calls */
+    struct CallLayout {
+        std::vector<forge::NodeId> frameBase;             ///< First frame slot per Call node, UINT32_MAX otherwise
+        std::vector<forge::Graph> bodies;                 ///< Bodies prepared for forging (outputs cleared, gradient flags set)
+        std::vector<std::vector<forge::NodeId>> params;   ///< Parameter node IDs per function
+        std::vector<std::vector<forge::NodeId>> results;  ///< Result node IDs per function
+        std::vector<uint8_t> used;                        ///< Whether any live Call targets the function
+        std::vector<asmjit::Label> forwardEntry;
+        std::vector<asmjit::Label> backwardEntry;
+        size_t slotCount = 0;                             ///< Frame slots in total
+
+        bool empty() const { return slotCount == 0; }
+        forge::NodeId frameOf(forge::NodeId call) const {
+            return call < frameBase.size() ? frameBase[call] : UINT32_MAX;
+        }
+    };
+
+    /**
+     * @brief Assign a frame to every live Call node, starting at firstSlot
+     *
+     * @param a Assembler the entry labels are created in
+     * @param graph Graph to compile
+     * @param firstSlot First value slot not used by the graph itself
+     * @param withGradient Prepare the bodies for backward subroutines
+     * @return Layout; empty if the graph has no live Call nodes
+     */
+    static CallLayout assignCallFrames(asmjit::x86::Assembler& a, const forge::Graph& graph,
+                                       forge::NodeId firstSlot, bool withGradient);
+
+    /**
+     * @brief Forward code for a Call or CallResult node
+     *
+     * Registers are clobbered by the callee: dirty values are written back
+     * before the call and regState is cleared after it.
+     */
+    static void forgeCallForward(
+        asmjit::x86::Assembler& a,
+        forge::NodeId nodeId,
+        const forge::Graph& graph,
+        const CallLayout& layout,
+        const std::unordered_map<forge::NodeId, ForgeEngine::ConstantInfo>& constantMap,
+        const asmjit::Label& constPoolLabel,
+        IRegisterAllocator& regState,
+        IInstructionSet* instructionSet
+    );
+
+    /**
+     * @brief Adjoint code for a Call or CallResult node
+     *
+     * CallResult adds its adjoint to the result's slot in the callee frame; Call
+     * does the same for its first result, zeroes the result slots no CallResult
+     * wrote, runs the backward subroutine and adds the parameters' adjoints to
+     * the arguments.
+     */
+    static void forgeCallBackward(
+        asmjit::x86::Assembler& a,
+        forge::NodeId nodeId,
+        const forge::Graph& graph,
+        const CallLayout& layout,
+        IRegisterAllocator& regState,
+        IInstructionSet* instructionSet,
+        AdjointWrites& adjointWrites
+    );
+
+    /**
+     * @brief Emit the subroutines of every called function
+     *
+     * Must be emitted outside the kernel's straight-line code (after the
+     * epilogue). Body constants are added to the kernel's constant pool.
+     *
+     * @param makeAllocator Creates a fresh register allocator per subroutine
+     */
+    template <typename MakeAllocator>
+    static void forgeFunctionBodies(
+        asmjit::x86::Assembler& a,
+        const CallLayout& layout,
+        asmjit::ConstPool& constPool,
+        const asmjit::Label& constPoolLabel,
+        IInstructionSet* instructionSet,
+        bool withGradient,
+        const CompilerConfig* config,
+        MakeAllocator makeAllocator
+    ) {
+        for (size_t f = 0; f < layout.bodies.size(); ++f) {
+            if (!layout.used[f]) continue;
+            const forge::Graph& body = layout.bodies[f];
+            std::unordered_map<forge::NodeId, ForgeEngine::ConstantInfo> constantMap;
+            collectConstants(body, constPool, constantMap);
+
+            auto forwardRegs = makeAllocator();
+            emitForwardSubroutine(a, body, layout.forwardEntry[f], constantMap, constPoolLabel, *forwardRegs, instructionSet);
+            if (withGradient) {
+                auto backwardRegs = makeAllocator();
+                emitBackwardSubroutine(a, body, layout.backwardEntry[f], constantMap, constPoolLabel, *backwardRegs, instructionSet, config);
+            }
+        }
+    }
+
+private:
+    static void collectConstants(const forge::Graph& body, asmjit::ConstPool& constPool,
+                                 std::unordered_map<forge::NodeId, ForgeEngine::ConstantInfo>& constantMap);
+    static void emitForwardSubroutine(
+        asmjit::x86::Assembler& a, const forge::Graph& body, const asmjit::Label& entry,
+        const std::unordered_map<forge::NodeId, ForgeEngine::ConstantInfo>& constantMap,
+        const asmjit::Label& constPoolLabel, IRegisterAllocator& regState, IInstructionSet* instructionSet);
+    static void emitBackwardSubroutine(
+        asmjit::x86::Assembler& a, const forge::Graph& body, const asmjit::Label& entry,
+        const std::unordered_map<forge::NodeId, ForgeEngine::ConstantInfo>& constantMap,
+        const asmjit::Label& constPoolLabel, IRegisterAllocator& regState, IInstructionSet* instructionSet,
+        const CompilerConfig* config);
+
+    // Call the subroutine at entry with RDI/RSI moved to the frame at frameBase
+    static void emitFrameCall(asmjit::x86::Assembler& a, const asmjit::Label& entry, forge::NodeId frameBase,
+                              IInstructionSet* instructionSet);
+    // Write dirty register values back so the callee and the caller's reloads see them
+    static void flushRegisters(asmjit::x86::Assembler& a, IRegisterAllocator& regState, IInstructionSet* instructionSet);
+};
+
+} // namespace forge
@@ -22,6 +22,7 @@
 #include "register_allocator.hpp"  // IRegisterAllocator interface
 #include <asmjit/x86.h>
 #include <cstdint>
+#include <vector>
 
 namespace forge {
 
@@ -178,4 +179,78 @@ class DefaultCompilationPolicy : public ICompilationPolicy {
     // All methods use base class defaults
 };
 
+/**
+ * @brief Skip-store policy for forward-only kernels
+ *
+ * Used automatically by ForgeEngine when no node needsGradient (see
+ * CompilerConfig::enableForwardOnlyStores). Only outputs and values that may
+ * be read back from memory are stored; a value consumed straight from its
+ * register by its only user is kept register-only.
+ *
+ * The register allocator drops evicted and call-clobbered values without
+ * writing them back, so a store is only skipped when that cannot happen:
+ * - the node has exactly one user and is not an output (or Input/Constant)
+ * - the user is the next node that emits code (within MAX_SCAN nodes); at
+ *   most MAX_INTERVENING_CONSTANTS constant loads may sit in between, far
+ *   fewer allocations than it takes to make the value least recently used
+ *
+ * Everything else is stored as usual, so spills under register pressure and
+ * values live across library calls stay correct. Skipped intermediates are
+ * not observable through the node value buffer afterwards.
+ */
+class ForwardOnlyPolicy : public ICompilationPolicy {
+public:
+    static constexpr int MAX_INTERVENING_CONSTANTS = 2;
+    static constexpr NodeId MAX_SCAN = 64;
+
+    void onCompileBegin(const Graph& graph, asmjit::x86::Assembler& a) override {
+        (void)a;
+        const size_t n = graph.nodes.size();
+        std::vector<uint32_t> userCount(n, 0);
+        std::vector<NodeId> lastUser(n, UINT32_MAX);
+        for (NodeId id = 0; id < n; ++id) {
+            const Node& node = graph.nodes[id];
+            if (node.isDead) continue;
+            const NodeId operands[3] = {node.a, node.b, node.c};
+            for (int k = 0; k < operandCount(node.op); ++k) {
+                NodeId operand = operands[k];
+                if (operand < n && lastUser[operand] != id) {
+                    lastUser[operand] = id;
+                    userCount[operand]++;
+                }
+            }
+        }
+
+        skipStore_.assign(n, 0);
+        for (NodeId id = 0; id < n; ++id) {
+            const Node& node = graph.nodes[id];
+            if (node.isDead || node.op == OpCode::Input || node.op == OpCode::Constant ||
+                userCount[id] != 1) {
+                continue;
+            }
+            int constants = 0;
+            bool adjacent = true;
+            if (lastUser[id] - id > MAX_SCAN) continue;  // Keeps the analysis O(nodes)
+            if (graph.nodes[lastUser[id]].op == OpCode::CallArg) continue;  // Copied from memory into the call frame
+            for (NodeId between = id + 1; between < lastUser[id] && adjacent; ++between) {
+                const Node& gap = graph.nodes[between];
+                if (gap.isDead || gap.op == OpCode::Input) continue;
+                adjacent = gap.op == OpCode::Constant && ++constants <= MAX_INTERVENING_CONSTANTS;
+            }
+            skipStore_[id] = adjacent ? 1 : 0;
+        }
+        for (NodeId id : graph.outputs) {
+            if (id < n) skipStore_[id] = 0;
+        }
+    }
+
+    bool requiresStore(NodeId nodeId, const Graph& graph) override {
+        (void)graph;
+        return nodeId >= skipStore_.size() || !skipStore_[nodeId];
+    }
+
+private:
+    std::vector<uint8_t> skipStore_;
+};
+
 } // namespace forge
@@ -0,0 +1,142 @@
+// This file is part of Forge <https://github.com/da-roth/forge>
+//
+// See LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+/**
+ * @file huge_pages.hpp
+ * @brief Huge-page backed memory for node value buffers and JIT code
+ *
+ * Kernels touch node slots all over multi-GB value and gradient buffers, so
+ * with 4 KB pages nearly every access needs its own TLB entry. With a
+ * HugePagePolicy other than Off, buffers of at least kHugePageSize are backed
+ * by 2 MB pages:
+ *
+ * - Transparent: 2 MB aligned allocation plus madvise(MADV_HUGEPAGE), honoured
+ *   when transparent huge pages are "always" or "madvise"
+ * - Explicit: mmap(MAP_HUGETLB) from the pre-reserved pool
+ *   (vm.nr_hugepages), falling back to Transparent when the pool is empty
+ *
+ * Neither fails when huge pages are unavailable: the memory is then simply
+ * backed by regular pages. Windows always uses regular pages (large pages
+ * need SeLockMemoryPrivilege).
+ *
+ * The policy is process-wide. It starts from the FORGE_HUGE_PAGES environment
+ * variable ("off", "thp", "hugetlb") and can be changed with
+ * NodeValueMemory::setPolicy() before buffers are created. The JIT runtime
+ * reads FORGE_HUGE_PAGES once at startup; with any policy but off it asks
+ * AsmJit for large-page code memory (again with fallback to regular pages).
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace forge {
+
+enum class HugePagePolicy {
+    Off,          ///< Regular pages (default)
+    Transparent,  ///< madvise(MADV_HUGEPAGE) on 2 MB aligned memory
+    Explicit      ///< MAP_HUGETLB, Transparent when no huge pages are reserved
+};
+
+/** @brief Policy named by FORGE_HUGE_PAGES ("thp", "hugetlb"; anything else: Off) */
+inline HugePagePolicy hugePagePolicyFromEnvironment() {
+    const char* env = std::getenv("FORGE_HUGE_PAGES");
+    if (!env) return HugePagePolicy::Off;
+    if (std::strcmp(env, "thp") == 0 || std::strcmp(env, "transparent") == 0) return HugePagePolicy::Transparent;
+    if (std::strcmp(env, "hugetlb") == 0 || std::strcmp(env, "explicit") == 0) return HugePagePolicy::Explicit;
+    return HugePagePolicy::Off;
+}
+
+/**
+ * Allocation of node value and gradient arrays (used by NodeValueBufferBase).
+ * Header-only so that runtime-loaded backends allocate the same way.
+ */
+class NodeValueMemory {
+public:
+    static constexpr size_t kHugePageSize = size_t(2) << 20;
+
+    /** How the block returned by allocate() must be freed */
+    enum class Kind { Aligned, HugeTlb };
+
+    static HugePagePolicy policy() { return static_cast<HugePagePolicy>(policyStorage().load(std::memory_order_relaxed)); }
+    static void setPolicy(HugePagePolicy policy) { policyStorage().store(static_cast<int>(policy), std::memory_order_relaxed); }
+
+    /**
+     * Allocate bytes with the given alignment under the current policy.
+     * Blocks smaller than kHugePageSize always use regular pages.
+     * @throws std::bad_alloc
+     */
+    static double* allocate(size_t bytes, size_t alignment, Kind& kind) {
+        kind = Kind::Aligned;
+        const HugePagePolicy current = policy();
+#ifndef _WIN32
+        if (current != HugePagePolicy::Off && bytes >= kHugePageSize) {
+            const size_t rounded = roundUp(bytes, kHugePageSize);
+            if (current == HugePagePolicy::Explicit) {
+                void* p = mmap(nullptr, rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+                if (p != MAP_FAILED) {
+                    kind = Kind::HugeTlb;
+                    return static_cast<double*>(p);
+                }
+            }
+            // THP only backs 2 MB aligned ranges
+            void* p = aligned_alloc(kHugePageSize, rounded);
+            if (!p) throw std::bad_alloc();
+#ifdef MADV_HUGEPAGE
+            madvise(p, rounded, MADV_HUGEPAGE);  // Advisory: regular pages if THP is off
+#endif
+            return static_cast<double*>(p);
+        }
+#else
+        (void)current;
+#endif
+
+        // Must be a multiple of alignment for aligned_alloc on Linux
+        const size_t alignedBytes = roundUp(bytes, alignment);
+#ifdef _WIN32
+        void* p = _aligned_malloc(alignedBytes, alignment);
+#else
+        void* p = aligned_alloc(alignment, alignedBytes);
+#endif
+        if (!p) throw std::bad_alloc();
+        return static_cast<double*>(p);
+    }
+
+    /** Free a block from allocate() (bytes as passed to allocate) */
+    static void release(double* p, size_t bytes, Kind kind) {
+        if (!p) return;
+#ifndef _WIN32
+        if (kind == Kind::HugeTlb) {
+            munmap(p, roundUp(bytes, kHugePageSize));
+            return;
+        }
+        free(p);
+#else
+        (void)bytes;
+        (void)kind;
+        _aligned_free(p);
+#endif
+    }
+
+private:
+    static size_t roundUp(size_t bytes, size_t multiple) { return (bytes + multiple - 1) / multiple * multiple; }
+
+    static std::atomic<int>& policyStorage() {
+        static std::atomic<int> storage{static_cast<int>(hugePagePolicyFromEnvironment())};
+        return storage;
+    }
+};
+
+} // namespace forge
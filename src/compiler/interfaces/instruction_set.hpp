@@ -31,7 +31,7 @@ namespace forge {
  * Increment this when making breaking changes to the interface.
  * Custom implementations built against a different version may be incompatible.
  */
-constexpr uint32_t INSTRUCTION_SET_API_VERSION = 1;
+constexpr uint32_t INSTRUCTION_SET_API_VERSION = 3;
 
 // Forward declarations
 class ForgeEngine;
@@ -83,6 +83,20 @@ public:
     /** @brief Get SIMD vector width (number of doubles per operation: 1 for scalar, 4 for AVX2, 8 for AVX-512) */
     virtual int getVectorWidth() const = 0;
 
+    /**
+     * @brief Give each node `blocks` vectors of getVectorWidth() doubles (CompilerConfig::laneBlocks)
+     *
+     * Node loads and stores then use a stride of blocks * getVectorWidth()
+     * doubles and address the node's first vector; ForgeEngine moves the base
+     * pointers by one vector to reach the others.
+     *
+     * @return false if the instruction set only supports one vector per node
+     */
+    virtual bool setLaneBlocks(int blocks) { return blocks == 1; }
+
+    /** @brief Vectors per node set by setLaneBlocks() */
+    virtual int getLaneBlocks() const { return 1; }
+
     /**
      * @brief Check if this instruction set supports a given operation
      * @param op Operation code to check
@@ -135,6 +149,16 @@ public:
     virtual void emitSin(asmjit::x86::Assembler& a, int dstReg, int srcReg, IRegisterAllocator& regState) = 0;
     virtual void emitCos(asmjit::x86::Assembler& a, int dstReg, int srcReg, IRegisterAllocator& regState) = 0;
     virtual void emitTan(asmjit::x86::Assembler& a, int dstReg, int srcReg, IRegisterAllocator& regState) = 0;
+
+    /**
+     * @brief Fused sine/cosine sharing one argument reduction
+     *
+     * dstReg receives sin(src) (cos(src) if cosToDst); the other result goes
+     * straight to the value slot otherSlot and is not tracked by regState.
+     * Used to keep the derivative factor of Sin/Cos nodes for the adjoint pass.
+     */
+    virtual void emitSinCos(asmjit::x86::Assembler& a, int dstReg, int srcReg, forge::NodeId otherSlot,
+                            bool cosToDst, IRegisterAllocator& regState) = 0;
     ///@}
 
     /** @brief Modulo operation (fmod) */
@@ -7,18 +7,37 @@
 #include <unordered_set>
 #include <stdexcept>
 #include "../../graph/graph.hpp"
-
-#ifdef _WIN32
-#include <malloc.h>  // For _aligned_malloc and _aligned_free on Windows
-#else
-#include <cstdlib>   // For aligned_alloc and free on Linux
-#endif
+#include "huge_pages.hpp"
 
 namespace forge {
 
 // Forward declaration
 class ForgedKernel;
 
+/**
+ * Buffer slots a kernel reads before it writes them, as [begin, end) node slot ranges.
+ * Every other slot is overwritten by each execution before it is read, so
+ * INodeValueBuffer::reset() only has to zero these.
+ */
+struct KernelLiveIns {
+    struct Range {
+        size_t begin;
+        size_t end;
+    };
+    std::vector<Range> values;     ///< Input slots
+    std::vector<Range> gradients;  ///< Adjoints read before written (none for kernels forged here)
+
+    /** Append [begin, end), merging it into the last range when they touch */
+    static void add(std::vector<Range>& ranges, size_t begin, size_t end) {
+        if (begin >= end) return;
+        if (!ranges.empty() && ranges.back().end >= begin) {
+            if (end > ranges.back().end) ranges.back().end = end;
+            return;
+        }
+        ranges.push_back({begin, end});
+    }
+};
+
 /**
  * Interface for node value storage that kernels read from and write to.
  * Different implementations handle different memory layouts (scalar vs SIMD).
@@ -111,9 +130,24 @@ public:
      */
     virtual size_t getBufferIndex(uint64_t nodeId) const = 0;
 
-    /** Clear all gradients to zero */
+    /**
+     * Clear all gradients to zero. Not needed before execute(): the backward
+     * pass writes every adjoint it reads.
+     */
     virtual void clearGradients() = 0;
 
+    /**
+     * Prepare the buffer for a new evaluation without reallocating: zero only the
+     * slots the kernel reads before writing (the inputs, see setLiveIns), or all
+     * values and gradients if they are unknown. Other values keep the previous
+     * evaluation's results until the kernel overwrites them, and executeBody()
+     * needs a full execute() first.
+     */
+    virtual void reset() = 0;
+
+    /** Slots reset() zeroes (set by NodeValueBufferFactory::create from the kernel; nullptr = all) */
+    virtual void setLiveIns(std::shared_ptr<const KernelLiveIns> liveIns) = 0;
+
     /** Check if gradients have been computed */
     virtual bool hasGradients() const = 0;
 
@@ -160,55 +194,26 @@ public:
             totalDoubles = VectorWidth;
         }
 
-        // Calculate allocation size - must be multiple of alignment for aligned_alloc on Linux
-        size_t allocSize = totalDoubles * sizeof(double);
-        size_t alignedAllocSize = (allocSize + (Alignment - 1)) & ~(Alignment - 1);
-
-        // Platform-specific aligned allocation
-#ifdef _WIN32
-        values_ = static_cast<double*>(_aligned_malloc(allocSize, Alignment));
-#else
-        values_ = static_cast<double*>(aligned_alloc(Alignment, alignedAllocSize));
-#endif
-        if (!values_) {
-            throw std::bad_alloc();
-        }
-        std::memset(values_, 0, allocSize);
+        // Huge pages for large buffers depending on NodeValueMemory::policy()
+        allocBytes_ = totalDoubles * sizeof(double);
+        values_ = NodeValueMemory::allocate(allocBytes_, Alignment, valuesKind_);
+        std::memset(values_, 0, allocBytes_);
 
         // Allocate gradients if needed
         if (!tape.diff_inputs.empty()) {
-#ifdef _WIN32
-            gradients_ = static_cast<double*>(_aligned_malloc(allocSize, Alignment));
-#else
-            gradients_ = static_cast<double*>(aligned_alloc(Alignment, alignedAllocSize));
-#endif
-            if (!gradients_) {
-#ifdef _WIN32
-                _aligned_free(values_);
-#else
-                free(values_);
-#endif
-                throw std::bad_alloc();
+            try {
+                gradients_ = NodeValueMemory::allocate(allocBytes_, Alignment, gradientsKind_);
+            } catch (...) {
+                NodeValueMemory::release(values_, allocBytes_, valuesKind_);
+                throw;
             }
-            std::memset(gradients_, 0, allocSize);
+            std::memset(gradients_, 0, allocBytes_);
         }
     }
 
     ~NodeValueBufferBase() override {
-        if (values_) {
-#ifdef _WIN32
-            _aligned_free(values_);
-#else
-            free(values_);
-#endif
-        }
-        if (gradients_) {
-#ifdef _WIN32
-            _aligned_free(gradients_);
-#else
-            free(gradients_);
-#endif
-        }
+        NodeValueMemory::release(values_, allocBytes_, valuesKind_);
+        NodeValueMemory::release(gradients_, allocBytes_, gradientsKind_);
     }
 
     // ==========================================================================
@@ -342,6 +347,20 @@ public:
         }
     }
 
+    void reset() override {
+        if (!liveIns_) {
+            std::memset(values_, 0, num_nodes_ * VectorWidth * sizeof(double));
+            clearGradients();
+            return;
+        }
+        zeroRanges(values_, liveIns_->values);
+        if (gradients_) zeroRanges(gradients_, liveIns_->gradients);
+    }
+
+    void setLiveIns(std::shared_ptr<const KernelLiveIns> liveIns) override {
+        liveIns_ = std::move(liveIns);
+    }
+
     bool hasGradients() const override {
         return gradients_ != nullptr;
     }
@@ -363,7 +382,9 @@ public:
         : values_(other.values_), gradients_(other.gradients_),
           num_nodes_(other.num_nodes_), diff_inputs_(std::move(other.diff_inputs_)),
           diff_inputs_set_(std::move(other.diff_inputs_set_)),
-          originalToOptimizedMapping_(std::move(other.originalToOptimizedMapping_)) {
+          originalToOptimizedMapping_(std::move(other.originalToOptimizedMapping_)),
+          liveIns_(std::move(other.liveIns_)),
+          allocBytes_(other.allocBytes_), valuesKind_(other.valuesKind_), gradientsKind_(other.gradientsKind_) {
         other.values_ = nullptr;
         other.gradients_ = nullptr;
         other.num_nodes_ = 0;
@@ -376,6 +397,20 @@ protected:
     std::vector<forge::NodeId> diff_inputs_;
     std::unordered_set<forge::NodeId> diff_inputs_set_;
     std::vector<forge::NodeId> originalToOptimizedMapping_;
+    std::shared_ptr<const KernelLiveIns> liveIns_;
+    size_t allocBytes_ = 0;  // Size of each of values_ and gradients_ as allocated
+    NodeValueMemory::Kind valuesKind_ = NodeValueMemory::Kind::Aligned;
+    NodeValueMemory::Kind gradientsKind_ = NodeValueMemory::Kind::Aligned;
+
+private:
+    void zeroRanges(double* data, const std::vector<KernelLiveIns::Range>& ranges) {
+        for (const auto& range : ranges) {
+            const size_t end = range.end < num_nodes_ ? range.end : num_nodes_;
+            if (range.begin < end) {
+                std::memset(&data[range.begin * VectorWidth], 0, (end - range.begin) * VectorWidth * sizeof(double));
+            }
+        }
+    }
 };
 
 /**
@@ -0,0 +1,129 @@
+// This file is part of Forge <https://github.com/da-roth/forge>
+//
+// See LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+/**
+ * @file io_binding.cpp
+ * @brief Bound kernel entry: copy-in, call, copy-out
+ */
+
+#include "io_binding.hpp"
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+
+namespace forge {
+
+KernelIoLayout KernelIoLayout::fromGraph(const Graph& graph, const std::vector<NodeId>& originalToOptimizedMapping) {
+    auto slotOf = [&](NodeId node) {
+        return node < originalToOptimizedMapping.size() ? originalToOptimizedMapping[node] : kNoSlot;
+    };
+
+    KernelIoLayout layout;
+    for (NodeId id = 0; id < graph.nodes.size(); ++id) {
+        if (graph.nodes[id].op == OpCode::Input) layout.inputSlots.push_back(slotOf(id));
+    }
+    for (NodeId output : graph.outputs) layout.outputSlots.push_back(slotOf(output));
+    for (NodeId input : graph.diff_inputs) layout.gradientSlots.push_back(slotOf(input));
+    return layout;
+}
+
+namespace {
+
+int32_t displacement(size_t bytes) {
+    if (bytes > static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+        throw std::runtime_error("I/O binding: array offset exceeds 2 GB");
+    }
+    return static_cast<int32_t>(bytes);
+}
+
+// Copy W lanes per element between an array (element i) and a buffer (slot), two lanes per move.
+// XMM0/XMM1 are volatile in both ABIs; the kernel's epilogue leaves the upper YMM state clean.
+void copyLanes(asmjit::x86::Assembler& a, const asmjit::x86::Gp& array, const asmjit::x86::Gp& buffer,
+               const std::vector<NodeId>& slots, int vectorWidth, bool toBuffer) {
+    using namespace asmjit::x86;
+    const size_t elementBytes = static_cast<size_t>(vectorWidth) * sizeof(double);
+    for (size_t i = 0; i < slots.size(); ++i) {
+        if (slots[i] == KernelIoLayout::kNoSlot) continue;
+        const size_t arrayOffset = i * elementBytes;
+        const size_t bufferOffset = static_cast<size_t>(slots[i]) * elementBytes;
+        for (int lane = 0; lane < vectorWidth; lane += 2) {
+            const size_t laneBytes = static_cast<size_t>(lane) * sizeof(double);
+            const Mem arrayMem = ptr(array, displacement(arrayOffset + laneBytes));
+            const Mem bufferMem = ptr(buffer, displacement(bufferOffset + laneBytes));
+            const Mem& from = toBuffer ? arrayMem : bufferMem;
+            const Mem& to = toBuffer ? bufferMem : arrayMem;
+            if (lane + 1 < vectorWidth) {
+                a.movupd(xmm0, from);
+                a.movupd(to, xmm0);
+            } else {
+                a.movsd(xmm0, from);
+                a.movsd(to, xmm0);
+            }
+        }
+    }
+}
+
+} // namespace
+
+void emitBoundEntry(asmjit::x86::Assembler& a, const asmjit::Label& kernelEntry, const KernelIoLayout& layout,
+                    int vectorWidth) {
+    using namespace asmjit::x86;
+#ifdef _WIN32
+    const Gp argValues = rcx, argGradients = rdx, argIo = r8;
+#else
+    const Gp argValues = rdi, argGradients = rsi, argIo = rdx;
+#endif
+    // RBX/R12/R13 are callee-saved in both ABIs and survive the kernel call.
+    // Three pushes after the return address leave RSP 16-byte aligned for it.
+    a.push(rbx);
+    a.push(r12);
+    a.push(r13);
+    a.mov(rbx, argValues);
+    a.mov(r12, argGradients);
+    a.mov(r13, argIo);
+
+    asmjit::Label inputsDone = a.newLabel();
+    a.mov(rax, qword_ptr(r13, static_cast<int32_t>(offsetof(KernelIoBinding, inputs))));
+    a.test(rax, rax);
+    a.jz(inputsDone);
+    copyLanes(a, rax, rbx, layout.inputSlots, vectorWidth, true);
+    a.bind(inputsDone);
+
+    a.mov(argValues, rbx);
+    a.mov(argGradients, r12);
+    a.xor_(argIo.r32(), argIo.r32());
+#ifdef _WIN32
+    a.sub(rsp, 32);  // Shadow space
+    a.call(kernelEntry);
+    a.add(rsp, 32);
+#else
+    a.call(kernelEntry);
+#endif
+
+    asmjit::Label outputsDone = a.newLabel();
+    a.mov(rax, qword_ptr(r13, static_cast<int32_t>(offsetof(KernelIoBinding, outputs))));
+    a.test(rax, rax);
+    a.jz(outputsDone);
+    copyLanes(a, rax, rbx, layout.outputSlots, vectorWidth, false);
+    a.bind(outputsDone);
+
+    if (!layout.gradientSlots.empty()) {
+        asmjit::Label gradientsDone = a.newLabel();
+        a.test(r12, r12);
+        a.jz(gradientsDone);
+        a.mov(rax, qword_ptr(r13, static_cast<int32_t>(offsetof(KernelIoBinding, inputGradients))));
+        a.test(rax, rax);
+        a.jz(gradientsDone);
+        copyLanes(a, rax, r12, layout.gradientSlots, vectorWidth, false);
+        a.bind(gradientsDone);
+    }
+
+    a.pop(r13);
+    a.pop(r12);
+    a.pop(rbx);
+    a.ret();
+}
+
+} // namespace forge
@@ -0,0 +1,72 @@
+// This file is part of Forge <https://github.com/da-roth/forge>
+//
+// See LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+/**
+ * @file io_binding.hpp
+ * @brief Kernel entry that reads inputs from and writes results to user-owned arrays
+ *
+ * With CompilerConfig::enableIoBinding, ForgeEngine also emits a bound entry
+ * taking a KernelIoBinding descriptor instead of the unused count argument.
+ * It copies the bound inputs into their value slots, runs the kernel and
+ * copies outputs and input gradients out again, all in generated code: no
+ * setValue()/getValue() calls, virtual dispatch or originalToOptimizedMapping
+ * lookups per value.
+ *
+ * @code
+ * config.enableIoBinding = true;
+ * auto kernel = ForgeEngine(config).compile(graph);
+ * std::vector<double> in(kernel->getIoLayout()->inputSlots.size() * width);
+ * std::vector<double> out(graph.outputs.size() * width);
+ * KernelIoBinding io{in.data(), out.data(), nullptr};
+ * kernel->executeBound(*buffer, io);
+ * @endcode
+ *
+ * Arrays are lane-interleaved like the buffer: element i of a kernel of
+ * vector width W occupies [i * W, i * W + W). Inputs are in recording order
+ * (the order of the graph's Input nodes), outputs in Graph::outputs order and
+ * gradients in Graph::diff_inputs order. Inputs the optimizer removed keep
+ * their array position and are ignored.
+ */
+
+#pragma once
+
+#include "../graph/graph.hpp"
+#include <asmjit/x86.h>
+#include <cstdint>
+#include <vector>
+
+namespace forge {
+
+/** @brief Descriptor passed to a bound kernel (see io_binding.hpp) */
+struct KernelIoBinding {
+    const double* inputs = nullptr;    ///< One element per recorded input
+    double* outputs = nullptr;         ///< One element per graph output (nullptr: not copied)
+    double* inputGradients = nullptr;  ///< One element per diff input (nullptr: not copied)
+};
+
+/** @brief Buffer slot behind each element of the binding arrays */
+struct KernelIoLayout {
+    static constexpr NodeId kNoSlot = UINT32_MAX;
+
+    std::vector<NodeId> inputSlots;     ///< Per recorded input; kNoSlot if optimized away
+    std::vector<NodeId> outputSlots;    ///< Per graph output
+    std::vector<NodeId> gradientSlots;  ///< Per diff input; kNoSlot if optimized away
+
+    /** @brief Map a recorded graph's inputs and outputs through the kernel's node mapping */
+    static KernelIoLayout fromGraph(const Graph& graph, const std::vector<NodeId>& originalToOptimizedMapping);
+};
+
+/**
+ * @brief Emit void bound(double* values, double* gradients, const KernelIoBinding* io)
+ *
+ * The stub calls kernelEntry (the regular entry) between the copies, so it
+ * needs no knowledge of the kernel's register or stack layout.
+ *
+ * @throws std::runtime_error if an array offset does not fit a 32-bit displacement
+ */
+void emitBoundEntry(asmjit::x86::Assembler& a, const asmjit::Label& kernelEntry, const KernelIoLayout& layout,
+                    int vectorWidth);
+
+} // namespace forge
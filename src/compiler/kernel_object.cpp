@@ -0,0 +1,496 @@
+// This file is part of Forge <https://github.com/da-roth/forge>
+//
+// See LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+/**
+ * @file kernel_object.cpp
+ * @brief ELF object writer and shared library loader for forged kernels
+ */
+
+#include "kernel_object.hpp"
+#include "x86/double/scalar/sse2_scalar_instruction_set.hpp"
+#include <cctype>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+#ifndef _WIN32
+#include <dlfcn.h>
+#endif
+
+#ifdef FORGE_BUNDLE_AVX2
+// SLEEF wrappers called by AVX2 kernels (backends/double/avx2/avx2_instruction_set.cpp)
+extern "C" double call_std_exp(double x);
+extern "C" double call_std_log(double x);
+extern "C" void call_vexp4d(const double* input, double* out);
+extern "C" void call_vlog4d(const double* input, double* out);
+extern "C" void call_vsin4d(const double* input, double* out);
+extern "C" void call_vcos4d(const double* input, double* out);
+extern "C" void call_vsincos4d(const double* input, double* sinOut, double* cosOut);
+extern "C" void call_vtan4d(const double* input, double* out);
+extern "C" void call_vpow4d(const double* base, const double* exp, double* out);
+#endif
+
+namespace forge {
+
+namespace {
+
+// -----------------------------------------------------------------------------
+// External symbol registry
+// -----------------------------------------------------------------------------
+
+struct SymbolRegistry {
+    std::mutex mutex;
+    std::vector<std::pair<std::string, const void*>> symbols;
+
+    SymbolRegistry() {
+        // SSE2 scalar instruction set
+        add("exp", reinterpret_cast<const void*>(static_cast<double(*)(double)>(std::exp)));
+        add("log", reinterpret_cast<const void*>(static_cast<double(*)(double)>(std::log)));
+        add("sin", reinterpret_cast<const void*>(static_cast<double(*)(double)>(std::sin)));
+        add("cos", reinterpret_cast<const void*>(static_cast<double(*)(double)>(std::cos)));
+        add("tan", reinterpret_cast<const void*>(static_cast<double(*)(double)>(std::tan)));
+        add("pow", reinterpret_cast<const void*>(static_cast<double(*)(double, double)>(std::pow)));
+        add("forge_scalar_sin_store_cos", reinterpret_cast<const void*>(&scalarSinStoreCos));
+        add("forge_scalar_cos_store_sin", reinterpret_cast<const void*>(&scalarCosStoreSin));
+#ifdef FORGE_BUNDLE_AVX2
+        // AVX2 packed instruction set (SLEEF wrappers)
+        add("call_std_exp", reinterpret_cast<const void*>(&call_std_exp));
+        add("call_std_log", reinterpret_cast<const void*>(&call_std_log));
+        add("call_vexp4d", reinterpret_cast<const void*>(&call_vexp4d));
+        add("call_vlog4d", reinterpret_cast<const void*>(&call_vlog4d));
+        add("call_vsin4d", reinterpret_cast<const void*>(&call_vsin4d));
+        add("call_vcos4d", reinterpret_cast<const void*>(&call_vcos4d));
+        add("call_vtan4d", reinterpret_cast<const void*>(&call_vtan4d));
+        add("call_vsincos4d", reinterpret_cast<const void*>(&call_vsincos4d));
+        add("call_vpow4d", reinterpret_cast<const void*>(&call_vpow4d));
+#endif
+    }
+
+    void add(const std::string& name, const void* address) {
+        for (auto& entry : symbols) {
+            if (entry.first == name) {
+                entry.second = address;
+                return;
+            }
+        }
+        symbols.emplace_back(name, address);
+    }
+
+    static SymbolRegistry& instance() {
+        static SymbolRegistry registry;
+        return registry;
+    }
+};
+
+const std::string* nameOfExternalSymbol(uint64_t address) {
+    SymbolRegistry& registry = SymbolRegistry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const auto& entry : registry.symbols) {
+        if (reinterpret_cast<uint64_t>(entry.second) == address) return &entry.first;
+    }
+    return nullptr;
+}
+
+// -----------------------------------------------------------------------------
+// ELF64 x86-64 relocatable object
+// -----------------------------------------------------------------------------
+
+namespace elf {
+constexpr uint16_t ET_REL = 1;
+constexpr uint16_t EM_X86_64 = 62;
+constexpr uint32_t SHT_PROGBITS = 1;
+constexpr uint32_t SHT_SYMTAB = 2;
+constexpr uint32_t SHT_STRTAB = 3;
+constexpr uint32_t SHT_RELA = 4;
+constexpr uint64_t SHF_WRITE = 0x1;
+constexpr uint64_t SHF_ALLOC = 0x2;
+constexpr uint64_t SHF_EXECINSTR = 0x4;
+constexpr uint64_t SHF_INFO_LINK = 0x40;
+constexpr uint8_t STB_LOCAL = 0;
+constexpr uint8_t STB_GLOBAL = 1;
+constexpr uint8_t STT_OBJECT = 1;
+constexpr uint8_t STT_FUNC = 2;
+constexpr uint8_t STT_SECTION = 3;
+constexpr uint32_t R_X86_64_PC32 = 2;
+constexpr size_t kHeaderSize = 64;
+constexpr size_t kSectionHeaderSize = 64;
+constexpr size_t kSymbolSize = 24;
+constexpr size_t kRelaSize = 24;
+
+// Section indices in the objects we write
+enum : uint16_t { kText = 1, kData, kRodata, kRelaText, kSymtab, kStrtab, kNoteStack, kShstrtab, kSectionCount };
+// Symbol indices: null, three section symbols, then the globals
+enum : uint32_t { kSymText = 1, kSymData, kSymRodata, kFirstGlobal };
+} // namespace elf
+
+class ByteWriter {
+public:
+    std::vector<uint8_t> bytes;
+
+    template <typename T>
+    void put(T value) {
+        const size_t at = bytes.size();
+        bytes.resize(at + sizeof(T));
+        std::memcpy(bytes.data() + at, &value, sizeof(T));
+    }
+    void put(const void* data, size_t size) {
+        if (size == 0) return;
+        const size_t at = bytes.size();
+        bytes.resize(at + size);
+        std::memcpy(bytes.data() + at, data, size);
+    }
+    void align(size_t alignment) {
+        bytes.resize((bytes.size() + alignment - 1) / alignment * alignment, 0);
+    }
+};
+
+class StringTable {
+public:
+    StringTable() : data_(1, '\0') {}
+    uint32_t add(const std::string& s) {
+        const uint32_t at = static_cast<uint32_t>(data_.size());
+        data_.insert(data_.end(), s.begin(), s.end());
+        data_.push_back('\0');
+        return at;
+    }
+    const std::vector<char>& data() const { return data_; }
+
+private:
+    std::vector<char> data_;
+};
+
+bool isIdentifier(const std::string& s) {
+    if (s.empty() || std::isdigit(static_cast<unsigned char>(s[0]))) return false;
+    for (char c : s) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_') return false;
+    }
+    return true;
+}
+
+std::vector<uint8_t> buildMetadata(const ForgedKernel& kernel, uint64_t codeSize, uint64_t bodyOffset,
+                                   const std::vector<std::string>& imports) {
+    const auto& mapping = kernel.getOriginalToOptimizedMapping();
+    const auto& outputs = kernel.getOutputNodes();
+    const std::string name = kernel.getInstructionSetName();
+
+    kernel_object::Metadata header{};
+    std::memcpy(header.magic, kernel_object::kMagic, sizeof(header.magic));
+    header.version = kernel_object::kVersion;
+    header.vectorWidth = static_cast<uint32_t>(kernel.getVectorWidth());
+    header.codeSize = codeSize;
+    header.bodyOffset = bodyOffset;
+    header.numNodes = kernel.getNumNodes();
+    header.maxNodeId = kernel.getMaxNodeId();
+    header.workingNodes = kernel.getWorkingNodes();
+    header.mappingCount = static_cast<uint32_t>(mapping.size());
+    header.outputCount = static_cast<uint32_t>(outputs.size());
+    header.importCount = static_cast<uint32_t>(imports.size());
+    header.nameLength = static_cast<uint32_t>(name.size());
+
+    ByteWriter out;
+    out.put(&header, sizeof(header));
+    out.put(mapping.data(), mapping.size() * sizeof(NodeId));
+    out.put(outputs.data(), outputs.size() * sizeof(NodeId));
+    out.put(name.data(), name.size());
+    for (const std::string& import : imports) out.put(import.c_str(), import.size() + 1);
+    out.align(8);
+
+    const uint64_t size = out.bytes.size();
+    std::memcpy(out.bytes.data() + offsetof(kernel_object::Metadata, metadataSize), &size, sizeof(size));
+    return out.bytes;
+}
+
+struct SectionHeader {
+    uint32_t name = 0;
+    uint32_t type = 0;
+    uint64_t flags = 0;
+    uint64_t offset = 0;
+    uint64_t size = 0;
+    uint32_t link = 0;
+    uint32_t info = 0;
+    uint64_t addralign = 1;
+    uint64_t entsize = 0;
+};
+
+// -----------------------------------------------------------------------------
+// Loading
+// -----------------------------------------------------------------------------
+
+bool cpuSupports(const std::string& instructionSetName) {
+#if defined(__GNUC__) || defined(__clang__)
+    if (instructionSetName.find("AVX2") != std::string::npos) {
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    }
+#endif
+    (void)instructionSetName;
+    return true;
+}
+
+template <typename T>
+std::vector<T> readArray(const uint8_t*& cursor, size_t count) {
+    std::vector<T> values(count);
+    if (count > 0) std::memcpy(values.data(), cursor, count * sizeof(T));
+    cursor += count * sizeof(T);
+    return values;
+}
+
+} // namespace
+
+void registerExternalSymbol(const std::string& name, const void* address) {
+    SymbolRegistry& registry = SymbolRegistry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.add(name, address);
+}
+
+const void* findExternalSymbol(const std::string& name) {
+    SymbolRegistry& registry = SymbolRegistry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const auto& entry : registry.symbols) {
+        if (entry.first == name) return entry.second;
+    }
+    return nullptr;
+}
+
+std::vector<uint8_t> serializeKernelObject(const ForgedKernel& kernel, const std::string& symbol) {
+#ifdef _WIN32
+    (void)kernel;
+    (void)symbol;
+    throw std::runtime_error("Kernel export is not supported on Windows");
+#else
+    const ForgedKernel::ExportInfo* info = kernel.getExportInfo();
+    if (!info || !kernel.getFunction()) {
+        throw std::runtime_error("Kernel was not compiled with CompilerConfig::enableKernelExport");
+    }
+    if (!isIdentifier(symbol)) {
+        throw std::runtime_error("Invalid kernel symbol name: " + symbol);
+    }
+
+    const uint8_t* base = reinterpret_cast<const uint8_t*>(kernel.getFunction());
+    std::vector<uint8_t> code(base, base + info->codeSize);
+    const uint64_t bodyOffset = kernel.getBodyFunction()
+        ? static_cast<uint64_t>(reinterpret_cast<const uint8_t*>(kernel.getBodyFunction()) - base) : 0;
+
+    // Each external call is "mov rax, imm64; call rax". Rewrite the mov in place
+    // to "mov rax, [rip + slot]; nop" so it reads the address from the import table.
+    std::vector<std::string> imports;
+    std::unordered_map<uint64_t, uint32_t> slotOf;
+    std::vector<std::pair<uint64_t, uint32_t>> relocations;  // disp32 offset, slot
+    for (size_t site : info->externalCallSites) {
+        if (site < 2 || site + sizeof(uint64_t) > code.size() || code[site - 2] != 0x48 || code[site - 1] != 0xB8) {
+            throw std::runtime_error("Unexpected external call encoding at code offset " + std::to_string(site));
+        }
+        uint64_t address = 0;
+        std::memcpy(&address, &code[site], sizeof(address));
+        auto it = slotOf.find(address);
+        if (it == slotOf.end()) {
+            const std::string* name = nameOfExternalSymbol(address);
+            if (!name) {
+                throw std::runtime_error("Kernel calls a function missing from the external symbol registry "
+                                         "(see registerExternalSymbol)");
+            }
+            it = slotOf.emplace(address, static_cast<uint32_t>(imports.size())).first;
+            imports.push_back(*name);
+        }
+        const uint8_t load[10] = {0x48, 0x8B, 0x05, 0, 0, 0, 0, 0x0F, 0x1F, 0x00};
+        std::memcpy(&code[site - 2], load, sizeof(load));
+        relocations.emplace_back(site + 1, it->second);
+    }
+
+    const std::vector<uint8_t> metadata = buildMetadata(kernel, info->codeSize, bodyOffset, imports);
+
+    StringTable shstrtab;
+    StringTable strtab;
+    SectionHeader sections[elf::kSectionCount];
+    ByteWriter out;
+    out.bytes.resize(elf::kHeaderSize);
+
+    auto beginSection = [&](uint16_t index, const char* name, uint32_t type, uint64_t flags, uint64_t alignment) {
+        out.align(alignment);
+        SectionHeader& section = sections[index];
+        section.name = shstrtab.add(name);
+        section.type = type;
+        section.flags = flags;
+        section.addralign = alignment;
+        section.offset = out.bytes.size();
+        return &section;
+    };
+
+    beginSection(elf::kText, ".text", elf::SHT_PROGBITS, elf::SHF_ALLOC | elf::SHF_EXECINSTR, 64)->size = code.size();
+    out.put(code.data(), code.size());
+
+    beginSection(elf::kData, ".data", elf::SHT_PROGBITS, elf::SHF_ALLOC | elf::SHF_WRITE, 8)->size = imports.size() * sizeof(uint64_t);
+    out.bytes.resize(out.bytes.size() + imports.size() * sizeof(uint64_t), 0);
+
+    beginSection(elf::kRodata, ".rodata", elf::SHT_PROGBITS, elf::SHF_ALLOC, 8)->size = metadata.size();
+    out.put(metadata.data(), metadata.size());
+
+    SectionHeader* rela = beginSection(elf::kRelaText, ".rela.text", elf::SHT_RELA, elf::SHF_INFO_LINK, 8);
+    for (const auto& [offset, slot] : relocations) {
+        out.put<uint64_t>(offset);
+        out.put<uint64_t>((static_cast<uint64_t>(elf::kSymData) << 32) | elf::R_X86_64_PC32);
+        out.put<int64_t>(static_cast<int64_t>(slot) * 8 - 4);  // Displacement is relative to the next instruction
+    }
+    rela->size = relocations.size() * elf::kRelaSize;
+    rela->link = elf::kSymtab;
+    rela->info = elf::kText;
+    rela->entsize = elf::kRelaSize;
+
+    SectionHeader* symtab = beginSection(elf::kSymtab, ".symtab", elf::SHT_SYMTAB, 0, 8);
+    auto putSymbol = [&](uint32_t name, uint8_t bind, uint8_t type, uint16_t section, uint64_t size) {
+        out.put<uint32_t>(name);
+        out.put<uint8_t>(static_cast<uint8_t>((bind << 4) | type));
+        out.put<uint8_t>(0);  // Default visibility
+        out.put<uint16_t>(section);
+        out.put<uint64_t>(0);
+        out.put<uint64_t>(size);
+    };
+    putSymbol(0, elf::STB_LOCAL, 0, 0, 0);
+    putSymbol(0, elf::STB_LOCAL, elf::STT_SECTION, elf::kText, 0);
+    putSymbol(0, elf::STB_LOCAL, elf::STT_SECTION, elf::kData, 0);
+    putSymbol(0, elf::STB_LOCAL, elf::STT_SECTION, elf::kRodata, 0);
+    putSymbol(strtab.add(symbol), elf::STB_GLOBAL, elf::STT_FUNC, elf::kText, code.size());
+    putSymbol(strtab.add(symbol + "_imports"), elf::STB_GLOBAL, elf::STT_OBJECT, elf::kData, imports.size() * sizeof(uint64_t));
+    putSymbol(strtab.add(symbol + "_metadata"), elf::STB_GLOBAL, elf::STT_OBJECT, elf::kRodata, metadata.size());
+    symtab->size = (elf::kFirstGlobal + 3) * elf::kSymbolSize;
+    symtab->link = elf::kStrtab;
+    symtab->info = elf::kFirstGlobal;
+    symtab->entsize = elf::kSymbolSize;
+
+    beginSection(elf::kStrtab, ".strtab", elf::SHT_STRTAB, 0, 1)->size = strtab.data().size();
+    out.put(strtab.data().data(), strtab.data().size());
+
+    // Empty marker: the kernel does not need an executable stack
+    beginSection(elf::kNoteStack, ".note.GNU-stack", elf::SHT_PROGBITS, 0, 1);
+
+    SectionHeader* names = beginSection(elf::kShstrtab, ".shstrtab", elf::SHT_STRTAB, 0, 1);
+    names->size = shstrtab.data().size();
+    out.put(shstrtab.data().data(), shstrtab.data().size());
+
+    out.align(8);
+    const uint64_t sectionHeaderOffset = out.bytes.size();
+    for (const SectionHeader& section : sections) {
+        out.put<uint32_t>(section.name);
+        out.put<uint32_t>(section.type);
+        out.put<uint64_t>(section.flags);
+        out.put<uint64_t>(0);  // Address
+        out.put<uint64_t>(section.offset);
+        out.put<uint64_t>(section.size);
+        out.put<uint32_t>(section.link);
+        out.put<uint32_t>(section.info);
+        out.put<uint64_t>(section.addralign);
+        out.put<uint64_t>(section.entsize);
+    }
+
+    ByteWriter header;
+    const uint8_t ident[16] = {0x7F, 'E', 'L', 'F', 2 /* 64-bit */, 1 /* little-endian */, 1 /* version */};
+    header.put(ident, sizeof(ident));
+    header.put<uint16_t>(elf::ET_REL);
+    header.put<uint16_t>(elf::EM_X86_64);
+    header.put<uint32_t>(1);                       // Version
+    header.put<uint64_t>(0);                       // Entry
+    header.put<uint64_t>(0);                       // Program headers
+    header.put<uint64_t>(sectionHeaderOffset);
+    header.put<uint32_t>(0);                       // Flags
+    header.put<uint16_t>(static_cast<uint16_t>(elf::kHeaderSize));
+    header.put<uint16_t>(0);                       // Program header entry size
+    header.put<uint16_t>(0);                       // Program header count
+    header.put<uint16_t>(static_cast<uint16_t>(elf::kSectionHeaderSize));
+    header.put<uint16_t>(elf::kSectionCount);
+    header.put<uint16_t>(elf::kShstrtab);
+    std::memcpy(out.bytes.data(), header.bytes.data(), elf::kHeaderSize);
+    return out.bytes;
+#endif
+}
+
+bool saveKernelObject(const ForgedKernel& kernel, const std::string& filename, const std::string& symbol) {
+    const std::vector<uint8_t> bytes = serializeKernelObject(kernel, symbol);
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return file.good();
+}
+
+std::unique_ptr<ForgedKernel> loadKernelLibrary(const std::string& path, const std::string& symbol) {
+#ifdef _WIN32
+    (void)path;
+    (void)symbol;
+    throw std::runtime_error("Kernel libraries are not supported on Windows");
+#else
+    void* handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        const char* error = dlerror();
+        throw std::runtime_error("Cannot load kernel library " + path + ": " + (error ? error : "unknown error"));
+    }
+    std::shared_ptr<void> library(handle, [](void* h) { dlclose(h); });
+
+    auto lookup = [&](const std::string& name) {
+        void* address = dlsym(handle, name.c_str());
+        if (!address) throw std::runtime_error("Kernel library " + path + " has no symbol " + name);
+        return address;
+    };
+    void* code = lookup(symbol);
+    const uint8_t* metadata = static_cast<const uint8_t*>(lookup(symbol + "_metadata"));
+    auto* imports = static_cast<const void**>(lookup(symbol + "_imports"));
+
+    kernel_object::Metadata header;
+    std::memcpy(&header, metadata, sizeof(header));
+    if (std::memcmp(header.magic, kernel_object::kMagic, sizeof(header.magic)) != 0 ||
+        header.version != kernel_object::kVersion) {
+        throw std::runtime_error("Kernel library " + path + " has unsupported metadata for " + symbol);
+    }
+    const uint64_t fixedSize = sizeof(header) + (static_cast<uint64_t>(header.mappingCount) + header.outputCount) * sizeof(NodeId) +
+                               header.nameLength;
+    if (header.metadataSize < fixedSize || header.vectorWidth == 0 ||
+        (header.bodyOffset != 0 && header.bodyOffset >= header.codeSize)) {
+        throw std::runtime_error("Kernel library " + path + " has corrupt metadata for " + symbol);
+    }
+
+    const uint8_t* cursor = metadata + sizeof(header);
+    const uint8_t* end = metadata + header.metadataSize;
+    std::vector<NodeId> mapping = readArray<NodeId>(cursor, header.mappingCount);
+    std::vector<NodeId> outputs = readArray<NodeId>(cursor, header.outputCount);
+    std::string instructionSetName(reinterpret_cast<const char*>(cursor), header.nameLength);
+    cursor += header.nameLength;
+
+    if (!cpuSupports(instructionSetName)) {
+        throw std::runtime_error("CPU does not support the " + instructionSetName + " kernel in " + path);
+    }
+
+    for (uint32_t i = 0; i < header.importCount; ++i) {
+        const uint8_t* terminator = static_cast<const uint8_t*>(std::memchr(cursor, 0, static_cast<size_t>(end - cursor)));
+        if (!terminator) {
+            throw std::runtime_error("Kernel library " + path + " has corrupt metadata for " + symbol);
+        }
+        const std::string name(reinterpret_cast<const char*>(cursor), static_cast<size_t>(terminator - cursor));
+        const void* address = findExternalSymbol(name);
+        if (!address) {
+            throw std::runtime_error("Kernel in " + path + " imports unknown function " + name);
+        }
+        imports[i] = address;
+        cursor = terminator + 1;
+    }
+
+    auto func = reinterpret_cast<ForgedKernel::KernelFunc>(code);
+    ForgedKernel::KernelFunc bodyFunc = header.bodyOffset != 0
+        ? reinterpret_cast<ForgedKernel::KernelFunc>(static_cast<uint8_t*>(code) + header.bodyOffset) : nullptr;
+
+    CompilerConfig config = CompilerConfig::Default();
+    config.instructionSetName = instructionSetName;
+    config.useNamedInstructionSet = true;
+    return std::make_unique<ForgedKernel>(func, std::move(library), static_cast<size_t>(header.numNodes),
+                                          static_cast<int>(header.vectorWidth), instructionSetName, config,
+                                          mapping, static_cast<size_t>(header.maxNodeId),
+                                          static_cast<size_t>(header.workingNodes), outputs, bodyFunc);
+#endif
+}
+
+} // namespace forge
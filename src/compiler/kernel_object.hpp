@@ -0,0 +1,117 @@
+// This file is part of Forge <https://github.com/da-roth/forge>
+//
+// See LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+/**
+ * @file kernel_object.hpp
+ * @brief Ahead-of-time export of forged kernels as linkable ELF objects
+ *
+ * saveKernelObject() writes a kernel compiled with CompilerConfig::enableKernelExport
+ * to a relocatable x86-64 ELF object. Linked into a shared library with the
+ * system linker, it is loaded back by loadKernelLibrary() as a ForgedKernel,
+ * without recording, optimizing or forging the graph again:
+ *
+ * @code
+ * CompilerConfig config = CompilerConfig::Default();
+ * config.enableKernelExport = true;
+ * auto kernel = ForgeEngine(config).compile(graph);
+ * saveKernelObject(*kernel, "pricer.o", "pricer");
+ * // cc -shared -o libpricer.so pricer.o
+ * auto loaded = loadKernelLibrary("./libpricer.so", "pricer");
+ * @endcode
+ *
+ * The object defines three global symbols:
+ *   <symbol>           the kernel, void(double* values, double* gradients, size_t count)
+ *   <symbol>_metadata  instruction set, buffer layout and node mapping (see kernel_object::Metadata)
+ *   <symbol>_imports   one pointer per external function the kernel calls
+ *
+ * Calls to external functions (libm, SLEEF, the sincos helpers) load their
+ * target from <symbol>_imports, which loadKernelLibrary() fills by name from
+ * the external symbol registry, so the library has no text relocations and
+ * no undefined symbols. It must be loaded by a process built with the
+ * backend that forged it, on a CPU supporting its instruction set.
+ *
+ * Objects follow the System V x86-64 calling convention; export and loading
+ * are not available on Windows.
+ */
+
+#pragma once
+
+#include "forge_engine.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace forge {
+
+namespace kernel_object {
+constexpr char kMagic[8] = {'F', 'O', 'R', 'G', 'E', 'K', 'O', 'B'};
+constexpr uint32_t kVersion = 1;
+
+/**
+ * @brief Fixed part of <symbol>_metadata (little-endian), followed by
+ *        u32 mapping[mappingCount], u32 outputs[outputCount], the instruction
+ *        set name (nameLength bytes) and importCount NUL-terminated import names
+ */
+struct Metadata {
+    char magic[8];
+    uint32_t version;
+    uint32_t vectorWidth;
+    uint64_t metadataSize;   ///< Total bytes including the variable part
+    uint64_t codeSize;
+    uint64_t bodyOffset;     ///< Offset of the body entry, 0 without uniform prologue
+    uint64_t numNodes;
+    uint64_t maxNodeId;
+    uint64_t workingNodes;
+    uint32_t mappingCount;
+    uint32_t outputCount;
+    uint32_t importCount;
+    uint32_t nameLength;
+};
+static_assert(sizeof(Metadata) == 80, "Metadata layout is part of the object format");
+} // namespace kernel_object
+
+/**
+ * @brief Make a function callable from exported kernels under a stable name
+ *
+ * The functions the bundled instruction sets call are registered already;
+ * backends loaded at runtime register theirs before exporting or loading.
+ */
+void registerExternalSymbol(const std::string& name, const void* address);
+
+/** @brief Address registered under name, nullptr if unknown */
+const void* findExternalSymbol(const std::string& name);
+
+/**
+ * @brief Build the relocatable ELF object for a kernel
+ *
+ * @param symbol C identifier naming the kernel symbol
+ * @throws std::runtime_error if the kernel was not compiled with
+ *         CompilerConfig::enableKernelExport, calls an unregistered function
+ *         or the symbol is not a valid identifier
+ */
+std::vector<uint8_t> serializeKernelObject(const ForgedKernel& kernel, const std::string& symbol = "forge_kernel");
+
+/**
+ * @brief Write the relocatable ELF object for a kernel (see serializeKernelObject)
+ *
+ * @return true if successful, false on I/O error
+ */
+bool saveKernelObject(const ForgedKernel& kernel, const std::string& filename, const std::string& symbol = "forge_kernel");
+
+/**
+ * @brief Load a kernel from a shared library linked from saveKernelObject() output
+ *
+ * The returned kernel keeps the library loaded and is used like a compiled one
+ * (NodeValueBufferFactory::create, execute, the node mapping).
+ *
+ * @throws std::runtime_error if the library or its symbols cannot be found, the
+ *         metadata is invalid, an import is not registered or the CPU lacks the
+ *         kernel's instruction set
+ */
+std::unique_ptr<ForgedKernel> loadKernelLibrary(const std::string& path, const std::string& symbol = "forge_kernel");
+
+} // namespace forge
@@ -0,0 +1,156 @@
+// This file is part of Forge <https://github.com/da-roth/forge>
+//
+// See LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+/**
+ * @file kernel_profile.cpp
+ * @brief Cycle counter emission and reporting for profiling kernels
+ */
+
+#include "kernel_profile.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <iomanip>
+
+namespace forge {
+
+// RAX = time stamp counter (RDX clobbered)
+void KernelProfile::emitTimestamp(asmjit::x86::Assembler& a) {
+    using namespace asmjit::x86;
+    a.rdtsc(edx, eax);
+    a.shl(rdx, 32);
+    a.or_(rax, rdx);
+}
+
+size_t KernelProfile::beginGroup(asmjit::x86::Assembler& a, const char* region) {
+    using namespace asmjit::x86;
+    const size_t group = groups_.size();
+    counters_.emplace_back();
+    groups_.push_back({region, {}, {}});
+
+    // Only scratch GP registers are touched, and they are restored: the
+    // register allocator's state is unaffected
+    a.push(rax);
+    a.push(rcx);
+    a.push(rdx);
+    emitTimestamp(a);
+    a.mov(rcx, reinterpret_cast<uint64_t>(&counters_[group]));
+    a.mov(qword_ptr(rcx, static_cast<int32_t>(offsetof(Counter, start))), rax);
+    a.pop(rdx);
+    a.pop(rcx);
+    a.pop(rax);
+    return group;
+}
+
+void KernelProfile::addNode(size_t group, NodeId node, const std::string& opName) {
+    groups_[group].nodes.push_back(node);
+    groups_[group].ops[opName]++;
+}
+
+void KernelProfile::endGroup(asmjit::x86::Assembler& a, size_t group) {
+    using namespace asmjit::x86;
+    a.push(rax);
+    a.push(rcx);
+    a.push(rdx);
+    emitTimestamp(a);
+    a.mov(rcx, reinterpret_cast<uint64_t>(&counters_[group]));
+    a.sub(rax, qword_ptr(rcx, static_cast<int32_t>(offsetof(Counter, start))));
+    a.add(qword_ptr(rcx, static_cast<int32_t>(offsetof(Counter, cycles))), rax);
+    a.add(qword_ptr(rcx, static_cast<int32_t>(offsetof(Counter, executions))), 1);
+    a.pop(rdx);
+    a.pop(rcx);
+    a.pop(rax);
+}
+
+void KernelProfile::setOriginalToOptimizedMapping(const std::vector<NodeId>& mapping) {
+    originalsOf_.clear();
+    for (size_t original = 0; original < mapping.size(); ++original) {
+        const NodeId working = mapping[original];
+        if (working == UINT32_MAX) continue;
+        if (working >= originalsOf_.size()) originalsOf_.resize(working + 1);
+        originalsOf_[working].push_back(static_cast<NodeId>(original));
+    }
+}
+
+void KernelProfile::reset() {
+    for (Counter& counter : counters_) counter = Counter{};
+}
+
+std::vector<KernelProfile::GroupReport> KernelProfile::report() const {
+    std::vector<GroupReport> result;
+    result.reserve(groups_.size());
+    for (size_t g = 0; g < groups_.size(); ++g) {
+        GroupReport entry;
+        entry.region = groups_[g].region;
+        entry.workingNodes = groups_[g].nodes;
+        entry.ops = groups_[g].ops;
+        entry.cycles = counters_[g].cycles;
+        entry.executions = counters_[g].executions;
+        for (NodeId node : entry.workingNodes) {
+            if (node < originalsOf_.size()) {
+                entry.originalNodes.insert(entry.originalNodes.end(), originalsOf_[node].begin(), originalsOf_[node].end());
+            }
+        }
+        std::sort(entry.originalNodes.begin(), entry.originalNodes.end());
+        result.push_back(std::move(entry));
+    }
+    return result;
+}
+
+uint64_t KernelProfile::totalCycles() const {
+    uint64_t total = 0;
+    for (const Counter& counter : counters_) total += counter.cycles;
+    return total;
+}
+
+namespace {
+
+std::string describeNodes(const KernelProfile::GroupReport& group) {
+    std::string text;
+    if (!group.workingNodes.empty()) {
+        text = "nodes " + std::to_string(group.workingNodes.front()) + "-" + std::to_string(group.workingNodes.back());
+    } else {
+        text = "all nodes";
+    }
+    if (!group.ops.empty()) {
+        text += " [";
+        bool first = true;
+        for (const auto& [op, count] : group.ops) {
+            text += (first ? "" : " ") + op + "*" + std::to_string(count);
+            first = false;
+        }
+        text += "]";
+    }
+    return text;
+}
+
+} // namespace
+
+void KernelProfile::writeFoldedStacks(std::ostream& out, const std::string& root) const {
+    for (const GroupReport& group : report()) {
+        if (group.cycles == 0) continue;
+        out << root << ';' << group.region << ';' << describeNodes(group) << ' ' << group.cycles << '\n';
+    }
+}
+
+void KernelProfile::printReport(std::ostream& out, size_t maxGroups) const {
+    std::vector<GroupReport> groups = report();
+    const uint64_t total = std::max<uint64_t>(totalCycles(), 1);
+    std::stable_sort(groups.begin(), groups.end(),
+                     [](const GroupReport& x, const GroupReport& y) { return x.cycles > y.cycles; });
+
+    out << "=== Kernel profile (" << totalCycles() << " cycles in " << groups.size() << " groups) ===\n";
+    for (size_t i = 0; i < groups.size() && i < maxGroups; ++i) {
+        const GroupReport& group = groups[i];
+        out << std::fixed << std::setprecision(1) << std::setw(6) << (100.0 * group.cycles / total) << "%  "
+            << std::setw(9) << group.region << "  " << describeNodes(group);
+        if (!group.originalNodes.empty()) {
+            out << "  recorded nodes " << group.originalNodes.front() << "-" << group.originalNodes.back()
+                << " (" << group.originalNodes.size() << ")";
+        }
+        out << '\n';
+    }
+}
+
+} // namespace forge
@@ -0,0 +1,116 @@
+// This file is part of Forge <https://github.com/da-roth/forge>
+//
+// See LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+/**
+ * @file kernel_profile.hpp
+ * @brief Per-node-group cycle counters compiled into profiling kernels
+ *
+ * With CompilerConfig::profileNodesPerGroup = N > 0, ForgeEngine brackets
+ * every N consecutive forward nodes, the uniform prologue and the backward
+ * pass with rdtsc reads and accumulates the elapsed cycles into a counter
+ * table owned by the kernel (ForgedKernel::getProfile()). The report maps
+ * each group back to the recorded graph's node IDs through
+ * originalToOptimizedMapping and lists its opcodes:
+ *
+ * @code
+ * config.profileNodesPerGroup = 64;
+ * auto kernel = ForgeEngine(config).compile(graph);
+ * for (...) kernel->execute(*buffer);
+ * std::ofstream out("payoff.folded");
+ * kernel->getProfile()->writeFoldedStacks(out, "payoff");  // flamegraph.pl payoff.folded > payoff.svg
+ * @endcode
+ *
+ * Each bracket costs two rdtsc reads (a few dozen cycles), so small groups
+ * inflate cheap nodes; forward nodes whose stores the compilation policy
+ * defers are charged to the group that emits the store. Counters are plain
+ * memory updates: they are exact when one thread runs the kernel at a time.
+ */
+
+#pragma once
+
+#include "../graph/graph.hpp"
+#include <asmjit/x86.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace forge {
+
+class KernelProfile {
+public:
+    /** @brief Counter slot the kernel updates (one cache line per group) */
+    struct alignas(64) Counter {
+        uint64_t start = 0;       ///< Time stamp at the last group entry
+        uint64_t cycles = 0;      ///< Accumulated time stamp ticks
+        uint64_t executions = 0;  ///< Completed group executions
+    };
+
+    /** @brief One group of the report */
+    struct GroupReport {
+        std::string region;                   ///< "uniform", "forward" or "backward"
+        std::vector<NodeId> workingNodes;     ///< Nodes of the compiled (optimized) graph
+        std::vector<NodeId> originalNodes;    ///< Recorded graph nodes mapped to them
+        std::map<std::string, size_t> ops;    ///< Opcode histogram of workingNodes
+        uint64_t cycles = 0;
+        uint64_t executions = 0;
+    };
+
+    // Compilation -------------------------------------------------------------
+
+    /** @brief Open a group and emit its entry time stamp */
+    size_t beginGroup(asmjit::x86::Assembler& a, const char* region);
+
+    /** @brief Attribute a working-graph node to a group */
+    void addNode(size_t group, NodeId node, const std::string& opName);
+
+    /** @brief Emit the group's exit: cycles += now - start, executions += 1 */
+    void endGroup(asmjit::x86::Assembler& a, size_t group);
+
+    /** @brief Record the kernel's node mapping (original node -> working node) */
+    void setOriginalToOptimizedMapping(const std::vector<NodeId>& mapping);
+
+    // Results -----------------------------------------------------------------
+
+    size_t groupCount() const { return groups_.size(); }
+
+    /** @brief Zero all counters */
+    void reset();
+
+    /** @brief Groups in code order with their current counts */
+    std::vector<GroupReport> report() const;
+
+    /** @brief Sum of cycles over all groups */
+    uint64_t totalCycles() const;
+
+    /**
+     * @brief Write the report in folded-stack format (flamegraph.pl, speedscope)
+     *
+     * One line per group: "<root>;<region>;nodes <first>-<last> [Op*count ...] <cycles>"
+     * with working-graph node IDs.
+     */
+    void writeFoldedStacks(std::ostream& out, const std::string& root = "forge_kernel") const;
+
+    /** @brief Human-readable table of the hottest groups with original node IDs */
+    void printReport(std::ostream& out, size_t maxGroups = 20) const;
+
+private:
+    struct Group {
+        const char* region;
+        std::vector<NodeId> nodes;
+        std::map<std::string, size_t> ops;
+    };
+
+    static void emitTimestamp(asmjit::x86::Assembler& a);
+
+    std::deque<Counter> counters_;  // Stable addresses: the kernel code embeds them
+    std::vector<Group> groups_;
+    std::vector<std::vector<NodeId>> originalsOf_;  // Working node -> original nodes
+};
+
+} // namespace forge
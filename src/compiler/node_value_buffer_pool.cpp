@@ -0,0 +1,103 @@
+// This file is part of Forge <https://github.com/da-roth/forge>
+//
+// See LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+/**
+ * @file node_value_buffer_pool.cpp
+ * @brief Per-kernel, per-NUMA-node free lists of node value buffers
+ */
+
+#include "node_value_buffer_pool.hpp"
+#include "forge_engine.hpp"
+#include "numa_topology.hpp"
+
+namespace forge {
+
+NodeValueBufferPool::Lease NodeValueBufferPool::acquire(const forge::Graph& tape, const ForgedKernel& kernel) {
+    const int node = NumaTopology::get().currentNode();
+    std::unique_ptr<INodeValueBuffer> buffer;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = idle_.find(kernel.getId());
+        if (it != idle_.end() && static_cast<size_t>(node) < it->second.size()) {
+            auto& buffers = it->second[static_cast<size_t>(node)];
+            if (!buffers.empty()) {
+                buffer = std::move(buffers.back());
+                buffers.pop_back();
+            }
+        }
+    }
+
+    // Allocation and zeroing happen outside the lock; zeroing on this thread
+    // places the pages on its node
+    if (buffer) {
+        buffer->reset();
+    } else {
+        buffer = NodeValueBufferFactory::create(tape, kernel);
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++created_;
+        idle_[kernel.getId()];  // Returned buffers are kept from now on
+    }
+    return Lease(this, kernel.getId(), node, std::move(buffer));
+}
+
+void NodeValueBufferPool::reserve(const forge::Graph& tape, const ForgedKernel& kernel, size_t count, int numaNode) {
+    const NumaTopology& topology = NumaTopology::get();
+    const int current = topology.currentNode();
+    const int node = (numaNode < 0 || numaNode >= topology.nodeCount()) ? current : numaNode;
+
+    std::vector<std::unique_ptr<INodeValueBuffer>> fresh;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& nodes = idle_[kernel.getId()];
+        const size_t idle = static_cast<size_t>(node) < nodes.size() ? nodes[static_cast<size_t>(node)].size() : 0;
+        if (idle >= count) return;
+        count -= idle;
+    }
+    fresh.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        fresh.push_back(NodeValueBufferFactory::create(tape, kernel));
+        if (node != current) topology.moveToNode(*fresh.back(), node);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& nodes = idle_[kernel.getId()];
+    if (nodes.size() <= static_cast<size_t>(node)) nodes.resize(static_cast<size_t>(node) + 1);
+    created_ += fresh.size();
+    for (auto& buffer : fresh) nodes[static_cast<size_t>(node)].push_back(std::move(buffer));
+}
+
+void NodeValueBufferPool::release(const ForgedKernel& kernel) {
+    std::vector<Buffers> dropped;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = idle_.find(kernel.getId());
+    if (it == idle_.end()) return;
+    dropped = std::move(it->second);
+    idle_.erase(it);
+}
+
+size_t NodeValueBufferPool::idleCount(const ForgedKernel& kernel) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = idle_.find(kernel.getId());
+    if (it == idle_.end()) return 0;
+    size_t count = 0;
+    for (const auto& buffers : it->second) count += buffers.size();
+    return count;
+}
+
+size_t NodeValueBufferPool::createdCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return created_;
+}
+
+void NodeValueBufferPool::giveBack(uint64_t kernelId, int node, std::unique_ptr<INodeValueBuffer> buffer) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = idle_.find(kernelId);
+    if (it == idle_.end()) return;  // The kernel was released while the lease was out: the buffer is freed here
+    auto& nodes = it->second;
+    if (nodes.size() <= static_cast<size_t>(node)) nodes.resize(static_cast<size_t>(node) + 1);
+    nodes[static_cast<size_t>(node)].push_back(std::move(buffer));
+}
+
+} // namespace forge
@@ -0,0 +1,134 @@
+// This file is part of Forge <https://github.com/da-roth/forge>
+//
+// See LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+/**
+ * @file node_value_buffer_pool.hpp
+ * @brief Reusable node value buffers for code that evaluates a kernel per request
+ *
+ * NodeValueBufferFactory::create() allocates and zeroes values and gradients,
+ * which for large graphs means megabytes of fresh pages to fault in on every
+ * call. The pool keeps released buffers per kernel and hands them out again
+ * after INodeValueBuffer::reset(), which zeroes only the slots the kernel
+ * reads before writing:
+ *
+ * @code
+ * NodeValueBufferPool pool;
+ * pool.reserve(graph, *kernel, threads);  // Allocated and faulted in up front
+ * // per request, on any thread:
+ * auto buffer = pool.acquire(graph, *kernel);
+ * buffer->setValue(x, request.spot);
+ * kernel->execute(*buffer);
+ * // buffer returns to the pool when the lease goes out of scope
+ * @endcode
+ *
+ * Idle buffers are also kept per NUMA node: acquire() prefers buffers on the
+ * calling thread's node, and buffers it creates are local by first touch.
+ * reserve() can place buffers on a given node (see numa_topology.hpp).
+ *
+ * Buffers are keyed by ForgedKernel::getId(), so a kernel created at the
+ * address of a destroyed one never receives its buffers. Idle buffers of a
+ * destroyed kernel stay allocated until release() or the pool's destruction.
+ * Leases must not outlive the pool.
+ */
+
+#pragma once
+
+#include "interfaces/node_value_buffer.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace forge {
+
+class NodeValueBufferPool {
+public:
+    /** @brief Exclusive use of a pooled buffer until destruction */
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(Lease&& other) noexcept
+            : pool_(other.pool_), kernelId_(other.kernelId_), node_(other.node_), buffer_(std::move(other.buffer_)) {
+            other.pool_ = nullptr;
+        }
+        Lease& operator=(Lease&& other) noexcept {
+            if (this != &other) {
+                giveBack();
+                pool_ = other.pool_;
+                kernelId_ = other.kernelId_;
+                node_ = other.node_;
+                buffer_ = std::move(other.buffer_);
+                other.pool_ = nullptr;
+            }
+            return *this;
+        }
+        ~Lease() { giveBack(); }
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        INodeValueBuffer* get() const { return buffer_.get(); }
+        INodeValueBuffer* operator->() const { return buffer_.get(); }
+        INodeValueBuffer& operator*() const { return *buffer_; }
+        explicit operator bool() const { return buffer_ != nullptr; }
+
+    private:
+        friend class NodeValueBufferPool;
+        Lease(NodeValueBufferPool* pool, uint64_t kernelId, int node, std::unique_ptr<INodeValueBuffer> buffer)
+            : pool_(pool), kernelId_(kernelId), node_(node), buffer_(std::move(buffer)) {}
+
+        void giveBack() {
+            if (pool_ && buffer_) pool_->giveBack(kernelId_, node_, std::move(buffer_));
+            pool_ = nullptr;
+        }
+
+        NodeValueBufferPool* pool_ = nullptr;
+        uint64_t kernelId_ = 0;
+        int node_ = 0;  // NUMA node the buffer returns to
+        std::unique_ptr<INodeValueBuffer> buffer_;
+    };
+
+    NodeValueBufferPool() = default;
+    NodeValueBufferPool(const NodeValueBufferPool&) = delete;
+    NodeValueBufferPool& operator=(const NodeValueBufferPool&) = delete;
+
+    /**
+     * @brief Take an idle buffer for the kernel, or create one
+     *
+     * Reused buffers come from the calling thread's NUMA node and are reset();
+     * new ones come zeroed from NodeValueBufferFactory. Thread-safe.
+     */
+    Lease acquire(const forge::Graph& tape, const ForgedKernel& kernel);
+
+    /**
+     * @brief Create buffers until the kernel has at least count idle ones on a NUMA node
+     *
+     * numaNode -1 means the calling thread's node. Buffers for another node
+     * are moved there with NumaTopology::moveToNode().
+     */
+    void reserve(const forge::Graph& tape, const ForgedKernel& kernel, size_t count, int numaNode = -1);
+
+    /** @brief Free the kernel's idle buffers; leases still out are freed on return */
+    void release(const ForgedKernel& kernel);
+
+    /** @brief Idle buffers held for the kernel (all NUMA nodes) */
+    size_t idleCount(const ForgedKernel& kernel) const;
+
+    /** @brief Buffers created by the pool so far (allocations a per-request create() would also pay) */
+    size_t createdCount() const;
+
+private:
+    using Buffers = std::vector<std::unique_ptr<INodeValueBuffer>>;
+
+    void giveBack(uint64_t kernelId, int node, std::unique_ptr<INodeValueBuffer> buffer);
+
+    mutable std::mutex mutex_;
+    std::unordered_map<uint64_t, std::vector<Buffers>> idle_;  // Per kernel id, per NUMA node
+    size_t created_ = 0;
+};
+
+} // namespace forge
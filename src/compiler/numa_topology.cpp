@@ -0,0 +1,189 @@
+// This file is part of Forge <https://github.com/da-roth/forge>
+//
+// See LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+/**
+ * @file numa_topology.cpp
+ * @brief NUMA topology from sysfs, mbind() placement and code replicas
+ */
+
+#include "numa_topology.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace forge {
+
+namespace {
+
+// "0-3,8,10-11" -> {0, 1, 2, 3, 8, 10, 11}
+std::vector<int> parseList(const std::string& text) {
+    std::vector<int> values;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find(',', pos);
+        if (end == std::string::npos) end = text.size();
+        const std::string item = text.substr(pos, end - pos);
+        int first = 0, last = 0;
+        const int fields = std::sscanf(item.c_str(), "%d-%d", &first, &last);
+        if (fields >= 1) {
+            if (fields == 1) last = first;
+            for (int v = first; v <= last; ++v) values.push_back(v);
+        }
+        pos = end + 1;
+    }
+    return values;
+}
+
+std::string readLine(const std::string& path) {
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    return line;
+}
+
+#ifdef __linux__
+// From <linux/mempolicy.h>; libnuma's numaif.h is not required
+constexpr int kMpolBind = 2;
+constexpr unsigned kMpolMfMove = 1u << 1;
+
+bool bindRange(void* p, size_t bytes, int node) {
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const uintptr_t begin = (reinterpret_cast<uintptr_t>(p) + page - 1) / page * page;
+    const uintptr_t end = (reinterpret_cast<uintptr_t>(p) + bytes) / page * page;
+    if (node < 0 || end <= begin) return false;
+
+    constexpr int kBitsPerWord = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> mask(static_cast<size_t>(node / kBitsPerWord + 1), 0);
+    mask[static_cast<size_t>(node / kBitsPerWord)] = 1ul << (node % kBitsPerWord);
+    const unsigned long maxNode = mask.size() * kBitsPerWord + 1;  // The kernel ignores the last bit
+    return syscall(SYS_mbind, begin, end - begin, kMpolBind, mask.data(), maxNode, kMpolMfMove) == 0;
+}
+#endif
+
+} // namespace
+
+const NumaTopology& NumaTopology::get() {
+    static const NumaTopology topology;
+    return topology;
+}
+
+NumaTopology::NumaTopology() {
+#ifdef __linux__
+    for (int node : parseList(readLine("/sys/devices/system/node/online"))) {
+        if (node < 0) continue;
+        if (static_cast<size_t>(node) >= cpus_.size()) cpus_.resize(static_cast<size_t>(node) + 1);
+        cpus_[static_cast<size_t>(node)] = parseList(readLine("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"));
+    }
+#endif
+    if (cpus_.empty()) cpus_.resize(1);  // Unknown: a single node 0
+    for (size_t node = 0; node < cpus_.size(); ++node) {
+        for (int cpu : cpus_[node]) {
+            if (cpu < 0) continue;
+            if (static_cast<size_t>(cpu) >= nodeOfCpu_.size()) nodeOfCpu_.resize(static_cast<size_t>(cpu) + 1, -1);
+            nodeOfCpu_[static_cast<size_t>(cpu)] = static_cast<int>(node);
+        }
+    }
+}
+
+int NumaTopology::nodeOfCpu(int cpu) const {
+    if (cpu < 0 || static_cast<size_t>(cpu) >= nodeOfCpu_.size() || nodeOfCpu_[static_cast<size_t>(cpu)] < 0) return 0;
+    return nodeOfCpu_[static_cast<size_t>(cpu)];
+}
+
+int NumaTopology::currentNode() const {
+    if (nodeCount() == 1) return 0;
+#ifdef __linux__
+    unsigned cpu = 0, node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0 && static_cast<int>(node) < nodeCount()) {
+        return static_cast<int>(node);
+    }
+#endif
+    return 0;
+}
+
+bool NumaTopology::moveToNode(void* p, size_t bytes, int node) const {
+    if (nodeCount() == 1 || node >= nodeCount()) return false;
+#ifdef __linux__
+    return bindRange(p, bytes, node);
+#else
+    (void)p;
+    (void)bytes;
+    return false;
+#endif
+}
+
+bool NumaTopology::moveToNode(INodeValueBuffer& buffer, int node) const {
+    const size_t bytes = static_cast<size_t>(buffer.getNumNodes()) * static_cast<size_t>(buffer.getVectorWidth()) * sizeof(double);
+    bool moved = moveToNode(buffer.getValuesPtr(), bytes, node);
+    if (buffer.getGradientsPtr()) moved = moveToNode(buffer.getGradientsPtr(), bytes, node) && moved;
+    return moved;
+}
+
+KernelCodeReplicas::KernelCodeReplicas(const ForgedKernel& kernel) : original_(kernel.getFunction()) {
+#ifdef __linux__
+    const size_t codeSize = kernel.getCodeSize();
+    if (codeSize == 0) return;  // Loaded from a shared library: the size is unknown
+
+    const NumaTopology& topology = NumaTopology::get();
+    if (topology.nodeCount() == 1) return;
+
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t bytes = (codeSize + page - 1) / page * page;
+    replicas_.reserve(static_cast<size_t>(topology.nodeCount()));  // push_back() cannot throw past a mapping
+    try {
+        for (int node = 0; node < topology.nodeCount(); ++node) {
+            Replica replica;
+            replica.bytes = bytes;
+            replica.memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (replica.memory == MAP_FAILED) {
+                throw std::runtime_error("Failed to map a kernel code replica");
+            }
+            replicas_.push_back(replica);
+            // Before the copy faults the pages in. A replica that cannot be
+            // placed is no better than the shared copy: use that everywhere.
+            if (!bindRange(replica.memory, bytes, node)) {
+                unmapAll();
+                return;
+            }
+            std::memcpy(replica.memory, reinterpret_cast<const void*>(original_), codeSize);
+            if (mprotect(replica.memory, bytes, PROT_READ | PROT_EXEC) != 0) {
+                throw std::runtime_error("Failed to make a kernel code replica executable");
+            }
+        }
+    } catch (...) {
+        unmapAll();  // The destructor does not run for a throwing constructor
+        throw;
+    }
+#else
+    (void)kernel;
+#endif
+}
+
+KernelCodeReplicas::~KernelCodeReplicas() {
+    unmapAll();
+}
+
+void KernelCodeReplicas::unmapAll() {
+#ifdef __linux__
+    for (const Replica& replica : replicas_) munmap(replica.memory, replica.bytes);
+#endif
+    replicas_.clear();
+}
+
+ForgedKernel::KernelFunc KernelCodeReplicas::entry(int node) const {
+    if (node < 0 || static_cast<size_t>(node) >= replicas_.size()) return original_;
+    return reinterpret_cast<ForgedKernel::KernelFunc>(replicas_[static_cast<size_t>(node)].memory);
+}
+
+} // namespace forge
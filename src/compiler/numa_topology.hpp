@@ -0,0 +1,121 @@
+// This file is part of Forge <https://github.com/da-roth/forge>
+//
+// See LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+/**
+ * @file numa_topology.hpp
+ * @brief NUMA topology, buffer placement and per-node kernel code replicas
+ *
+ * On multi-socket machines a worker should run code and touch buffers on its
+ * own NUMA node. Forge provides three pieces for that:
+ *
+ * - NumaTopology: nodes, their CPUs and the node of the calling thread
+ *   (from /sys/devices/system/node, no libnuma needed)
+ * - NumaTopology::moveToNode(): mbind() memory to a node, migrating pages that
+ *   were already touched. NodeValueBufferPool uses it to keep idle buffers per
+ *   node; buffers created on a worker thread are already local by first touch.
+ * - KernelCodeReplicas: copies of a kernel's code, one on each node
+ *
+ * @code
+ * KernelCodeReplicas replicas(*kernel);  // Once, after compile()
+ * NodeValueBufferPool pool;
+ * // per request, on a pinned worker thread:
+ * auto buffer = pool.acquire(graph, *kernel);  // Local buffer
+ * replicas.execute(*buffer);                   // Local code
+ * @endcode
+ *
+ * Everything degrades to a single node 0 outside Linux or on one-node
+ * machines: moveToNode() does nothing and KernelCodeReplicas runs the
+ * kernel's own code.
+ */
+
+#pragma once
+
+#include "forge_engine.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace forge {
+
+class NumaTopology {
+public:
+    /** @brief Topology of this machine (read once) */
+    static const NumaTopology& get();
+
+    /** @brief Number of NUMA nodes (1 if unknown) */
+    int nodeCount() const { return static_cast<int>(cpus_.size()); }
+
+    /** @brief CPUs of a node */
+    const std::vector<int>& cpus(int node) const { return cpus_.at(static_cast<size_t>(node)); }
+
+    /** @brief Node of a CPU (0 if unknown) */
+    int nodeOfCpu(int cpu) const;
+
+    /** @brief Node of the CPU the calling thread runs on (0 if unknown) */
+    int currentNode() const;
+
+    /**
+     * @brief Bind the whole pages inside [p, p + bytes) to a node, migrating touched pages
+     * @return false if nothing was bound (single node, unsupported, or mbind failed)
+     */
+    bool moveToNode(void* p, size_t bytes, int node) const;
+
+    /** @brief Move a buffer's values and gradients to a node */
+    bool moveToNode(INodeValueBuffer& buffer, int node) const;
+
+private:
+    NumaTopology();
+
+    std::vector<std::vector<int>> cpus_;  // Per node
+    std::vector<int> nodeOfCpu_;          // Per CPU, -1 if offline
+};
+
+/**
+ * @brief Copies of a kernel's code on every NUMA node
+ *
+ * Forged code is position independent (constants RIP-relative, external
+ * calls through absolute addresses), so its bytes run unchanged from any
+ * address. Replicas cover the main entry only; executeBody() and
+ * executeBound() keep using the original code. Replicas must not outlive the
+ * kernel (they share its constant pool copy and trace/profile storage).
+ *
+ * If any replica cannot be bound to its node, none are kept and every node
+ * runs the kernel's own code; size() then reports 0.
+ */
+class KernelCodeReplicas {
+public:
+    /** @throws std::runtime_error if a replica cannot be mapped */
+    explicit KernelCodeReplicas(const ForgedKernel& kernel);
+    ~KernelCodeReplicas();
+
+    KernelCodeReplicas(const KernelCodeReplicas&) = delete;
+    KernelCodeReplicas& operator=(const KernelCodeReplicas&) = delete;
+
+    /** @brief Entry on a node (the kernel's own code without replicas) */
+    ForgedKernel::KernelFunc entry(int node) const;
+
+    /** @brief Entry on the calling thread's node */
+    ForgedKernel::KernelFunc localEntry() const { return entry(NumaTopology::get().currentNode()); }
+
+    /** @brief ForgedKernel::execute() with the calling thread's replica */
+    void execute(INodeValueBuffer& buffer) const {
+        localEntry()(buffer.getValuesPtr(), buffer.getGradientsPtr(), buffer.getNumNodes());
+    }
+
+    /** @brief Number of replicas (0 on single-node machines or when binding failed) */
+    size_t size() const { return replicas_.size(); }
+
+private:
+    struct Replica {
+        void* memory = nullptr;
+        size_t bytes = 0;
+    };
+
+    void unmapAll();
+
+    ForgedKernel::KernelFunc original_;
+    std::vector<Replica> replicas_;  // Per node when the machine has more than one
+};
+
+} // namespace forge
@@ -0,0 +1,275 @@
+// This file is part of Forge <https://github.com/da-roth/forge>
+//
+// See LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+/**
+ * @file perf_jit_map.cpp
+ * @brief perf map and jitdump writers for forged kernels
+ */
+
+#include "perf_jit_map.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace forge {
+
+std::vector<PerfKernelLayout::Symbol> PerfKernelLayout::symbols(const std::string& kernelName, size_t codeSize,
+                                                                size_t nodesPerSymbol) const {
+    if (nodesPerSymbol == 0 || marks_.empty()) {
+        return {{0, codeSize, kernelName}};
+    }
+
+    std::vector<Mark> marks = marks_;
+    std::stable_sort(marks.begin(), marks.end(), [](const Mark& x, const Mark& y) { return x.offset < y.offset; });
+
+    // Symbol starts; node marks are grouped nodesPerSymbol at a time
+    std::vector<Symbol> starts;
+    size_t groupSize = 0;
+    NodeId groupFirst = kNoNode;
+    NodeId groupLast = kNoNode;
+    auto nameGroup = [&]() {
+        if (groupSize > 0) {
+            starts.back().name = kernelName + ":nodes_" + std::to_string(groupFirst) + "-" + std::to_string(groupLast);
+        }
+        groupSize = 0;
+    };
+    for (const Mark& mark : marks) {
+        if (mark.node == kNoNode) {
+            nameGroup();
+            starts.push_back({mark.offset, 0, kernelName + ":" + mark.region});
+            continue;
+        }
+        if (groupSize == nodesPerSymbol) nameGroup();
+        if (groupSize == 0) {
+            starts.push_back({mark.offset, 0, std::string()});
+            groupFirst = mark.node;
+        }
+        groupLast = mark.node;
+        ++groupSize;
+    }
+    nameGroup();
+    if (starts.front().offset > 0) {
+        starts.insert(starts.begin(), {0, 0, kernelName});
+    }
+
+    std::vector<Symbol> result;
+    for (size_t i = 0; i < starts.size(); ++i) {
+        const size_t end = i + 1 < starts.size() ? starts[i + 1].offset : codeSize;
+        if (end > starts[i].offset) {
+            result.push_back({starts[i].offset, end - starts[i].offset, std::move(starts[i].name)});
+        }
+    }
+    return result;
+}
+
+std::vector<PerfKernelLayout::Line> PerfKernelLayout::lines() const {
+    std::vector<Line> result;
+    for (const Mark& mark : marks_) {
+        if (mark.node != kNoNode) result.push_back({mark.offset, mark.node + 1});
+    }
+    std::stable_sort(result.begin(), result.end(), [](const Line& x, const Line& y) { return x.offset < y.offset; });
+    return result;
+}
+
+namespace {
+
+#ifdef __linux__
+// jitdump format, see tools/perf/Documentation/jitdump-specification.txt in the Linux sources
+constexpr uint32_t kJitDumpMagic = 0x4A695444;
+constexpr uint32_t kJitDumpVersion = 1;
+constexpr uint32_t kElfMachineX86_64 = 62;
+constexpr uint32_t kJitCodeLoad = 0;
+constexpr uint32_t kJitCodeDebugInfo = 2;
+
+uint64_t monotonicNanos() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);  // Matches perf record -k mono
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+class RecordBuffer {
+public:
+    template <typename T>
+    void put(T value) { put(&value, sizeof(T)); }
+    void put(const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        data_.insert(data_.end(), bytes, bytes + size);
+    }
+    void putString(const std::string& s) { put(s.c_str(), s.size() + 1); }
+    const std::vector<uint8_t>& bytes() const { return data_; }
+
+    // Record: u32 id, u32 total size, u64 timestamp, body
+    std::vector<uint8_t> finish(uint32_t id, uint64_t timestamp) const {
+        RecordBuffer record;
+        record.put<uint32_t>(id);
+        record.put<uint32_t>(static_cast<uint32_t>(16 + data_.size()));
+        record.put<uint64_t>(timestamp);
+        record.put(data_.data(), data_.size());
+        return record.data_;
+    }
+
+private:
+    std::vector<uint8_t> data_;
+};
+
+struct JitDumpFile {
+    std::mutex mutex;
+    int fd = -1;
+    void* marker = nullptr;
+    uint64_t codeIndex = 0;
+    bool failed = false;
+
+    bool open() {
+        if (fd >= 0) return true;
+        if (failed) return false;
+        const std::string path = PerfJitMap::jitDumpPath();
+        fd = ::open(path.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0666);
+        if (fd < 0) {
+            failed = true;
+            return false;
+        }
+        // perf record finds the dump through this executable mapping of it
+        marker = mmap(nullptr, static_cast<size_t>(sysconf(_SC_PAGESIZE)), PROT_READ | PROT_EXEC, MAP_PRIVATE, fd, 0);
+        if (marker == MAP_FAILED) marker = nullptr;
+
+        RecordBuffer header;
+        header.put<uint32_t>(kJitDumpMagic);
+        header.put<uint32_t>(kJitDumpVersion);
+        header.put<uint32_t>(40);  // Header size
+        header.put<uint32_t>(kElfMachineX86_64);
+        header.put<uint32_t>(0);
+        header.put<uint32_t>(static_cast<uint32_t>(getpid()));
+        header.put<uint64_t>(monotonicNanos());
+        header.put<uint64_t>(0);  // Flags
+        write(header.bytes().data(), header.bytes().size());
+        return true;
+    }
+
+    void write(const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        while (size > 0) {
+            const ssize_t written = ::write(fd, bytes, size);
+            if (written <= 0) return;
+            bytes += written;
+            size -= static_cast<size_t>(written);
+        }
+    }
+
+    static JitDumpFile& instance() {
+        static JitDumpFile file;
+        return file;
+    }
+};
+
+std::mutex& perfMapMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+#endif
+
+} // namespace
+
+std::string PerfJitMap::nextKernelName() {
+    static std::atomic<uint64_t> counter{0};
+    return "forge_kernel_" + std::to_string(counter.fetch_add(1));
+}
+
+std::string PerfJitMap::perfMapPath() {
+#ifdef __linux__
+    return "/tmp/perf-" + std::to_string(getpid()) + ".map";
+#else
+    return std::string();
+#endif
+}
+
+std::string PerfJitMap::jitDumpPath() {
+#ifdef __linux__
+    const char* dir = std::getenv("JITDUMPDIR");
+    return std::string(dir && *dir ? dir : "/tmp") + "/jit-" + std::to_string(getpid()) + ".dump";
+#else
+    return std::string();
+#endif
+}
+
+void PerfJitMap::writePerfMap(const void* base, const std::vector<PerfKernelLayout::Symbol>& symbols) {
+#ifdef __linux__
+    std::lock_guard<std::mutex> lock(perfMapMutex());
+    FILE* file = std::fopen(perfMapPath().c_str(), "a");
+    if (!file) return;
+    const uintptr_t start = reinterpret_cast<uintptr_t>(base);
+    for (const auto& symbol : symbols) {
+        // START SIZE name, addresses in hex without prefix
+        std::fprintf(file, "%zx %zx %s\n", static_cast<size_t>(start + symbol.offset), symbol.size, symbol.name.c_str());
+    }
+    std::fclose(file);
+#else
+    (void)base;
+    (void)symbols;
+#endif
+}
+
+void PerfJitMap::writeJitDump(const void* base, const std::vector<PerfKernelLayout::Symbol>& symbols,
+                              const std::vector<PerfKernelLayout::Line>& lines, const std::string& sourceName) {
+#ifdef __linux__
+    JitDumpFile& dump = JitDumpFile::instance();
+    std::lock_guard<std::mutex> lock(dump.mutex);
+    if (!dump.open()) return;
+
+    const uint64_t start = reinterpret_cast<uint64_t>(base);
+    const uint32_t pid = static_cast<uint32_t>(getpid());
+    const uint32_t tid = static_cast<uint32_t>(syscall(SYS_gettid));
+    size_t line = 0;
+    for (const auto& symbol : symbols) {
+        const uint64_t address = start + symbol.offset;
+
+        // Debug info must precede the load of the code it describes
+        const size_t firstLine = line;
+        while (line < lines.size() && lines[line].offset < symbol.offset + symbol.size) ++line;
+        if (line > firstLine) {
+            RecordBuffer debug;
+            debug.put<uint64_t>(address);
+            debug.put<uint64_t>(line - firstLine);
+            for (size_t i = firstLine; i < line; ++i) {
+                debug.put<uint64_t>(start + lines[i].offset);
+                debug.put<uint32_t>(lines[i].line);
+                debug.put<uint32_t>(0);  // Discriminator
+                debug.putString(sourceName);
+            }
+            const std::vector<uint8_t> bytes = debug.finish(kJitCodeDebugInfo, monotonicNanos());
+            dump.write(bytes.data(), bytes.size());
+        }
+
+        RecordBuffer load;
+        load.put<uint32_t>(pid);
+        load.put<uint32_t>(tid);
+        load.put<uint64_t>(address);  // vma
+        load.put<uint64_t>(address);  // code address
+        load.put<uint64_t>(symbol.size);
+        load.put<uint64_t>(dump.codeIndex++);
+        load.putString(symbol.name);
+        load.put(reinterpret_cast<const void*>(address), symbol.size);
+        const std::vector<uint8_t> bytes = load.finish(kJitCodeLoad, monotonicNanos());
+        dump.write(bytes.data(), bytes.size());
+    }
+#else
+    (void)base;
+    (void)symbols;
+    (void)lines;
+    (void)sourceName;
+#endif
+}
+
+} // namespace forge
@@ -0,0 +1,109 @@
+// This file is part of Forge <https://github.com/da-roth/forge>
+//
+// See LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+/**
+ * @file perf_jit_map.hpp
+ * @brief Linux perf symbols for forged kernels
+ *
+ * Without symbols, `perf report` attributes samples in forged kernels to
+ * anonymous [unknown] ranges. With CompilerConfig::emitPerfMap, ForgeEngine
+ * appends every kernel to /tmp/perf-<pid>.map, which `perf report` reads
+ * directly. With CompilerConfig::emitJitDump it writes jitdump records to
+ * $JITDUMPDIR/jit-<pid>.dump (default /tmp) for
+ *
+ *   perf record -k mono -g ./app
+ *   perf inject --jit -i perf.data -o perf.jit.data
+ *   perf report -i perf.jit.data   (or perf annotate)
+ *
+ * which also carries the code bytes and a line table: line n of the source
+ * file "<kernel>.nodes" is working-graph node n - 1, so `perf annotate`
+ * shows which node each hot instruction belongs to.
+ *
+ * CompilerConfig::perfNodesPerSymbol > 0 splits kernels into one symbol per
+ * range of that many forward nodes ("forge_kernel_3:nodes_0-63") plus the
+ * prologue, backward pass, epilogue, function bodies and constant pool, so
+ * `perf report` alone attributes cycles to parts of the graph.
+ *
+ * Neither format supports unloading: addresses of released kernels may be
+ * reused by later ones. Both are no-ops outside Linux.
+ */
+
+#pragma once
+
+#include "../graph/graph.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace forge {
+
+/**
+ * @brief Code layout of a kernel, recorded while it is forged
+ */
+class PerfKernelLayout {
+public:
+    /** @brief Named region starting at offset (runs to the next mark) */
+    void mark(size_t offset, const char* region) { marks_.push_back({offset, region, kNoNode}); }
+
+    /** @brief Code of a working-graph node starting at offset */
+    void markNode(size_t offset, NodeId node) { marks_.push_back({offset, nullptr, node}); }
+
+    struct Symbol {
+        size_t offset;
+        size_t size;
+        std::string name;
+    };
+
+    struct Line {
+        size_t offset;
+        uint32_t line;  ///< Working-graph node + 1
+    };
+
+    /**
+     * @brief Non-overlapping symbols covering codeSize bytes
+     * @param nodesPerSymbol 0 for a single symbol named kernelName
+     */
+    std::vector<Symbol> symbols(const std::string& kernelName, size_t codeSize, size_t nodesPerSymbol) const;
+
+    /** @brief Line table for jitdump debug info, ordered by offset */
+    std::vector<Line> lines() const;
+
+private:
+    static constexpr NodeId kNoNode = UINT32_MAX;
+    struct Mark {
+        size_t offset;
+        const char* region;
+        NodeId node;
+    };
+    std::vector<Mark> marks_;
+};
+
+/**
+ * @brief Process-wide writer of perf map and jitdump files
+ *
+ * Thread Safety: Safe to call from multiple threads.
+ */
+class PerfJitMap {
+public:
+    /** @brief Unique kernel name ("forge_kernel_<n>") */
+    static std::string nextKernelName();
+
+    /** @brief Append symbols for code at base to /tmp/perf-<pid>.map */
+    static void writePerfMap(const void* base, const std::vector<PerfKernelLayout::Symbol>& symbols);
+
+    /**
+     * @brief Append debug info and code load records to the jitdump file
+     *
+     * The file is created (and mapped, so perf record sees it) on first use.
+     */
+    static void writeJitDump(const void* base, const std::vector<PerfKernelLayout::Symbol>& symbols,
+                             const std::vector<PerfKernelLayout::Line>& lines, const std::string& sourceName);
+
+    static std::string perfMapPath();
+    static std::string jitDumpPath();
+};
+
+} // namespace forge
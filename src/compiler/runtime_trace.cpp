@@ -1,9 +1,12 @@
 #include "runtime_trace.hpp"
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
 #include <iostream>
 #include <iomanip>
 #include <cmath>
+#include <stdexcept>
 #ifdef _WIN32
 #include <malloc.h>  // For _aligned_malloc and _aligned_free
 #endif
@@ -11,57 +14,113 @@
 namespace forge {
 
 // Global trace buffer instance
-TraceBuffer g_traceBuffer = {nullptr, 0, {0}, false};
+TraceBuffer g_traceBuffer;
 
-void initializeTraceBuffer(size_t bufferSize) {
-    // Only initialize once - check if already initialized
-    if (g_traceBuffer.records != nullptr) {
-        // Already initialized, just reset the index for a fresh start
-        g_traceBuffer.index.store(0);
-        g_traceBuffer.enabled = true;
-        // Clear the buffer to avoid showing old garbage data
-        std::memset(g_traceBuffer.records, 0, (g_traceBuffer.mask + 1) * sizeof(TraceRecord));
-        return;
+namespace {
+
+std::atomic<TraceBuffer*> g_traceRegistry{nullptr};   // Private rings, newest first
+std::atomic<uint32_t> g_nextTraceThreadId{1};
+std::atomic<uint32_t> g_threadTraceCapacity{1024};
+
+#if defined(__linux__) && defined(__x86_64__)
+// Initial-exec TLS lives at a fixed offset from the thread pointer in every
+// thread, which is what lets JIT code address it through FS
+#define FORGE_TRACE_TLS_OFFSET 1
+thread_local TraceBuffer* t_traceBuffer __attribute__((tls_model("initial-exec"))) = nullptr;
+#else
+thread_local TraceBuffer* t_traceBuffer = nullptr;
+#endif
+
+// Releases the calling thread's ring on thread exit
+struct ThreadTraceOwner {
+    ~ThreadTraceOwner() {
+        if (t_traceBuffer) {
+            t_traceBuffer->owned.store(false, std::memory_order_release);
+            t_traceBuffer = nullptr;
+        }
     }
-    
-    // Ensure buffer size is a power of 2
+};
+thread_local ThreadTraceOwner t_traceOwner;
+
+size_t roundUpToPowerOfTwo(size_t size) {
     size_t actualSize = 1;
-    while (actualSize < bufferSize) {
+    while (actualSize < size) {
         actualSize <<= 1;
     }
-    
-    // Allocate aligned memory for trace records
+    return actualSize;
+}
+
+TraceRecord* allocateRecords(size_t count) {
     // Use platform-specific aligned allocation since std::aligned_alloc may not be available
 #ifdef _WIN32
-    g_traceBuffer.records = static_cast<TraceRecord*>(_aligned_malloc(actualSize * sizeof(TraceRecord), 32));
+    auto* records = static_cast<TraceRecord*>(_aligned_malloc(count * sizeof(TraceRecord), 32));
 #else
-    g_traceBuffer.records = static_cast<TraceRecord*>(aligned_alloc(32, actualSize * sizeof(TraceRecord)));
+    auto* records = static_cast<TraceRecord*>(aligned_alloc(32, count * sizeof(TraceRecord)));
 #endif
+    if (records) {
+        std::memset(records, 0, count * sizeof(TraceRecord));
+    }
+    return records;
+}
+
+void freeRecords(TraceRecord* records) {
+#ifdef _WIN32
+    _aligned_free(records);
+#else
+    free(records);
+#endif
+}
+
+void clearRing(TraceBuffer& ring) {
+    ring.index.store(0);
+    if (ring.records) {
+        std::memset(ring.records, 0, (ring.mask + 1) * sizeof(TraceRecord));
+    }
+}
+
+} // namespace
+
+void initializeTraceBuffer(size_t bufferSize) {
+    const size_t actualSize = roundUpToPowerOfTwo(bufferSize);
+    g_threadTraceCapacity.store(static_cast<uint32_t>(actualSize));
+    for (TraceBuffer* ring = g_traceRegistry.load(std::memory_order_acquire); ring; ring = ring->next) {
+        clearRing(*ring);
+    }
+
+    // Only initialize once - check if already initialized
+    if (g_traceBuffer.records != nullptr) {
+        // Already initialized, just reset the index for a fresh start
+        // Clear the buffer to avoid showing old garbage data
+        clearRing(g_traceBuffer);
+        g_traceBuffer.enabled = true;
+        return;
+    }
+
+    // Allocate aligned memory for trace records
+    g_traceBuffer.records = allocateRecords(actualSize);
     g_traceBuffer.mask = static_cast<uint32_t>(actualSize - 1);
     g_traceBuffer.index.store(0);
     g_traceBuffer.enabled = true;
-    
+
     if (!g_traceBuffer.records) {
         std::cerr << "Failed to allocate trace buffer" << std::endl;
         g_traceBuffer.enabled = false;
-    } else {
-        // Clear the newly allocated buffer
-        std::memset(g_traceBuffer.records, 0, actualSize * sizeof(TraceRecord));
     }
 }
 
 void cleanupTraceBuffer() {
     if (g_traceBuffer.records) {
-#ifdef _WIN32
-        _aligned_free(g_traceBuffer.records);
-#else
-        free(g_traceBuffer.records);
-#endif
+        freeRecords(g_traceBuffer.records);
         g_traceBuffer.records = nullptr;
     }
     g_traceBuffer.mask = 0;
     g_traceBuffer.index.store(0);
     g_traceBuffer.enabled = false;
+
+    // Private rings may still be referenced by their threads: clear, don't free
+    for (TraceBuffer* ring = g_traceRegistry.load(std::memory_order_acquire); ring; ring = ring->next) {
+        clearRing(*ring);
+    }
 }
 
 void setTracingEnabled(bool enabled) {
@@ -69,15 +128,72 @@ void setTracingEnabled(bool enabled) {
 }
 
 bool isTracingEnabled() {
-    bool enabled = g_traceBuffer.enabled;
-    bool hasRecords = (g_traceBuffer.records != nullptr);
-    bool result = enabled && hasRecords;
+    return g_traceBuffer.enabled && g_traceBuffer.records != nullptr;
+}
 
-    // std::cout << "[isTracingEnabled] enabled=" << (enabled ? "true" : "false")
-    //           << ", hasRecords=" << (hasRecords ? "true" : "false")
-    //           << ", returning=" << (result ? "true" : "false") << std::endl;
+TraceBuffer* acquireThreadTraceBuffer() {
+    if (t_traceBuffer) {
+        return t_traceBuffer;
+    }
+    (void)&t_traceOwner;  // Constructs the owner so the ring is released at thread exit
+
+    // Recycle the ring of an exited thread
+    TraceBuffer* ring = nullptr;
+    for (TraceBuffer* r = g_traceRegistry.load(std::memory_order_acquire); r; r = r->next) {
+        bool expected = false;
+        if (r->owned.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+            ring = r;
+            clearRing(*ring);
+            break;
+        }
+    }
 
-    return result;
+    if (!ring) {
+        const uint32_t capacity = g_threadTraceCapacity.load();
+        TraceRecord* records = allocateRecords(capacity);
+        if (!records) {
+            return nullptr;
+        }
+        ring = new TraceBuffer;
+        ring->records = records;
+        ring->mask = capacity - 1;
+        ring->enabled = true;
+        ring->owned.store(true);
+
+        // Lock-free push onto the registry
+        ring->next = g_traceRegistry.load(std::memory_order_relaxed);
+        while (!g_traceRegistry.compare_exchange_weak(ring->next, ring, std::memory_order_release,
+                                                      std::memory_order_relaxed)) {
+        }
+    }
+
+    ring->threadId = g_nextTraceThreadId.fetch_add(1);
+    t_traceBuffer = ring;
+    return ring;
+}
+
+bool getThreadTraceBufferOffset(int64_t& offset) {
+#ifdef FORGE_TRACE_TLS_OFFSET
+    uintptr_t threadPointer;
+    __asm__("mov %%fs:0, %0" : "=r"(threadPointer));  // TCB self pointer
+    offset = static_cast<int64_t>(reinterpret_cast<uintptr_t>(&t_traceBuffer) - threadPointer);
+    return true;
+#else
+    (void)offset;
+    return false;
+#endif
+}
+
+std::vector<const TraceBuffer*> getTraceBuffers() {
+    std::vector<const TraceBuffer*> rings{&g_traceBuffer};
+    std::vector<const TraceBuffer*> privateRings;
+    for (TraceBuffer* ring = g_traceRegistry.load(std::memory_order_acquire); ring; ring = ring->next) {
+        privateRings.push_back(ring);
+    }
+    std::sort(privateRings.begin(), privateRings.end(),
+              [](const TraceBuffer* x, const TraceBuffer* y) { return x->threadId < y->threadId; });
+    rings.insert(rings.end(), privateRings.begin(), privateRings.end());
+    return rings;
 }
 
 const char* getOperationName(uint32_t operationType) {
@@ -126,158 +242,279 @@ const char* getOperationName(uint32_t operationType) {
     }
 }
 
-void printTraceRecords() {
-    if (!isTracingEnabled()) {
+
+namespace {
+
+constexpr char kTraceDumpMagic[8] = {'F', 'O', 'R', 'G', 'E', 'T', 'R', 'C'};
+constexpr uint32_t kTraceDumpVersion = 1;
+constexpr uint32_t kMaxTraceLanes = 4;
+
+// Records of a ring, oldest first
+TraceDumpRing snapshotRing(const TraceBuffer& ring) {
+    TraceDumpRing snapshot;
+    snapshot.threadId = ring.threadId;
+    snapshot.capacity = ring.records ? ring.mask + 1 : 0;
+    snapshot.written = ring.index.load(std::memory_order_acquire);
+    const uint32_t count = std::min(snapshot.written, snapshot.capacity);
+    const uint32_t first = snapshot.written > snapshot.capacity ? (snapshot.written & ring.mask) : 0;
+    snapshot.records.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        snapshot.records.push_back(ring.records[(first + i) & ring.mask]);
+    }
+    return snapshot;
+}
+
+std::vector<TraceDumpRing> snapshotRings() {
+    std::vector<TraceDumpRing> rings;
+    for (const TraceBuffer* ring : getTraceBuffers()) {
+        if (ring->records && ring->index.load(std::memory_order_acquire) > 0) {
+            rings.push_back(snapshotRing(*ring));
+        }
+    }
+    return rings;
+}
+
+void printRecord(std::ostream& out, const TraceRecord& record, uint32_t i) {
+    // Debug: show all records with full details
+    if (record.operationType == 0 && record.vectorWidth == 0) {
+        out << "[" << i << "] EMPTY record (op=" << record.operationType
+            << ", width=" << record.vectorWidth
+            << ", id=" << record.instructionId << ")" << std::endl;
         return;
     }
-    
-    uint32_t currentIndex = g_traceBuffer.index.load();
-    uint32_t recordCount = std::min(currentIndex, g_traceBuffer.mask + 1);
-    
-    // Limit runtime trace to 1000 entries
+
+    out << "[" << i << "] ";
+
+    // Format based on operation type
+    const char* opName = getOperationName(record.operationType);
+
+    // Extract register info from timestamp field
+    uint32_t regInfo = static_cast<uint32_t>(record.timestamp & 0xFFFFFFFF);
+    uint32_t srcRegRaw = regInfo & 0xFFFF;
+    uint32_t dstRegRaw = (regInfo >> 16) & 0xFFFF;
+
+    // Convert back from encoded format (0xFFFE means no register)
+    int srcReg = (srcRegRaw == 0xFFFE) ? -1 : static_cast<int>(srcRegRaw);
+    int dstReg = (dstRegRaw == 0xFFFE) ? -1 : static_cast<int>(dstRegRaw);
+
+    // Helper function to format register names (handles -1 as "none")
+    auto formatReg = [&](int regId) {
+        if (regId < 0) {
+            out << "none";
+        } else {
+            const char* regPrefix = (record.vectorWidth == 1) ? "xmm" : "ymm";
+            out << regPrefix << regId;
+        }
+    };
+
+    if (record.operationType == static_cast<uint32_t>(OperationType::LOAD)) {
+        out << "LOAD(node#" << record.instructionId << "->";
+        formatReg(dstReg);
+        out << ")";
+    } else if (record.operationType == static_cast<uint32_t>(OperationType::STORE)) {
+        out << "STORE(";
+        formatReg(srcReg);
+        out << "->node#" << record.instructionId << ")";
+    } else if (record.operationType == static_cast<uint32_t>(OperationType::ADD)) {
+        out << "ADD(";
+        formatReg(dstReg);
+        out << "+";
+        formatReg(srcReg);
+        out << ")";
+    } else if (record.operationType == static_cast<uint32_t>(OperationType::SUB)) {
+        out << "SUB(";
+        formatReg(dstReg);
+        out << "-";
+        formatReg(srcReg);
+        out << ")";
+    } else if (record.operationType == static_cast<uint32_t>(OperationType::MUL)) {
+        out << "MUL(";
+        formatReg(dstReg);
+        out << "*";
+        formatReg(srcReg);
+        out << ")";
+    } else if (record.operationType == static_cast<uint32_t>(OperationType::DIV)) {
+        out << "DIV(";
+        formatReg(dstReg);
+        out << "/";
+        formatReg(srcReg);
+        out << ")";
+    } else if (record.operationType == static_cast<uint32_t>(OperationType::EXP)) {
+        out << "EXP(";
+        formatReg(dstReg);
+        out << ")";
+    } else if (record.operationType == static_cast<uint32_t>(OperationType::LOG)) {
+        out << "LOG(";
+        formatReg(dstReg);
+        out << ")";
+    } else if (record.operationType == static_cast<uint32_t>(OperationType::SQRT)) {
+        out << "SQRT(";
+        formatReg(dstReg);
+        out << ")";
+    } else {
+        out << opName << "(op=" << record.operationType << ",regs=" << dstReg << "," << srcReg << ")";
+    }
+
+    out << " = ";
+
+    // Check if this is a bitwise operation that should show hex patterns
+    bool isBitwiseOp = (record.operationType == static_cast<uint32_t>(OperationType::CREATE_ALL_ONES) ||
+                       record.operationType == static_cast<uint32_t>(OperationType::SHIFT_LEFT) ||
+                       record.operationType == static_cast<uint32_t>(OperationType::SHIFT_RIGHT) ||
+                       record.operationType == static_cast<uint32_t>(OperationType::CREATE_MASK));
+
+    // Print vector values - only print the actual number of lanes
+    const double* values = reinterpret_cast<const double*>(record.data);
+    const uint64_t* bitPatterns = reinterpret_cast<const uint64_t*>(record.data);
+
+    for (uint32_t lane = 0; lane < std::min(record.vectorWidth, kMaxTraceLanes); ++lane) {
+        if (lane > 0) out << ", ";
+
+        if (isBitwiseOp) {
+            // Show as hex pattern for bit operations
+            out << "0x" << std::hex << std::setw(16) << std::setfill('0') << bitPatterns[lane] << std::dec << std::setfill(' ');
+        } else if (std::isnan(values[lane])) {
+            // For non-bitwise ops, NaN is unexpected - show warning
+            out << "NaN";
+        } else {
+            // Normal double value
+            out << std::fixed << std::setprecision(3) << values[lane];
+        }
+    }
+    out << std::endl;
+}
+
+void printRing(std::ostream& out, const TraceDumpRing& ring) {
+    // Limit runtime trace to 1000 entries per ring
     const uint32_t maxDisplayRecords = 1000;
-    uint32_t displayCount = std::min(recordCount, maxDisplayRecords);
-    
-    std::cout << "\n=== Runtime Trace Records ===" << std::endl;
-    std::cout << "Total records: " << recordCount;
+    const uint32_t recordCount = static_cast<uint32_t>(ring.records.size());
+    const uint32_t displayCount = std::min(recordCount, maxDisplayRecords);
+
+    out << "--- " << (ring.threadId == 0 ? std::string("Shared ring") : "Thread " + std::to_string(ring.threadId))
+        << ": " << recordCount << " records";
+    if (ring.written > ring.capacity) {
+        out << " (last " << recordCount << " of " << ring.written << ")";
+    }
     if (recordCount > maxDisplayRecords) {
-        std::cout << " (showing first " << maxDisplayRecords << ")";
-    }
-    std::cout << std::endl;
-    std::cout << "Buffer size: " << (g_traceBuffer.mask + 1) << std::endl;
-    std::cout << "Current index: " << currentIndex << std::endl;
-    std::cout << "sizeof(TraceRecord): " << sizeof(TraceRecord) << std::endl;
-    std::cout << "offsetof(data): " << offsetof(TraceRecord, data) << std::endl;
-    std::cout << "Note: Bitwise ops (CREATE_ALL_ONES, SHIFT_*) show hex patterns" << std::endl;
-    std::cout << "=============================" << std::endl;
-    
+        out << " (showing first " << maxDisplayRecords << ")";
+    }
+    out << ", buffer size " << ring.capacity << " ---" << std::endl;
+
     for (uint32_t i = 0; i < displayCount; ++i) {
-        const TraceRecord& record = g_traceBuffer.records[i];
-        
-        // Debug: Always print first record for debugging
-        if (i == 0) {
-            std::cout << "[DEBUG] First record: op=" << record.operationType 
-                      << ", width=" << record.vectorWidth 
-                      << ", id=" << record.instructionId;
-            const double* values = reinterpret_cast<const double*>(record.data);
-            std::cout << ", data=" << values[0] << std::endl;
-        }
-        
-        // Debug: show all records with full details
-        if (record.operationType == 0 && record.vectorWidth == 0) {
-            std::cout << "[" << i << "] EMPTY record (op=" << record.operationType 
-                      << ", width=" << record.vectorWidth 
-                      << ", id=" << record.instructionId << ")" << std::endl;
-            continue;
+        printRecord(out, ring.records[i], i);
+    }
+
+    // Show truncation message if needed
+    if (recordCount > maxDisplayRecords) {
+        out << "... (" << (recordCount - maxDisplayRecords) << " more records omitted)" << std::endl;
+    }
+}
+
+template <typename T>
+void writeValue(std::ostream& out, T value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T readValue(std::istream& in) {
+    T value;
+    if (!in.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+        throw std::runtime_error("Truncated trace dump");
+    }
+    return value;
+}
+
+} // namespace
+
+void printTraceRecords() {
+    if (!isTracingEnabled()) {
+        return;
+    }
+    printTraceDump(snapshotRings(), std::cout);
+}
+
+void printTraceDump(const std::vector<TraceDumpRing>& rings, std::ostream& out) {
+    out << "\n=== Runtime Trace Records ===" << std::endl;
+    out << "Rings with records: " << rings.size() << std::endl;
+    out << "Note: Bitwise ops (CREATE_ALL_ONES, SHIFT_*) show hex patterns" << std::endl;
+    out << "=============================" << std::endl;
+    for (const TraceDumpRing& ring : rings) {
+        printRing(out, ring);
+    }
+    out << "=============================" << std::endl;
+}
+
+void writeTraceDump(std::ostream& out) {
+    const std::vector<TraceDumpRing> rings = snapshotRings();
+    out.write(kTraceDumpMagic, sizeof(kTraceDumpMagic));
+    writeValue<uint32_t>(out, kTraceDumpVersion);
+    writeValue<uint32_t>(out, static_cast<uint32_t>(rings.size()));
+    for (const TraceDumpRing& ring : rings) {
+        writeValue<uint32_t>(out, ring.threadId);
+        writeValue<uint32_t>(out, ring.capacity);
+        writeValue<uint32_t>(out, ring.written);
+        writeValue<uint32_t>(out, static_cast<uint32_t>(ring.records.size()));
+        for (const TraceRecord& record : ring.records) {
+            const uint32_t lanes = std::min(record.vectorWidth, kMaxTraceLanes);
+            writeValue<uint32_t>(out, record.instructionId);
+            writeValue<uint32_t>(out, record.operationType);
+            writeValue<uint32_t>(out, record.vectorWidth);
+            writeValue<uint32_t>(out, static_cast<uint32_t>(record.timestamp & 0xFFFFFFFF));
+            out.write(reinterpret_cast<const char*>(record.data), lanes * sizeof(double));
         }
-        
-        std::cout << "[" << i << "] ";
-        
-        // Format based on operation type
-        const char* opName = getOperationName(record.operationType);
-        
-        // Extract register info from timestamp field
-        uint32_t regInfo = static_cast<uint32_t>(record.timestamp & 0xFFFFFFFF);
-        uint32_t srcRegRaw = regInfo & 0xFFFF;
-        uint32_t dstRegRaw = (regInfo >> 16) & 0xFFFF;
-        
-        // Convert back from encoded format (0xFFFE means no register)
-        int srcReg = (srcRegRaw == 0xFFFE) ? -1 : static_cast<int>(srcRegRaw);
-        int dstReg = (dstRegRaw == 0xFFFE) ? -1 : static_cast<int>(dstRegRaw);
-        
-        // Helper function to format register names (handles -1 as "none")
-        auto formatReg = [&](int regId) {
-            if (regId < 0) {
-                std::cout << "none";
-            } else {
-                const char* regPrefix = (record.vectorWidth == 1) ? "xmm" : "ymm";
-                std::cout << regPrefix << regId;
-            }
-        };
-        
-        if (record.operationType == static_cast<uint32_t>(OperationType::LOAD)) {
-            std::cout << "LOAD(node#" << record.instructionId << "->";
-            formatReg(dstReg);
-            std::cout << ")";
-        } else if (record.operationType == static_cast<uint32_t>(OperationType::STORE)) {
-            std::cout << "STORE(";
-            formatReg(srcReg);
-            std::cout << "->node#" << record.instructionId << ")";
-        } else if (record.operationType == static_cast<uint32_t>(OperationType::ADD)) {
-            std::cout << "ADD(";
-            formatReg(dstReg);
-            std::cout << "+";
-            formatReg(srcReg);
-            std::cout << ")";
-        } else if (record.operationType == static_cast<uint32_t>(OperationType::SUB)) {
-            std::cout << "SUB(";
-            formatReg(dstReg);
-            std::cout << "-";
-            formatReg(srcReg);
-            std::cout << ")";
-        } else if (record.operationType == static_cast<uint32_t>(OperationType::MUL)) {
-            std::cout << "MUL(";
-            formatReg(dstReg);
-            std::cout << "*";
-            formatReg(srcReg);
-            std::cout << ")";
-        } else if (record.operationType == static_cast<uint32_t>(OperationType::DIV)) {
-            std::cout << "DIV(";
-            formatReg(dstReg);
-            std::cout << "/";
-            formatReg(srcReg);
-            std::cout << ")";
-        } else if (record.operationType == static_cast<uint32_t>(OperationType::EXP)) {
-            std::cout << "EXP(";
-            formatReg(dstReg);
-            std::cout << ")";
-        } else if (record.operationType == static_cast<uint32_t>(OperationType::LOG)) {
-            std::cout << "LOG(";
-            formatReg(dstReg);
-            std::cout << ")";
-        } else if (record.operationType == static_cast<uint32_t>(OperationType::SQRT)) {
-            std::cout << "SQRT(";
-            formatReg(dstReg);
-            std::cout << ")";
-        } else {
-            std::cout << opName << "(op=" << record.operationType << ",regs=" << dstReg << "," << srcReg << ")";
+    }
+}
+
+bool writeTraceDump(const std::string& path) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        return false;
+    }
+    writeTraceDump(out);
+    return static_cast<bool>(out);
+}
+
+std::vector<TraceDumpRing> readTraceDump(std::istream& in) {
+    char magic[sizeof(kTraceDumpMagic)];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kTraceDumpMagic, sizeof(magic)) != 0) {
+        throw std::runtime_error("Not a Forge trace dump");
+    }
+    const uint32_t version = readValue<uint32_t>(in);
+    if (version != kTraceDumpVersion) {
+        throw std::runtime_error("Unsupported trace dump version " + std::to_string(version));
+    }
+
+    std::vector<TraceDumpRing> rings(readValue<uint32_t>(in));
+    for (TraceDumpRing& ring : rings) {
+        ring.threadId = readValue<uint32_t>(in);
+        ring.capacity = readValue<uint32_t>(in);
+        ring.written = readValue<uint32_t>(in);
+        const uint32_t count = readValue<uint32_t>(in);
+        if (count > ring.capacity) {
+            throw std::runtime_error("Corrupt trace dump: ring holds more records than its capacity");
         }
-        
-        std::cout << " = ";
-        
-        // Check if this is a bitwise operation that should show hex patterns
-        bool isBitwiseOp = (record.operationType == static_cast<uint32_t>(OperationType::CREATE_ALL_ONES) ||
-                           record.operationType == static_cast<uint32_t>(OperationType::SHIFT_LEFT) ||
-                           record.operationType == static_cast<uint32_t>(OperationType::SHIFT_RIGHT) ||
-                           record.operationType == static_cast<uint32_t>(OperationType::CREATE_MASK));
-        
-        // Print vector values - only print the actual number of lanes
-        const double* values = reinterpret_cast<const double*>(record.data);
-        const uint64_t* bitPatterns = reinterpret_cast<const uint64_t*>(record.data);
-        
-        for (uint32_t lane = 0; lane < std::min(record.vectorWidth, 4u); ++lane) {
-            if (lane > 0) std::cout << ", ";
-            
-            if (isBitwiseOp) {
-                // Show as hex pattern for bit operations
-                std::cout << "0x" << std::hex << std::setw(16) << std::setfill('0') << bitPatterns[lane] << std::dec;
-            } else if (std::isnan(values[lane])) {
-                // For non-bitwise ops, NaN is unexpected - show warning
-                std::cout << "NaN";
-            } else {
-                // Normal double value
-                std::cout << std::fixed << std::setprecision(3) << values[lane];
+        ring.records.resize(count);
+        for (TraceRecord& record : ring.records) {
+            std::memset(&record, 0, sizeof(record));
+            record.instructionId = readValue<uint32_t>(in);
+            record.operationType = readValue<uint32_t>(in);
+            record.vectorWidth = readValue<uint32_t>(in);
+            record.timestamp = readValue<uint32_t>(in);
+            const uint32_t lanes = std::min(record.vectorWidth, kMaxTraceLanes);
+            if (!in.read(reinterpret_cast<char*>(record.data), lanes * sizeof(double))) {
+                throw std::runtime_error("Truncated trace dump");
             }
         }
-        std::cout << std::endl;
     }
-    
-    // Show truncation message if needed
-    if (recordCount > maxDisplayRecords) {
-        std::cout << "... (" << (recordCount - maxDisplayRecords) << " more records omitted)" << std::endl;
+    return rings;
+}
+
+std::vector<TraceDumpRing> readTraceDump(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open trace dump: " + path);
     }
-    
-    std::cout << "=============================" << std::endl;
+    return readTraceDump(in);
 }
 
 } // namespace forge
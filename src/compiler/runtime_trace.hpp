@@ -4,6 +4,10 @@
 #include <cstdio>
 #include <cstring>
 #include <atomic>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
 
 namespace forge {
 
@@ -20,20 +24,36 @@ struct TraceRecord {
 };
 
 // Ring buffer for trace records
+//
+// g_traceBuffer is the shared ring. Every thread that runs a traced kernel
+// through a ForgedKernel entry point (execute(), executeDirect(),
+// executeBody(), executeBound(), ...) or calls acquireThreadTraceBuffer() gets
+// a private ring, so traced instructions do not contend on one index and
+// records of different threads do not interleave. Private rings are linked
+// into a lock-free registry through `next` and are never freed; the ring of
+// an exited thread is recycled by the next thread that needs one. Threads
+// without a private ring, and all threads on platforms other than x86-64
+// Linux, record into the shared ring.
 struct TraceBuffer {
-    TraceRecord* records;
-    uint32_t mask;              // Ring buffer size mask (must be power of 2 - 1)
-    std::atomic<uint32_t> index; // Current write position
-    bool enabled;
+    TraceRecord* records = nullptr;
+    uint32_t mask = 0;                  // Ring buffer size mask (must be power of 2 - 1)
+    std::atomic<uint32_t> index{0};     // Total records written (lock xadd by JIT code)
+    bool enabled = false;               // Global switch (shared ring only)
+    uint32_t threadId = 0;              // 0 for the shared ring, 1, 2, ... in registration order
+    std::atomic<bool> owned{false};     // Private ring held by a live thread
+    TraceBuffer* next = nullptr;        // Registry link (private rings only)
 };
 
 // Global trace buffer instance
 extern TraceBuffer g_traceBuffer;
 
 // Initialize the trace buffer
+// bufferSize also sets the capacity of private rings created afterwards;
+// existing private rings are cleared.
 void initializeTraceBuffer(size_t bufferSize = 1024);
 
 // Cleanup the trace buffer
+// Frees the shared ring and clears private rings. Call while no traced kernel runs.
 void cleanupTraceBuffer();
 
 // Enable/disable tracing
@@ -42,12 +62,51 @@ void setTracingEnabled(bool enabled);
 // Check if tracing is enabled
 bool isTracingEnabled();
 
+// Private ring of the calling thread, registered on first use (nullptr if allocation fails)
+TraceBuffer* acquireThreadTraceBuffer();
+
+// Offset of the calling thread's private ring pointer from the thread pointer
+// (the FS base on x86-64 Linux). The offset is the same for every thread, so
+// JIT code loads the ring with `mov reg, fs:[offset]`. Returns false where
+// private rings are not reachable from JIT code.
+bool getThreadTraceBufferOffset(int64_t& offset);
+
+// Shared ring followed by all registered private rings
+std::vector<const TraceBuffer*> getTraceBuffers();
+
 // Helper function to get operation name from type
 const char* getOperationName(uint32_t operationType);
 
 // Print all trace records (for debugging)
 void printTraceRecords();
 
+// Binary trace dump
+//
+// Compact little-endian snapshot of all rings that hold records, for offline
+// decoding (tools/traceDecoder):
+//   header  "FORGETRC", u32 version, u32 ring count
+//   ring    u32 threadId, u32 capacity, u32 written, u32 record count
+//   record  u32 instructionId, u32 operationType, u32 vectorWidth,
+//           u32 register info, then min(vectorWidth, 4) lanes of 8 bytes
+// Records of a ring are stored oldest first. Snapshots taken while kernels
+// run may contain torn records.
+struct TraceDumpRing {
+    uint32_t threadId = 0;
+    uint32_t capacity = 0;
+    uint32_t written = 0;               // Records ever written; more than capacity means the ring wrapped
+    std::vector<TraceRecord> records;   // Oldest first
+};
+
+void writeTraceDump(std::ostream& out);
+bool writeTraceDump(const std::string& path);
+
+// Decode a dump; throws std::runtime_error on malformed input
+std::vector<TraceDumpRing> readTraceDump(std::istream& in);
+std::vector<TraceDumpRing> readTraceDump(const std::string& path);
+
+// Print decoded rings in the format of printTraceRecords()
+void printTraceDump(const std::vector<TraceDumpRing>& rings, std::ostream& out);
+
 // Operation type constants
 enum class OperationType : uint32_t {
     ADD = 1,
@@ -40,6 +40,11 @@ struct CompilerConfig {
     bool enableCSE = false;                 // Common subexpression elimination
     bool enableAlgebraicSimplification = false; // Apply algebraic identities (x*1=x, etc)
     bool enableStabilityCleaning = true;    // Fix numerical stability issues (1/exp(x) -> exp(-x)) - DEFAULT: enabled
+    bool enableDeadCodeElimination = true;  // Drop nodes no output depends on (applies when enableOptimizations is set)
+    bool enableOutputPruning = true;        // Emit no code for nodes outside the outputs' cone (independent of enableOptimizations)
+    bool enableForwardOnlyStores = true;    // Use ForwardOnlyPolicy (skip stores of register-consumed values) when no node needsGradient
+    bool enableUniformHoisting = true;      // Compute nodes depending only on uniform inputs in a once-per-batch prologue
+    bool enableLoopRerolling = false;       // Forge repeated blocks (unrolled loops) once and call them per block
     int maxOptimizationPasses = 5;          // Iterate until no changes or max passes
     
     // Debug output flags (all false by default in production)
@@ -55,6 +60,8 @@ struct CompilerConfig {
     
     // Performance tuning
     size_t maxRegisterCount = 16;           // Use XMM0-XMM15 (full set for maximum performance)
+    int laneBlocks = 1;                     // Vectors per node (AVX2: 1, 2 or 4): kernels evaluate 4*laneBlocks scenarios
+    size_t laneBlockSegmentNodes = 16;      // With laneBlocks > 1: forward nodes forged per block before the next block
     
     // Safety and validation
     bool validateGraph = false;             // Validate graph structure before compilation
@@ -63,6 +70,19 @@ struct CompilerConfig {
     // Debug recording for integration testing
     bool enableDebugRecording = false;      // Enable recording of intermediate values for debugging
                                             // This adds memory overhead (vector<double> + flag to Graph struct)
+
+    // Ahead-of-time export
+    bool enableKernelExport = false;        // Keep what saveKernelObject() needs (code size, external call sites)
+
+    // Zero-copy I/O (see io_binding.hpp)
+    bool enableIoBinding = false;           // Also emit an entry that copies inputs/outputs from/to user arrays (executeBound)
+
+    // Profiling with Linux perf (see perf_jit_map.hpp)
+    bool emitPerfMap = false;               // Append kernel symbols to /tmp/perf-<pid>.map
+    bool emitJitDump = false;               // Write jitdump records (jit-<pid>.dump) for perf inject --jit
+    size_t perfNodesPerSymbol = 0;          // >0: one symbol per this many forward nodes instead of one per kernel
+    size_t profileNodesPerGroup = 0;        // >0: count cycles per group of this many forward nodes (see kernel_profile.hpp)
+    bool collectCompileStats = false;       // Record per-phase compile time and memory (ForgeEngine::getLastCompileStats)
     
     // Instruction set selection (extensible for future additions)
     enum class InstructionSet {
@@ -87,7 +107,9 @@ struct CompilerConfig {
      * @brief Load configuration from FORGE_INSTRUCTION_SET environment variable
      *
      * Reads the environment to override instruction set selection at runtime.
-     * Supported values: "SSE2" or "SSE2-Scalar", "AVX2" or "AVX2-Packed"
+     * Supported values: "SSE2" or "SSE2-Scalar", "AVX2" or "AVX2-Packed".
+     * FORGE_PERF_MAP, FORGE_JITDUMP and FORGE_PERF_NODES_PER_SYMBOL enable perf
+     * symbols without code changes.
      */
     void loadFromEnvironment() {
         // Check for FORGE_INSTRUCTION_SET environment variable
@@ -100,6 +122,13 @@ struct CompilerConfig {
             // else if (val == "SSE2-Packed") instructionSet = InstructionSet::SSE2_PACKED;
             // else if (val == "AVX512-Packed") instructionSet = InstructionSet::AVX512_PACKED;
         }
+
+        // Profiling: FORGE_PERF_MAP=1, FORGE_JITDUMP=1, FORGE_PERF_NODES_PER_SYMBOL=<n>
+        if (const char* perfMap = std::getenv("FORGE_PERF_MAP")) emitPerfMap = *perfMap && std::string(perfMap) != "0";
+        if (const char* jitDump = std::getenv("FORGE_JITDUMP")) emitJitDump = *jitDump && std::string(jitDump) != "0";
+        if (const char* nodes = std::getenv("FORGE_PERF_NODES_PER_SYMBOL")) {
+            perfNodesPerSymbol = static_cast<size_t>(std::strtoull(nodes, nullptr, 10));
+        }
     }
 
     /** @brief Create default production configuration with only stability cleaning enabled */
@@ -136,6 +165,9 @@ struct CompilerConfig {
         config.enableCSE = false;
         config.enableAlgebraicSimplification = false;
         config.enableStabilityCleaning = false;
+        config.enableOutputPruning = false;
+        config.enableForwardOnlyStores = false;
+        config.enableUniformHoisting = false;
         config.maxOptimizationPasses = 0;
         return config;
     }
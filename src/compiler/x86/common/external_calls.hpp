@@ -0,0 +1,50 @@
+#pragma once
+
+#include <asmjit/x86.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace forge {
+
+// Records where kernels call external functions while a kernel is being
+// forged for export (CompilerConfig::enableKernelExport). Each entry is the
+// code offset of the 64-bit function address loaded by emitExternalCall(),
+// which saveKernelObject() turns into an import-table load.
+class ExternalCallRecorder {
+public:
+    ExternalCallRecorder() : previous_(current()) { current() = this; }
+    ~ExternalCallRecorder() { current() = previous_; }
+
+    ExternalCallRecorder(const ExternalCallRecorder&) = delete;
+    ExternalCallRecorder& operator=(const ExternalCallRecorder&) = delete;
+
+    const std::vector<size_t>& sites() const { return sites_; }
+    void record(size_t immediateOffset) { sites_.push_back(immediateOffset); }
+
+    // Recorder active on this thread, nullptr if none
+    static ExternalCallRecorder*& current() {
+        static thread_local ExternalCallRecorder* recorder = nullptr;
+        return recorder;
+    }
+
+private:
+    ExternalCallRecorder* previous_;
+    std::vector<size_t> sites_;
+};
+
+// Call a function outside the kernel through RAX (clobbers RAX only; the
+// caller handles argument registers, stack alignment and volatile registers).
+// While recording, the address is always emitted as a full 64-bit immediate
+// so it can be rewritten in place.
+inline void emitExternalCall(asmjit::x86::Assembler& a, uint64_t functionPtr) {
+    if (ExternalCallRecorder* recorder = ExternalCallRecorder::current()) {
+        a.long_().mov(asmjit::x86::rax, functionPtr);  // REX.W B8+r imm64
+        recorder->record(a.offset() - sizeof(uint64_t));
+    } else {
+        a.mov(asmjit::x86::rax, functionPtr);
+    }
+    a.call(asmjit::x86::rax);
+}
+
+} // namespace forge
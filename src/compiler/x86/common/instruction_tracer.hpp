@@ -30,7 +30,8 @@ namespace forge {
  * @brief Helper for emitting safe runtime tracing in JIT code
  *
  * This class generates inline assembly code that captures register values
- * and operation metadata into a global trace buffer at runtime. It provides:
+ * and operation metadata into the executing thread's trace ring at runtime
+ * (see TraceBuffer). It provides:
  *
  * - Safe register usage (saves/restores all modified registers)
  * - Support for both SSE2 (XMM, 128-bit) and AVX2 (YMM, 256-bit) registers
@@ -42,7 +43,8 @@ namespace forge {
  * - Never modifies the original register being traced
  * - Uses dedicated temporary registers (XMM15/YMM15)
  * - Direct memory writes instead of function calls
- * - Circular buffer with atomic index management
+ * - Per-thread rings found through the thread pointer; the shared fallback
+ *   ring claims slots with lock xadd
  *
  * API Stability: Stable - interface won't change
  *
@@ -147,33 +149,46 @@ public:
             a.movaps(tempReg, liveReg);
         }
 
-        // 3) Store directly to the global trace buffer using atomic index
+        // 3) Store directly to the calling thread's trace ring
         asmjit::Label skipTrace = a.newLabel();
+        asmjit::Label sharedRing = a.newLabel();
+        asmjit::Label haveSlot = a.newLabel();
 
         // Save registers we're about to use
         a.push(rax);
         a.push(rcx);
         a.push(rdx);
 
-        // Calculate buffer index atomically (simple increment)
-        a.mov(rcx, asmjit::imm((uint64_t)&g_traceBuffer.index));
-        a.mov(edx, asmjit::x86::dword_ptr(rcx));  // Load current index (32-bit)
-        a.mov(rax, rdx);                           // Save current index in RAX
-        a.inc(edx);                                // Increment for next record
-        a.mov(asmjit::x86::dword_ptr(rcx), edx);  // Store back
+        // Private ring through the thread pointer: only its owner writes the
+        // index, so a plain increment suffices
+        int64_t ringSlotOffset = 0;
+        if (getThreadTraceBufferOffset(ringSlotOffset)) {
+            asmjit::x86::Mem ringSlot = asmjit::x86::qword_ptr(rcx);
+            ringSlot.setSegment(fs);
+            a.mov(rcx, asmjit::imm(ringSlotOffset));
+            a.mov(rcx, ringSlot);                      // Thread's TraceBuffer* (null if none)
+            a.test(rcx, rcx);
+            a.jz(sharedRing);
+            a.mov(eax, asmjit::x86::dword_ptr(rcx, offsetof(TraceBuffer, index)));  // Load current index
+            a.mov(edx, eax);
+            a.inc(edx);                                // Increment for next record
+            a.mov(asmjit::x86::dword_ptr(rcx, offsetof(TraceBuffer, index)), edx);  // Store back
+            a.jmp(haveSlot);
+        }
 
-        // Calculate buffer position: (index & mask) * sizeof(TraceRecord)
-        a.mov(rcx, asmjit::imm((uint64_t)&g_traceBuffer.mask));
-        a.mov(ecx, asmjit::x86::dword_ptr(rcx));   // Load mask (32-bit)
-        a.and_(eax, ecx);                           // (saved_index & mask) in EAX
-        a.mov(rdx, rax);                            // Move masked index to RDX
+        // Shared ring: claim the index atomically (EAX = claimed index)
+        a.bind(sharedRing);
+        a.mov(rcx, asmjit::imm((uint64_t)&g_traceBuffer));
+        a.mov(eax, 1);
+        a.lock().xadd(asmjit::x86::dword_ptr(rcx, offsetof(TraceBuffer, index)), eax);
 
-        // Calculate offset: rdx * sizeof(TraceRecord)
-        a.imul(rdx, rdx, sizeof(TraceRecord));
+        // Calculate buffer position: (index & mask) * sizeof(TraceRecord)
+        a.bind(haveSlot);
+        a.and_(eax, asmjit::x86::dword_ptr(rcx, offsetof(TraceBuffer, mask)));  // Also clears RAX[63:32]
+        a.imul(rdx, rax, sizeof(TraceRecord));
 
         // Get pointer to the record
-        a.mov(rcx, asmjit::imm((uint64_t)&g_traceBuffer.records));
-        a.mov(rcx, asmjit::x86::qword_ptr(rcx));  // Load records pointer
+        a.mov(rcx, asmjit::x86::qword_ptr(rcx, offsetof(TraceBuffer, records)));  // Load records pointer
         a.add(rcx, rdx);  // rcx now points to the TraceRecord
 
         // Store metadata
@@ -11,6 +11,15 @@ namespace {
         static std::unordered_map<int, NodeValueBufferFactory::BufferCreatorFunc> registry;
         return registry;
     }
+
+    // Lane-blocked kernels (CompilerConfig::laneBlocks) keep several vectors per
+    // node; the layout is still getVectorWidth() contiguous doubles per node
+    template<int Width>
+    std::unique_ptr<INodeValueBuffer> createLaneBlockBuffer(const forge::Graph& optimizedTape,
+                                                            const std::vector<forge::NodeId>& mapping,
+                                                            size_t requiredNodes) {
+        return std::make_unique<NodeValueBufferBase<Width, 32>>(optimizedTape, mapping, requiredNodes);
+    }
 }
 
 void NodeValueBufferFactory::registerBufferCreator(int vectorWidth, BufferCreatorFunc creator) {
@@ -53,14 +62,24 @@ std::unique_ptr<INodeValueBuffer> NodeValueBufferFactory::create(
 
     // Scalar (vectorWidth == 1) is always available
     if (vectorWidth == 1) {
-        return std::make_unique<ScalarNodeValueBuffer>(optimizedTape, mapping);
+        auto buffer = std::make_unique<ScalarNodeValueBuffer>(optimizedTape, mapping);
+        buffer->setLiveIns(kernel.getLiveIns());
+        return buffer;
     }
 
     // Look up registered buffer creator for this vector width
     auto& registry = getBufferCreatorRegistry();
     auto it = registry.find(vectorWidth);
     if (it != registry.end() && it->second != nullptr) {
-        return it->second(optimizedTape, mapping, requiredNodes);
+        auto buffer = it->second(optimizedTape, mapping, requiredNodes);
+        buffer->setLiveIns(kernel.getLiveIns());
+        return buffer;
+    }
+    if (vectorWidth == 8 || vectorWidth == 16) {
+        auto buffer = vectorWidth == 8 ? createLaneBlockBuffer<8>(optimizedTape, mapping, requiredNodes)
+                                       : createLaneBlockBuffer<16>(optimizedTape, mapping, requiredNodes);
+        buffer->setLiveIns(kernel.getLiveIns());
+        return buffer;
     }
 
     throw std::runtime_error(
@@ -1,4 +1,5 @@
 #include "x86_instruction_set_base.hpp"
+#include "external_calls.hpp"
 
 namespace forge {
 
@@ -33,11 +34,8 @@ void X86InstructionSetBase::endFunctionCall(asmjit::x86::Assembler& a) const {
 }
 
 void X86InstructionSetBase::callFunctionAndInvalidate(asmjit::x86::Assembler& a, uint64_t functionPtr, IRegisterAllocator& regState) const {
-    // Move function pointer to RAX
-    a.mov(asmjit::x86::rax, functionPtr);
-    
-    // Call the function
-    a.call(asmjit::x86::rax);
+    // Call through RAX (recorded for kernel export)
+    emitExternalCall(a, functionPtr);
     
     // Invalidate volatile registers (crucial for register allocator)
     regState.invalidateVolatileRegisters();
@@ -36,6 +36,13 @@ protected:
     // Call a function pointer and invalidate volatile registers
     void callFunctionAndInvalidate(asmjit::x86::Assembler& a, uint64_t functionPtr, IRegisterAllocator& regState) const;
 
+    // Byte offset of a node's first vector (nodes span getVectorWidth() * getLaneBlocks() doubles)
+    int64_t nodeOffset(forge::NodeId nodeId) const {
+        return static_cast<int64_t>(nodeId) * getVectorWidth() * laneBlocks_ * static_cast<int64_t>(sizeof(double));
+    }
+
+    int laneBlocks_ = 1;
+
 public:
     // Common prologue/epilogue implementation (extracted from working SSE2 code)
     void emitPrologue(asmjit::x86::Assembler& a) override;
@@ -44,6 +51,7 @@ public:
     void emitRestoreCalleeRegisters(asmjit::x86::Assembler& a) override;
     void emitMoveArgsToRegisters(asmjit::x86::Assembler& a) override;
     int getStackSpaceNeeded() const override;
+    int getLaneBlocks() const override { return laneBlocks_; }
 };
 
 } // namespace forge
\ No newline at end of file
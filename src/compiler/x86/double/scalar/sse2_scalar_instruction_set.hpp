@@ -17,6 +17,29 @@ struct ConstantInfo {
     double value;       // The constant value
 };
 
+// Fused sine/cosine helpers called from emitSinCos: return one result and
+// write the other through the pointer (the kernel passes a value slot)
+inline void scalarSinCos(double x, double* sinOut, double* cosOut) {
+#if defined(__GLIBC__) && defined(_GNU_SOURCE)
+    ::sincos(x, sinOut, cosOut);  // Single argument reduction
+#else
+    *sinOut = std::sin(x);
+    *cosOut = std::cos(x);
+#endif
+}
+
+inline double scalarSinStoreCos(double x, double* cosOut) {
+    double sinValue;
+    scalarSinCos(x, &sinValue, cosOut);
+    return sinValue;
+}
+
+inline double scalarCosStoreSin(double x, double* sinOut) {
+    double cosValue;
+    scalarSinCos(x, sinOut, &cosValue);
+    return cosValue;
+}
+
 // SSE2 Scalar instruction set implementation
 // This uses SSE2 instructions but only processes ONE double at a time (scalar operations)
 // The 'sd' suffix in instructions like 'addsd', 'mulsd' means 'Scalar Double'
@@ -282,6 +305,26 @@ public:
         tracer.emitTraceXMM(a, getRegister(dstReg), OperationType::TAN, 1, -1, srcReg, dstReg);
     }
     
+    void emitSinCos(asmjit::x86::Assembler& a, int dstReg, int srcReg, forge::NodeId otherSlot,
+                    bool cosToDst, IRegisterAllocator& regState) override {
+        a.movsd(asmjit::x86::xmm0, getRegister(srcReg));
+        beginFunctionCall(a);
+        // Second argument: address of the slot receiving the other result (RDI = values)
+        auto slot = asmjit::x86::ptr(asmjit::x86::rdi, static_cast<int32_t>(otherSlot * sizeof(double)));
+#ifdef _WIN32
+        a.lea(asmjit::x86::rdx, slot);
+#else
+        a.lea(asmjit::x86::rdi, slot);  // RDI itself was saved by beginFunctionCall
+#endif
+        auto helper = cosToDst ? &scalarCosStoreSin : &scalarSinStoreCos;
+        callFunctionAndInvalidate(a, reinterpret_cast<uint64_t>(helper), regState);
+        endFunctionCall(a);
+        a.movsd(getRegister(dstReg), asmjit::x86::xmm0);
+        
+        // Trace the result kept in the register
+        tracer.emitTraceXMM(a, getRegister(dstReg), cosToDst ? OperationType::COS : OperationType::SIN, 1, -1, srcReg, dstReg);
+    }
+    
     // Simplified pow implementation - use base class pattern too
     void emitPow(asmjit::x86::Assembler& a, int dstReg, int baseReg, int expReg, IRegisterAllocator& regState) override {
         // Handle register conflicts when moving to XMM0 and XMM1 (same logic as before)
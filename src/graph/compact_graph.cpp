@@ -0,0 +1,144 @@
+#include "compact_graph.hpp"
+#include <algorithm>
+
+namespace forge {
+
+template <typename T>
+const T* CompactGraph::findSparse(const std::vector<std::pair<NodeId, T>>& column, NodeId id) {
+    auto it = std::lower_bound(column.begin(), column.end(), id,
+                               [](const std::pair<NodeId, T>& entry, NodeId key) { return entry.first < key; });
+    return (it != column.end() && it->first == id) ? &it->second : nullptr;
+}
+
+template <typename T>
+void CompactGraph::setSparse(std::vector<std::pair<NodeId, T>>& column, NodeId id, T value) {
+    // Appending in ID order (the common case while building) stays O(1)
+    if (column.empty() || column.back().first < id) {
+        if (value != T{}) column.emplace_back(id, value);
+        return;
+    }
+    auto it = std::lower_bound(column.begin(), column.end(), id,
+                               [](const std::pair<NodeId, T>& entry, NodeId key) { return entry.first < key; });
+    if (it != column.end() && it->first == id) {
+        if (value != T{}) {
+            it->second = value;
+        } else {
+            column.erase(it);
+        }
+    } else if (value != T{}) {
+        column.insert(it, {id, value});
+    }
+}
+
+CompactGraph CompactGraph::fromGraph(const Graph& graph) {
+    CompactGraph result;
+    result.reserve(graph.nodes.size());
+    size_t immCount = 0;
+    size_t flagCount = 0;
+    for (const Node& node : graph.nodes) {
+        immCount += node.imm != 0.0;
+        flagCount += node.flags != 0;
+    }
+    result.imm_.reserve(immCount);
+    result.flags_.reserve(flagCount);
+    for (const Node& node : graph.nodes) {
+        result.addNode(node);
+    }
+    result.constPool = graph.constPool;
+    result.outputs = graph.outputs;
+    result.diff_inputs = graph.diff_inputs;
+    result.functions = graph.functions;
+    return result;
+}
+
+Graph CompactGraph::toGraph() const {
+    Graph graph;
+    graph.nodes.reserve(size());
+    for (NodeId id = 0; id < size(); ++id) {
+        graph.nodes.push_back(node(id));
+    }
+    graph.constPool = constPool;
+    graph.outputs = outputs;
+    graph.diff_inputs = diff_inputs;
+    graph.functions = functions;
+    return graph;
+}
+
+NodeId CompactGraph::addNode(const Node& node) {
+    NodeId id = static_cast<NodeId>(op_.size());
+    op_.push_back(node.op);
+    a_.push_back(0);
+    b_.push_back(0);
+    c_.push_back(0);
+    state_.push_back(0);
+    setNode(id, node);
+    return id;
+}
+
+void CompactGraph::reserve(size_t count) {
+    op_.reserve(count);
+    a_.reserve(count);
+    b_.reserve(count);
+    c_.reserve(count);
+    state_.reserve(count);
+}
+
+void CompactGraph::clear() {
+    op_.clear();
+    a_.clear();
+    b_.clear();
+    c_.clear();
+    state_.clear();
+    imm_.clear();
+    flags_.clear();
+    constPool.clear();
+    outputs.clear();
+    diff_inputs.clear();
+    functions.clear();
+}
+
+Node CompactGraph::node(NodeId id) const {
+    Node node{};
+    node.op = op_[id];
+    node.dst = id;
+    node.a = a_[id];
+    node.b = b_[id];
+    node.c = c_[id];
+    node.flags = flags(id);
+    node.imm = imm(id);
+    node.isActive = isActive(id);
+    node.isDead = isDead(id);
+    node.needsGradient = needsGradient(id);
+    return node;
+}
+
+void CompactGraph::setNode(NodeId id, const Node& node) {
+    op_[id] = node.op;
+    a_[id] = node.a;
+    b_[id] = node.b;
+    c_[id] = node.c;
+    state_[id] = (node.isActive ? kActive : 0) | (node.isDead ? kDead : 0) |
+                 (node.needsGradient ? kNeedsGradient : 0);
+    setSparse(imm_, id, node.imm);
+    setSparse(flags_, id, node.flags);
+}
+
+double CompactGraph::imm(NodeId id) const {
+    const double* value = findSparse(imm_, id);
+    return value ? *value : 0.0;
+}
+
+uint32_t CompactGraph::flags(NodeId id) const {
+    const uint32_t* value = findSparse(flags_, id);
+    return value ? *value : 0u;
+}
+
+size_t CompactGraph::nodeBytes() const {
+    return op_.capacity() * sizeof(OpCode) +
+           (a_.capacity() + b_.capacity() + c_.capacity()) * sizeof(NodeId) +
+           state_.capacity() * sizeof(uint8_t) +
+           imm_.capacity() * sizeof(imm_[0]) +
+           flags_.capacity() * sizeof(flags_[0]);
+}
+
+} // namespace forge
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "graph.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace forge {
+
+/**
+ * Struct-of-arrays node storage for very large tapes
+ *
+ * A forge::Node occupies 40 bytes, although dst is always its own index,
+ * imm is only meaningful for constants and flags are almost always zero.
+ * CompactGraph keeps one column per field instead:
+ * - op:       2 bytes per node
+ * - a, b, c:  4 bytes each per node
+ * - state:    1 byte per node (isActive / isDead / needsGradient bits)
+ * - imm and flags: sparse, only for nodes where they are non-zero
+ *
+ * That is 15 bytes per node plus 16 per constant (recording with
+ * Graph::setInterning keeps constants few); a pass reading only opcodes and
+ * operands would stream 14 bytes per node instead of 40.
+ *
+ * This is the storage adapter only: no optimizer or compiler pass runs on
+ * it yet, so nothing in the pipeline saves memory or bandwidth from it.
+ * fromGraph()/toGraph() convert at the boundary, node()/setNode()
+ * materialize a forge::Node, and the column accessors are for passes that
+ * are later moved onto the columns (converting once, not per pass).
+ */
+class CompactGraph {
+public:
+    std::vector<double> constPool;
+    std::vector<NodeId> outputs;
+    std::vector<NodeId> diff_inputs;
+    std::vector<Graph> functions;  // Bodies for Call nodes (kept as whole graphs)
+
+    CompactGraph() = default;
+
+    static CompactGraph fromGraph(const Graph& graph);
+    Graph toGraph() const;
+
+    NodeId addNode(const Node& node);
+    void reserve(size_t count);
+    void clear();
+
+    size_t size() const { return op_.size(); }
+    bool empty() const { return op_.empty(); }
+
+    // Whole-node adapter
+    Node node(NodeId id) const;
+    void setNode(NodeId id, const Node& node);
+
+    // Column accessors
+    OpCode op(NodeId id) const { return op_[id]; }
+    NodeId a(NodeId id) const { return a_[id]; }
+    NodeId b(NodeId id) const { return b_[id]; }
+    NodeId c(NodeId id) const { return c_[id]; }
+    bool isActive(NodeId id) const { return (state_[id] & kActive) != 0; }
+    bool isDead(NodeId id) const { return (state_[id] & kDead) != 0; }
+    bool needsGradient(NodeId id) const { return (state_[id] & kNeedsGradient) != 0; }
+    double imm(NodeId id) const;
+    uint32_t flags(NodeId id) const;
+
+    void setDead(NodeId id, bool dead) { setBit(id, kDead, dead); }
+    void setNeedsGradient(NodeId id, bool needs) { setBit(id, kNeedsGradient, needs); }
+
+    const std::vector<OpCode>& ops() const { return op_; }
+
+    /**
+     * Heap bytes held by the node columns (excluding constPool/outputs/functions)
+     */
+    size_t nodeBytes() const;
+
+private:
+    static constexpr uint8_t kActive = 1u << 0;
+    static constexpr uint8_t kDead = 1u << 1;
+    static constexpr uint8_t kNeedsGradient = 1u << 2;
+
+    void setBit(NodeId id, uint8_t bit, bool value) {
+        state_[id] = value ? (state_[id] | bit) : (state_[id] & ~bit);
+    }
+
+    // Sparse columns: (node, value) pairs sorted by node ID
+    template <typename T>
+    static const T* findSparse(const std::vector<std::pair<NodeId, T>>& column, NodeId id);
+    template <typename T>
+    static void setSparse(std::vector<std::pair<NodeId, T>>& column, NodeId id, T value);
+
+    std::vector<OpCode> op_;
+    std::vector<NodeId> a_;
+    std::vector<NodeId> b_;
+    std::vector<NodeId> c_;
+    std::vector<uint8_t> state_;
+    std::vector<std::pair<NodeId, double>> imm_;
+    std::vector<std::pair<NodeId, uint32_t>> flags_;
+};
+
+} // namespace forge
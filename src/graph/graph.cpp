@@ -1,15 +1,82 @@
 #include "graph.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
 
 namespace forge {
 
+namespace {
+
+uint64_t bitsOf(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+} // namespace
+
+size_t Graph::NodeKeyHash::operator()(const NodeKey& key) const {
+    uint64_t h = static_cast<uint64_t>(key.op);
+    h = h * 0x9E3779B97F4A7C15ull ^ key.a;
+    h = h * 0x9E3779B97F4A7C15ull ^ key.b;
+    h = h * 0x9E3779B97F4A7C15ull ^ key.c;
+    h = h * 0x9E3779B97F4A7C15ull ^ key.imm;
+    return static_cast<size_t>(h ^ (h >> 32));
+}
+
+// Unused operand fields are not normalized by callers, so mask them here
+Graph::NodeKey Graph::keyOf(const Node& node) {
+    const int count = operandCount(node.op);
+    return {node.op,
+            count > 0 ? node.a : UINT32_MAX,
+            count > 1 ? node.b : UINT32_MAX,
+            count > 2 ? node.c : UINT32_MAX,
+            bitsOf(node.imm)};
+}
+
 NodeId Graph::addNode(const Node& node) {
-    NodeId id = static_cast<NodeId>(nodes.size());
-    nodes.push_back(node);
-    nodes.back().dst = id;
+    const bool intern = interning_ && node.op != OpCode::Input;
+    NodeKey key{};
+    if (intern) {
+        key = keyOf(node);
+        auto it = nodeTable_.find(key);
+        // Table entries are re-validated: the graph may have been edited directly
+        if (it != nodeTable_.end() && it->second < size()) {
+            const Node& existing = this->node(it->second);
+            if (!existing.isDead && keyOf(existing) == key && existing.flags == node.flags &&
+                existing.isActive == node.isActive && existing.needsGradient == node.needsGradient) {
+                return it->second;
+            }
+        }
+    }
+    
+    NodeId id = static_cast<NodeId>(size());
+    if (segmented_) {
+        arena_.push_back(node);
+        arena_.back().dst = id;
+    } else {
+        nodes.push_back(node);
+        nodes.back().dst = id;
+    }
+    if (intern) {
+        nodeTable_[key] = id;
+    }
     return id;
 }
 
 NodeId Graph::addConstant(double value) {
+    if (interning_) {
+        auto it = constantTable_.find(bitsOf(value));
+        if (it != constantTable_.end() && it->second < size()) {
+            const Node& existing = node(it->second);
+            size_t index = static_cast<size_t>(existing.imm);
+            if (existing.op == OpCode::Constant && !existing.isDead &&
+                index < constPool.size() && bitsOf(constPool[index]) == bitsOf(value)) {
+                return it->second;
+            }
+        }
+    }
+    
     size_t constIndex = constPool.size();
     constPool.push_back(value);
     
@@ -17,7 +84,11 @@ NodeId Graph::addConstant(double value) {
     node.op = OpCode::Constant;
     node.imm = static_cast<double>(constIndex);
     node.isActive = false;  // Constants never depend on inputs
-    return addNode(node);
+    NodeId id = addNode(node);
+    if (interning_) {
+        constantTable_[bitsOf(value)] = id;
+    }
+    return id;
 }
 
 NodeId Graph::addInput() {
@@ -31,11 +102,100 @@ void Graph::markOutput(NodeId node) {
     outputs.push_back(node);
 }
 
+void Graph::markUniform(NodeId input) {
+    if (input < size() && node(input).op == OpCode::Input) {
+        node(input).flags |= NodeFlags::Uniform;
+    }
+}
+
+NodeId Graph::addCall(uint32_t function, const std::vector<NodeId>& args) {
+    if (function >= functions.size()) {
+        throw std::runtime_error("Graph::addCall: unknown function");
+    }
+    const Graph& body = functions[function];
+    size_t params = 0;
+    for (const Node& node : body.nodes) {
+        params += node.op == OpCode::Input;
+    }
+    if (args.empty() || args.size() != params) {
+        throw std::runtime_error("Graph::addCall: argument count does not match the function's parameters");
+    }
+    
+    // Call-family nodes are never folded: the optimizer cannot evaluate a body
+    bool needsGrad = false;
+    for (NodeId arg : args) {
+        if (arg >= size()) {
+            throw std::runtime_error("Graph::addCall: argument is not a node of this graph");
+        }
+        needsGrad = needsGrad || node(arg).needsGradient;
+    }
+    NodeId previous = UINT32_MAX;
+    for (NodeId arg : args) {
+        Node entry{};
+        entry.op = OpCode::CallArg;
+        entry.a = arg;
+        entry.b = previous;
+        entry.needsGradient = needsGrad;
+        previous = addNode(entry);
+    }
+    
+    Node call{};
+    call.op = OpCode::Call;
+    call.a = previous;
+    call.imm = static_cast<double>(function);
+    call.needsGradient = needsGrad;
+    return addNode(call);
+}
+
+NodeId Graph::addCallResult(NodeId call, uint32_t index) {
+    if (call >= size() || node(call).op != OpCode::Call) {
+        throw std::runtime_error("Graph::addCallResult: not a Call node");
+    }
+    const Graph& body = functions[static_cast<size_t>(node(call).imm)];
+    if (index == 0 || index >= body.outputs.size()) {
+        throw std::runtime_error("Graph::addCallResult: result index out of range");
+    }
+    Node result{};
+    result.op = OpCode::CallResult;
+    result.a = call;
+    result.imm = static_cast<double>(index);
+    result.needsGradient = node(call).needsGradient;
+    return addNode(result);
+}
+
+std::vector<NodeId> Graph::callArguments(NodeId call) const {
+    std::vector<NodeId> args;
+    for (NodeId id = node(call).a; id < size() && node(id).op == OpCode::CallArg; id = node(id).b) {
+        args.push_back(node(id).a);
+    }
+    std::reverse(args.begin(), args.end());
+    return args;
+}
+
+void Graph::setInterning(bool enable) {
+    interning_ = enable;
+    if (!enable) {
+        constantTable_ = {};
+        nodeTable_ = {};
+    }
+}
+
+void Graph::setSegmentedStorage(bool enable) {
+    segmented_ = enable;
+    if (!enable) {
+        arena_.takeInto(nodes);
+    }
+}
+
 void Graph::clear() {
     nodes.clear();
+    arena_.clear();
     constPool.clear();
     outputs.clear();
     diff_inputs.clear();
+    functions.clear();
+    constantTable_.clear();
+    nodeTable_.clear();
 }
 
 } // namespace forge
\ No newline at end of file
@@ -1,7 +1,9 @@
 #pragma once
 
+#include "node_arena.hpp"
 #include <cstddef>
 #include <cstdint>
+#include <unordered_map>
 #include <vector>
 
 namespace forge {
@@ -69,9 +71,53 @@ enum class OpCode : uint16_t {
     IntIf,         // Bool ? Int : Int
     
     // Array indexing
-    ArrayIndex     // Double array[fint index] - dynamic array access
+    ArrayIndex,    // Double array[fint index] - dynamic array access
+    
+    // Subgraph functions (Graph::functions)
+    Call,          // Calls functions[imm]; a = last CallArg; value is the first result
+    CallArg,       // Argument list entry: a = value, b = previous CallArg (UINT32_MAX for the first)
+    CallResult     // Result imm of Call a (imm >= 1; result 0 is the Call node itself)
 };
 
+// Number of operand fields (a, b, c) an opcode actually reads.
+// Unused operand fields are not guaranteed to be UINT32_MAX (default-initialized
+// nodes leave them at 0), so graph walks must go through this instead of
+// testing the fields directly.
+inline int operandCount(OpCode op) {
+    switch (op) {
+        case OpCode::Input:
+        case OpCode::Constant:
+        case OpCode::BoolConstant:
+        case OpCode::IntConstant:
+            return 0;
+        case OpCode::Neg:
+        case OpCode::Abs:
+        case OpCode::Square:
+        case OpCode::Recip:
+        case OpCode::Exp:
+        case OpCode::Log:
+        case OpCode::Sqrt:
+        case OpCode::Sin:
+        case OpCode::Cos:
+        case OpCode::Tan:
+        case OpCode::BoolNot:
+        case OpCode::IntNeg:
+        case OpCode::Call:
+        case OpCode::CallResult:
+            return 1;
+        case OpCode::If:
+        case OpCode::IntIf:
+            return 3;
+        default:
+            return 2;
+    }
+}
+
+// Node::flags bits
+namespace NodeFlags {
+constexpr uint32_t Uniform = 1u << 0;  // Input holds the same value in every lane (Graph::markUniform)
+}
+
 struct Node {
     OpCode op;
     NodeId dst{};
@@ -91,14 +137,63 @@ struct Graph {
     std::vector<NodeId> outputs;
     std::vector<NodeId> diff_inputs;  // AAD: Inputs marked for differentiation
     
+    // Subgraph function bodies, recorded once and called from Call nodes. A body's
+    // Input nodes are its parameters in ID order and its outputs are its results;
+    // bodies cannot call other functions.
+    std::vector<Graph> functions;
+    
     NodeId addNode(const Node& node);
     NodeId addConstant(double value);
     NodeId addInput();
     void markOutput(NodeId node);
+    void markUniform(NodeId input);  // Input is identical across scenarios/lanes
+    
+    // Call functions[function] with one argument per body parameter; returns the
+    // Call node (first result). Further results come from addCallResult().
+    NodeId addCall(uint32_t function, const std::vector<NodeId>& args);
+    NodeId addCallResult(NodeId call, uint32_t index);
+    std::vector<NodeId> callArguments(NodeId call) const;  // In parameter order
+    
+    // Record-time hash-consing (off by default). While enabled, addConstant()
+    // reuses the node of a bit-identical value and addNode() returns an existing
+    // node with the same opcode, operands, immediate and flags instead of
+    // appending a duplicate. Inputs are never merged. Disabling drops the tables.
+    void setInterning(bool enable);
+    bool interningEnabled() const { return interning_; }
+    
+    // Segmented recording storage (off by default). While enabled, new nodes go
+    // into a NodeArena instead of `nodes` and must be reached through node(id);
+    // disabling moves them into `nodes` in one exact-size allocation.
+    void setSegmentedStorage(bool enable);
+    bool segmentedStorageEnabled() const { return segmented_; }
+    
+    // Node access valid in both storage modes
+    Node& node(NodeId id) { return id < nodes.size() ? nodes[id] : arena_[id - nodes.size()]; }
+    const Node& node(NodeId id) const { return id < nodes.size() ? nodes[id] : arena_[id - nodes.size()]; }
     
     void clear();
-    bool empty() const { return nodes.empty(); }
-    size_t size() const { return nodes.size(); }
+    bool empty() const { return size() == 0; }
+    size_t size() const { return nodes.size() + arena_.size(); }
+
+private:
+    struct NodeKey {
+        OpCode op;
+        NodeId a, b, c;
+        uint64_t imm;
+        bool operator==(const NodeKey& other) const {
+            return op == other.op && a == other.a && b == other.b && c == other.c && imm == other.imm;
+        }
+    };
+    struct NodeKeyHash {
+        size_t operator()(const NodeKey& key) const;
+    };
+    static NodeKey keyOf(const Node& node);
+    
+    bool interning_ = false;
+    bool segmented_ = false;
+    NodeArena arena_;  // Nodes recorded after `nodes` while segmented_
+    std::unordered_map<uint64_t, NodeId> constantTable_;  // Value bits -> Constant node
+    std::unordered_map<NodeKey, NodeId, NodeKeyHash> nodeTable_;
 };
 
 } // namespace forge
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <iomanip>
 #include <chrono>
+#include <utility>
 
 namespace forge {
 
@@ -31,232 +32,75 @@ GraphOptimizer::GraphOptimizer() {
 }
 
 forge::Graph GraphOptimizer::optimize(const forge::Graph& input) {
+    return optimizeWithMapping(input).optimizedTape;
+}
+
+GraphOptimizer::OptimizationResult GraphOptimizer::optimizeWithMapping(const forge::Graph& input) {
+    return optimizeWithMapping(GraphView::of(input));
+}
+
+GraphOptimizer::OptimizationResult GraphOptimizer::optimizeWithMapping(const forge::GraphView& input) {
     using Clock = std::chrono::high_resolution_clock;
     using Duration = std::chrono::duration<double, std::milli>;
     
     stats_.clear();
-    stats_.originalNodeCount = input.nodes.size();
+    stats_.originalNodeCount = input.nodeCount;
     
-    forge::Graph current = input;  // Copy constructor
+    // The only full copy: every pass below rewrites 'current' in place
+    forge::Graph current = input.toGraph();
+    optimizations::GraphRewriter rewriter(current);
     
     // Timing for individual optimization passes
     double inactiveFoldingTime = 0.0;
     double cseTime = 0.0;
     double algebraicTime = 0.0;
     double stabilityTime = 0.0;
-    double deadCodeTime = 0.0;
     
     auto totalOptStart = Clock::now();
     
-    // IMPORTANT: Apply stability cleaning BEFORE any other optimization
-    // This ensures 1/exp(x) patterns are transformed to exp(-x) before constant folding
-    if (config_.enableStabilityCleaning) {
+    // Run one rule over the nodes of the current worklist generation
+    using Rule = bool (*)(optimizations::GraphRewriter&, forge::NodeId, OptimizationStats&);
+    auto sweep = [&](Rule rule, double& timeMs) {
         auto start = Clock::now();
-        current = optimizations::StabilityCleaning::apply(current, stats_);
-        Duration elapsed = Clock::now() - start;
-        stabilityTime += elapsed.count();
-    }
-    
-    // Apply optimization passes - up to maxOptimizationPasses iterations
-    // Each pass is O(n), so total is O(k*n) where k = maxOptimizationPasses
-    for (int pass = 0; pass < config_.maxOptimizationPasses; ++pass) {
-        size_t changesMadeThisPass = 0;
-        size_t previousFolded = stats_.inactiveNodesFolded;
-        size_t previousCSE = stats_.duplicatesEliminated;
-        size_t previousSimplified = stats_.algebraicSimplifications;
-        size_t previousStability = stats_.stabilityFixes;
-        
-        if (config_.enableInactiveFolding) {
-            auto start = Clock::now();
-            current = optimizations::InactiveFolding::apply(current, stats_);
-            Duration elapsed = Clock::now() - start;
-            inactiveFoldingTime += elapsed.count();
-            changesMadeThisPass += (stats_.inactiveNodesFolded - previousFolded);
-            if (config_.printStepByStepDebug) {
-                printGraphDebug(current, "After Inactive Folding");
-            }
-        }
-        
-        if (config_.enableCSE) {
-            auto start = Clock::now();
-            current = optimizations::CommonSubexpressionElimination::apply(current, stats_);
-            Duration elapsed = Clock::now() - start;
-            cseTime += elapsed.count();
-            changesMadeThisPass += (stats_.duplicatesEliminated - previousCSE);
-            if (config_.printStepByStepDebug) {
-                printGraphDebug(current, "After CSE");
-            }
-        }
-        
-        if (config_.enableAlgebraicSimplification) {
-            auto start = Clock::now();
-            current = optimizations::AlgebraicSimplification::apply(current, stats_);
-            Duration elapsed = Clock::now() - start;
-            algebraicTime += elapsed.count();
-            changesMadeThisPass += (stats_.algebraicSimplifications - previousSimplified);
-            if (config_.printStepByStepDebug) {
-                printGraphDebug(current, "After Algebraic Simplification");
+        size_t changes = 0;
+        for (forge::NodeId id : rewriter.currentGeneration()) {
+            if (rewriter.isLive(id) && rule(rewriter, id, stats_)) {
+                changes++;
             }
         }
-        
-        // Also run stability cleaning after other optimizations (may expose new patterns)
-        if (config_.enableStabilityCleaning) {
-            current = optimizations::StabilityCleaning::apply(current, stats_);
-            changesMadeThisPass += (stats_.stabilityFixes - previousStability);
-            if (config_.printStepByStepDebug) {
-                printGraphDebug(current, "After Stability Cleaning");
-            }
-        }
-        
-        stats_.passesPerformed = pass + 1;
-        
-        // Stop early if no changes were made in this pass
-        if (changesMadeThisPass == 0) {
-            break;
-        } else {
-            stats_.changesApplied = true;
-        }
-    }
-    
-    // Apply constant cleanup as final step
-    if (config_.enableConstantCleanup) {
-        auto start = Clock::now();
-        current = optimizations::ConstantCleanup::apply(current, stats_);
         Duration elapsed = Clock::now() - start;
-        if (config_.printStepByStepDebug) {
-            printGraphDebug(current, "After Constant Cleanup");
-        }
-    }
-    
-    stats_.optimizedNodeCount = current.nodes.size();
-    
-    // Calculate total optimization time
-    Duration totalOptTime = Clock::now() - totalOptStart;
-    
-    // Store timing information in stats
-    stats_.inactiveFoldingTimeMs = inactiveFoldingTime;
-    stats_.cseTimeMs = cseTime;
-    stats_.algebraicTimeMs = algebraicTime;
-    stats_.stabilityTimeMs = stabilityTime;
-    stats_.totalOptimizationTimeMs = totalOptTime.count();
-    
-    // Print detailed optimization timing only if debug flags are set
-    if (config_.printOriginalGraph || config_.printOptimizedGraph) {
-        std::cout << "\n=== Optimization Pass Timing ===" << std::endl;
-        if (inactiveFoldingTime > 0.0)
-            std::cout << "  Inactive folding: " << std::fixed << std::setprecision(2) 
-                      << inactiveFoldingTime << " ms" << std::endl;
-        if (cseTime > 0.0)
-            std::cout << "  Common subexpression elimination: " << std::fixed << std::setprecision(2) 
-                      << cseTime << " ms" << std::endl;
-        if (algebraicTime > 0.0)
-            std::cout << "  Algebraic simplification: " << std::fixed << std::setprecision(2) 
-                      << algebraicTime << " ms" << std::endl;
-        if (stabilityTime > 0.0)
-            std::cout << "  Stability cleaning: " << std::fixed << std::setprecision(2) 
-                      << stabilityTime << " ms" << std::endl;
-        std::cout << "  Total optimization time: " << std::fixed << std::setprecision(2) 
-                  << totalOptTime.count() << " ms" << std::endl;
-    }
-    
-    // Print optimization statistics
-    if (config_.printOriginalGraph || config_.printOptimizedGraph) {
-        std::cout << "\n=== Optimization Statistics ===" << std::endl;
-        std::cout << "  Original nodes: " << stats_.originalNodeCount << std::endl;
-        std::cout << "  Optimized nodes: " << stats_.optimizedNodeCount << std::endl;
-        std::cout << "  Dead nodes: " << stats_.deadNodeCount << std::endl;
-        std::cout << "  Inactive nodes folded: " << stats_.inactiveNodesFolded << std::endl;
-        std::cout << "  Duplicates eliminated: " << stats_.duplicatesEliminated << std::endl;
-        std::cout << "  Algebraic simplifications: " << stats_.algebraicSimplifications << std::endl;
-        std::cout << "  Stability fixes: " << stats_.stabilityFixes << std::endl;
-        std::cout << "  Constants removed: " << stats_.constantsRemoved << std::endl;
-        std::cout << "  Passes performed: " << stats_.passesPerformed << std::endl;
-        std::cout << "  Changes applied: " << (stats_.changesApplied ? "Yes" : "No") << std::endl;
-    }
-    
-    // Print graphs if requested
-    if (config_.printOriginalGraph) {
-        printGraphDebug(input, "Original Graph");
-    }
-    if (config_.printOptimizedGraph) {
-        printGraphDebug(current, "Optimized Graph");
-    }
-    
-    // Constant pool debugging removed
-    
-    return current;
-}
-
-GraphOptimizer::OptimizationResult GraphOptimizer::optimizeWithMapping(const forge::Graph& input) {
-    using Clock = std::chrono::high_resolution_clock;
-    using Duration = std::chrono::duration<double, std::milli>;
-    
-    stats_.clear();
-    stats_.originalNodeCount = input.nodes.size();
-    
-    // Initialize mapping as identity - maps original node ID to optimized node ID
-    std::vector<forge::NodeId> currentMapping(input.nodes.size(), UINT32_MAX);
-    for (size_t i = 0; i < input.nodes.size(); ++i) {
-        currentMapping[i] = i;
-    }
-    
-    forge::Graph current = input;  // Copy constructor
-    
-    // Timing for individual optimization passes
-    double inactiveFoldingTime = 0.0;
-    double cseTime = 0.0;
-    double algebraicTime = 0.0;
-    double stabilityTime = 0.0;
-    double deadCodeTime = 0.0;
-    
-    auto totalOptStart = Clock::now();
+        timeMs += elapsed.count();
+        return changes;
+    };
     
     // IMPORTANT: Apply stability cleaning BEFORE any other optimization
     // This ensures 1/exp(x) patterns are transformed to exp(-x) before constant folding
     if (config_.enableStabilityCleaning) {
-        auto start = Clock::now();
-        current = optimizations::StabilityCleaning::apply(current, stats_);
-        Duration elapsed = Clock::now() - start;
-        stabilityTime += elapsed.count();
+        sweep(&optimizations::StabilityCleaning::rewrite, stabilityTime);
     }
     
-    // Apply optimization passes - up to maxOptimizationPasses iterations
-    // Each pass is O(n), so total is O(k*n) where k = maxOptimizationPasses
+    // Worklist generations - up to maxOptimizationPasses
+    // The first generation visits every node; later ones only the nodes touched
+    // by a rewrite (and their users), so the total is O(n + changes)
     for (int pass = 0; pass < config_.maxOptimizationPasses; ++pass) {
         size_t changesMadeThisPass = 0;
-        size_t previousFolded = stats_.inactiveNodesFolded;
-        size_t previousCSE = stats_.duplicatesEliminated;
-        size_t previousSimplified = stats_.algebraicSimplifications;
-        size_t previousStability = stats_.stabilityFixes;
         
         if (config_.enableInactiveFolding) {
-            auto start = Clock::now();
-            current = optimizations::InactiveFolding::apply(current, stats_);
-            Duration elapsed = Clock::now() - start;
-            inactiveFoldingTime += elapsed.count();
-            changesMadeThisPass += (stats_.inactiveNodesFolded - previousFolded);
+            changesMadeThisPass += sweep(&optimizations::InactiveFolding::rewrite, inactiveFoldingTime);
             if (config_.printStepByStepDebug) {
                 printGraphDebug(current, "After Inactive Folding");
             }
         }
         
         if (config_.enableCSE) {
-            auto start = Clock::now();
-            current = optimizations::CommonSubexpressionElimination::apply(current, stats_);
-            Duration elapsed = Clock::now() - start;
-            cseTime += elapsed.count();
-            changesMadeThisPass += (stats_.duplicatesEliminated - previousCSE);
+            changesMadeThisPass += sweep(&optimizations::CommonSubexpressionElimination::rewrite, cseTime);
             if (config_.printStepByStepDebug) {
                 printGraphDebug(current, "After CSE");
             }
         }
         
         if (config_.enableAlgebraicSimplification) {
-            auto start = Clock::now();
-            current = optimizations::AlgebraicSimplification::apply(current, stats_);
-            Duration elapsed = Clock::now() - start;
-            algebraicTime += elapsed.count();
-            changesMadeThisPass += (stats_.algebraicSimplifications - previousSimplified);
+            changesMadeThisPass += sweep(&optimizations::AlgebraicSimplification::rewrite, algebraicTime);
             if (config_.printStepByStepDebug) {
                 printGraphDebug(current, "After Algebraic Simplification");
             }
@@ -264,31 +108,39 @@ GraphOptimizer::OptimizationResult GraphOptimizer::optimizeWithMapping(const for
         
         // Also run stability cleaning after other optimizations (may expose new patterns)
         if (config_.enableStabilityCleaning) {
-            current = optimizations::StabilityCleaning::apply(current, stats_);
-            changesMadeThisPass += (stats_.stabilityFixes - previousStability);
+            changesMadeThisPass += sweep(&optimizations::StabilityCleaning::rewrite, stabilityTime);
             if (config_.printStepByStepDebug) {
                 printGraphDebug(current, "After Stability Cleaning");
             }
         }
         
         stats_.passesPerformed = pass + 1;
+        if (changesMadeThisPass > 0) {
+            stats_.changesApplied = true;
+        }
         
-        // Stop early if no changes were made in this pass
-        if (changesMadeThisPass == 0) {
+        // Stop once no rewrite queued further work
+        if (!rewriter.nextGeneration()) {
             break;
-        } else {
-            stats_.changesApplied = true;
         }
     }
     
-    // Apply constant cleanup as final step
-    if (config_.enableConstantCleanup) {
-        auto start = Clock::now();
-        current = optimizations::ConstantCleanup::apply(current, stats_);
-        Duration elapsed = Clock::now() - start;
-        if (config_.printStepByStepDebug) {
-            printGraphDebug(current, "After Constant Cleanup");
-        }
+    // Dead code elimination: keep only what the outputs depend on (a graph
+    // without outputs is left alone, there is nothing to root the walk at)
+    if (config_.enableDeadCodeElimination && !current.outputs.empty()) {
+        stats_.unreachableNodesRemoved = rewriter.eraseUnreachable();
+    }
+    
+    // Single final compaction: drop dead nodes, restore dependency order,
+    // renumber densely and (optionally) remove unused constants from the pool
+    stats_.deadNodeCount = rewriter.deadNodeCount();
+    std::vector<forge::NodeId> originalToOptimized =
+        rewriter.compact(config_.enableConstantCleanup, &stats_.constantsRemoved);
+    // The rewriter started from a copy of input, so IDs below input.nodeCount
+    // are original IDs; nodes appended by rules have no original counterpart
+    originalToOptimized.resize(input.nodeCount);
+    if (config_.printStepByStepDebug) {
+        printGraphDebug(current, "After Compaction");
     }
     
     stats_.optimizedNodeCount = current.nodes.size();
@@ -328,6 +180,7 @@ GraphOptimizer::OptimizationResult GraphOptimizer::optimizeWithMapping(const for
         std::cout << "  Original nodes: " << stats_.originalNodeCount << std::endl;
         std::cout << "  Optimized nodes: " << stats_.optimizedNodeCount << std::endl;
         std::cout << "  Dead nodes: " << stats_.deadNodeCount << std::endl;
+        std::cout << "  Unreachable nodes removed: " << stats_.unreachableNodesRemoved << std::endl;
         std::cout << "  Inactive nodes folded: " << stats_.inactiveNodesFolded << std::endl;
         std::cout << "  Duplicates eliminated: " << stats_.duplicatesEliminated << std::endl;
         std::cout << "  Algebraic simplifications: " << stats_.algebraicSimplifications << std::endl;
@@ -339,92 +192,19 @@ GraphOptimizer::OptimizationResult GraphOptimizer::optimizeWithMapping(const for
     
     // Print graphs if requested
     if (config_.printOriginalGraph) {
-        printGraphDebug(input, "Original Graph");
+        printGraphDebug(input.toGraph(), "Original Graph");
     }
     if (config_.printOptimizedGraph) {
         printGraphDebug(current, "Optimized Graph");
     }
     
-    // The current implementation doesn't properly track mappings through optimizations
-    // For now, we need to implement a proper mapping system
-    // This is a temporary solution that maintains the original node IDs
-    
     OptimizationResult result;
-    result.optimizedTape = current;
-    
-    // Create a mapping from original to optimized node IDs
-    // Minimal correct mapping: map all inputs by order and all outputs by position
-    std::vector<forge::NodeId> finalMapping(input.nodes.size(), UINT32_MAX);
-    
-    // Map inputs by ordinal occurrence of OpCode::Input
-    if (!input.nodes.empty()) {
-        // Collect input indices in original and optimized tapes
-        std::vector<forge::NodeId> originalInputs;
-        originalInputs.reserve(input.nodes.size());
-        for (forge::NodeId i = 0; i < input.nodes.size(); ++i) {
-            if (input.nodes[i].op == forge::OpCode::Input) {
-                originalInputs.push_back(i);
-            }
-        }
-        std::vector<forge::NodeId> optimizedInputs;
-        optimizedInputs.reserve(current.nodes.size());
-        for (forge::NodeId i = 0; i < current.nodes.size(); ++i) {
-            if (current.nodes[i].op == forge::OpCode::Input) {
-                optimizedInputs.push_back(i);
-            }
-        }
-        const size_t numInputsToMap = std::min(originalInputs.size(), optimizedInputs.size());
-        for (size_t k = 0; k < numInputsToMap; ++k) {
-            finalMapping[originalInputs[k]] = optimizedInputs[k];
-        }
-        
-        // Map outputs by position
-        const size_t numOutputsToMap = std::min(input.outputs.size(), current.outputs.size());
-        for (size_t k = 0; k < numOutputsToMap; ++k) {
-            const auto origOutNode = input.outputs[k];
-            const auto optOutNode = current.outputs[k];
-            if (origOutNode < finalMapping.size()) {
-                finalMapping[origOutNode] = optOutNode;
-            }
-        }
-    }
-    
-        // Debug output (commented out for cleaner test output)
-        // std::cout << "[MAPPING DEBUG] Original tape size: " << input.nodes.size() << ", Optimized tape size: " << current.nodes.size() << std::endl;
-        // for (size_t i = 0; i < finalMapping.size(); ++i) {
-        //     std::cout << "[MAPPING DEBUG] " << i << " -> " << finalMapping[i] << std::endl;
-        // }
-    
-    result.originalToOptimizedMapping = finalMapping;
+    result.optimizedTape = std::move(current);
+    result.originalToOptimizedMapping = std::move(originalToOptimized);
     
     return result;
 }
 
-bool GraphOptimizer::graphsEqual(const forge::Graph& a, const forge::Graph& b) const {
-    // Simple equality check for optimization iteration
-    if (a.nodes.size() != b.nodes.size()) {
-        return false;
-    }
-    
-    // Compare node by node
-    for (size_t i = 0; i < a.nodes.size(); ++i) {
-        const auto& nodeA = a.nodes[i];
-        const auto& nodeB = b.nodes[i];
-        
-        if (nodeA.op != nodeB.op || 
-            nodeA.a != nodeB.a || 
-            nodeA.b != nodeB.b ||
-            nodeA.c != nodeB.c ||
-            nodeA.imm != nodeB.imm ||
-            nodeA.isActive != nodeB.isActive ||
-            nodeA.isDead != nodeB.isDead) {
-            return false;
-        }
-    }
-    
-    return true;
-}
-
 std::string GraphOptimizer::getOpCodeName(forge::OpCode op) const {
     switch (op) {
         case forge::OpCode::Input: return "Input";
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "graph.hpp"  // For Graph structure
+#include "graph_view.hpp"
 #include <string>
 
 namespace forge {
@@ -10,8 +11,11 @@ namespace forge {
  * Performs optimization passes on the graph structure before JIT compilation.
  * 
  * Design principles:
- * - Takes const Graph& input, returns optimized Graph copy
- * - Multiple optimization passes can be chained
+ * - Takes const Graph& input, copies it once and rewrites the copy in place
+ *   (see optimizations/graph_rewriter.hpp); a single compaction at the end
+ *   removes replaced and unreachable nodes and renumbers densely
+ * - Passes are per-node rules driven by a worklist, so repeated passes only
+ *   revisit nodes affected by an earlier rewrite
  * - Each pass preserves correctness while improving performance
  * - Operates on graph structure, not generated code
  * 
@@ -39,6 +43,8 @@ public:
     
     /**
      * Optimization result containing both optimized tape and node ID mapping
+     * The mapping covers every original node: replaced nodes map to their
+     * replacement, nodes removed as unreachable map to UINT32_MAX.
      */
     struct OptimizationResult {
         forge::Graph optimizedTape;
@@ -52,6 +58,13 @@ public:
      * @return Optimization result with optimized tape and mapping
      */
     OptimizationResult optimizeWithMapping(const forge::Graph& input);
+    
+    /**
+     * Optimize a graph held in memory the optimizer does not own, e.g. a
+     * memory-mapped binary graph file. The arrays are copied once into the
+     * optimizer's working graph; nothing is parsed.
+     */
+    OptimizationResult optimizeWithMapping(const forge::GraphView& input);
 
     // Configuration for optimization passes - SINGLE SOURCE OF TRUTH
     struct OptimizationConfig {
@@ -61,9 +74,10 @@ public:
         bool enableAlgebraicSimplification = true; // Algebraic simplifications and strength reduction
         bool enableStabilityCleaning = true;    // Fix numerical stability issues (1/exp(x) -> exp(-x))
         bool enableConstantCleanup = true;      // Remove unused constants from const pool
+        bool enableDeadCodeElimination = true;  // Remove nodes no output depends on before compaction
         
         // Performance vs. compile time trade-offs
-        int maxOptimizationPasses = 5;  // Iterate until no changes or max passes (O(k*n) where k≤5)
+        int maxOptimizationPasses = 5;  // Max worklist generations; only the first visits every node
         
         // Debug output controls (enable/disable as needed for investigation)
         bool printStepByStepDebug = false;  // Print graph after each optimization step
@@ -78,7 +92,8 @@ public:
     struct OptimizationStats {
         size_t originalNodeCount = 0;
         size_t optimizedNodeCount = 0;
-        size_t deadNodeCount = 0;        // Nodes marked as dead after optimization
+        size_t deadNodeCount = 0;        // Nodes removed by compaction (replaced or unreachable)
+        size_t unreachableNodesRemoved = 0; // Nodes removed because no output depends on them
         size_t inactiveNodesFolded = 0;  // Number of inactive subgraphs folded
         size_t duplicatesEliminated = 0; // Number of duplicate subexpressions eliminated
         size_t algebraicSimplifications = 0; // Number of algebraic simplifications applied
@@ -98,6 +113,7 @@ public:
             originalNodeCount = 0;
             optimizedNodeCount = 0; 
             deadNodeCount = 0;
+            unreachableNodesRemoved = 0;
             inactiveNodesFolded = 0;
             duplicatesEliminated = 0;
             algebraicSimplifications = 0;
@@ -126,7 +142,6 @@ private:
     // Individual optimization passes are now in separate files in optimizations/ directory
     
     // Helper methods
-    bool graphsEqual(const forge::Graph& a, const forge::Graph& b) const;
     void printGraphDebug(const forge::Graph& graph, const std::string& title);
     std::string getOpCodeName(forge::OpCode op) const;
 };
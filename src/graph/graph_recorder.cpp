@@ -1,6 +1,7 @@
 #include "graph_recorder.hpp"
 #include <stdexcept>
 #include <mutex>
+#include <utility>
 
 namespace forge {
 
@@ -40,6 +41,10 @@ void GraphRecorder::start() {
     }
     
     graph_.clear();
+    current_ = &graph_;
+    session_++;
+    graph_.setInterning(interning_);
+    graph_.setSegmentedStorage(segmented_);
     recording_ = true;
     RecorderRegistry::setActive(this);
 }
@@ -48,6 +53,14 @@ void GraphRecorder::stop() {
     if (!recording_) {
         throw std::runtime_error("GraphRecorder::stop() called without matching start()");
     }
+    if (isRecordingFunction()) {
+        throw std::runtime_error("GraphRecorder::stop() called inside beginFunction()/endFunction()");
+    }
+    
+    // The recorded graph no longer needs its intern tables, and compilation
+    // expects contiguous nodes
+    graph_.setInterning(false);
+    graph_.setSegmentedStorage(false);
     
     // Enforce that at least one output was marked
     if (graph_.outputs.empty()) {
@@ -64,4 +77,43 @@ void GraphRecorder::stop() {
     }
 }
 
+uint32_t GraphRecorder::beginFunction() {
+    if (!recording_) {
+        throw std::runtime_error("GraphRecorder::beginFunction() called while not recording");
+    }
+    if (isRecordingFunction()) {
+        throw std::runtime_error("Function bodies cannot be nested");
+    }
+    graph_.functions.emplace_back();
+    current_ = &graph_.functions.back();
+    current_->setInterning(interning_);
+    return static_cast<uint32_t>(graph_.functions.size() - 1);
+}
+
+void GraphRecorder::endFunction() {
+    if (!isRecordingFunction()) {
+        throw std::runtime_error("GraphRecorder::endFunction() called without matching beginFunction()");
+    }
+    Graph& body = *current_;
+    current_ = &graph_;
+    body.setInterning(false);
+    if (body.outputs.empty()) {
+        throw std::runtime_error("Function body has no outputs. Call markOutput() on its results before endFunction().");
+    }
+    for (const Node& node : body.nodes) {
+        if (node.op == OpCode::Call) {
+            throw std::runtime_error("Function bodies cannot call other functions");
+        }
+    }
+}
+
+Graph GraphRecorder::releaseGraph() {
+    if (recording_) {
+        throw std::runtime_error("GraphRecorder::releaseGraph() called while recording");
+    }
+    Graph released = std::move(graph_);
+    graph_.clear();
+    return released;
+}
+
 } // namespace forge
\ No newline at end of file
@@ -22,7 +22,11 @@ public:
 class GraphRecorder {
 private:
     Graph graph_;
+    Graph* current_ = &graph_;  // graph_ or the function body being recorded
     bool recording_ = false;
+    uint64_t session_ = 0;
+    bool interning_ = false;
+    bool segmented_ = false;
     
 public:
     GraphRecorder() = default;
@@ -34,10 +38,35 @@ public:
     void start();
     void stop();
     
-    Graph& graph() { return graph_; }
-    const Graph& graph() const { return graph_; }
+    // The graph operations are recorded into: the function body between
+    // beginFunction() and endFunction(), the main graph otherwise
+    Graph& graph() { return *current_; }
+    const Graph& graph() const { return *current_; }
+    
+    // Record a subgraph function body into graph().functions. Inputs marked in
+    // the body become its parameters and outputs its results; the body may only
+    // use its own parameters and constants. Returns the function index for
+    // Graph::addCall().
+    uint32_t beginFunction();
+    void endFunction();
+    bool isRecordingFunction() const { return current_ != &graph_; }
+    
+    // Moves the recorded graph out without copying; the recorder is left empty
+    Graph releaseGraph();
     
     bool isRecording() const { return recording_; }
+    uint64_t session() const { return session_; }  // Incremented by every start()
+    
+    // Hash-cons constants and identical operations while recording (see
+    // Graph::setInterning). Takes effect at the next start().
+    void setInterning(bool enable) { interning_ = enable; }
+    bool interningEnabled() const { return interning_; }
+    
+    // Record into chunked arena storage (see Graph::setSegmentedStorage) so
+    // very large tapes never reallocate while recording. Nodes become
+    // contiguous in graph().nodes at stop(). Takes effect at the next start().
+    void setSegmentedStorage(bool enable) { segmented_ = enable; }
+    bool segmentedStorageEnabled() const { return segmented_; }
     
     static bool isAnyRecording() { return RecorderRegistry::getActive() != nullptr; }
     static GraphRecorder* active() { return RecorderRegistry::getActive(); }
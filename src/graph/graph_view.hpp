@@ -0,0 +1,53 @@
+#pragma once
+
+#include "graph.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace forge {
+
+/**
+ * Read-only view of a graph's arrays in memory the view does not own
+ *
+ * Lets a graph stored elsewhere (a memory-mapped binary graph file, see
+ * tools/graphSerialization/graph_binary_format.hpp) be handed to
+ * GraphOptimizer without building a Graph first: the optimizer's own
+ * working copy is then the only copy, made with plain array copies.
+ */
+struct GraphView {
+    const Node* nodes = nullptr;
+    size_t nodeCount = 0;
+    const double* constPool = nullptr;
+    size_t constCount = 0;
+    const NodeId* outputs = nullptr;
+    size_t outputCount = 0;
+    const NodeId* diffInputs = nullptr;
+    size_t diffInputCount = 0;
+    const std::vector<Graph>* functions = nullptr;  // Optional function bodies
+
+    static GraphView of(const Graph& graph) {
+        GraphView view;
+        view.nodes = graph.nodes.data();
+        view.nodeCount = graph.nodes.size();
+        view.constPool = graph.constPool.data();
+        view.constCount = graph.constPool.size();
+        view.outputs = graph.outputs.data();
+        view.outputCount = graph.outputs.size();
+        view.diffInputs = graph.diff_inputs.data();
+        view.diffInputCount = graph.diff_inputs.size();
+        view.functions = &graph.functions;
+        return view;
+    }
+
+    Graph toGraph() const {
+        Graph graph;
+        graph.nodes.assign(nodes, nodes + nodeCount);
+        graph.constPool.assign(constPool, constPool + constCount);
+        graph.outputs.assign(outputs, outputs + outputCount);
+        graph.diff_inputs.assign(diffInputs, diffInputs + diffInputCount);
+        if (functions) graph.functions = *functions;
+        return graph;
+    }
+};
+
+} // namespace forge
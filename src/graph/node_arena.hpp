@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace forge {
+
+struct Node;
+
+/**
+ * Segmented node storage for recording very large tapes
+ *
+ * Nodes are appended into fixed-size chunks that are never reallocated, so
+ * growth costs one chunk allocation instead of a copy of everything recorded
+ * so far, and a Node& stays valid until clear(). takeInto() hands the nodes
+ * over as one exactly-sized contiguous vector and releases each chunk as soon
+ * as it has been copied, so the handoff peaks at twice the final size instead
+ * of the up-to-3x a doubling std::vector reaches while recording.
+ */
+template <typename T>
+class SegmentedStorage {
+public:
+    static constexpr size_t kChunkShift = 16;
+    static constexpr size_t kChunkSize = size_t(1) << kChunkShift;  // 65536 elements
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    T& operator[](size_t index) { return chunks_[index >> kChunkShift][index & (kChunkSize - 1)]; }
+    const T& operator[](size_t index) const { return chunks_[index >> kChunkShift][index & (kChunkSize - 1)]; }
+    T& back() { return (*this)[size_ - 1]; }
+
+    void push_back(const T& value) {
+        if ((size_ & (kChunkSize - 1)) == 0) {
+            chunks_.emplace_back();
+            chunks_.back().reserve(kChunkSize);
+        }
+        chunks_.back().push_back(value);
+        ++size_;
+    }
+
+    void clear() {
+        chunks_.clear();
+        size_ = 0;
+    }
+
+    // Appends all elements to out and leaves this storage empty
+    void takeInto(std::vector<T>& out) {
+        out.reserve(out.size() + size_);
+        for (auto& chunk : chunks_) {
+            out.insert(out.end(), chunk.begin(), chunk.end());
+            std::vector<T>().swap(chunk);
+        }
+        clear();
+    }
+
+private:
+    std::vector<std::vector<T>> chunks_;
+    size_t size_ = 0;
+};
+
+using NodeArena = SegmentedStorage<Node>;
+
+} // namespace forge
@@ -208,6 +208,96 @@ forge::Graph AlgebraicSimplification::apply(const forge::Graph& graph,
     return result;
 }
 
+bool AlgebraicSimplification::rewrite(GraphRewriter& rewriter, forge::NodeId id,
+                                      forge::GraphOptimizer::OptimizationStats& stats) {
+    // Copy: interning a constant may reallocate the node array
+    const forge::Node node = rewriter.node(id);
+
+    // Replace this node by an existing one (redirect all uses)
+    auto redirect = [&](forge::NodeId target) {
+        rewriter.replaceAllUsesWith(id, target);
+        stats.algebraicSimplifications++;
+        return true;
+    };
+    auto toConstant = [&](double value) {
+        return redirect(rewriter.internConstant(value));
+    };
+
+    switch (node.op) {
+        case forge::OpCode::Mul:
+            // x * x → Square(x)
+            if (node.a == node.b) {
+                forge::Node square = node;
+                square.op = forge::OpCode::Square;
+                square.b = UINT32_MAX;
+                rewriter.updateNode(id, square);
+                stats.algebraicSimplifications++;
+                return true;
+            }
+            // x * 1.0 → x
+            if (rewriter.isConstantValue(node.b, 1.0)) return redirect(node.a);
+            // x * 0.0 or 0.0 * x → 0.0
+            if (rewriter.isConstantValue(node.a, 0.0) || rewriter.isConstantValue(node.b, 0.0)) {
+                return toConstant(0.0);
+            }
+            break;
+
+        case forge::OpCode::Add:
+            // 0.0 + x → x, x + 0.0 → x
+            if (rewriter.isConstantValue(node.a, 0.0)) return redirect(node.b);
+            if (rewriter.isConstantValue(node.b, 0.0)) return redirect(node.a);
+            break;
+
+        case forge::OpCode::Sub:
+            // x - 0.0 → x
+            if (rewriter.isConstantValue(node.b, 0.0)) return redirect(node.a);
+            // x - x → 0.0
+            if (node.a == node.b) return toConstant(0.0);
+            break;
+
+        case forge::OpCode::Div:
+            // x / 1.0 → x
+            if (rewriter.isConstantValue(node.b, 1.0)) return redirect(node.a);
+            // x / x → 1.0
+            if (node.a == node.b) return toConstant(1.0);
+            break;
+
+        case forge::OpCode::Neg:
+            // -(-x) → x
+            if (rewriter.isLive(node.a) && rewriter.node(node.a).op == forge::OpCode::Neg) {
+                return redirect(rewriter.node(node.a).a);
+            }
+            break;
+
+        case forge::OpCode::Square:
+            // Square(0.0) → 0.0, Square(1.0) → 1.0
+            if (rewriter.isConstantValue(node.a, 0.0)) return toConstant(0.0);
+            if (rewriter.isConstantValue(node.a, 1.0)) return toConstant(1.0);
+            break;
+
+        case forge::OpCode::Sqrt:
+            // Sqrt(0.0) → 0.0, Sqrt(1.0) → 1.0
+            if (rewriter.isConstantValue(node.a, 0.0)) return toConstant(0.0);
+            if (rewriter.isConstantValue(node.a, 1.0)) return toConstant(1.0);
+            break;
+
+        case forge::OpCode::Exp:
+            // Exp(0.0) → 1.0
+            if (rewriter.isConstantValue(node.a, 0.0)) return toConstant(1.0);
+            break;
+
+        case forge::OpCode::Log:
+            // Log(1.0) → 0.0
+            if (rewriter.isConstantValue(node.a, 1.0)) return toConstant(0.0);
+            break;
+
+        default:
+            break;
+    }
+
+    return false;
+}
+
 bool AlgebraicSimplification::isConstantValue(forge::NodeId nodeId, double expectedValue,
                                              const forge::Graph& graph) {
     if (nodeId >= graph.nodes.size()) return false;
@@ -2,6 +2,7 @@
 
 #include "../graph.hpp"
 #include "../graph_optimizer.hpp"
+#include "graph_rewriter.hpp"
 
 namespace forge {
 namespace optimizations {
@@ -30,6 +31,13 @@ public:
     static forge::Graph apply(const forge::Graph& graph, 
                                          forge::GraphOptimizer::OptimizationStats& stats);
 
+    /**
+     * In-place rule: apply the identities above to a single node
+     * @return True if the node was rewritten or replaced
+     */
+    static bool rewrite(GraphRewriter& rewriter, forge::NodeId id,
+                        forge::GraphOptimizer::OptimizationStats& stats);
+
 private:
     /**
      * Check if a node is a specific constant value
@@ -107,6 +107,21 @@ forge::Graph CommonSubexpressionElimination::apply(const forge::Graph& graph,
     return result;
 }
 
+bool CommonSubexpressionElimination::rewrite(GraphRewriter& rewriter, forge::NodeId id,
+                                             forge::GraphOptimizer::OptimizationStats& stats) {
+    // Operands are already canonical (duplicates were redirected when found),
+    // so structural equality of (op, a, b, c, imm) is enough; constants
+    // compare by value
+    forge::NodeId canonical = rewriter.findEquivalent(id);
+    if (canonical == id) {
+        return false;
+    }
+    
+    rewriter.replaceAllUsesWith(id, canonical);
+    stats.duplicatesEliminated++;
+    return true;
+}
+
 forge::NodeId CommonSubexpressionElimination::normalizeOperand(forge::NodeId id, 
                                                                            const forge::Graph& graph,
                                                                            const std::vector<forge::NodeId>& oldToNew) {
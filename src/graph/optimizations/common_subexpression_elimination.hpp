@@ -2,6 +2,7 @@
 
 #include "../graph.hpp"
 #include "../graph_optimizer.hpp"
+#include "graph_rewriter.hpp"
 #include <unordered_map>
 #include <vector>
 
@@ -28,6 +29,13 @@ public:
     static forge::Graph apply(const forge::Graph& graph, 
                                          forge::GraphOptimizer::OptimizationStats& stats);
 
+    /**
+     * In-place rule: replace the node with an earlier structurally identical one
+     * @return True if the node was rewritten or replaced
+     */
+    static bool rewrite(GraphRewriter& rewriter, forge::NodeId id,
+                        forge::GraphOptimizer::OptimizationStats& stats);
+
 private:
     // Hash function for node signatures
     struct NodeSignature {
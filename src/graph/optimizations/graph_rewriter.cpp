@@ -0,0 +1,379 @@
+#include "graph_rewriter.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace forge {
+namespace optimizations {
+
+namespace {
+
+uint64_t doubleBits(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+forge::NodeId& operandRef(forge::Node& node, int index) {
+    return index == 0 ? node.a : (index == 1 ? node.b : node.c);
+}
+
+forge::NodeId operandAt(const forge::Node& node, int index) {
+    return index == 0 ? node.a : (index == 1 ? node.b : node.c);
+}
+
+} // anonymous namespace
+
+std::size_t GraphRewriter::SignatureHash::operator()(const Signature& sig) const {
+    std::size_t h = static_cast<std::size_t>(sig.op);
+    h = h * 0x9E3779B97F4A7C15ULL + sig.a;
+    h = h * 0x9E3779B97F4A7C15ULL + sig.b;
+    h = h * 0x9E3779B97F4A7C15ULL + sig.c;
+    h = h * 0x9E3779B97F4A7C15ULL + static_cast<std::size_t>(sig.imm ^ (sig.imm >> 32));
+    return h ^ (h >> 29);
+}
+
+GraphRewriter::GraphRewriter(forge::Graph& graph)
+    : graph_(graph), initialCount_(graph.nodes.size()) {
+    const size_t n = initialCount_;
+
+    // Build use-lists in CSR form: count, prefix-sum, fill
+    userOffsets_.assign(n + 1, 0);
+    for (forge::NodeId id = 0; id < n; ++id) {
+        const auto& node = graph_.nodes[id];
+        for (int k = 0; k < forge::operandCount(node.op); ++k) {
+            forge::NodeId operand = operandAt(node, k);
+            if (operand < n) userOffsets_[operand + 1]++;
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        userOffsets_[i + 1] += userOffsets_[i];
+    }
+    users_.resize(userOffsets_[n]);
+    std::vector<uint32_t> fill(userOffsets_.begin(), userOffsets_.end() - 1);
+    for (forge::NodeId id = 0; id < n; ++id) {
+        const auto& node = graph_.nodes[id];
+        for (int k = 0; k < forge::operandCount(node.op); ++k) {
+            forge::NodeId operand = operandAt(node, k);
+            if (operand < n) users_[fill[operand]++] = id;
+        }
+    }
+
+    forward_.assign(n, UINT32_MAX);
+    queued_.assign(n, 0);
+    canonical_.reserve(n);
+
+    // First generation visits every node in recorded order
+    current_.resize(n);
+    for (forge::NodeId id = 0; id < n; ++id) {
+        current_[id] = id;
+        if (graph_.nodes[id].isDead) deadCount_++;
+    }
+}
+
+bool GraphRewriter::isConstant(forge::NodeId id) const {
+    return isLive(id) && graph_.nodes[id].op == forge::OpCode::Constant &&
+           static_cast<size_t>(graph_.nodes[id].imm) < graph_.constPool.size();
+}
+
+double GraphRewriter::constantValue(forge::NodeId id) const {
+    return graph_.constPool[static_cast<size_t>(graph_.nodes[id].imm)];
+}
+
+bool GraphRewriter::isConstantValue(forge::NodeId id, double expectedValue) const {
+    return isConstant(id) && std::abs(constantValue(id) - expectedValue) < 1e-15;
+}
+
+forge::NodeId GraphRewriter::internConstant(double value) {
+    Signature sig{forge::OpCode::Constant, 0, 0, 0, doubleBits(value)};
+    auto it = canonical_.find(sig);
+    if (it != canonical_.end() && isLive(it->second) && signatureOf(it->second) == sig) {
+        return it->second;
+    }
+    forge::NodeId id = graph_.addConstant(value);
+    grow();
+    canonical_[sig] = id;
+    return id;
+}
+
+forge::NodeId GraphRewriter::addNode(const forge::Node& node) {
+    forge::NodeId id = graph_.addNode(node);
+    grow();
+    for (int k = 0; k < forge::operandCount(node.op); ++k) {
+        addUser(operandAt(node, k), id);
+    }
+    push(id);
+    return id;
+}
+
+void GraphRewriter::updateNode(forge::NodeId id, const forge::Node& node) {
+    forge::Node& target = graph_.nodes[id];
+    target = node;
+    target.dst = id;
+    // Old edges stay in the use-lists; users are re-checked when visited
+    for (int k = 0; k < forge::operandCount(node.op); ++k) {
+        addUser(operandAt(node, k), id);
+    }
+    push(id);
+    pushUsers(id);
+}
+
+void GraphRewriter::replaceAllUsesWith(forge::NodeId from, forge::NodeId to) {
+    if (from == to) return;
+
+    std::vector<forge::NodeId> users;
+    users.swap(scratchUsers_);
+    collectUsers(from, users);
+
+    for (forge::NodeId user : users) {
+        if (!isLive(user)) continue;
+        forge::Node& node = graph_.nodes[user];
+        bool touched = false;
+        for (int k = 0; k < forge::operandCount(node.op); ++k) {
+            forge::NodeId& operand = operandRef(node, k);
+            if (operand == from) {
+                operand = to;
+                touched = true;
+            }
+        }
+        if (touched) {
+            addUser(to, user);
+            push(user);
+        }
+    }
+
+    users.clear();
+    users.swap(scratchUsers_);
+
+    // Outputs and diff inputs are resolved through forward_ at compaction
+    forward_[from] = to;
+    graph_.nodes[from].isDead = true;
+    deadCount_++;
+}
+
+forge::NodeId GraphRewriter::findEquivalent(forge::NodeId id) {
+    if (graph_.nodes[id].op == forge::OpCode::Input) {
+        return id;  // Every input is a distinct value
+    }
+    Signature sig = signatureOf(id);
+    auto it = canonical_.find(sig);
+    if (it != canonical_.end() && it->second != id && isLive(it->second) &&
+        signatureOf(it->second) == sig) {
+        return it->second;
+    }
+    canonical_[sig] = id;
+    return id;
+}
+
+bool GraphRewriter::nextGeneration() {
+    current_.clear();
+    current_.swap(pending_);
+    // Visit operands before users where possible
+    std::sort(current_.begin(), current_.end());
+    for (forge::NodeId id : current_) {
+        queued_[id] = 0;
+    }
+    return !current_.empty();
+}
+
+size_t GraphRewriter::eraseUnreachable() {
+    const size_t n = graph_.nodes.size();
+    std::vector<uint8_t> reachable(n, 0);
+    std::vector<forge::NodeId> stack;
+
+    auto mark = [&](forge::NodeId id) {
+        id = resolve(id);
+        if (id < n && !reachable[id] && !graph_.nodes[id].isDead) {
+            reachable[id] = 1;
+            stack.push_back(id);
+        }
+    };
+
+    for (forge::NodeId id : graph_.outputs) mark(id);
+    for (forge::NodeId id : graph_.diff_inputs) mark(id);
+    for (forge::NodeId id = 0; id < n; ++id) {
+        if (graph_.nodes[id].op == forge::OpCode::Input) mark(id);
+    }
+
+    while (!stack.empty()) {
+        forge::NodeId id = stack.back();
+        stack.pop_back();
+        const auto& node = graph_.nodes[id];
+        for (int k = 0; k < forge::operandCount(node.op); ++k) {
+            mark(operandAt(node, k));
+        }
+    }
+
+    // Erased nodes have no replacement, so compact() maps them to UINT32_MAX
+    size_t erased = 0;
+    for (forge::NodeId id = 0; id < n; ++id) {
+        if (!reachable[id] && !graph_.nodes[id].isDead) {
+            graph_.nodes[id].isDead = true;
+            erased++;
+        }
+    }
+    deadCount_ += erased;
+    return erased;
+}
+
+std::vector<forge::NodeId> GraphRewriter::compact(bool compactConstPool, size_t* constantsRemoved) {
+    const size_t n = graph_.nodes.size();
+    std::vector<forge::NodeId> oldToNew(n, UINT32_MAX);
+
+    std::vector<forge::Node> compacted;
+    compacted.reserve(n - std::min(n, deadCount_));
+
+    // Emit live nodes in recorded order, pulling in not-yet-emitted operands
+    // first (nodes appended by rules sit after their users until now)
+    std::vector<forge::NodeId> stack;
+    for (forge::NodeId root = 0; root < n; ++root) {
+        if (graph_.nodes[root].isDead || oldToNew[root] != UINT32_MAX) continue;
+        stack.push_back(root);
+        while (!stack.empty()) {
+            forge::NodeId id = stack.back();
+            if (oldToNew[id] != UINT32_MAX) {
+                stack.pop_back();
+                continue;
+            }
+            const auto& node = graph_.nodes[id];
+            bool ready = true;
+            for (int k = 0; k < forge::operandCount(node.op); ++k) {
+                forge::NodeId operand = resolve(operandAt(node, k));
+                if (operand < n && oldToNew[operand] == UINT32_MAX && !graph_.nodes[operand].isDead) {
+                    stack.push_back(operand);
+                    ready = false;
+                }
+            }
+            if (!ready) continue;
+            stack.pop_back();
+
+            forge::Node newNode = node;
+            for (int k = 0; k < forge::operandCount(node.op); ++k) {
+                forge::NodeId& operand = operandRef(newNode, k);
+                operand = resolve(operand);
+                if (operand < n) operand = oldToNew[operand];
+            }
+            newNode.dst = static_cast<forge::NodeId>(compacted.size());
+            oldToNew[id] = newNode.dst;
+            compacted.push_back(newNode);
+        }
+    }
+
+    // Replaced nodes map to wherever their replacement ended up
+    for (forge::NodeId id = 0; id < n; ++id) {
+        if (graph_.nodes[id].isDead && forward_[id] != UINT32_MAX) {
+            forge::NodeId target = resolve(id);
+            oldToNew[id] = target < n ? oldToNew[target] : UINT32_MAX;
+        }
+    }
+
+    graph_.nodes.swap(compacted);
+
+    auto remapList = [&](std::vector<forge::NodeId>& list) {
+        for (auto& id : list) {
+            if (id < n) id = oldToNew[id];
+        }
+        list.erase(std::remove(list.begin(), list.end(), UINT32_MAX), list.end());
+    };
+    remapList(graph_.outputs);
+    remapList(graph_.diff_inputs);
+
+    size_t removed = 0;
+    if (compactConstPool) {
+        std::vector<forge::NodeId> constMapping(graph_.constPool.size(), UINT32_MAX);
+        std::vector<double> pool;
+        for (auto& node : graph_.nodes) {
+            if (node.op != forge::OpCode::Constant) continue;
+            size_t oldIndex = static_cast<size_t>(node.imm);
+            if (oldIndex >= constMapping.size()) continue;
+            if (constMapping[oldIndex] == UINT32_MAX) {
+                constMapping[oldIndex] = static_cast<forge::NodeId>(pool.size());
+                pool.push_back(graph_.constPool[oldIndex]);
+            }
+            node.imm = static_cast<double>(constMapping[oldIndex]);
+        }
+        removed = graph_.constPool.size() - pool.size();
+        graph_.constPool.swap(pool);
+    }
+    if (constantsRemoved) *constantsRemoved = removed;
+
+    // The session is over; release bookkeeping
+    userOffsets_.clear();
+    users_.clear();
+    extraUsers_.clear();
+    forward_.clear();
+    queued_.clear();
+    current_.clear();
+    pending_.clear();
+    canonical_.clear();
+    initialCount_ = 0;
+    deadCount_ = 0;
+
+    return oldToNew;
+}
+
+GraphRewriter::Signature GraphRewriter::signatureOf(forge::NodeId id) const {
+    const auto& node = graph_.nodes[id];
+    if (node.op == forge::OpCode::Constant) {
+        return Signature{node.op, 0, 0, 0, doubleBits(constantValue(id))};
+    }
+    int count = forge::operandCount(node.op);
+    return Signature{node.op,
+                     count > 0 ? node.a : UINT32_MAX,
+                     count > 1 ? node.b : UINT32_MAX,
+                     count > 2 ? node.c : UINT32_MAX,
+                     doubleBits(node.imm)};
+}
+
+forge::NodeId GraphRewriter::resolve(forge::NodeId id) {
+    forge::NodeId target = id;
+    while (target < forward_.size() && forward_[target] != UINT32_MAX) {
+        target = forward_[target];
+    }
+    // Path compression keeps repeated lookups O(1)
+    while (id < forward_.size() && forward_[id] != UINT32_MAX && forward_[id] != target) {
+        forge::NodeId next = forward_[id];
+        forward_[id] = target;
+        id = next;
+    }
+    return target;
+}
+
+void GraphRewriter::addUser(forge::NodeId operand, forge::NodeId user) {
+    if (operand < graph_.nodes.size()) {
+        extraUsers_[operand].push_back(user);
+    }
+}
+
+void GraphRewriter::collectUsers(forge::NodeId id, std::vector<forge::NodeId>& out) const {
+    if (id < initialCount_) {
+        out.insert(out.end(), users_.begin() + userOffsets_[id], users_.begin() + userOffsets_[id + 1]);
+    }
+    auto it = extraUsers_.find(id);
+    if (it != extraUsers_.end()) {
+        out.insert(out.end(), it->second.begin(), it->second.end());
+    }
+}
+
+void GraphRewriter::push(forge::NodeId id) {
+    if (!queued_[id]) {
+        queued_[id] = 1;
+        pending_.push_back(id);
+    }
+}
+
+void GraphRewriter::pushUsers(forge::NodeId id) {
+    std::vector<forge::NodeId> users;
+    collectUsers(id, users);
+    for (forge::NodeId user : users) {
+        if (isLive(user)) push(user);
+    }
+}
+
+void GraphRewriter::grow() {
+    forward_.resize(graph_.nodes.size(), UINT32_MAX);
+    queued_.resize(graph_.nodes.size(), 0);
+}
+
+} // namespace optimizations
+} // namespace forge
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "../graph.hpp"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace forge {
+namespace optimizations {
+
+/**
+ * In-place rewrite context shared by all optimization passes
+ *
+ * The rewriter mutates a graph in place instead of rebuilding it per pass:
+ * - Use-lists let a replacement redirect exactly the affected users
+ * - Replaced nodes are only flagged isDead; nothing is moved until compact()
+ * - Touched nodes are queued for the next worklist generation, so every
+ *   generation after the first costs O(changed nodes) instead of O(nodes)
+ * - Constants are interned by value, so folding never grows the pool twice
+ *   for the same number
+ *
+ * Node order is not maintained while rewriting (nodes created by a rule are
+ * appended after their users). compact() restores a dependency order and
+ * renumbers the surviving nodes densely in a single O(nodes) sweep.
+ *
+ * Rules must copy a node before calling any mutating method, since appending
+ * a node can reallocate graph().nodes.
+ */
+class GraphRewriter {
+public:
+    /**
+     * Start a rewrite session on the given graph
+     * @param graph The graph to rewrite in place (must outlive the rewriter)
+     */
+    explicit GraphRewriter(forge::Graph& graph);
+
+    forge::Graph& graph() { return graph_; }
+    const forge::Node& node(forge::NodeId id) const { return graph_.nodes[id]; }
+    bool isLive(forge::NodeId id) const {
+        return id < graph_.nodes.size() && !graph_.nodes[id].isDead;
+    }
+
+    // Constant helpers
+    bool isConstant(forge::NodeId id) const;
+    double constantValue(forge::NodeId id) const;
+    bool isConstantValue(forge::NodeId id, double expectedValue) const;
+
+    /**
+     * Return a live constant node holding value, creating it if needed
+     */
+    forge::NodeId internConstant(double value);
+
+    /**
+     * Append a new node, register its uses and queue it for the next generation
+     */
+    forge::NodeId addNode(const forge::Node& node);
+
+    /**
+     * Overwrite a node in place (new opcode and/or operands)
+     * The node and its users are queued for the next generation.
+     */
+    void updateNode(forge::NodeId id, const forge::Node& node);
+
+    /**
+     * Redirect every use of 'from' (operands, outputs, diff inputs) to 'to'
+     * and mark 'from' as dead. Users are queued for the next generation.
+     */
+    void replaceAllUsesWith(forge::NodeId from, forge::NodeId to);
+
+    /**
+     * Structural hashing: return a live node computing the same value as id
+     * (same opcode, operands and immediate; constants compare by value),
+     * or register id as the canonical node and return it.
+     */
+    forge::NodeId findEquivalent(forge::NodeId id);
+
+    /**
+     * Nodes to visit in the current generation (all nodes initially)
+     */
+    const std::vector<forge::NodeId>& currentGeneration() const { return current_; }
+
+    /**
+     * Promote queued nodes to the current generation
+     * @return false if no node was queued, i.e. the rewrite reached a fixed point
+     */
+    bool nextGeneration();
+
+    /**
+     * Dead code elimination: mark every live node that no output depends on as
+     * dead. Inputs and diff inputs are always kept so callers can still bind
+     * values by their original IDs.
+     * @return Number of nodes erased
+     */
+    size_t eraseUnreachable();
+
+    size_t deadNodeCount() const { return deadCount_; }
+
+    /**
+     * Remove dead nodes, restore dependency order and renumber densely.
+     * Outputs and diff inputs are remapped. Ends the rewrite session.
+     * @param compactConstPool Also drop constant pool entries no live node references
+     * @param constantsRemoved Receives the number of dropped pool entries (may be null)
+     * @return Mapping from pre-compaction node IDs to new IDs; replaced nodes map
+     *         to the new ID of their replacement, UINT32_MAX if none survives
+     */
+    std::vector<forge::NodeId> compact(bool compactConstPool, size_t* constantsRemoved = nullptr);
+
+private:
+    struct Signature {
+        forge::OpCode op;
+        forge::NodeId a, b, c;
+        uint64_t imm;
+
+        bool operator==(const Signature& other) const {
+            return op == other.op && a == other.a && b == other.b &&
+                   c == other.c && imm == other.imm;
+        }
+    };
+
+    struct SignatureHash {
+        std::size_t operator()(const Signature& sig) const;
+    };
+
+    Signature signatureOf(forge::NodeId id) const;
+    forge::NodeId resolve(forge::NodeId id);
+    void addUser(forge::NodeId operand, forge::NodeId user);
+    void collectUsers(forge::NodeId id, std::vector<forge::NodeId>& out) const;
+    void push(forge::NodeId id);
+    void pushUsers(forge::NodeId id);
+    void grow();
+
+    forge::Graph& graph_;
+
+    // Use-lists: CSR built once for the recorded nodes, plus overflow lists for
+    // edges created while rewriting. Entries may be stale; users are re-checked.
+    size_t initialCount_;
+    std::vector<uint32_t> userOffsets_;
+    std::vector<forge::NodeId> users_;
+    std::unordered_map<forge::NodeId, std::vector<forge::NodeId>> extraUsers_;
+    std::vector<forge::NodeId> scratchUsers_;
+
+    std::vector<forge::NodeId> forward_;   // Replacement of a dead node (UINT32_MAX if live)
+    std::vector<uint8_t> queued_;          // Already in pending_
+    std::vector<forge::NodeId> current_;
+    std::vector<forge::NodeId> pending_;
+
+    std::unordered_map<Signature, forge::NodeId, SignatureHash> canonical_;
+    size_t deadCount_ = 0;
+};
+
+} // namespace optimizations
+} // namespace forge
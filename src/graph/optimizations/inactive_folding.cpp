@@ -23,157 +23,22 @@ forge::Graph InactiveFolding::apply(const forge::Graph& graph,
     std::function<double(forge::NodeId)> evaluateConstantSubgraph = [&](forge::NodeId nodeId) -> double {
         const auto& node = graph.nodes[nodeId];
         
-        switch (node.op) {
-            case forge::OpCode::Constant: {
-                size_t constIndex = static_cast<size_t>(node.imm);
-                return graph.constPool[constIndex];
-            }
-            case forge::OpCode::Add: {
-                double a = evaluateConstantSubgraph(node.a);
-                double b = evaluateConstantSubgraph(node.b);
-                return a + b;
-            }
-            case forge::OpCode::Sub: {
-                double a = evaluateConstantSubgraph(node.a);
-                double b = evaluateConstantSubgraph(node.b);
-                return a - b;
-            }
-            case forge::OpCode::Mul: {
-                double a = evaluateConstantSubgraph(node.a);
-                double b = evaluateConstantSubgraph(node.b);
-                return a * b;
-            }
-            case forge::OpCode::Div: {
-                double a = evaluateConstantSubgraph(node.a);
-                double b = evaluateConstantSubgraph(node.b);
-                return (b != 0.0) ? (a / b) : 0.0;
-            }
-            case forge::OpCode::Neg: {
-                double a = evaluateConstantSubgraph(node.a);
-                return -a;
-            }
-            case forge::OpCode::Exp: {
-                double a = evaluateConstantSubgraph(node.a);
-                return std::exp(a);
-            }
-            case forge::OpCode::Log: {
-                double a = evaluateConstantSubgraph(node.a);
-                return (a > 0.0) ? std::log(a) : 0.0;
-            }
-            case forge::OpCode::Sqrt: {
-                double a = evaluateConstantSubgraph(node.a);
-                return (a >= 0.0) ? std::sqrt(a) : 0.0;
-            }
-            case forge::OpCode::Square: {
-                double a = evaluateConstantSubgraph(node.a);
-                return a * a;
-            }
-            case forge::OpCode::Recip: {
-                double a = evaluateConstantSubgraph(node.a);
-                return (a != 0.0) ? (1.0 / a) : 0.0;
-            }
-            case forge::OpCode::Abs: {
-                double a = evaluateConstantSubgraph(node.a);
-                return std::abs(a);
-            }
-            case forge::OpCode::Sin: {
-                double a = evaluateConstantSubgraph(node.a);
-                return std::sin(a);
-            }
-            case forge::OpCode::Cos: {
-                double a = evaluateConstantSubgraph(node.a);
-                return std::cos(a);
-            }
-            case forge::OpCode::Tan: {
-                double a = evaluateConstantSubgraph(node.a);
-                return std::tan(a);
-            }
-            case forge::OpCode::Pow: {
-                double a = evaluateConstantSubgraph(node.a);
-                double b = evaluateConstantSubgraph(node.b);
-                return std::pow(a, b);
-            }
-            case forge::OpCode::Min: {
-                double a = evaluateConstantSubgraph(node.a);
-                double b = evaluateConstantSubgraph(node.b);
-                return std::min(a, b);
-            }
-            case forge::OpCode::Max: {
-                double a = evaluateConstantSubgraph(node.a);
-                double b = evaluateConstantSubgraph(node.b);
-                return std::max(a, b);
-            }
-            // Comparison operations - return 1.0 for true, 0.0 for false
-            case forge::OpCode::CmpLT: {
-                double a = evaluateConstantSubgraph(node.a);
-                double b = evaluateConstantSubgraph(node.b);
-                return (a < b) ? 1.0 : 0.0;
-            }
-            case forge::OpCode::CmpLE: {
-                double a = evaluateConstantSubgraph(node.a);
-                double b = evaluateConstantSubgraph(node.b);
-                return (a <= b) ? 1.0 : 0.0;
-            }
-            case forge::OpCode::CmpGT: {
-                double a = evaluateConstantSubgraph(node.a);
-                double b = evaluateConstantSubgraph(node.b);
-                return (a > b) ? 1.0 : 0.0;
-            }
-            case forge::OpCode::CmpGE: {
-                double a = evaluateConstantSubgraph(node.a);
-                double b = evaluateConstantSubgraph(node.b);
-                return (a >= b) ? 1.0 : 0.0;
-            }
-            case forge::OpCode::CmpEQ: {
-                double a = evaluateConstantSubgraph(node.a);
-                double b = evaluateConstantSubgraph(node.b);
-                return (a == b) ? 1.0 : 0.0;
-            }
-            case forge::OpCode::CmpNE: {
-                double a = evaluateConstantSubgraph(node.a);
-                double b = evaluateConstantSubgraph(node.b);
-                return (a != b) ? 1.0 : 0.0;
-            }
-            // Conditional operation
-            case forge::OpCode::If: {
-                double condition = evaluateConstantSubgraph(node.a);
-                double true_val = evaluateConstantSubgraph(node.b);
-                double false_val = evaluateConstantSubgraph(node.c);
-                return (condition != 0.0) ? true_val : false_val;
-            }
-            // Boolean operations
-            case forge::OpCode::BoolAnd: {
-                double a = evaluateConstantSubgraph(node.a);
-                double b = evaluateConstantSubgraph(node.b);
-                return ((a != 0.0) && (b != 0.0)) ? 1.0 : 0.0;
-            }
-            case forge::OpCode::BoolOr: {
-                double a = evaluateConstantSubgraph(node.a);
-                double b = evaluateConstantSubgraph(node.b);
-                return ((a != 0.0) || (b != 0.0)) ? 1.0 : 0.0;
-            }
-            case forge::OpCode::BoolNot: {
-                double a = evaluateConstantSubgraph(node.a);
-                return (a == 0.0) ? 1.0 : 0.0;
-            }
-            case forge::OpCode::BoolEq: {
-                double a = evaluateConstantSubgraph(node.a);
-                double b = evaluateConstantSubgraph(node.b);
-                // Both true or both false
-                return ((a != 0.0) == (b != 0.0)) ? 1.0 : 0.0;
-            }
-            case forge::OpCode::BoolNe: {
-                double a = evaluateConstantSubgraph(node.a);
-                double b = evaluateConstantSubgraph(node.b);
-                // One true, one false
-                return ((a != 0.0) != (b != 0.0)) ? 1.0 : 0.0;
-            }
-            default:
-                // All supported operations are handled above.
-                // Input nodes should never reach here (they are active).
-                // Any other OpCode in an inactive subgraph is unsupported.
-                return 0.0;
+        if (node.op == forge::OpCode::Constant) {
+            size_t constIndex = static_cast<size_t>(node.imm);
+            return graph.constPool[constIndex];
         }
+        
+        double v[3] = {0.0, 0.0, 0.0};
+        int count = forge::operandCount(node.op);
+        if (count > 0) v[0] = evaluateConstantSubgraph(node.a);
+        if (count > 1) v[1] = evaluateConstantSubgraph(node.b);
+        if (count > 2) v[2] = evaluateConstantSubgraph(node.c);
+        
+        // Input nodes should never reach here (they are active).
+        // Any other OpCode in an inactive subgraph is unsupported and folds to 0.0.
+        double value = 0.0;
+        foldOperation(node.op, v, value);
+        return value;
     };
     
     // Process nodes in original order to maintain dependency order by construction
@@ -262,5 +127,80 @@ forge::Graph InactiveFolding::apply(const forge::Graph& graph,
     return result;
 }
 
+bool InactiveFolding::rewrite(GraphRewriter& rewriter, forge::NodeId id,
+                              forge::GraphOptimizer::OptimizationStats& stats) {
+    const forge::Node node = rewriter.node(id);
+    if (node.isActive || node.op == forge::OpCode::Constant) {
+        return false;
+    }
+    
+    int count = forge::operandCount(node.op);
+    if (count == 0) {
+        return false;
+    }
+    
+    // Operands fold before their users, so only direct constants need checking
+    const forge::NodeId operands[3] = {node.a, node.b, node.c};
+    double v[3] = {0.0, 0.0, 0.0};
+    for (int k = 0; k < count; ++k) {
+        if (!rewriter.isConstant(operands[k])) {
+            return false;
+        }
+        v[k] = rewriter.constantValue(operands[k]);
+    }
+    
+    double folded = 0.0;
+    if (!foldOperation(node.op, v, folded)) {
+        return false;
+    }
+    
+    rewriter.replaceAllUsesWith(id, rewriter.internConstant(folded));
+    stats.inactiveNodesFolded++;
+    return true;
+}
+
+bool InactiveFolding::foldOperation(forge::OpCode op, const double* v, double& result) {
+    const double a = v[0];
+    const double b = v[1];
+    const double c = v[2];
+    
+    switch (op) {
+        case forge::OpCode::Add: result = a + b; return true;
+        case forge::OpCode::Sub: result = a - b; return true;
+        case forge::OpCode::Mul: result = a * b; return true;
+        case forge::OpCode::Div: result = (b != 0.0) ? (a / b) : 0.0; return true;
+        case forge::OpCode::Neg: result = -a; return true;
+        case forge::OpCode::Exp: result = std::exp(a); return true;
+        case forge::OpCode::Log: result = (a > 0.0) ? std::log(a) : 0.0; return true;
+        case forge::OpCode::Sqrt: result = (a >= 0.0) ? std::sqrt(a) : 0.0; return true;
+        case forge::OpCode::Square: result = a * a; return true;
+        case forge::OpCode::Recip: result = (a != 0.0) ? (1.0 / a) : 0.0; return true;
+        case forge::OpCode::Abs: result = std::abs(a); return true;
+        case forge::OpCode::Sin: result = std::sin(a); return true;
+        case forge::OpCode::Cos: result = std::cos(a); return true;
+        case forge::OpCode::Tan: result = std::tan(a); return true;
+        case forge::OpCode::Pow: result = std::pow(a, b); return true;
+        case forge::OpCode::Min: result = std::min(a, b); return true;
+        case forge::OpCode::Max: result = std::max(a, b); return true;
+        // Comparison operations - return 1.0 for true, 0.0 for false
+        case forge::OpCode::CmpLT: result = (a < b) ? 1.0 : 0.0; return true;
+        case forge::OpCode::CmpLE: result = (a <= b) ? 1.0 : 0.0; return true;
+        case forge::OpCode::CmpGT: result = (a > b) ? 1.0 : 0.0; return true;
+        case forge::OpCode::CmpGE: result = (a >= b) ? 1.0 : 0.0; return true;
+        case forge::OpCode::CmpEQ: result = (a == b) ? 1.0 : 0.0; return true;
+        case forge::OpCode::CmpNE: result = (a != b) ? 1.0 : 0.0; return true;
+        // Conditional operation
+        case forge::OpCode::If: result = (a != 0.0) ? b : c; return true;
+        // Boolean operations
+        case forge::OpCode::BoolAnd: result = ((a != 0.0) && (b != 0.0)) ? 1.0 : 0.0; return true;
+        case forge::OpCode::BoolOr: result = ((a != 0.0) || (b != 0.0)) ? 1.0 : 0.0; return true;
+        case forge::OpCode::BoolNot: result = (a == 0.0) ? 1.0 : 0.0; return true;
+        case forge::OpCode::BoolEq: result = ((a != 0.0) == (b != 0.0)) ? 1.0 : 0.0; return true;
+        case forge::OpCode::BoolNe: result = ((a != 0.0) != (b != 0.0)) ? 1.0 : 0.0; return true;
+        default:
+            return false;
+    }
+}
+
 } // namespace optimizations
 } // namespace forge
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "../graph.hpp"
 #include "../graph_optimizer.hpp"
+#include "graph_rewriter.hpp"
 #include <vector>
 
 namespace forge {
@@ -26,15 +27,23 @@ public:
     static forge::Graph apply(const forge::Graph& graph, 
                                          forge::GraphOptimizer::OptimizationStats& stats);
 
+    /**
+     * In-place rule: fold an inactive node whose operands are all constants
+     * Folding cascades through the worklist, one level per visit.
+     * @return True if the node was replaced by a constant
+     */
+    static bool rewrite(GraphRewriter& rewriter, forge::NodeId id,
+                        forge::GraphOptimizer::OptimizationStats& stats);
+
 private:
     /**
-     * Evaluate a constant subgraph recursively
-     * @param graph The tape containing the subgraph
-     * @param nodeId The root node of the subgraph to evaluate
-     * @return The computed constant value
+     * Evaluate a single operation on constant operand values
+     * @param op The operation to evaluate
+     * @param v Operand values (a, b, c)
+     * @param result Receives the folded value
+     * @return False if the operation cannot be folded
      */
-    static double evaluateInactiveSubgraph(const forge::Graph& graph, 
-                                          forge::NodeId nodeId);
+    static bool foldOperation(forge::OpCode op, const double* v, double& result);
 };
 
 } // namespace optimizations
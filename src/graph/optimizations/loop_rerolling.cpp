@@ -0,0 +1,240 @@
+#include "loop_rerolling.hpp"
+#include <cstring>
+#include <unordered_map>
+
+namespace forge {
+namespace optimizations {
+
+namespace {
+
+constexpr NodeId kNone = UINT32_MAX;
+
+bool rerollable(OpCode op) {
+    switch (op) {
+        case OpCode::Input:       // Values are set per kernel call, never per block
+        case OpCode::Call:        // Bodies cannot call other functions
+        case OpCode::CallArg:
+        case OpCode::CallResult:
+            return false;
+        default:
+            return true;
+    }
+}
+
+bool sameConstant(const Graph& graph, const Node& a, const Node& b) {
+    const size_t ia = static_cast<size_t>(a.imm);
+    const size_t ib = static_cast<size_t>(b.imm);
+    if (ia >= graph.constPool.size() || ib >= graph.constPool.size()) return false;
+    return std::memcmp(&graph.constPool[ia], &graph.constPool[ib], sizeof(double)) == 0;
+}
+
+} // namespace
+
+bool LoopRerolling::blocksMatch(const Graph& graph, NodeId p, NodeId q, NodeId stride, uint32_t* params) {
+    const size_t n = graph.nodes.size();
+    // Values from before the block, numbered by first use
+    std::unordered_map<NodeId, uint32_t> paramsP;
+    std::unordered_map<NodeId, uint32_t> paramsQ;
+
+    for (NodeId i = 0; i < stride; ++i) {
+        const Node& a = graph.nodes[p + i];
+        const Node& b = graph.nodes[q + i];
+        if (a.op != b.op || !rerollable(a.op) || a.isDead || b.isDead) return false;
+        if (a.flags != b.flags || a.isActive != b.isActive) return false;
+        if (a.op == OpCode::Constant ? !sameConstant(graph, a, b) : a.imm != b.imm) return false;
+
+        const NodeId operandsA[3] = {a.a, a.b, a.c};
+        const NodeId operandsB[3] = {b.a, b.b, b.c};
+        for (int k = 0; k < operandCount(a.op); ++k) {
+            const NodeId oa = operandsA[k];
+            const NodeId ob = operandsB[k];
+            if (oa >= n) {
+                if (ob != oa) return false;
+            } else if (oa >= p) {
+                // Inside the block: same position in the next one
+                if (oa >= p + i || ob != oa + stride) return false;
+            } else {
+                if (ob >= q) return false;
+                uint32_t ia = paramsP.emplace(oa, static_cast<uint32_t>(paramsP.size())).first->second;
+                uint32_t ib = paramsQ.emplace(ob, static_cast<uint32_t>(paramsQ.size())).first->second;
+                if (ia != ib) return false;
+            }
+        }
+    }
+    if (params) *params = static_cast<uint32_t>(paramsP.size());
+    return true;
+}
+
+std::vector<LoopRerolling::Region> LoopRerolling::findRegions(const Graph& graph, const Options& options) {
+    std::vector<Region> regions;
+    const size_t n = graph.nodes.size();
+    if (n < 2 || options.minRepeats < 2) return regions;
+
+    // Next node with the same opcode proposes the stride
+    std::vector<NodeId> next(n, kNone);
+    std::unordered_map<uint32_t, NodeId> lastByOp;
+    for (size_t id = n; id-- > 0;) {
+        const uint32_t op = static_cast<uint32_t>(graph.nodes[id].op);
+        auto it = lastByOp.find(op);
+        if (it != lastByOp.end()) next[id] = it->second;
+        lastByOp[op] = static_cast<NodeId>(id);
+    }
+
+    size_t i = 0;
+    while (i < n) {
+        bool found = false;
+        NodeId candidate = next[i];
+        for (size_t tries = 0; candidate != kNone && tries < options.maxCandidates; ++tries, candidate = next[candidate]) {
+            const size_t stride = candidate - i;
+            if (stride > options.maxBlockNodes) break;
+            if (stride < options.minBlockNodes || i + stride * options.minRepeats > n) continue;
+
+            uint32_t params = 0;
+            const NodeId p = static_cast<NodeId>(i);
+            const NodeId s = static_cast<NodeId>(stride);
+            if (!blocksMatch(graph, p, p + s, s, &params)) continue;
+            size_t count = 2;
+            while (i + (count + 1) * stride <= n &&
+                   blocksMatch(graph, static_cast<NodeId>(i + (count - 1) * stride),
+                               static_cast<NodeId>(i + count * stride), s, nullptr)) {
+                ++count;
+            }
+            if (count < options.minRepeats) continue;
+
+            regions.push_back({p, s, static_cast<uint32_t>(count), params});
+            i += count * stride;
+            found = true;
+            break;
+        }
+        if (!found) ++i;
+    }
+    return regions;
+}
+
+std::vector<NodeId> LoopRerolling::reroll(Graph& graph, const std::vector<Region>& regions) {
+    const size_t n = graph.nodes.size();
+    std::vector<NodeId> mapping(n, kNone);
+
+    std::vector<uint32_t> regionOf(n, kNone);
+    for (size_t r = 0; r < regions.size(); ++r) {
+        const Region& region = regions[r];
+        const size_t end = static_cast<size_t>(region.start) + static_cast<size_t>(region.stride) * region.count;
+        for (size_t id = region.start; id < end && id < n; ++id) {
+            regionOf[id] = static_cast<uint32_t>(r);
+        }
+    }
+    auto blockStart = [&](NodeId id) {
+        const Region& region = regions[regionOf[id]];
+        return region.start + (id - region.start) / region.stride * region.stride;
+    };
+
+    // Results: block positions read from outside their block, in any block
+    std::vector<std::vector<uint8_t>> isResult(regions.size());
+    for (size_t r = 0; r < regions.size(); ++r) {
+        isResult[r].assign(regions[r].stride, 0);
+    }
+    auto markUse = [&](NodeId user, NodeId operand) {
+        if (operand >= n || regionOf[operand] == kNone) return;
+        const NodeId start = blockStart(operand);
+        if (user != kNone && user >= start && user < start + regions[regionOf[operand]].stride) return;
+        isResult[regionOf[operand]][operand - start] = 1;
+    };
+    for (NodeId id = 0; id < n; ++id) {
+        const Node& node = graph.nodes[id];
+        if (node.isDead) continue;
+        const NodeId operands[3] = {node.a, node.b, node.c};
+        for (int k = 0; k < operandCount(node.op); ++k) {
+            markUse(id, operands[k]);
+        }
+    }
+    for (NodeId output : graph.outputs) markUse(kNone, output);
+
+    // Outline the first block of each region; skip regions a call would not shrink
+    std::vector<uint32_t> function(regions.size(), kNone);
+    std::vector<std::vector<NodeId>> results(regions.size());
+    for (size_t r = 0; r < regions.size(); ++r) {
+        const Region& region = regions[r];
+        for (NodeId pos = 0; pos < region.stride; ++pos) {
+            if (isResult[r][pos]) results[r].push_back(pos);
+        }
+        if (region.params == 0 || results[r].empty() ||
+            region.params + results[r].size() >= region.stride) {
+            continue;
+        }
+
+        Graph body;
+        std::unordered_map<NodeId, NodeId> params;
+        for (uint32_t k = 0; k < region.params; ++k) body.addInput();
+        for (NodeId pos = 0; pos < region.stride; ++pos) {
+            Node node = graph.nodes[region.start + pos];
+            NodeId* operands[3] = {&node.a, &node.b, &node.c};
+            for (int k = 0; k < operandCount(node.op); ++k) {
+                NodeId& operand = *operands[k];
+                if (operand >= n) continue;
+                if (operand >= region.start) {
+                    operand = region.params + (operand - region.start);
+                } else {
+                    operand = params.emplace(operand, static_cast<NodeId>(params.size())).first->second;
+                }
+            }
+            if (node.op == OpCode::Constant) {
+                body.constPool.push_back(graph.constPool[static_cast<size_t>(node.imm)]);
+                node.imm = static_cast<double>(body.constPool.size() - 1);
+            }
+            body.addNode(node);
+        }
+        for (NodeId pos : results[r]) body.markOutput(region.params + pos);
+
+        function[r] = static_cast<uint32_t>(graph.functions.size());
+        graph.functions.push_back(std::move(body));
+    }
+
+    // Rebuild the node list: outlined blocks become a Call and its CallResults
+    std::vector<Node> old = std::move(graph.nodes);
+    graph.nodes.clear();
+    graph.nodes.reserve(n);
+    for (NodeId id = 0; id < n; ++id) {
+        const uint32_t r = regionOf[id];
+        if (r != kNone && function[r] != kNone) {
+            const Region& region = regions[r];
+            if ((id - region.start) % region.stride != 0) continue;  // Handled with its block
+
+            std::vector<NodeId> args;
+            std::unordered_map<NodeId, uint32_t> seen;
+            for (NodeId pos = 0; pos < region.stride; ++pos) {
+                const Node& node = old[id + pos];
+                const NodeId operands[3] = {node.a, node.b, node.c};
+                for (int k = 0; k < operandCount(node.op); ++k) {
+                    if (operands[k] < id && seen.emplace(operands[k], 0).second) {
+                        args.push_back(mapping[operands[k]]);
+                    }
+                }
+            }
+            const NodeId call = graph.addCall(function[r], args);
+            mapping[id + results[r][0]] = call;
+            for (size_t k = 1; k < results[r].size(); ++k) {
+                mapping[id + results[r][k]] = graph.addCallResult(call, static_cast<uint32_t>(k));
+            }
+            continue;
+        }
+
+        Node node = old[id];
+        if (node.isDead) continue;
+        NodeId* operands[3] = {&node.a, &node.b, &node.c};
+        for (int k = 0; k < operandCount(node.op); ++k) {
+            if (*operands[k] < n) *operands[k] = mapping[*operands[k]];
+        }
+        mapping[id] = graph.addNode(node);
+    }
+
+    for (NodeId& output : graph.outputs) {
+        if (output < n) output = mapping[output];
+    }
+    for (NodeId& input : graph.diff_inputs) {
+        if (input < n) input = mapping[input];
+    }
+    return mapping;
+}
+
+} // namespace optimizations
+} // namespace forge
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "../graph.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace forge {
+namespace optimizations {
+
+/**
+ * Loop rerolling: find unrolled loops in a recorded tape and outline them
+ *
+ * Tapes of time-stepping code repeat the same block of nodes once per step.
+ * A region is a run of `count` consecutive blocks of `stride` nodes, where
+ * block k+1 is block k shifted by `stride`:
+ * - same opcodes, flags and constant values at every position
+ * - operands inside the block point to the same position in the block
+ * - operands before the block (carried values, parameters) may differ, but
+ *   must repeat in the same pattern: a value used twice in one block is
+ *   used twice in the next
+ *
+ * reroll() turns every region into one entry of Graph::functions and a Call
+ * per block, so the compiler forges the block once and each step costs an
+ * argument copy and a call. The frames of consecutive calls are laid out
+ * back to back, i.e. the loop runs over a buffer with constant stride.
+ *
+ * Example (stride 3, 3 blocks, parameter p):
+ *   s1 = s0 * p; c1 = 1.0; t1 = s1 + c1
+ *   s2 = t1 * p; c2 = 1.0; t2 = s2 + c2
+ *   s3 = t2 * p; c3 = 1.0; t3 = s3 + c3
+ * → f(x, q) = x * q + 1.0;  t1 = f(s0, p); t2 = f(t1, p); t3 = f(t2, p)
+ *
+ * The scan proposes a stride from the next node with the same opcode and
+ * verifies block against block, so it is O(nodes) for tapes without
+ * repetition and O(nodes * candidates) in the worst case.
+ */
+class LoopRerolling {
+public:
+    struct Options {
+        size_t minRepeats = 4;       // Blocks a region needs
+        size_t minBlockNodes = 8;    // Smaller blocks cost more in call overhead than they save
+        size_t maxBlockNodes = 4096; // Longest stride tried
+        size_t maxCandidates = 16;   // Strides tried per start position
+    };
+
+    struct Region {
+        forge::NodeId start = 0;
+        forge::NodeId stride = 0;
+        uint32_t count = 0;
+        uint32_t params = 0;         // Values the block reads from before it
+    };
+
+    /**
+     * Find non-overlapping regions, in node order
+     */
+    static std::vector<Region> findRegions(const forge::Graph& graph, const Options& options);
+    static std::vector<Region> findRegions(const forge::Graph& graph) { return findRegions(graph, Options{}); }
+
+    /**
+     * Outline the regions as functions and calls
+     *
+     * @param graph Graph the regions were found in; rewritten in place
+     * @return Mapping from old to new node IDs; nodes that only exist inside
+     *         a function body now map to UINT32_MAX
+     */
+    static std::vector<forge::NodeId> reroll(forge::Graph& graph, const std::vector<Region>& regions);
+
+private:
+    // Whether the block at q is the block at p shifted by stride; counts p's parameters
+    static bool blocksMatch(const forge::Graph& graph, forge::NodeId p, forge::NodeId q,
+                            forge::NodeId stride, uint32_t* params);
+};
+
+} // namespace optimizations
+} // namespace forge
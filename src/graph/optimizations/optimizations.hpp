@@ -6,6 +6,8 @@
 #include "algebraic_simplification.hpp"
 #include "stability_cleaning.hpp"
 #include "constant_cleanup.hpp"
+#include "graph_rewriter.hpp"
+#include "loop_rerolling.hpp"
 
 namespace forge {
 namespace optimizations {
@@ -150,6 +150,92 @@ forge::Graph StabilityCleaning::apply(const forge::Graph& graph,
     return result;
 }
 
+bool StabilityCleaning::rewrite(GraphRewriter& rewriter, forge::NodeId id,
+                                forge::GraphOptimizer::OptimizationStats& stats) {
+    // Copy: appending a node may reallocate the node array
+    const forge::Node node = rewriter.node(id);
+    
+    auto isExp = [&](forge::NodeId operand) {
+        return rewriter.isLive(operand) && rewriter.node(operand).op == forge::OpCode::Exp;
+    };
+    
+    if (node.op == forge::OpCode::Div) {
+        // Pattern: 1.0 / exp(x) -> exp(-x)
+        if (rewriter.isConstantValue(node.a, 1.0)) {
+            if (isExp(node.b)) {
+                const forge::Node expNode = rewriter.node(node.b);
+                
+                forge::Node negNode{};
+                negNode.op = forge::OpCode::Neg;
+                negNode.a = expNode.a;
+                negNode.b = UINT32_MAX;
+                negNode.c = UINT32_MAX;
+                negNode.isActive = expNode.isActive;
+                negNode.needsGradient = expNode.needsGradient;
+                forge::NodeId negId = rewriter.addNode(negNode);
+                
+                forge::Node newNode = node;
+                newNode.op = forge::OpCode::Exp;
+                newNode.a = negId;
+                newNode.b = UINT32_MAX;
+                newNode.c = UINT32_MAX;
+                rewriter.updateNode(id, newNode);
+                stats.stabilityFixes++;
+                return true;
+            }
+        }
+        // Pattern: exp(x) / exp(y) -> exp(x - y)
+        else if (isExp(node.a) && isExp(node.b)) {
+            const forge::Node expX = rewriter.node(node.a);
+            const forge::Node expY = rewriter.node(node.b);
+            
+            forge::Node subNode{};
+            subNode.op = forge::OpCode::Sub;
+            subNode.a = expX.a;
+            subNode.b = expY.a;
+            subNode.c = UINT32_MAX;
+            subNode.isActive = expX.isActive || expY.isActive;
+            subNode.needsGradient = expX.needsGradient || expY.needsGradient;
+            forge::NodeId subId = rewriter.addNode(subNode);
+            
+            forge::Node newNode = node;
+            newNode.op = forge::OpCode::Exp;
+            newNode.a = subId;
+            newNode.b = UINT32_MAX;
+            newNode.c = UINT32_MAX;
+            rewriter.updateNode(id, newNode);
+            stats.stabilityFixes++;
+            return true;
+        }
+    }
+    // Pattern: log(exp(x)) -> x
+    else if (node.op == forge::OpCode::Log) {
+        if (isExp(node.a)) {
+            rewriter.replaceAllUsesWith(id, rewriter.node(node.a).a);
+            stats.stabilityFixes++;
+            return true;
+        }
+    }
+    // Pattern: sqrt(x * x) -> abs(x)
+    else if (node.op == forge::OpCode::Sqrt) {
+        if (rewriter.isLive(node.a) && rewriter.node(node.a).op == forge::OpCode::Mul) {
+            const forge::Node mulNode = rewriter.node(node.a);
+            if (mulNode.a == mulNode.b) {
+                forge::Node newNode = node;
+                newNode.op = forge::OpCode::Abs;
+                newNode.a = mulNode.a;
+                newNode.b = UINT32_MAX;
+                newNode.c = UINT32_MAX;
+                rewriter.updateNode(id, newNode);
+                stats.stabilityFixes++;
+                return true;
+            }
+        }
+    }
+    
+    return false;
+}
+
 bool StabilityCleaning::isConstantValue(forge::NodeId nodeId, double expectedValue, 
                                        const forge::Graph& graph) {
     if (nodeId >= graph.nodes.size()) return false;
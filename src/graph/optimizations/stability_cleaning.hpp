@@ -2,6 +2,7 @@
 
 #include "../graph.hpp"
 #include "../graph_optimizer.hpp"
+#include "graph_rewriter.hpp"
 #include <map>
 #include <vector>
 
@@ -32,6 +33,13 @@ public:
     static forge::Graph apply(const forge::Graph& graph, 
                                          forge::GraphOptimizer::OptimizationStats& stats);
 
+    /**
+     * In-place rule: apply the stability patterns above to a single node
+     * @return True if the node was rewritten or replaced
+     */
+    static bool rewrite(GraphRewriter& rewriter, forge::NodeId id,
+                        forge::GraphOptimizer::OptimizationStats& stats);
+
 private:
     // Structure to track transformations needed
     struct Transformation {
@@ -55,6 +55,9 @@ TEST_F(CompilerConfigTest, NoOptimizationConfiguration) {
     EXPECT_FALSE(config.enableCSE);
     EXPECT_FALSE(config.enableAlgebraicSimplification);
     EXPECT_FALSE(config.enableStabilityCleaning);
+    EXPECT_FALSE(config.enableOutputPruning);
+    EXPECT_FALSE(config.enableForwardOnlyStores);
+    EXPECT_FALSE(config.enableUniformHoisting);
     EXPECT_EQ(config.maxOptimizationPasses, 0);
 }
 
@@ -136,6 +139,35 @@ TEST_F(CompilerConfigTest, LoadFromEnvironmentAVX2Packed) {
     EXPECT_EQ(config.instructionSet, CompilerConfig::InstructionSet::AVX2_PACKED);
 }
 
+TEST_F(CompilerConfigTest, LoadPerfSettingsFromEnvironment) {
+    #ifdef _WIN32
+    _putenv_s("FORGE_PERF_MAP", "1");
+    _putenv_s("FORGE_JITDUMP", "0");
+    _putenv_s("FORGE_PERF_NODES_PER_SYMBOL", "16");
+    #else
+    setenv("FORGE_PERF_MAP", "1", 1);
+    setenv("FORGE_JITDUMP", "0", 1);
+    setenv("FORGE_PERF_NODES_PER_SYMBOL", "16", 1);
+    #endif
+
+    CompilerConfig config;
+    config.loadFromEnvironment();
+
+    EXPECT_TRUE(config.emitPerfMap);
+    EXPECT_FALSE(config.emitJitDump);
+    EXPECT_EQ(config.perfNodesPerSymbol, 16u);
+
+    #ifdef _WIN32
+    _putenv_s("FORGE_PERF_MAP", "");
+    _putenv_s("FORGE_JITDUMP", "");
+    _putenv_s("FORGE_PERF_NODES_PER_SYMBOL", "");
+    #else
+    unsetenv("FORGE_PERF_MAP");
+    unsetenv("FORGE_JITDUMP");
+    unsetenv("FORGE_PERF_NODES_PER_SYMBOL");
+    #endif
+}
+
 TEST_F(CompilerConfigTest, DefaultValues) {
     CompilerConfig config;
     
@@ -2,8 +2,20 @@
 #include <iostream>
 #include <sstream>
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <optional>
+#include <tuple>
+#include <algorithm>
 #include "../src/graph/graph.hpp"
 #include "../src/compiler/forge_engine.hpp"
+#include "../src/compiler/backward_forging.hpp"
+#include "../src/compiler/compile_stats.hpp"
+#include "../src/compiler/kernel_object.hpp"
+#include "../src/compiler/node_value_buffer_pool.hpp"
+#include "../src/compiler/numa_topology.hpp"
+#include "../src/compiler/perf_jit_map.hpp"
 #include "../src/compiler/x86/common/compiler_config.hpp"
 #include "../src/compiler/interfaces/node_value_buffer.hpp"
 #include "test_graphs.hpp"
@@ -166,6 +178,636 @@ TEST(ForgeEngineTest, CompileAndExecuteWithGradient) {
     EXPECT_EQ(failed, 0) << "Some graphs failed";
 }
 
+// Output-driven pruning: a recorded diagnostic that never reaches an output
+// gets no code, while outputs and gradients are unaffected
+TEST(ForgeEngineTest, OutputPruningSkipsUnreachableNodes) {
+    forge::Graph graph;
+    NodeId x = graph.addInput();
+    NodeId y = graph.addInput();
+    graph.diff_inputs.push_back(x);
+    graph.nodes[x].needsGradient = true;
+
+    NodeId diagnostic = addUnaryOp(graph, OpCode::Exp, x, true);  // Recorded, never output
+    NodeId yOnly = addUnaryOp(graph, OpCode::Sin, y, true);       // Reaches the output, no diff input
+    NodeId out = addBinaryOp(graph, OpCode::Add, addBinaryOp(graph, OpCode::Mul, x, y, true), yOnly, true);
+    graph.markOutput(out);
+
+    ForgeEngine engine(CompilerConfig::Default());
+    auto kernel = engine.compile(graph);
+    ASSERT_TRUE(kernel);
+
+    auto buffer = NodeValueBufferFactory::create(graph, *kernel);
+    buffer->setValue(x, 2.0);
+    buffer->setValue(y, 3.0);
+    buffer->clearGradients();
+    kernel->execute(*buffer);
+
+    EXPECT_TRUE(approxEqual(buffer->getValue(out), 6.0 + std::sin(3.0)));
+    EXPECT_TRUE(approxEqual(buffer->getGradient(x), 3.0));
+    EXPECT_EQ(buffer->getValue(diagnostic), 0.0) << "Unreachable node should not be computed";
+
+    // Disabling pruning computes the diagnostic again
+    CompilerConfig config = CompilerConfig::Default();
+    config.enableOutputPruning = false;
+    ForgeEngine unprunedEngine(config);
+    auto unprunedKernel = unprunedEngine.compile(graph);
+    auto unprunedBuffer = NodeValueBufferFactory::create(graph, *unprunedKernel);
+    unprunedBuffer->setValue(x, 2.0);
+    unprunedBuffer->setValue(y, 3.0);
+    unprunedKernel->execute(*unprunedBuffer);
+    EXPECT_TRUE(approxEqual(unprunedBuffer->getValue(diagnostic), std::exp(2.0)));
+}
+
+// Skip-store mode: single-use intermediates consumed by the next node stay in
+// registers; outputs and multi-use values are still stored
+TEST(ForgeEngineTest, ForwardOnlyPolicySkipsRegisterConsumedStores) {
+    forge::Graph graph;
+    NodeId x = graph.addInput();
+    NodeId y = graph.addInput();
+    NodeId product = addBinaryOp(graph, OpCode::Mul, x, y);      // Only used by the next node
+    NodeId shared = addBinaryOp(graph, OpCode::Add, product, x); // Used twice
+    NodeId c = graph.addConstant(2.0);
+    NodeId scaled = addBinaryOp(graph, OpCode::Mul, shared, c);
+    NodeId out = addBinaryOp(graph, OpCode::Sub, scaled, shared);
+    graph.markOutput(out);
+
+    asmjit::CodeHolder code;
+    code.init(asmjit::Environment::host());
+    asmjit::x86::Assembler a(&code);
+    ForwardOnlyPolicy policy;
+    policy.onCompileBegin(graph, a);
+
+    EXPECT_FALSE(policy.requiresStore(product, graph));
+    EXPECT_TRUE(policy.requiresStore(shared, graph));
+    EXPECT_TRUE(policy.requiresStore(out, graph));
+
+    // Results match the always-store kernel; the skipped value never reaches memory
+    CompilerConfig storeAll = CompilerConfig::Default();
+    storeAll.enableForwardOnlyStores = false;
+    for (const CompilerConfig& config : {CompilerConfig::Default(), storeAll}) {
+        ForgeEngine engine(config);
+        auto kernel = engine.compile(graph);
+        auto buffer = NodeValueBufferFactory::create(graph, *kernel);
+        buffer->setValue(x, 2.0);
+        buffer->setValue(y, 3.0);
+        kernel->execute(*buffer);
+        EXPECT_TRUE(approxEqual(buffer->getValue(out), 8.0));
+        EXPECT_EQ(buffer->getValue(product), config.enableForwardOnlyStores ? 0.0 : 6.0);
+    }
+}
+
+TEST(ForgeEngineTest, UniformHoistingSplitsPrologueFromBody) {
+    forge::Graph graph;
+    NodeId spot = graph.addInput();
+    NodeId rate = graph.addInput();
+    NodeId z = graph.addInput();
+    graph.markUniform(spot);
+    graph.markUniform(rate);
+    NodeId growth = addUnaryOp(graph, OpCode::Exp, rate);
+    NodeId forward = addBinaryOp(graph, OpCode::Mul, spot, growth);  // Uniform: hoisted
+    NodeId out = addBinaryOp(graph, OpCode::Mul, forward, z);
+    graph.markOutput(out);
+
+    ForgeEngine engine;
+    auto kernel = engine.compile(graph);
+    ASSERT_TRUE(kernel->hasUniformPrologue());
+
+    auto buffer = NodeValueBufferFactory::create(graph, *kernel);
+    buffer->setValue(spot, 2.0);
+    buffer->setValue(rate, 0.0);
+    buffer->setValue(z, 3.0);
+    kernel->execute(*buffer);
+    EXPECT_TRUE(approxEqual(buffer->getValue(out), 6.0));
+
+    // The body reuses the stored uniform values
+    buffer->setValue(z, 4.0);
+    kernel->executeBody(*buffer);
+    EXPECT_TRUE(approxEqual(buffer->getValue(out), 8.0));
+
+    // A changed uniform input only takes effect through the full entry
+    buffer->setValue(spot, 10.0);
+    kernel->executeBody(*buffer);
+    EXPECT_TRUE(approxEqual(buffer->getValue(out), 8.0));
+    kernel->execute(*buffer);
+    EXPECT_TRUE(approxEqual(buffer->getValue(out), 40.0));
+
+    // Without uniform inputs there is a single entry
+    CompilerConfig noHoisting = CompilerConfig::Default();
+    noHoisting.enableUniformHoisting = false;
+    ForgeEngine plainEngine(noHoisting);
+    EXPECT_FALSE(plainEngine.compile(graph)->hasUniformPrologue());
+}
+
+// Sin/Cos keep their derivative factor from one fused forward call
+TEST(ForgeEngineTest, TrigAdjointsReuseForwardSinCos) {
+    forge::Graph graph;
+    NodeId x = graph.addInput();
+    NodeId y = graph.addInput();
+    graph.diff_inputs.push_back(x);
+    graph.nodes[x].needsGradient = true;
+    NodeId s = addUnaryOp(graph, OpCode::Sin, x, true);
+    NodeId c = addUnaryOp(graph, OpCode::Cos, x, true);
+    NodeId sy = addUnaryOp(graph, OpCode::Sin, y);  // Not on the adjoint path
+    NodeId out = addBinaryOp(graph, OpCode::Add, addBinaryOp(graph, OpCode::Mul, s, c, true), sy, true);
+    graph.markOutput(out);
+
+    std::vector<NodeId> slots = BackwardForging::assignDerivativeSlots(graph);
+    EXPECT_EQ(slots[s], graph.nodes.size());
+    EXPECT_EQ(slots[c], graph.nodes.size() + 1);
+    EXPECT_EQ(slots[sy], UINT32_MAX);
+
+    ForgeEngine engine(CompilerConfig::Default());
+    auto kernel = engine.compile(graph);
+    auto buffer = NodeValueBufferFactory::create(graph, *kernel);
+    buffer->setValue(x, 0.7);
+    buffer->setValue(y, 0.2);
+    buffer->clearGradients();
+    kernel->execute(*buffer);
+
+    EXPECT_TRUE(approxEqual(buffer->getValue(out), std::sin(0.7) * std::cos(0.7) + std::sin(0.2)));
+    EXPECT_TRUE(approxEqual(buffer->getGradient(x), std::cos(1.4)));  // cos^2 - sin^2
+}
+
+// A function body is forged once and every Call runs it on its own frame
+TEST(ForgeEngineTest, SubgraphCallsMatchInlinedEvaluation) {
+    forge::Graph body;
+    NodeId p0 = body.addInput();
+    NodeId p1 = body.addInput();
+    NodeId prod = addBinaryOp(body, OpCode::Mul, p0, p1);
+    body.markOutput(addBinaryOp(body, OpCode::Add, prod, addUnaryOp(body, OpCode::Sin, p0)));
+    body.markOutput(addBinaryOp(body, OpCode::Add, p1, p1));
+
+    forge::Graph graph;
+    graph.functions.push_back(body);
+    NodeId x = graph.addInput();
+    NodeId y = graph.addInput();
+    graph.diff_inputs.push_back(x);
+    graph.nodes[x].needsGradient = true;
+    NodeId u = x;
+    NodeId v = y;
+    for (int t = 0; t < 3; ++t) {
+        NodeId call = graph.addCall(0, {u, v});
+        v = graph.addCallResult(call, 1);
+        u = call;
+    }
+    graph.markOutput(u);
+
+    auto step = [](double a, double b) { return std::make_pair(a * b + std::sin(a), b + b); };
+    auto reference = [&](double a, double b) {
+        for (int t = 0; t < 3; ++t) std::tie(a, b) = step(a, b);
+        return a;
+    };
+
+    ForgeEngine engine(CompilerConfig::Default());
+    auto kernel = engine.compile(graph);
+    auto buffer = NodeValueBufferFactory::create(graph, *kernel);
+    for (double x0 : {0.3, -1.2, 2.0}) {
+        buffer->setValue(x, x0);
+        buffer->setValue(y, 0.8);
+        buffer->clearGradients();
+        kernel->execute(*buffer);
+
+        const double h = 1e-6;
+        EXPECT_TRUE(approxEqual(buffer->getValue(u), reference(x0, 0.8)));
+        EXPECT_NEAR(buffer->getGradient(x), (reference(x0 + h, 0.8) - reference(x0 - h, 0.8)) / (2 * h), 1e-6);
+    }
+}
+
+TEST(ForgeEngineTest, BackwardPassNeedsNoGradientClearing) {
+    forge::Graph body;
+    NodeId p0 = body.addInput();
+    NodeId p1 = body.addInput();
+    body.markOutput(addBinaryOp(body, OpCode::Mul, p0, p1));
+    body.markOutput(addBinaryOp(body, OpCode::Add, p1, p1));  // Result without a CallResult
+
+    forge::Graph graph;
+    graph.functions.push_back(body);
+    NodeId x = graph.addInput();
+    NodeId z = graph.addInput();
+    graph.diff_inputs.push_back(x);
+    graph.diff_inputs.push_back(z);
+    graph.nodes[x].needsGradient = true;
+    graph.nodes[z].needsGradient = true;
+    NodeId square = addBinaryOp(graph, OpCode::Mul, x, x, true);  // Both contributions go to x
+    NodeId call = graph.addCall(0, {square, x});
+    NodeId mod = addBinaryOp(graph, OpCode::Mod, x, z, true);  // No adjoint reaches z
+    graph.markOutput(call);
+    graph.markOutput(mod);
+
+    auto kernel = ForgeEngine(CompilerConfig::Default()).compile(graph);
+    auto buffer = NodeValueBufferFactory::create(graph, *kernel);
+    const size_t slots = buffer->getNumNodes() * static_cast<size_t>(buffer->getVectorWidth());
+    for (double x0 : {0.3, 1.5, 2.0}) {
+        // Stale adjoints from an earlier run must not leak into this one
+        std::fill(buffer->getGradientsPtr(), buffer->getGradientsPtr() + slots, std::nan(""));
+        buffer->setValue(x, x0);
+        buffer->setValue(z, 5.0);
+        kernel->execute(*buffer);
+
+        EXPECT_NEAR(buffer->getGradient(x), 3.0 * x0 * x0 + 1.0, 1e-12);  // d(x^3 + x mod z)/dx
+        EXPECT_EQ(buffer->getGradient(z), 0.0);
+    }
+}
+
+#if defined(__linux__) && defined(__x86_64__)
+TEST(ForgeEngineTest, ExportedKernelLoadsFromSharedLibrary) {
+    // Linking the object needs a system C compiler
+    if (std::system("cc --version > /dev/null 2>&1") != 0) {
+        GTEST_SKIP() << "No system linker (cc) available";
+    }
+
+    forge::Graph graph;
+    NodeId x = graph.addInput();
+    graph.diff_inputs.push_back(x);
+    graph.nodes[x].needsGradient = true;
+    NodeId e = addUnaryOp(graph, OpCode::Exp, x);
+    NodeId s = addUnaryOp(graph, OpCode::Sin, x);
+    graph.markOutput(addBinaryOp(graph, OpCode::Mul, e, s));
+
+    CompilerConfig config = CompilerConfig::Default();
+    config.enableKernelExport = true;
+    ForgeEngine engine(config);
+    auto kernel = engine.compile(graph);
+    ASSERT_NE(kernel->getExportInfo(), nullptr);
+
+    const std::string object = "test_exported_kernel.o";
+    const std::string library = "libtest_exported_kernel.so";
+    ASSERT_TRUE(saveKernelObject(*kernel, object, "exp_sin"));
+    ASSERT_EQ(std::system(("cc -shared -o " + library + " " + object).c_str()), 0);
+
+    auto loaded = loadKernelLibrary("./" + library, "exp_sin");
+    EXPECT_EQ(loaded->getVectorWidth(), kernel->getVectorWidth());
+    EXPECT_EQ(loaded->getRequiredNodes(), kernel->getRequiredNodes());
+    EXPECT_EQ(loaded->getOriginalToOptimizedMapping(), kernel->getOriginalToOptimizedMapping());
+
+    auto jitBuffer = NodeValueBufferFactory::create(graph, *kernel);
+    auto aotBuffer = NodeValueBufferFactory::create(graph, *loaded);
+    for (double x0 : {0.3, -1.2, 2.0}) {
+        jitBuffer->setValue(x, x0);
+        aotBuffer->setValue(x, x0);
+        jitBuffer->clearGradients();
+        aotBuffer->clearGradients();
+        kernel->execute(*jitBuffer);
+        loaded->execute(*aotBuffer);
+        EXPECT_EQ(aotBuffer->getValue(graph.outputs[0]), jitBuffer->getValue(graph.outputs[0]));
+        EXPECT_EQ(aotBuffer->getGradient(x), jitBuffer->getGradient(x));
+    }
+
+    EXPECT_THROW(saveKernelObject(*engine.compile(graph), object, "exp_sin"), std::runtime_error);  // Export not enabled
+    EXPECT_THROW(loadKernelLibrary("./" + library, "missing"), std::runtime_error);
+    loaded.reset();
+    std::remove(object.c_str());
+    std::remove(library.c_str());
+}
+#endif
+
+TEST(ForgeEngineTest, ProfilingKernelCountsNodeGroups) {
+    forge::Graph graph;
+    NodeId x = graph.addInput();
+    graph.diff_inputs.push_back(x);
+    graph.nodes[x].needsGradient = true;
+    NodeId acc = x;
+    for (int i = 0; i < 5; ++i) {
+        acc = addBinaryOp(graph, OpCode::Mul, addUnaryOp(graph, OpCode::Exp, acc), x);
+    }
+    graph.markOutput(acc);
+
+    CompilerConfig config = CompilerConfig::Default();
+    config.profileNodesPerGroup = 4;
+    ForgeEngine engine(config);
+    auto kernel = engine.compile(graph);
+    ASSERT_NE(kernel->getProfile(), nullptr);
+    EXPECT_EQ(ForgeEngine(CompilerConfig::Default()).compile(graph)->getProfile(), nullptr);
+
+    // Counters must not change results
+    auto plain = ForgeEngine(CompilerConfig::Default()).compile(graph);
+    auto buffer = NodeValueBufferFactory::create(graph, *kernel);
+    auto plainBuffer = NodeValueBufferFactory::create(graph, *plain);
+    const int runs = 7;
+    for (int run = 0; run < runs; ++run) {
+        buffer->setValue(x, 0.1 * run);
+        plainBuffer->setValue(x, 0.1 * run);
+        buffer->clearGradients();
+        plainBuffer->clearGradients();
+        kernel->execute(*buffer);
+        plain->execute(*plainBuffer);
+        EXPECT_EQ(buffer->getValue(acc), plainBuffer->getValue(acc));
+        EXPECT_EQ(buffer->getGradient(x), plainBuffer->getGradient(x));
+    }
+
+    const KernelProfile& profile = *kernel->getProfile();
+    size_t forwardNodes = 0;
+    bool sawBackward = false;
+    for (const auto& group : profile.report()) {
+        EXPECT_EQ(group.executions, static_cast<uint64_t>(runs)) << group.region;
+        if (group.region == "forward") {
+            EXPECT_LE(group.workingNodes.size(), 4u);
+            EXPECT_FALSE(group.originalNodes.empty());
+            forwardNodes += group.workingNodes.size();
+        }
+        sawBackward |= group.region == "backward";
+    }
+    EXPECT_GE(forwardNodes, 10u);  // 5 Exp + 5 Mul
+    EXPECT_TRUE(sawBackward);
+    EXPECT_GT(profile.totalCycles(), 0u);
+
+    std::ostringstream folded;
+    profile.writeFoldedStacks(folded, "chain");
+    EXPECT_NE(folded.str().find("chain;forward;nodes "), std::string::npos);
+    EXPECT_NE(folded.str().find("Exp*"), std::string::npos);
+
+    kernel->getProfile()->reset();
+    EXPECT_EQ(profile.totalCycles(), 0u);
+}
+
+TEST(ForgeEngineTest, PooledBuffersResetOnlyLiveIns) {
+    forge::Graph graph;
+    NodeId x = graph.addInput();
+    NodeId y = graph.addInput();
+    graph.diff_inputs.push_back(x);
+    graph.nodes[x].needsGradient = true;
+    NodeId prod = addBinaryOp(graph, OpCode::Mul, addUnaryOp(graph, OpCode::Exp, x, true), y, true);
+    graph.markOutput(prod);
+
+    auto kernel = ForgeEngine(CompilerConfig::Default()).compile(graph);
+    ASSERT_NE(kernel->getLiveIns(), nullptr);
+    EXPECT_FALSE(kernel->getLiveIns()->values.empty());
+    EXPECT_TRUE(kernel->getLiveIns()->gradients.empty());  // The backward pass writes every adjoint first
+
+    NodeValueBufferPool pool;
+    pool.reserve(graph, *kernel, 2);
+    EXPECT_EQ(pool.idleCount(*kernel), 2u);
+    EXPECT_EQ(pool.createdCount(), 2u);
+
+    INodeValueBuffer* first = nullptr;
+    for (int request = 0; request < 4; ++request) {
+        auto buffer = pool.acquire(graph, *kernel);
+        if (request == 0) first = buffer.get();
+        EXPECT_EQ(buffer.get(), first);  // The same buffer comes back every time
+        EXPECT_EQ(buffer->getValue(y), 0.0);
+        EXPECT_EQ(buffer->getGradient(x), 0.0);
+
+        const double xv = 0.25 * request;
+        buffer->setValue(x, xv);
+        buffer->setValue(y, 3.0);
+        kernel->execute(*buffer);
+        EXPECT_NEAR(buffer->getValue(prod), std::exp(xv) * 3.0, 1e-12);
+        EXPECT_NEAR(buffer->getGradient(x), std::exp(xv) * 3.0, 1e-12);  // Not accumulated across requests
+    }
+    EXPECT_EQ(pool.createdCount(), 2u);
+
+    {
+        auto a = pool.acquire(graph, *kernel);
+        auto b = pool.acquire(graph, *kernel);
+        auto c = pool.acquire(graph, *kernel);
+        EXPECT_NE(a.get(), c.get());
+        EXPECT_EQ(pool.idleCount(*kernel), 0u);
+    }
+    EXPECT_EQ(pool.createdCount(), 3u);
+    EXPECT_EQ(pool.idleCount(*kernel), 3u);
+
+    pool.release(*kernel);
+    EXPECT_EQ(pool.idleCount(*kernel), 0u);
+}
+
+TEST(ForgeEngineTest, PoolKeysBuffersByKernelId) {
+    forge::Graph small;
+    NodeId a = small.addInput();
+    small.markOutput(addUnaryOp(small, OpCode::Exp, a));
+
+    forge::Graph large;
+    NodeId x = large.addInput();
+    NodeId y = large.addInput();
+    NodeId prod = addBinaryOp(large, OpCode::Mul, addUnaryOp(large, OpCode::Exp, x), y);
+    large.markOutput(prod);
+
+    // Both kernels live in the same storage, so the second one has the address
+    // of the first; only the id tells them apart
+    NodeValueBufferPool pool;
+    std::optional<ForgedKernel> kernel;
+    kernel.emplace(std::move(*ForgeEngine(CompilerConfig::Default()).compile(small)));
+    const uint64_t firstId = kernel->getId();
+    pool.reserve(small, *kernel, 1);
+    EXPECT_EQ(pool.idleCount(*kernel), 1u);
+
+    kernel.reset();  // Destroyed without pool.release()
+    kernel.emplace(std::move(*ForgeEngine(CompilerConfig::Default()).compile(large)));
+    EXPECT_NE(kernel->getId(), firstId);
+    EXPECT_EQ(pool.idleCount(*kernel), 0u);
+
+    auto buffer = pool.acquire(large, *kernel);
+    EXPECT_EQ(pool.createdCount(), 2u);  // Not the stale buffer of the first kernel
+    EXPECT_EQ(buffer->getNumNodes(), kernel->getRequiredNodes());
+    buffer->setValue(x, 0.5);
+    buffer->setValue(y, 2.0);
+    kernel->execute(*buffer);
+    EXPECT_NEAR(buffer->getValue(prod), std::exp(0.5) * 2.0, 1e-12);
+}
+
+TEST(ForgeEngineTest, HugePageBuffersFallBackToRegularPages) {
+    const HugePagePolicy saved = NodeValueMemory::policy();
+    forge::Graph tape;
+    tape.nodes.resize(NodeValueMemory::kHugePageSize / sizeof(double) + 1);  // Just over 2 MB per array
+    tape.diff_inputs.push_back(0);
+    std::vector<NodeId> mapping(tape.nodes.size());
+    for (NodeId i = 0; i < mapping.size(); ++i) mapping[i] = i;
+
+    for (HugePagePolicy policy : {HugePagePolicy::Off, HugePagePolicy::Transparent, HugePagePolicy::Explicit}) {
+        NodeValueMemory::setPolicy(policy);
+        NodeValueBufferBase<1, 64> buffer(tape, mapping, tape.nodes.size());
+        const auto address = reinterpret_cast<uintptr_t>(buffer.getValuesPtr());
+        EXPECT_EQ(address % 64, 0u);
+        if (policy != HugePagePolicy::Off) {
+            // Huge pages when the system has them, regular pages otherwise; 2 MB aligned either way
+            EXPECT_EQ(address % NodeValueMemory::kHugePageSize, 0u);
+            EXPECT_EQ(reinterpret_cast<uintptr_t>(buffer.getGradientsPtr()) % NodeValueMemory::kHugePageSize, 0u);
+        }
+        const NodeId last = static_cast<NodeId>(tape.nodes.size() - 1);
+        EXPECT_EQ(buffer.getValue(last), 0.0);
+        buffer.setValue(last, 2.5);
+        EXPECT_EQ(buffer.getValue(last), 2.5);
+        buffer.reset();
+        EXPECT_EQ(buffer.getValue(last), 0.0);
+    }
+
+    // Small buffers never use huge pages
+    NodeValueMemory::setPolicy(HugePagePolicy::Explicit);
+    NodeValueMemory::Kind kind;
+    double* small = NodeValueMemory::allocate(4096, 32, kind);
+    EXPECT_EQ(kind, NodeValueMemory::Kind::Aligned);
+    NodeValueMemory::release(small, 4096, kind);
+    NodeValueMemory::setPolicy(saved);
+}
+
+TEST(ForgeEngineTest, NumaReplicasAndPoolPlacement) {
+    const NumaTopology& topology = NumaTopology::get();
+    ASSERT_GE(topology.nodeCount(), 1);
+    EXPECT_GE(topology.currentNode(), 0);
+    EXPECT_LT(topology.currentNode(), topology.nodeCount());
+    EXPECT_EQ(topology.nodeOfCpu(-1), 0);
+
+    forge::Graph graph;
+    NodeId x = graph.addInput();
+    graph.diff_inputs.push_back(x);
+    graph.nodes[x].needsGradient = true;
+    NodeId y = addBinaryOp(graph, OpCode::Mul, addUnaryOp(graph, OpCode::Exp, x, true), x, true);
+    graph.markOutput(y);
+
+    auto kernel = ForgeEngine(CompilerConfig::Default()).compile(graph);
+    EXPECT_GT(kernel->getCodeSize(), 0u);
+    KernelCodeReplicas replicas(*kernel);
+    if (topology.nodeCount() == 1) {
+        EXPECT_EQ(replicas.size(), 0u);
+    } else {
+        // All or nothing: 0 when mbind() is refused (e.g. by a container's seccomp policy)
+        EXPECT_TRUE(replicas.size() == 0u || replicas.size() == static_cast<size_t>(topology.nodeCount()));
+    }
+    if (replicas.size() == 0u) {
+        for (int node = 0; node < topology.nodeCount(); ++node) EXPECT_EQ(replicas.entry(node), kernel->getFunction());
+    }
+
+    NodeValueBufferPool pool;
+    pool.reserve(graph, *kernel, 1, topology.nodeCount() - 1);
+    EXPECT_EQ(pool.idleCount(*kernel), 1u);
+    for (int node = 0; node < topology.nodeCount(); ++node) {
+        auto buffer = pool.acquire(graph, *kernel);
+        buffer->setValue(x, 0.5);
+        // Every replica computes what the original code does
+        replicas.entry(node)(buffer->getValuesPtr(), buffer->getGradientsPtr(), buffer->getNumNodes());
+        EXPECT_NEAR(buffer->getValue(y), std::exp(0.5) * 0.5, 1e-12);
+        EXPECT_NEAR(buffer->getGradient(x), std::exp(0.5) * 1.5, 1e-12);
+        if (topology.nodeCount() == 1) EXPECT_FALSE(topology.moveToNode(*buffer, 0));
+    }
+    EXPECT_GE(pool.idleCount(*kernel), 1u);
+}
+
+TEST(ForgeEngineTest, BoundEntryCopiesUserArrays) {
+    forge::Graph graph;
+    NodeId x = graph.addInput();
+    NodeId y = graph.addInput();
+    graph.diff_inputs.push_back(x);
+    graph.diff_inputs.push_back(y);
+    graph.nodes[x].needsGradient = true;
+    graph.nodes[y].needsGradient = true;
+    NodeId prod = addBinaryOp(graph, OpCode::Mul, addUnaryOp(graph, OpCode::Exp, x, true), y, true);
+    NodeId sum = addBinaryOp(graph, OpCode::Add, x, y, true);
+    graph.markOutput(prod);
+    graph.markOutput(sum);
+
+    EXPECT_THROW({
+        auto plain = ForgeEngine(CompilerConfig::Default()).compile(graph);
+        EXPECT_FALSE(plain->hasIoBinding());
+        auto buffer = NodeValueBufferFactory::create(graph, *plain);
+        plain->executeBound(*buffer, KernelIoBinding{});
+    }, std::runtime_error);
+
+    CompilerConfig config = CompilerConfig::Default();
+    config.enableIoBinding = true;
+    auto kernel = ForgeEngine(config).compile(graph);
+    ASSERT_TRUE(kernel->hasIoBinding());
+    ASSERT_EQ(kernel->getIoLayout()->inputSlots.size(), 2u);
+
+    const int width = kernel->getVectorWidth();
+    auto buffer = NodeValueBufferFactory::create(graph, *kernel);
+    std::vector<double> in(2 * width), out(2 * width), grad(2 * width);
+    for (int request = 0; request < 3; ++request) {
+        for (int lane = 0; lane < width; ++lane) {
+            in[lane] = 0.1 * request + 0.01 * lane;
+            in[width + lane] = 2.0 + lane;
+        }
+        buffer->reset();
+        kernel->executeBound(*buffer, KernelIoBinding{in.data(), out.data(), grad.data()});
+        for (int lane = 0; lane < width; ++lane) {
+            const double xv = in[lane], yv = in[width + lane];
+            EXPECT_NEAR(out[lane], std::exp(xv) * yv, 1e-12);
+            EXPECT_NEAR(out[width + lane], xv + yv, 1e-12);
+            EXPECT_NEAR(grad[lane], std::exp(xv) * yv + 1.0, 1e-12);
+            EXPECT_NEAR(grad[width + lane], std::exp(xv) + 1.0, 1e-12);
+        }
+    }
+
+    // Outputs only: gradients are not written
+    std::fill(grad.begin(), grad.end(), -1.0);
+    buffer->reset();
+    kernel->executeBound(*buffer, KernelIoBinding{in.data(), out.data(), nullptr});
+    EXPECT_EQ(grad[0], -1.0);
+    EXPECT_NEAR(out[0], std::exp(in[0]) * in[width], 1e-12);
+}
+
+TEST(ForgeEngineTest, CompileStatsRecordEveryPhase) {
+    forge::Graph graph;
+    NodeId x = graph.addInput();
+    graph.diff_inputs.push_back(x);
+    graph.nodes[x].needsGradient = true;
+    graph.markOutput(addBinaryOp(graph, OpCode::Mul, addUnaryOp(graph, OpCode::Exp, x), x));
+
+    ForgeEngine plain(CompilerConfig::Default());
+    plain.compile(graph);
+    EXPECT_TRUE(plain.getLastCompileStats().phases.empty());
+
+    CompilerConfig config = CompilerConfig::Default();
+    config.collectCompileStats = true;
+    ForgeEngine engine(config);
+    engine.compile(graph);
+    const CompileStats& stats = engine.getLastCompileStats();
+
+    const std::vector<std::string> expected = {"optimize", "prepare", "forward", "backward", "finalize", "runtime"};
+    ASSERT_EQ(stats.phases.size(), expected.size());
+    double phaseSum = 0.0;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(stats.phases[i].name, expected[i]);
+        EXPECT_GE(stats.phases[i].timeMs, 0.0);
+        phaseSum += stats.phases[i].timeMs;
+    }
+    EXPECT_LE(phaseSum, stats.totalMs + 1e-6);
+    EXPECT_EQ(stats.graphNodes, graph.size());
+    EXPECT_GT(stats.codeSize, 0u);
+    ASSERT_NE(stats.phase("backward"), nullptr);
+    EXPECT_EQ(stats.phase("link"), nullptr);
+#ifdef __linux__
+    EXPECT_GT(stats.phases.back().rssBytes, 0u);
+    EXPECT_GE(stats.phases.back().peakRssBytes, stats.phases.back().rssBytes);
+#endif
+}
+
+#ifdef __linux__
+TEST(ForgeEngineTest, PerfMapListsKernelSymbols) {
+    forge::Graph graph;
+    NodeId x = graph.addInput();
+    NodeId e = addUnaryOp(graph, OpCode::Exp, x);
+    graph.markOutput(addBinaryOp(graph, OpCode::Mul, e, addUnaryOp(graph, OpCode::Sin, x)));
+
+    CompilerConfig config = CompilerConfig::Default();
+    config.emitPerfMap = true;
+    config.emitJitDump = true;
+    config.perfNodesPerSymbol = 1;
+    ForgeEngine engine(config);
+    auto kernel = engine.compile(graph);
+
+    std::ostringstream start;
+    start << std::hex << reinterpret_cast<uintptr_t>(kernel->getFunction()) << ' ';
+    std::ifstream map(PerfJitMap::perfMapPath());
+    ASSERT_TRUE(map.is_open());
+    bool foundStart = false;
+    size_t nodeSymbols = 0;
+    for (std::string line; std::getline(map, line);) {
+        foundStart |= line.rfind(start.str(), 0) == 0;
+        nodeSymbols += line.find(":nodes_") != std::string::npos;
+    }
+    EXPECT_TRUE(foundStart);
+    EXPECT_GE(nodeSymbols, 3u);  // exp, sin, mul
+
+    std::ifstream dump(PerfJitMap::jitDumpPath(), std::ios::binary);
+    ASSERT_TRUE(dump.is_open());
+    uint32_t magic = 0;
+    dump.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    EXPECT_EQ(magic, 0x4A695444u);
+
+    std::remove(PerfJitMap::perfMapPath().c_str());
+    std::remove(PerfJitMap::jitDumpPath().c_str());
+}
+#endif
+
 // ============================================================================
 // AVX2 tests (only compiled when AVX2 is bundled)
 // ============================================================================
@@ -297,6 +939,64 @@ TEST(ForgeEngineTestAVX2, CompileAndExecuteWithGradient) {
     std::cout << "\n  Summary: " << passed << " passed, " << failed << " failed" << std::endl;
     EXPECT_EQ(failed, 0) << "Some graphs failed";
 }
+
+TEST(ForgeEngineTestAVX2, LaneBlocksEvaluateEveryScenario) {
+    // A dependency chain longer than a segment: v = sin(v * y + x), 40 times
+    forge::Graph graph;
+    NodeId x = graph.addInput();
+    NodeId y = graph.addInput();
+    graph.diff_inputs.push_back(x);
+    graph.nodes[x].needsGradient = true;
+    NodeId v = x;
+    for (int i = 0; i < 40; ++i) {
+        v = addUnaryOp(graph, OpCode::Sin, addBinaryOp(graph, OpCode::Add, addBinaryOp(graph, OpCode::Mul, v, y, true), x, true), true);
+    }
+    graph.markOutput(v);
+
+    auto chain = [](double xv, double yv, double& dx) {
+        double value = xv, d = 1.0;
+        for (int i = 0; i < 40; ++i) {
+            const double arg = value * yv + xv;
+            d = std::cos(arg) * (d * yv + 1.0);
+            value = std::sin(arg);
+        }
+        dx = d;
+        return value;
+    };
+
+    for (int blocks : {2, 4}) {
+        CompilerConfig config = CompilerConfig::Default();
+        config.instructionSet = CompilerConfig::InstructionSet::AVX2_PACKED;
+        config.laneBlocks = blocks;
+        auto kernel = ForgeEngine(config).compile(graph);
+        const int width = kernel->getVectorWidth();
+        ASSERT_EQ(width, 4 * blocks);
+
+        auto buffer = NodeValueBufferFactory::create(graph, *kernel);
+        ASSERT_EQ(buffer->getVectorWidth(), width);
+        std::vector<double> xs(width), ys(width, 0.5), out(width), grads(width);
+        for (int lane = 0; lane < width; ++lane) xs[lane] = 0.1 * (lane + 1);
+        buffer->setLanes(x, xs.data());
+        buffer->setLanes(y, ys.data());
+        kernel->execute(*buffer);
+
+        buffer->getLanes(v, out.data());
+        buffer->getGradientLanes({buffer->getBufferIndex(x)}, grads.data());
+        for (int lane = 0; lane < width; ++lane) {
+            double dx = 0.0;
+            EXPECT_NEAR(out[lane], chain(xs[lane], ys[lane], dx), 1e-12) << "blocks=" << blocks << " lane=" << lane;
+            EXPECT_NEAR(grads[lane], dx, 1e-10) << "blocks=" << blocks << " lane=" << lane;
+        }
+    }
+
+    CompilerConfig unsupported = CompilerConfig::Default();
+    unsupported.instructionSet = CompilerConfig::InstructionSet::AVX2_PACKED;
+    unsupported.laneBlocks = 3;
+    EXPECT_THROW(ForgeEngine{unsupported}, std::runtime_error);
+    unsupported.instructionSet = CompilerConfig::InstructionSet::SSE2_SCALAR;
+    unsupported.laneBlocks = 2;
+    EXPECT_THROW(ForgeEngine{unsupported}, std::runtime_error);
+}
 #endif // FORGE_BUNDLE_AVX2
 
 // ============================================================================
@@ -1,8 +1,10 @@
 #include <gtest/gtest.h>
 #include "../src/graph/graph.hpp"
 #include "../src/graph/graph_optimizer.hpp"
+#include "../src/graph/optimizations/loop_rerolling.hpp"
 #include "../src/compiler/forge_engine.hpp"
 #include "../src/compiler/interfaces/node_value_buffer.hpp"
+#include "../src/compiler/x86/common/compiler_config.hpp"
 
 #include <functional>
 #include <tuple>
@@ -1428,3 +1430,251 @@ TEST_F(GraphInactiveFoldingTest, DeeplyNestedConstantSubgraph) {
     runInactiveFoldingTest(InactiveFoldingGraphs::DeeplyNestedConstantSubgraph, 5.0, 0.0, 15.0, "DeeplyNestedConstantSubgraph");  // 5 + (((1+2)+3)+4) = 5 + 10 = 15
 }
 
+
+// ============================================================================
+// In-place rewrite pipeline - structural checks on the compacted graph
+// ============================================================================
+namespace {
+
+bool operandsPrecedeUsers(const Graph& g) {
+    for (NodeId i = 0; i < g.nodes.size(); ++i) {
+        const auto& node = g.nodes[i];
+        const NodeId operands[3] = {node.a, node.b, node.c};
+        for (int k = 0; k < operandCount(node.op); ++k) {
+            if (operands[k] >= i) return false;
+        }
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+TEST_F(GraphOptimizationTest, CompactionRemovesReplacedNodes) {
+    Graph graph;
+    Graphs::DuplicateAddXY(graph);  // x, y, x+y, x+y, sum1+sum2
+
+    GraphOptimizer optimizer;
+    optimizer.setConfig(MakeConfig(false, true, false, false, false));  // CSE only
+    Graph optimized = optimizer.optimize(graph);
+
+    // The duplicate x+y is gone, not just flagged
+    EXPECT_EQ(optimized.nodes.size(), 4u);
+    for (const auto& node : optimized.nodes) {
+        EXPECT_FALSE(node.isDead);
+    }
+    EXPECT_EQ(optimizer.getLastStats().duplicatesEliminated, 1u);
+    EXPECT_NEAR(executeKernel(optimized, 1.0, 2.0), 6.0, 1e-12);
+}
+
+TEST_F(GraphOptimizationTest, CompactionRestoresDependencyOrder) {
+    // Stability cleaning appends exp(x - y)'s Sub node after its user;
+    // compaction must move it in front again
+    Graph graph;
+    StabilityGraphs::ExpXDivExpY(graph);
+
+    GraphOptimizer optimizer;
+    optimizer.setConfig(MakeConfig(false, false, false, true, false));
+    Graph optimized = optimizer.optimize(graph);
+
+    EXPECT_GE(optimizer.getLastStats().stabilityFixes, 1u);
+    EXPECT_TRUE(operandsPrecedeUsers(optimized));
+    EXPECT_NEAR(executeKernel(optimized, 2.0, 1.0), std::exp(1.0), 1e-12);
+}
+
+TEST_F(GraphOptimizationTest, LaterGenerationsOnlyRevisitChangedNodes) {
+    // A chain of x + 0.0 collapses completely in the first generation because
+    // replacements redirect users immediately
+    Graph graph;
+    NodeId x = graph.addInput();
+    NodeId zero = graph.addConstant(0.0);
+    NodeId current = x;
+    for (int i = 0; i < 100; ++i) {
+        current = addBinaryOp(graph, OpCode::Add, current, zero);
+    }
+    graph.markOutput(current);
+
+    GraphOptimizer optimizer;
+    optimizer.setConfig(MakeConfig(false, false, true, false, true));
+    Graph optimized = optimizer.optimize(graph);
+
+    const auto& stats = optimizer.getLastStats();
+    EXPECT_EQ(stats.algebraicSimplifications, 100u);
+    EXPECT_LE(stats.passesPerformed, 2);
+    ASSERT_EQ(optimized.outputs.size(), 1u);
+    EXPECT_EQ(optimized.nodes[optimized.outputs[0]].op, OpCode::Input);
+}
+
+// ============================================================================
+// Dead code elimination - unreachable nodes are removed, mapping stays complete
+// ============================================================================
+TEST_F(GraphOptimizationTest, DeadCodeEliminationRemovesUnreachableNodes) {
+    Graph graph;
+    NodeId x = graph.addInput();
+    NodeId y = graph.addInput();
+    NodeId unused = addUnaryOp(graph, OpCode::Exp, x);
+    addBinaryOp(graph, OpCode::Mul, unused, graph.addConstant(3.0));
+    NodeId sum = addBinaryOp(graph, OpCode::Add, x, y);
+    graph.markOutput(sum);
+
+    GraphOptimizer optimizer;
+    auto result = optimizer.optimizeWithMapping(graph);
+    const Graph& optimized = result.optimizedTape;
+
+    // Only x, y and x+y survive; the unused constant leaves the pool too
+    EXPECT_EQ(optimized.nodes.size(), 3u);
+    EXPECT_TRUE(optimized.constPool.empty());
+    EXPECT_EQ(optimizer.getLastStats().unreachableNodesRemoved, 3u);
+
+    const auto& mapping = result.originalToOptimizedMapping;
+    ASSERT_EQ(mapping.size(), graph.nodes.size());
+    EXPECT_EQ(mapping[unused], UINT32_MAX);
+    ASSERT_LT(mapping[sum], optimized.nodes.size());
+    EXPECT_EQ(optimized.outputs[0], mapping[sum]);
+    EXPECT_NEAR(executeKernel(optimized, 1.0, 2.0), 3.0, 1e-12);
+}
+
+TEST_F(GraphOptimizationTest, DeadCodeEliminationKeepsUnusedInputs) {
+    // Inputs are bound by original ID, so an input no output reads must stay
+    Graph graph;
+    NodeId x = graph.addInput();
+    NodeId y = graph.addInput();
+    graph.markOutput(addUnaryOp(graph, OpCode::Exp, x));
+
+    GraphOptimizer optimizer;
+    auto result = optimizer.optimizeWithMapping(graph);
+
+    ASSERT_LT(result.originalToOptimizedMapping[y], result.optimizedTape.nodes.size());
+    EXPECT_EQ(result.optimizedTape.nodes[result.originalToOptimizedMapping[x]].op, OpCode::Input);
+    EXPECT_EQ(result.optimizedTape.nodes[result.originalToOptimizedMapping[y]].op, OpCode::Input);
+    EXPECT_LT(result.originalToOptimizedMapping[x], result.originalToOptimizedMapping[y]);
+}
+
+TEST_F(GraphOptimizationTest, DeadCodeEliminationCanBeDisabled) {
+    Graph graph;
+    NodeId x = graph.addInput();
+    NodeId y = graph.addInput();
+    addUnaryOp(graph, OpCode::Exp, x);
+    graph.markOutput(addBinaryOp(graph, OpCode::Add, x, y));
+
+    GraphOptimizer optimizer;
+    auto config = MakeConfig(true, true, true, true, true);
+    config.enableDeadCodeElimination = false;
+    optimizer.setConfig(config);
+    Graph optimized = optimizer.optimize(graph);
+
+    EXPECT_EQ(optimized.nodes.size(), graph.nodes.size());
+    EXPECT_EQ(optimizer.getLastStats().unreachableNodesRemoved, 0u);
+}
+
+TEST_F(GraphOptimizationTest, MappingFollowsReplacedIntermediates) {
+    Graph graph;
+    Graphs::DuplicateAddXY(graph);  // x, y, sum1, sum2, sum1+sum2
+
+    GraphOptimizer optimizer;
+    optimizer.setConfig(MakeConfig(false, true, false, false, false));  // CSE only
+    auto result = optimizer.optimizeWithMapping(graph);
+
+    // Every original node is reachable, so every node has a target
+    const auto& mapping = result.originalToOptimizedMapping;
+    for (NodeId i = 0; i < graph.nodes.size(); ++i) {
+        EXPECT_LT(mapping[i], result.optimizedTape.nodes.size()) << "node " << i;
+    }
+    EXPECT_EQ(mapping[2], mapping[3]);  // The duplicate maps to its canonical node
+}
+
+// ============================================================================
+// Loop rerolling - unrolled time steps are outlined into one function
+// ============================================================================
+namespace {
+
+// x, p, s0 = x + p, then `steps` unrolled blocks of 9 nodes, output exp(s_n)
+NodeId buildUnrolledSteps(Graph& g, int steps, int oddStep = -1) {
+    NodeId x = g.addInput();
+    NodeId p = g.addInput();
+    NodeId s = addBinaryOp(g, OpCode::Add, x, p);
+    for (int t = 0; t < steps; ++t) {
+        NodeId a = addBinaryOp(g, OpCode::Add, addBinaryOp(g, OpCode::Mul, s, p), g.addConstant(0.5));
+        NodeId c = g.addConstant(t == oddStep ? 0.2 : 0.1);
+        NodeId u = addBinaryOp(g, OpCode::Add, s, addBinaryOp(g, OpCode::Mul, addUnaryOp(g, OpCode::Sin, a), c));
+        s = addBinaryOp(g, OpCode::Mul, u, addUnaryOp(g, OpCode::Cos, u));
+    }
+    NodeId out = addUnaryOp(g, OpCode::Exp, s);
+    g.markOutput(out);
+    return out;
+}
+
+} // anonymous namespace
+
+TEST_F(GraphOptimizationTest, LoopRerollingFindsUnrolledSteps) {
+    Graph graph;
+    NodeId out = buildUnrolledSteps(graph, 6);
+
+    auto regions = optimizations::LoopRerolling::findRegions(graph);
+    ASSERT_EQ(regions.size(), 1u);
+    EXPECT_EQ(regions[0].start, 3u);
+    EXPECT_EQ(regions[0].stride, 9u);
+    EXPECT_EQ(regions[0].count, 6u);
+    EXPECT_EQ(regions[0].params, 2u);  // The carried state and p
+
+    Graph rerolled = graph;
+    auto mapping = optimizations::LoopRerolling::reroll(rerolled, regions);
+    ASSERT_EQ(rerolled.functions.size(), 1u);
+    EXPECT_EQ(rerolled.functions[0].outputs.size(), 1u);
+    size_t calls = 0;
+    for (const Node& node : rerolled.nodes) {
+        calls += node.op == OpCode::Call;
+    }
+    EXPECT_EQ(calls, 6u);
+    // x, p, s0, six calls with two arguments each, exp
+    EXPECT_EQ(rerolled.nodes.size(), 3u + 6u * 3u + 1u);
+    EXPECT_EQ(rerolled.outputs[0], mapping[out]);
+    EXPECT_EQ(rerolled.nodes[rerolled.nodes[mapping[out]].a].op, OpCode::Call);
+    EXPECT_EQ(mapping[3], UINT32_MAX);  // Only exists inside the body now
+}
+
+TEST_F(GraphOptimizationTest, LoopRerollingRequiresIdenticalBlocks) {
+    Graph graph;
+    buildUnrolledSteps(graph, 6, 2);  // Step 2 uses another constant
+    EXPECT_TRUE(optimizations::LoopRerolling::findRegions(graph).empty());
+
+    optimizations::LoopRerolling::Options options;
+    options.minRepeats = 3;
+    auto regions = optimizations::LoopRerolling::findRegions(graph, options);
+    ASSERT_EQ(regions.size(), 1u);
+    EXPECT_GT(regions[0].start, 3u + 2u * 9u + 3u);  // Starts after the odd constant, phase may differ
+    EXPECT_EQ(regions[0].stride, 9u);
+    EXPECT_EQ(regions[0].count, 3u);
+}
+
+TEST_F(GraphOptimizationTest, LoopRerolledKernelMatchesUnrolled) {
+    Graph graph;
+    NodeId out = buildUnrolledSteps(graph, 8);
+    graph.diff_inputs.push_back(0);
+    for (Node& node : graph.nodes) {
+        node.needsGradient = node.op == OpCode::Input && node.dst == 0;
+        const NodeId operands[3] = {node.a, node.b, node.c};
+        for (int k = 0; k < operandCount(node.op); ++k) {
+            node.needsGradient = node.needsGradient || graph.nodes[operands[k]].needsGradient;
+        }
+    }
+
+    auto run = [&](bool reroll, double& gradient) {
+        CompilerConfig config = CompilerConfig::Default();
+        config.enableLoopRerolling = reroll;
+        ForgeEngine engine(config);
+        auto kernel = engine.compile(graph);
+        auto buffer = NodeValueBufferFactory::create(graph, *kernel);
+        buffer->setValue(0, 0.3);
+        buffer->setValue(1, 0.9);
+        buffer->clearGradients();
+        kernel->execute(*buffer);
+        gradient = buffer->getGradient(0);
+        return buffer->getValue(out);
+    };
+    double unrolledGradient = 0.0;
+    double rerolledGradient = 0.0;
+    double unrolled = run(false, unrolledGradient);
+    double rerolled = run(true, rerolledGradient);
+    EXPECT_NEAR(rerolled, unrolled, 1e-12);
+    EXPECT_NEAR(rerolledGradient, unrolledGradient, 1e-12);
+}
@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 #include "../src/graph/graph.hpp"
 #include "../src/graph/graph_recorder.hpp"
+#include "../src/graph/compact_graph.hpp"
+#include "../src/compiler/forge_engine.hpp"
+#include "../api/native/ffunction.hpp"
 
 using namespace forge;
 
@@ -98,6 +101,177 @@ TEST_F(GraphTest, Clear) {
     EXPECT_EQ(graph.diff_inputs.size(), 0);
 }
 
+TEST_F(GraphTest, InterningMergesConstantsAndDuplicates) {
+    graph.setInterning(true);
+    NodeId x = graph.addInput();
+    NodeId y = graph.addInput();
+    EXPECT_NE(x, y);  // Inputs are never merged
+    
+    NodeId one = graph.addConstant(1.0);
+    EXPECT_EQ(graph.addConstant(1.0), one);
+    EXPECT_NE(graph.addConstant(-0.0), graph.addConstant(0.0));  // Bitwise identity
+    EXPECT_EQ(graph.constPool.size(), 3);
+    
+    Node add{};
+    add.op = OpCode::Add;
+    add.a = x;
+    add.b = one;
+    add.c = 7;  // Unused operand field is ignored
+    NodeId first = graph.addNode(add);
+    add.c = 0;
+    EXPECT_EQ(graph.addNode(add), first);
+    
+    add.needsGradient = true;  // Different flags stay distinct
+    EXPECT_NE(graph.addNode(add), first);
+    
+    // Disabling stops merging
+    size_t before = graph.nodes.size();
+    graph.setInterning(false);
+    graph.addConstant(1.0);
+    EXPECT_EQ(graph.nodes.size(), before + 1);
+}
+
+TEST_F(GraphTest, CompactGraphRoundTrip) {
+    NodeId x = graph.addInput();
+    NodeId c = graph.addConstant(2.5);
+    Node mul{};
+    mul.op = OpCode::Mul;
+    mul.a = x;
+    mul.b = c;
+    mul.needsGradient = true;
+    NodeId m = graph.addNode(mul);
+    graph.markUniform(x);
+    graph.markOutput(m);
+    graph.diff_inputs.push_back(x);
+    
+    CompactGraph compact = CompactGraph::fromGraph(graph);
+    ASSERT_EQ(compact.size(), graph.nodes.size());
+    EXPECT_EQ(compact.op(m), OpCode::Mul);
+    EXPECT_EQ(compact.b(m), c);
+    EXPECT_TRUE(compact.needsGradient(m));
+    EXPECT_EQ(compact.flags(x), NodeFlags::Uniform);
+    EXPECT_EQ(compact.flags(m), 0u);
+    
+    compact.setDead(m, true);
+    EXPECT_TRUE(compact.node(m).isDead);
+    compact.setDead(m, false);
+    
+    Graph back = compact.toGraph();
+    ASSERT_EQ(back.nodes.size(), graph.nodes.size());
+    for (NodeId id = 0; id < back.nodes.size(); ++id) {
+        const Node& expected = graph.nodes[id];
+        const Node& actual = back.nodes[id];
+        EXPECT_EQ(actual.op, expected.op);
+        EXPECT_EQ(actual.dst, id);
+        EXPECT_EQ(actual.a, expected.a);
+        EXPECT_EQ(actual.b, expected.b);
+        EXPECT_EQ(actual.flags, expected.flags);
+        EXPECT_EQ(actual.imm, expected.imm);
+        EXPECT_EQ(actual.isActive, expected.isActive);
+        EXPECT_EQ(actual.needsGradient, expected.needsGradient);
+    }
+    EXPECT_EQ(back.constPool, graph.constPool);
+    EXPECT_EQ(back.outputs, graph.outputs);
+    EXPECT_EQ(back.diff_inputs, graph.diff_inputs);
+}
+
+TEST_F(GraphTest, CompactGraphRoundTripKeepsFunctions) {
+    Graph body;
+    NodeId p0 = body.addInput();
+    NodeId p1 = body.addInput();
+    Node mul{};
+    mul.op = OpCode::Mul;
+    mul.a = p0;
+    mul.b = p1;
+    body.markOutput(body.addNode(mul));
+
+    NodeId x = graph.addInput();
+    NodeId y = graph.addInput();
+    graph.functions.push_back(body);
+    NodeId call = graph.addCall(0, {x, y});
+    graph.markOutput(call);
+
+    Graph back = CompactGraph::fromGraph(graph).toGraph();
+    ASSERT_EQ(back.functions.size(), 1u);
+    EXPECT_EQ(back.functions[0].nodes.size(), body.nodes.size());
+    EXPECT_EQ(back.functions[0].outputs, body.outputs);
+    EXPECT_EQ(back.nodes[call].op, OpCode::Call);
+    EXPECT_LT(static_cast<size_t>(back.nodes[call].imm), back.functions.size());
+
+    // The round-tripped graph still compiles: every Call finds its body
+    auto kernel = ForgeEngine(CompilerConfig::Default()).compile(back);
+    auto buffer = NodeValueBufferFactory::create(back, *kernel);
+    buffer->setValue(x, 3.0);
+    buffer->setValue(y, 4.0);
+    kernel->execute(*buffer);
+    EXPECT_DOUBLE_EQ(buffer->getValue(call), 12.0);
+}
+
+TEST_F(GraphTest, CompactGraphIsAtLeastTwiceSmaller) {
+    Graph large;
+    NodeId x = large.addInput();
+    for (int i = 0; i < 10000; ++i) {
+        Node node{};
+        node.op = (i % 4 == 0) ? OpCode::Add : OpCode::Exp;
+        node.a = x;
+        node.b = (i % 4 == 0) ? large.addConstant(static_cast<double>(i)) : 0;
+        x = large.addNode(node);
+    }
+    CompactGraph compact = CompactGraph::fromGraph(large);
+    EXPECT_LE(compact.nodeBytes() * 2, large.nodes.size() * sizeof(Node));
+}
+
+TEST_F(GraphTest, SegmentedStorageKeepsIdsAndAddresses) {
+    graph.setSegmentedStorage(true);
+    NodeId x = graph.addInput();
+    const Node* first = &graph.node(x);
+    
+    // Cross a chunk boundary
+    const size_t count = NodeArena::kChunkSize + 10;
+    for (size_t i = 1; i < count; ++i) {
+        Node node{};
+        node.op = OpCode::Neg;
+        node.a = x;
+        x = graph.addNode(node);
+    }
+    EXPECT_EQ(graph.size(), count);
+    EXPECT_TRUE(graph.nodes.empty());
+    EXPECT_EQ(&graph.node(0), first);
+    EXPECT_EQ(graph.node(x).a, x - 1);
+    
+    graph.setSegmentedStorage(false);
+    ASSERT_EQ(graph.nodes.size(), count);
+    EXPECT_EQ(graph.nodes.capacity(), count);
+    for (NodeId id = 0; id < count; ++id) {
+        EXPECT_EQ(graph.nodes[id].dst, id);
+    }
+    EXPECT_EQ(graph.nodes[x].a, x - 1);
+}
+
+TEST_F(GraphTest, CallNodesKeepArgumentOrder) {
+    Graph body;
+    NodeId p0 = body.addInput();
+    NodeId p1 = body.addInput();
+    body.markOutput(body.addNode({OpCode::Mul, 0, p0, p1}));
+    body.markOutput(body.addNode({OpCode::Sub, 0, p0, p1}));
+    graph.functions.push_back(body);
+    
+    NodeId x = graph.addInput();
+    NodeId y = graph.addInput();
+    graph.nodes[y].needsGradient = true;
+    NodeId call = graph.addCall(0, {y, x});
+    NodeId second = graph.addCallResult(call, 1);
+    
+    EXPECT_EQ(graph.nodes[call].op, OpCode::Call);
+    EXPECT_TRUE(graph.nodes[call].needsGradient);
+    EXPECT_TRUE(graph.nodes[second].needsGradient);
+    EXPECT_EQ(graph.callArguments(call), (std::vector<NodeId>{y, x}));
+    EXPECT_THROW(graph.addCall(0, {x}), std::runtime_error);
+    EXPECT_THROW(graph.addCall(1, {x, y}), std::runtime_error);
+    EXPECT_THROW(graph.addCallResult(call, 0), std::runtime_error);
+    EXPECT_THROW(graph.addCallResult(call, 2), std::runtime_error);
+}
+
 // Test GraphRecorder
 class GraphRecorderTest : public ::testing::Test {
 protected:
@@ -182,6 +356,91 @@ TEST_F(GraphRecorderTest, MultipleRecorders) {
     recorder1.stop();
 }
 
+TEST_F(GraphRecorderTest, InterningOnlyWhileRecording) {
+    recorder.setInterning(true);
+    recorder.start();
+    EXPECT_TRUE(recorder.graph().interningEnabled());
+    
+    NodeId c1 = recorder.graph().addConstant(2.0);
+    NodeId c2 = recorder.graph().addConstant(2.0);
+    EXPECT_EQ(c1, c2);
+    recorder.graph().markOutput(c1);
+    
+    recorder.stop();
+    EXPECT_FALSE(recorder.graph().interningEnabled());
+    EXPECT_EQ(recorder.graph().nodes.size(), 1);
+}
+
+TEST_F(GraphRecorderTest, SegmentedRecordingIsContiguousAfterStop) {
+    recorder.setSegmentedStorage(true);
+    recorder.start();
+    
+    NodeId input = recorder.graph().addInput();
+    recorder.graph().markUniform(input);
+    NodeId constant = recorder.graph().addConstant(3.0);
+    NodeId sum = recorder.graph().addNode({OpCode::Add, 0, input, constant});
+    recorder.graph().markOutput(sum);
+    EXPECT_TRUE(recorder.graph().nodes.empty());
+    EXPECT_EQ(recorder.graph().size(), 3);
+    
+    recorder.stop();
+    EXPECT_FALSE(recorder.graph().segmentedStorageEnabled());
+    ASSERT_EQ(recorder.graph().nodes.size(), 3);
+    EXPECT_EQ(recorder.graph().nodes[input].flags, NodeFlags::Uniform);
+    EXPECT_EQ(recorder.graph().nodes[sum].b, constant);
+    
+    Graph released = recorder.releaseGraph();
+    EXPECT_EQ(released.nodes.size(), 3);
+    EXPECT_EQ(released.outputs[0], sum);
+    EXPECT_TRUE(recorder.graph().empty());
+}
+
+TEST_F(GraphRecorderTest, FunctionBodyIsRecordedOnce) {
+    ffunction step([](const std::vector<fdouble>& s) {
+        return std::vector<fdouble>{s[0] * s[1] + 1.0, s[1] * 2.0};
+    });
+    
+    recorder.start();
+    fdouble a(1.5);
+    fdouble b(0.5);
+    a.markInputAndDiff();
+    b.markInputAndDiff();
+    std::vector<fdouble> state{a, b};
+    for (int t = 0; t < 3; ++t) {
+        state = step(state);
+    }
+    state[0].markOutput();
+    recorder.stop();
+    
+    const Graph& graph = recorder.graph();
+    ASSERT_EQ(graph.functions.size(), 1);
+    EXPECT_EQ(graph.functions[0].outputs.size(), 2);
+    size_t calls = 0;
+    for (const Node& node : graph.nodes) {
+        calls += node.op == OpCode::Call;
+    }
+    EXPECT_EQ(calls, 3);
+    
+    // Values are tracked through every call: (1.5, 0.5) -> (1.75, 1) -> (2.75, 2) -> (6.5, 4)
+    EXPECT_DOUBLE_EQ(state[0].value(), 6.5);
+    EXPECT_DOUBLE_EQ(state[1].value(), 4.0);
+    EXPECT_TRUE(state[0].isActive());
+    
+    // Outside a recording the body is just evaluated
+    EXPECT_DOUBLE_EQ(step({fdouble(2.0), fdouble(3.0)})[0].value(), 7.0);
+}
+
+TEST_F(GraphRecorderTest, FunctionMisuseThrows) {
+    EXPECT_THROW(recorder.beginFunction(), std::runtime_error);
+    recorder.start();
+    recorder.beginFunction();
+    EXPECT_THROW(recorder.beginFunction(), std::runtime_error);
+    EXPECT_THROW(recorder.endFunction(), std::runtime_error);  // No outputs
+    EXPECT_THROW(recorder.endFunction(), std::runtime_error);  // Not in a function
+    recorder.graph().markOutput(recorder.graph().addInput());
+    recorder.stop();
+}
+
 TEST_F(GraphRecorderTest, GraphAccess) {
     recorder.start();
     
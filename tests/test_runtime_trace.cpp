@@ -4,6 +4,9 @@
 #include "../src/compiler/x86/common/compiler_config.hpp"
 #include <asmjit/x86.h>
 #include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
 
 using namespace forge;
 
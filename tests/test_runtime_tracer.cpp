@@ -32,7 +32,11 @@
 #include <gtest/gtest.h>
 #include <iostream>
 #include <iomanip>
+#include <atomic>
 #include <cmath>
+#include <sstream>
+#include <thread>
+#include <vector>
 #include "../src/graph/graph.hpp"
 #include "../src/compiler/forge_engine.hpp"
 #include "../src/compiler/x86/common/compiler_config.hpp"
@@ -337,3 +341,164 @@ TEST(DebugHelperTraceTest, ComparisonWithAndWithoutTracing) {
     std::cout << "============================================================\n";
     std::cout << "\n";
 }
+
+#if defined(__linux__) && defined(__x86_64__)
+// executeDirect() is the multithreaded hot path: each thread must trace into
+// its own ring, never into the shared one
+TEST(DebugHelperTraceTest, ExecuteDirectTracesIntoThreadRings) {
+    CompilerConfig config = CompilerConfig::Default();
+    config.printRuntimeTrace = true;
+    config.instructionSet = CompilerConfig::InstructionSet::SSE2_SCALAR;
+
+    Graph graph;
+    NodeId x = graph.addInput();
+    NodeId y = graph.addInput();
+    graph.markOutput(addBinaryOp(graph, OpCode::Mul, addBinaryOp(graph, OpCode::Add, x, y), y));
+
+    ForgeEngine engine(config);
+    auto kernel = engine.compile(graph);
+    ASSERT_NE(kernel, nullptr);
+
+    initializeTraceBuffer(1024);
+    setTracingEnabled(true);
+    const uint32_t sharedBefore = g_traceBuffer.index.load();
+
+    std::atomic<int> done{0};
+    const TraceBuffer* rings[2] = {nullptr, nullptr};
+    uint32_t written[2] = {0, 0};
+    auto worker = [&](int t) {
+        auto buffer = NodeValueBufferFactory::create(graph, *kernel);
+        buffer->setValue(x, 1.0 + t);
+        buffer->setValue(y, 2.0);
+        kernel->executeDirect(buffer->getValuesPtr(), buffer->getGradientsPtr(), buffer->getNumNodes());
+        rings[t] = acquireThreadTraceBuffer();
+        written[t] = rings[t] ? rings[t]->index.load() : 0;
+        // Both threads hold their rings at the same time, so none is recycled
+        done.fetch_add(1);
+        while (done.load() < 2) std::this_thread::yield();
+    };
+    std::thread first(worker, 0);
+    std::thread second(worker, 1);
+    first.join();
+    second.join();
+
+    ASSERT_NE(rings[0], nullptr);
+    ASSERT_NE(rings[1], nullptr);
+    EXPECT_NE(rings[0], rings[1]);
+    EXPECT_GT(written[0], 0u);
+    EXPECT_GT(written[1], 0u);
+    EXPECT_EQ(g_traceBuffer.index.load(), sharedBefore);
+
+    setTracingEnabled(false);
+    cleanupTraceBuffer();
+}
+#endif
+
+// ============================================================================
+// Per-thread rings and the binary trace dump
+// ============================================================================
+
+class RuntimeTraceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        initializeTraceBuffer(1024);  // Also empties the rings left by earlier tests
+        setTracingEnabled(true);
+    }
+
+    void TearDown() override {
+        cleanupTraceBuffer();
+    }
+};
+
+// Simulates what a traced kernel writes: the next slot of a ring
+static void writeRecord(TraceBuffer& ring, uint32_t id, double value) {
+    TraceRecord& record = ring.records[ring.index.fetch_add(1) & ring.mask];
+    record.instructionId = id;
+    record.operationType = static_cast<uint32_t>(OperationType::ADD);
+    record.vectorWidth = 4;
+    record.timestamp = 0xFFFE0001;
+    reinterpret_cast<double*>(record.data)[0] = value;
+}
+
+TEST_F(RuntimeTraceTest, TestThreadsGetPrivateRings) {
+    TraceBuffer* mainRing = acquireThreadTraceBuffer();
+    ASSERT_NE(mainRing, nullptr);
+    EXPECT_NE(mainRing, &g_traceBuffer);
+    EXPECT_EQ(acquireThreadTraceBuffer(), mainRing);
+
+    TraceBuffer* workerRing = nullptr;
+    uint32_t workerThreadId = 0;
+    std::thread worker([&]() {
+        workerRing = acquireThreadTraceBuffer();
+        // Held until the thread exits, so not shared with the main thread
+        EXPECT_NE(workerRing, mainRing);
+        workerThreadId = workerRing->threadId;
+        writeRecord(*workerRing, 7, 1.5);
+    });
+    worker.join();
+
+    bool foundWorker = false;
+    for (const TraceBuffer* ring : getTraceBuffers()) {
+        foundWorker |= (ring == workerRing);
+    }
+    EXPECT_TRUE(foundWorker);
+
+    // The exited worker's ring (or another idle one) is recycled, not a new one
+    // allocated, and it starts empty under a new thread ID
+    const size_t ringCount = getTraceBuffers().size();
+    const TraceBuffer* recycled = nullptr;
+    uint32_t recycledWritten = 1;
+    uint32_t recycledThreadId = 0;
+    std::thread next([&]() {
+        TraceBuffer* ring = acquireThreadTraceBuffer();
+        recycled = ring;
+        recycledWritten = ring->index.load();
+        recycledThreadId = ring->threadId;
+    });
+    next.join();
+    EXPECT_EQ(getTraceBuffers().size(), ringCount);
+    EXPECT_NE(recycled, mainRing);
+    EXPECT_EQ(recycledWritten, 0u);
+    EXPECT_GT(recycledThreadId, workerThreadId);
+
+#if defined(__linux__) && defined(__x86_64__)
+    // JIT code finds the ring through the thread pointer
+    int64_t offset = 0;
+    ASSERT_TRUE(getThreadTraceBufferOffset(offset));
+    TraceBuffer* viaThreadPointer = nullptr;
+    __asm__("mov %%fs:(%1), %0" : "=r"(viaThreadPointer) : "r"(offset));
+    EXPECT_EQ(viaThreadPointer, mainRing);
+#endif
+}
+
+TEST_F(RuntimeTraceTest, TestTraceDumpRoundTrip) {
+    TraceBuffer* ring = acquireThreadTraceBuffer();
+    ASSERT_NE(ring, nullptr);
+    const uint32_t capacity = ring->mask + 1;
+    for (uint32_t i = 0; i < capacity + 3; ++i) {
+        writeRecord(*ring, i, 0.5 * i);
+    }
+    writeRecord(g_traceBuffer, 42, -1.0);
+
+    std::stringstream dump;
+    writeTraceDump(dump);
+    std::vector<TraceDumpRing> rings = readTraceDump(dump);
+
+    ASSERT_EQ(rings.size(), 2u);
+    EXPECT_EQ(rings[0].threadId, 0u);
+    ASSERT_EQ(rings[0].records.size(), 1u);
+    EXPECT_EQ(rings[0].records[0].instructionId, 42u);
+
+    const TraceDumpRing& threadRing = rings[1];
+    EXPECT_EQ(threadRing.threadId, ring->threadId);
+    EXPECT_EQ(threadRing.written, capacity + 3);
+    ASSERT_EQ(threadRing.records.size(), capacity);
+    // Oldest surviving record first
+    EXPECT_EQ(threadRing.records.front().instructionId, 3u);
+    EXPECT_EQ(threadRing.records.back().instructionId, capacity + 2);
+    EXPECT_EQ(reinterpret_cast<const double*>(threadRing.records.back().data)[0], 0.5 * (capacity + 2));
+    EXPECT_EQ(threadRing.records.back().timestamp, 0xFFFE0001u);
+
+    std::stringstream garbage("not a dump");
+    EXPECT_THROW(readTraceDump(garbage), std::runtime_error);
+}
@@ -160,11 +160,8 @@ private:
         result.stabilityTimeMs = optStats.stabilityTimeMs;
         result.totalOptimizationTimeMs = optStats.totalOptimizationTimeMs;
         
-        // Count dead nodes
-        size_t deadCount = 0;
-        for (const auto& node : optimizedGraph.nodes) {
-            if (node.isDead) deadCount++;
-        }
+        // Nodes removed by dead code elimination and compaction
+        size_t deadCount = optStats.originalNodeCount - std::min(optStats.originalNodeCount, optimizedGraph.nodes.size());
         result.deadNodesMarked = deadCount;
         result.optimizationRatio = (optStats.originalNodeCount > 0) ? 
             (100.0 * deadCount / optStats.originalNodeCount) : 0.0;
@@ -256,10 +253,10 @@ private:
                      << "| Numerical stability improvements|" << std::endl;
         }
         
-        std::cout << "| Dead Nodes Marked          | " << std::setw(11) << result.deadNodesMarked 
+        std::cout << "| Dead Nodes Removed         | " << std::setw(11) << result.deadNodesMarked 
                   << " | " << std::setw(13) << std::fixed << std::setprecision(1)
                   << result.optimizationRatio << "% "
-                  << "| Nodes marked dead (skipped)     |" << std::endl;
+                  << "| Removed from graph and buffers  |" << std::endl;
         
         size_t effectiveNodes = result.originalNodeCount - result.deadNodesMarked;
         std::cout << "| Active Nodes Remaining     | " << std::setw(11) << effectiveNodes 
@@ -267,8 +264,8 @@ private:
                   << (100.0 * effectiveNodes / result.originalNodeCount) << "% "
                   << "| Nodes actively computed         |" << std::endl;
         
-        std::cout << "\nNote: Nodes are marked as 'dead' but remain in the graph structure to preserve workspace compatibility." << std::endl;
-        std::cout << "      Dead nodes are skipped during JIT execution, providing the performance benefit without memory reallocation." << std::endl;
+        std::cout << "\nNote: Dead and unreachable nodes are removed and the graph is renumbered densely before forging." << std::endl;
+        std::cout << "      Kernel scans and node value buffers shrink with the optimized graph." << std::endl;
     }
     
     // Helper to analyze graph structure
@@ -498,7 +495,6 @@ private:
 
                         if (withGradient) {
                             buffer->setLanes(diffInputNode, batch);
-                            buffer->clearGradients();
                         } else {
                             buffer->setLanes(inputNode, batch);
                         }
@@ -510,7 +506,6 @@ private:
                         double inputData[1] = {x};
                         if (withGradient) {
                             buffer->setLanes(diffInputNode, inputData);
-                            buffer->clearGradients();
                         } else {
                             buffer->setLanes(inputNode, inputData);
                         }
@@ -545,7 +540,6 @@ private:
 
                 if (withGradient) {
                     buffer->setLanes(diffInputNode, batch);
-                    buffer->clearGradients();
                 } else {
                     buffer->setLanes(inputNode, batch);
                 }
@@ -575,7 +569,6 @@ private:
                 double inputData[1] = {x};
                 if (withGradient) {
                     buffer->setLanes(diffInputNode, inputData);
-                    buffer->clearGradients();
                 } else {
                     buffer->setLanes(inputNode, inputData);
                 }
@@ -623,7 +616,6 @@ private:
 
                         if (withGradient) {
                             buffer->setLanes(diffInputNode, batch);
-                            buffer->clearGradients();
                             kernel->execute(*buffer);
                         } else {
                             buffer->setLanes(inputNode, batch);
@@ -639,7 +631,6 @@ private:
                             // The kernel was compiled from a tape with gradient flags,
                             // so it computes BOTH forward and backward passes
                             buffer->setLanes(diffInputNode, inputData);
-                            buffer->clearGradients();
                             kernel->execute(*buffer);
                             // After execution, both values and gradients are computed
                         } else {
@@ -1206,14 +1197,12 @@ public:
                         // Warmup and benchmark AVX2 forward+backward
                         for (int i = 0; i < config_.warmupRuns; ++i) {
                             avx2BufferWithDiff->setLanes(diffInputNode, batch);
-                            avx2BufferWithDiff->clearGradients();
                             avx2KernelWithDiff->execute(*avx2BufferWithDiff);
                         }
 
                         auto avx2WithGradStart = std::chrono::high_resolution_clock::now();
                         for (size_t iter = 0; iter < config_.iterations; ++iter) {
                             avx2BufferWithDiff->setLanes(diffInputNode, batch);
-                            avx2BufferWithDiff->clearGradients();
                             avx2KernelWithDiff->execute(*avx2BufferWithDiff);
                         }
                         auto avx2WithGradEnd = std::chrono::high_resolution_clock::now();
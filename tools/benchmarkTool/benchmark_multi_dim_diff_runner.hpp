@@ -20,6 +20,7 @@
 #include "../../src/compiler/forge_engine.hpp"
 #include "../../src/compiler/interfaces/node_value_buffer.hpp"
 #include <native/fdouble.hpp>
+#include "hardware_counters.hpp"
 
 namespace forge {
 namespace tools {
@@ -37,6 +38,7 @@ struct BenchmarkMultiDimDiffConfig {
     double jacobianRelTolerance = 1e-6;
     bool showJacobianDetails = false;  // Show individual ∂f_i/∂x_j timings
     bool showScalingAnalysis = true;   // Show how timing scales with dimensions
+    bool hardwareCounters = true;      // Count cycles, instructions and misses of the JIT loops (Linux)
 };
 
 struct BenchmarkMultiDimDiffResult {
@@ -92,6 +94,8 @@ struct BenchmarkMultiDimDiffResult {
     double nativeFDJacobianTime;  // Finite difference Jacobian
     double jitForwardOnlyTime;
     double jitFullJacobianTime;   // Forward + all gradient computations
+    HardwareCounterSample jitForwardOnlyCounters;    // Per evaluation (see hardware_counters.hpp)
+    HardwareCounterSample jitFullJacobianCounters;
     
     // Accuracy metrics
     std::vector<std::vector<double>> fdJacobian;    // Finite difference Jacobian
@@ -249,11 +253,8 @@ private:
         result.stabilityTimeMs = optStats.stabilityTimeMs;
         result.totalOptimizationTimeMs = optStats.totalOptimizationTimeMs;
         
-        // Count dead nodes
-        size_t deadCount = 0;
-        for (const auto& node : optimizedGraph.nodes) {
-            if (node.isDead) deadCount++;
-        }
+        // Nodes removed by dead code elimination and compaction
+        size_t deadCount = optStats.originalNodeCount - std::min(optStats.originalNodeCount, optimizedGraph.nodes.size());
         result.deadNodesMarked = deadCount;
         result.optimizationRatio = (optStats.originalNodeCount > 0) ? 
             (100.0 * deadCount / optStats.originalNodeCount) : 0.0;
@@ -345,10 +346,10 @@ private:
                      << "| Numerical stability improvements|" << std::endl;
         }
         
-        std::cout << "| Dead Nodes Marked          | " << std::setw(11) << result.deadNodesMarked 
+        std::cout << "| Dead Nodes Removed         | " << std::setw(11) << result.deadNodesMarked 
                   << " | " << std::setw(13) << std::fixed << std::setprecision(1)
                   << result.optimizationRatio << "% "
-                  << "| Nodes marked dead (skipped)     |" << std::endl;
+                  << "| Removed from graph and buffers  |" << std::endl;
         
         size_t effectiveNodes = result.originalNodeCount - result.deadNodesMarked;
         std::cout << "| Active Nodes Remaining     | " << std::setw(11) << effectiveNodes 
@@ -356,8 +357,8 @@ private:
                   << (100.0 * effectiveNodes / result.originalNodeCount) << "% "
                   << "| Nodes actively computed         |" << std::endl;
         
-        std::cout << "\nNote: Nodes are marked as 'dead' but remain in the graph structure to preserve workspace compatibility." << std::endl;
-        std::cout << "      Dead nodes are skipped during JIT execution, providing the performance benefit without memory reallocation." << std::endl;
+        std::cout << "\nNote: Dead and unreachable nodes are removed and the graph is renumbered densely before forging." << std::endl;
+        std::cout << "      Kernel scans and node value buffers shrink with the optimized graph." << std::endl;
     }
     
     // Compute automatic differentiation Jacobian
@@ -401,7 +402,6 @@ private:
             for (size_t i = 0; i < numInputs; ++i) {
                 buffer->setValue(graph.diff_inputs[i], input[i]);
             }
-            buffer->clearGradients();
             
             // Execute to compute gradients
             kernel->execute(*buffer);
@@ -525,7 +525,8 @@ private:
                          double& forwardTime, double& jacobianTime,
                          double& graphOptTime, double& codeGenTime,
                          std::vector<std::vector<double>>& outputs,
-                         std::vector<std::vector<double>>& jacobian) {
+                         std::vector<std::vector<double>>& jacobian,
+                         HardwareCounterSample& counterSample) {
         
         // Average compilation over multiple runs for stability
         const int numCompilations = 5;
@@ -558,7 +559,6 @@ private:
                         for (size_t j = 0; j < numInputs; ++j) {
                             buffer->setValue(graph.diff_inputs[j], input[j]);
                         }
-                        buffer->clearGradients();
                     } else {
                         for (size_t j = 0; j < numInputs; ++j) {
                             NodeId inputNode = j;  // Assumes inputs are first nodes
@@ -578,7 +578,6 @@ private:
                 for (size_t j = 0; j < numInputs; ++j) {
                     buffer->setValue(graph.diff_inputs[j], input[j]);
                 }
-                buffer->clearGradients();
             } else {
                 for (size_t j = 0; j < numInputs; ++j) {
                     NodeId inputNode = j;  // Assumes inputs are first nodes
@@ -598,9 +597,14 @@ private:
         const int numRounds = 5;
         std::vector<double> timings;
         
+        // One counter sample per round; the sleeps between rounds are not counted
+        HardwareCounters counters;
+        std::vector<HardwareCounterSample> roundCounters;
+        
         for (int round = 0; round < numRounds; ++round) {
             std::this_thread::sleep_for(std::chrono::microseconds(100));
             
+            if (config_.hardwareCounters) counters.start();
             auto start = std::chrono::high_resolution_clock::now();
             
             for (size_t iter = 0; iter < config_.iterations; ++iter) {
@@ -609,7 +613,6 @@ private:
                         for (size_t j = 0; j < numInputs; ++j) {
                             buffer->setValue(graph.diff_inputs[j], input[j]);
                         }
-                        buffer->clearGradients();
                         kernel->execute(*buffer);
                     } else {
                         for (size_t j = 0; j < numInputs; ++j) {
@@ -622,11 +625,20 @@ private:
             }
             
             auto end = std::chrono::high_resolution_clock::now();
+            if (config_.hardwareCounters) roundCounters.push_back(counters.stop(static_cast<double>(config_.iterations * inputs.size())));
             double duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
             double timePerEval = duration / (config_.iterations * inputs.size());
             timings.push_back(timePerEval);
         }
         
+        // Report the counters of the median-time round
+        if (!roundCounters.empty()) {
+            std::vector<size_t> order(timings.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(), order.end(), [&](size_t x, size_t y) { return timings[x] < timings[y]; });
+            counterSample = roundCounters[order[order.size() / 2]];
+        }
+        
         std::sort(timings.begin(), timings.end());
         double medianTime = timings[timings.size() / 2];
         
@@ -790,7 +802,7 @@ public:
             benchmarkKernel<false>(nonDiffTape, func.inputs, numInputs, numOutputs,
                                   result.jitForwardOnlyTime, result.jitFullJacobianTime,
                                   result.nonDiffGraphOptTime, result.nonDiffCodeGenTime,
-                                  nonDiffOutputs, dummyJacobian);
+                                  nonDiffOutputs, dummyJacobian, result.jitForwardOnlyCounters);
             
             std::this_thread::sleep_for(std::chrono::milliseconds(10));
             
@@ -798,7 +810,7 @@ public:
             benchmarkKernel<true>(withDiffTape, func.inputs, numInputs, numOutputs,
                                  result.jitFullJacobianTime, result.jitFullJacobianTime,
                                  result.withDiffGraphOptTime, result.withDiffCodeGenTime,
-                                 withDiffOutputs, dummyJacobian);
+                                 withDiffOutputs, dummyJacobian, result.jitFullJacobianCounters);
             
             // JIT size estimation
             result.nonDiffJitSize = result.nonDiffNodes * 50;
@@ -877,6 +889,15 @@ public:
                      << " | " << std::setw(8) << totalSpeedup << "x"
                      << " |       - | vs FD     |" << std::endl;
             
+            if (config_.hardwareCounters) {
+                std::cout << "\nHardware counters per evaluation (misses per 1000 instructions):" << std::endl;
+                std::cout << "  JIT Forward Only   ";
+                printHardwareCounters(result.jitForwardOnlyCounters, std::cout);
+                std::cout << "\n  JIT Full Jacobian  ";
+                printHardwareCounters(result.jitFullJacobianCounters, std::cout);
+                std::cout << std::endl;
+            }
+            
             // SECTION 5: JACOBIAN ACCURACY (sample)
             if (!func.inputs.empty()) {
                 std::cout << "\nSECTION 5: JACOBIAN ACCURACY (Sample: first test input)" << std::endl;
@@ -15,6 +15,7 @@
 #include "../../src/compiler/forge_engine.hpp"
 #include "../../src/compiler/interfaces/node_value_buffer.hpp"
 #include "../../src/compiler/x86/common/compiler_config.hpp"
+#include "hardware_counters.hpp"
 
 namespace forge {
 namespace tools {
@@ -25,6 +26,7 @@ struct ComprehensiveBenchmarkResult {
     double graphOptimizationTimeMs;
     double kernelCreationTimeMs;
     double kernelEvalTimeNs;
+    HardwareCounterSample kernelCounters;  // Per kernel evaluation (see hardware_counters.hpp)
     double nativeEvalTimeNs;
     double speedup;
     std::vector<double> testInputs;  // Test inputs used for this function
@@ -72,6 +74,7 @@ struct BenchmarkConfig {
     bool verifyResults = true;
     double tolerance = 1e-10;
     bool testAvx2 = true;  // Test AVX2 in addition to SSE2
+    bool hardwareCounters = true;  // Count cycles, instructions and misses of the kernel loop (Linux)
 };
 
 // Main benchmark runner class
@@ -211,11 +214,8 @@ private:
         result.totalOptimizationTimeMs = optStats.totalOptimizationTimeMs;
         result.passesPerformed = optStats.passesPerformed;
         
-        // Count dead nodes
-        size_t deadCount = 0;
-        for (const auto& node : optimizedGraph.nodes) {
-            if (node.isDead) deadCount++;
-        }
+        // Nodes removed by dead code elimination and compaction
+        size_t deadCount = optStats.originalNodeCount - std::min(optStats.originalNodeCount, optimizedGraph.nodes.size());
         result.deadNodesMarked = deadCount;
         result.optimizationRatio = (optStats.originalNodeCount > 0) ? 
             (100.0 * deadCount / optStats.originalNodeCount) : 0.0;
@@ -252,6 +252,8 @@ private:
         }
 
         // Step 5: Benchmark kernel execution
+        HardwareCounters counters;
+        if (config_.hardwareCounters) counters.start();
         auto kernelBenchStart = high_resolution_clock::now();
         for (int i = 0; i < config_.benchmarkIterations; ++i) {
             buffer->setLanes(inputNode, inputData);
@@ -261,6 +263,7 @@ private:
             (void)dummy;
         }
         auto kernelBenchEnd = high_resolution_clock::now();
+        if (config_.hardwareCounters) result.kernelCounters = counters.stop(config_.benchmarkIterations);
         result.kernelEvalTimeNs = duration<double, std::nano>(kernelBenchEnd - kernelBenchStart).count() 
                                   / config_.benchmarkIterations;
         
@@ -503,10 +506,24 @@ private:
             PrintAvx2Comparison();
         }
         
+        if (config_.hardwareCounters) {
+            PrintHardwareCounters();
+        }
+        
         // Calculate and print summary statistics (now Section 6)
         PrintSummary();
     }
     
+    void PrintHardwareCounters() {
+        std::cout << "\nHARDWARE COUNTERS (per kernel evaluation, misses per 1000 instructions)" << std::endl;
+        std::cout << "-----------------------------------------------------------------------------------------------------------" << std::endl;
+        for (const auto& result : results_) {
+            std::cout << "  " << std::left << std::setw(24) << result.functionName << std::right << " ";
+            printHardwareCounters(result.kernelCounters, std::cout);
+            std::cout << std::endl;
+        }
+    }
+    
     void PrintGraphInfo() {
         for (const auto& result : results_) {
             std::cout << "\n" << result.functionName << " - Graph Recording Details:" << std::endl;
@@ -620,8 +637,8 @@ private:
                      << (result.originalNodeCount * 1000.0 / std::max(0.01, result.totalOptimizationTimeMs))
                      << " nodes/sec |" << std::endl;
             
-            std::cout << "\nNote: Nodes are marked as 'dead' but remain in the graph structure to preserve workspace compatibility." << std::endl;
-            std::cout << "      Dead nodes are skipped during JIT execution, providing the performance benefit without memory reallocation." << std::endl;
+            std::cout << "\nNote: Dead and unreachable nodes are removed and the graph is renumbered densely before forging." << std::endl;
+            std::cout << "      Kernel scans and node value buffers shrink with the optimized graph." << std::endl;
             
             // Then show impact summary table
             std::cout << "\nOptimization Impact Summary:" << std::endl;
@@ -658,10 +675,10 @@ private:
                          << "| Numerical stability improvements|" << std::endl;
             }
             
-            std::cout << "| Dead Nodes Marked          | " << std::setw(11) << result.deadNodesMarked 
+            std::cout << "| Dead Nodes Removed         | " << std::setw(11) << result.deadNodesMarked 
                       << " | " << std::setw(13) << std::fixed << std::setprecision(1)
                       << result.optimizationRatio << "% "
-                      << "| Nodes marked dead (skipped)     |" << std::endl;
+                      << "| Removed from graph and buffers  |" << std::endl;
             
             size_t effectiveNodes = result.originalNodeCount - result.deadNodesMarked;
             std::cout << "| Active Nodes Remaining     | " << std::setw(11) << effectiveNodes 
@@ -672,15 +689,15 @@ private:
             // Show optimization effectiveness
             std::cout << "\n  Optimization Impact: ";
             if (result.optimizationRatio > 50) {
-                std::cout << "EXCELLENT - Marked " << std::setprecision(1) << result.optimizationRatio << "% of nodes as dead (will be skipped during execution)";
+                std::cout << "EXCELLENT - Removed " << std::setprecision(1) << result.optimizationRatio << "% of nodes from the graph";
             } else if (result.optimizationRatio > 20) {
-                std::cout << "GOOD - Marked " << std::setprecision(1) << result.optimizationRatio << "% of nodes as dead";
+                std::cout << "GOOD - Removed " << std::setprecision(1) << result.optimizationRatio << "% of nodes";
             } else if (result.optimizationRatio > 5) {
-                std::cout << "MODERATE - Marked " << std::setprecision(1) << result.optimizationRatio << "% of nodes as dead";
+                std::cout << "MODERATE - Removed " << std::setprecision(1) << result.optimizationRatio << "% of nodes";
             } else if (result.optimizationRatio > 0.1) {
-                std::cout << "MINIMAL - Marked " << std::setprecision(1) << result.optimizationRatio << "% of nodes as dead";
+                std::cout << "MINIMAL - Removed " << std::setprecision(1) << result.optimizationRatio << "% of nodes";
             } else {
-                std::cout << "NEGLIGIBLE - Marked " << std::setprecision(2) << result.optimizationRatio << "% of nodes as dead";
+                std::cout << "NEGLIGIBLE - Removed " << std::setprecision(2) << result.optimizationRatio << "% of nodes";
             }
             std::cout << std::endl;
         }
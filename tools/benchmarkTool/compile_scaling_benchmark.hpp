@@ -0,0 +1,343 @@
+#pragma once
+
+// Compile-time scalability benchmark: time and peak RSS of every
+// ForgeEngine::compile() phase (see compile_stats.hpp) for generated graphs
+// from 1K to 10M nodes, with a machine-readable report.
+//
+// Generators:
+// - "synthetic": arithmetic-heavy random DAG built directly on forge::Graph;
+//   each node reads its predecessor and a mostly-local earlier node
+// - "bigGraph":  the inner loop of testFunctions/oneToOne/bigGraph.hpp
+//   recorded through fdouble until the requested size is reached
+//
+// For each generator, mode (forward / gradient) and phase the report gives
+// the scaling exponent between consecutive sizes, log(t2/t1) / log(n2/n1):
+// 1.0 is linear, and anything above the threshold breaks the "must be
+// O(nodes)" rule and is marked superlinear.
+//
+//   forge_compile_bench --max-nodes 10000000 --out scaling.json
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include <native/fdouble.hpp>
+#include "../../src/graph/graph.hpp"
+#include "../../src/graph/graph_recorder.hpp"
+#include "../../src/compiler/forge_engine.hpp"
+#include "../../src/compiler/compile_stats.hpp"
+#include "../../src/compiler/x86/common/compiler_config.hpp"
+#include "../testFunctions/select_helper.hpp"
+
+namespace forge {
+namespace tools {
+
+struct CompileScalingConfig {
+    std::vector<size_t> sizes = {1000, 10000, 100000, 1000000};
+    std::vector<std::string> generators = {"synthetic", "bigGraph"};
+    bool forward = true;                  // Compile without diff inputs
+    bool gradient = true;                 // Compile with diff inputs (backward pass)
+    bool optimize = true;                 // CompilerConfig::enableOptimizations with all passes
+    int repetitions = 1;                  // Fastest repetition is reported
+    double superlinearExponent = 1.15;    // Exponent above which a phase is flagged
+    double minPhaseMs = 1.0;              // Phases faster than this at the smaller size are not rated
+};
+
+struct CompileScalingRun {
+    std::string generator;
+    std::string mode;                     // "forward" or "gradient"
+    size_t requestedNodes = 0;
+    double recordMs = 0.0;                // Graph generation
+    size_t recordPeakRssBytes = 0;
+    CompileStats stats;
+};
+
+struct CompileScalingVerdict {
+    std::string generator;
+    std::string mode;
+    std::string phase;                    // A compile phase or "total"
+    double exponent = 0.0;                // Worst consecutive-size exponent
+    size_t fromNodes = 0;
+    size_t toNodes = 0;
+    bool superlinear = false;
+};
+
+namespace compile_scaling_detail {
+
+// Deterministic generator state (graphs must be identical across runs)
+struct Lcg {
+    uint64_t state;
+    explicit Lcg(uint64_t seed) : state(seed) {}
+    uint32_t next() {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return static_cast<uint32_t>(state >> 33);
+    }
+    uint32_t below(uint32_t n) { return next() % n; }
+};
+
+inline NodeId addOp(Graph& graph, OpCode op, NodeId a, NodeId b = UINT32_MAX, NodeId c = UINT32_MAX, bool grad = false) {
+    Node node{};
+    node.op = op;
+    node.a = a;
+    node.b = b;
+    node.c = c;
+    node.needsGradient = grad;
+    return graph.addNode(node);
+}
+
+inline Graph syntheticGraph(size_t targetNodes, bool gradient) {
+    Graph graph;
+    graph.nodes.reserve(targetNodes + 8);
+    Lcg rng(0x5eed);
+    const size_t inputs = 16;
+    for (size_t i = 0; i < inputs; ++i) {
+        NodeId input = graph.addInput();
+        if (gradient) {
+            graph.diff_inputs.push_back(input);
+            graph.nodes[input].needsGradient = true;
+        }
+    }
+
+    NodeId prev = static_cast<NodeId>(inputs - 1);
+    while (graph.nodes.size() < targetNodes) {
+        const NodeId count = static_cast<NodeId>(graph.nodes.size());
+        // Mostly local operands keep register pressure realistic; a few reach far back
+        const NodeId other = rng.below(10) == 0 ? rng.below(count) : count - 1 - rng.below(std::min<NodeId>(count, 32));
+        if (graph.nodes[other].op == OpCode::Constant || rng.below(50) == 0) {
+            prev = addOp(graph, OpCode::Mul, prev, graph.addConstant(0.5 + rng.below(1000) * 1e-3), UINT32_MAX, gradient);
+            continue;
+        }
+        const uint32_t pick = rng.below(100);
+        if (pick < 30) prev = addOp(graph, OpCode::Add, prev, other, UINT32_MAX, gradient);
+        else if (pick < 58) prev = addOp(graph, OpCode::Mul, prev, other, UINT32_MAX, gradient);
+        else if (pick < 70) prev = addOp(graph, OpCode::Sub, prev, other, UINT32_MAX, gradient);
+        else if (pick < 75) prev = addOp(graph, OpCode::Div, prev, other, UINT32_MAX, gradient);
+        else if (pick < 80) prev = addOp(graph, OpCode::Max, prev, other, UINT32_MAX, gradient);
+        else if (pick < 85) prev = addOp(graph, OpCode::Min, prev, other, UINT32_MAX, gradient);
+        else if (pick < 90) prev = addOp(graph, OpCode::Abs, prev, UINT32_MAX, UINT32_MAX, gradient);
+        else if (pick < 96) {
+            const NodeId cond = addOp(graph, OpCode::CmpGT, prev, other);
+            prev = addOp(graph, OpCode::If, cond, prev, other, gradient);
+        }
+        else if (pick < 98) prev = addOp(graph, OpCode::Sqrt, addOp(graph, OpCode::Abs, prev, UINT32_MAX, UINT32_MAX, gradient),
+                                         UINT32_MAX, UINT32_MAX, gradient);
+        else prev = addOp(graph, OpCode::Exp, prev, UINT32_MAX, UINT32_MAX, gradient);
+    }
+    graph.markOutput(prev);
+    return graph;
+}
+
+// Inner loop body of massiveIterativeGraph (bigGraph.hpp), repeated until the tape is large enough
+inline Graph bigGraphStyle(size_t targetNodes, bool gradient) {
+    using test_functions::select;
+    using test_functions::select_abs;
+    using test_functions::select_max;
+    using test_functions::select_min;
+
+    GraphRecorder recorder;
+    recorder.setSegmentedStorage(targetNodes > 1000000);
+    recorder.start();
+    fdouble x(0.5);
+    if (gradient) x.markInputAndDiff();
+    else x.markInput();
+
+    fdouble result = x * fdouble(0.1) + fdouble(1.0);
+    fdouble accumulator = fdouble(1.0);
+    fdouble state1 = fdouble(0.0);
+    fdouble state2 = fdouble(1.0);
+    for (size_t step = 0; recorder.graph().size() < targetNodes; ++step) {
+        const fdouble factor = fdouble(static_cast<double>(step % 1000 + 1) * 0.001);
+        const fdouble subfactor = fdouble(static_cast<double>(step % 997 + 1) * 0.0001);
+        fdouble temp5 = ((result * factor) * subfactor - accumulator + state1) / (subfactor + fdouble(0.01));
+        fdouble conditional = select(temp5 > fdouble(0.0), select_max(temp5, state2), select_min(temp5, -state2));
+        fdouble power = select_abs(conditional);
+        if (step % 40 == 0) power = pow(power * power + fdouble(1.0), fdouble(1.5));
+        fdouble bounded = power * fdouble(0.001);
+        state1 = state1 * fdouble(0.999) + bounded;
+        state2 = select_abs(state2 * fdouble(0.998)) + bounded * fdouble(0.1);
+        accumulator = accumulator * fdouble(0.9999) + bounded;
+        result = result * fdouble(0.9995) + bounded * fdouble(0.001);
+    }
+    (result * fdouble(10.0) + x).markOutput();
+    recorder.stop();
+    return recorder.releaseGraph();
+}
+
+inline Graph generate(const std::string& generator, size_t targetNodes, bool gradient) {
+    if (generator == "synthetic") return syntheticGraph(targetNodes, gradient);
+    if (generator == "bigGraph") return bigGraphStyle(targetNodes, gradient);
+    throw std::runtime_error("Unknown graph generator: " + generator);
+}
+
+inline double phaseMs(const CompileScalingRun& run, const std::string& phase) {
+    if (phase == "total") return run.stats.totalMs;
+    const CompileStats::Phase* p = run.stats.phase(phase);
+    return p ? p->timeMs : 0.0;
+}
+
+} // namespace compile_scaling_detail
+
+/**
+ * @brief Generate and compile every configured graph
+ * @param progress Receives one line per compile (nullptr for silence)
+ */
+inline std::vector<CompileScalingRun> runCompileScaling(const CompileScalingConfig& config,
+                                                        std::ostream* progress = &std::cout) {
+    using namespace compile_scaling_detail;
+    using Clock = std::chrono::steady_clock;
+
+    CompilerConfig compilerConfig = CompilerConfig::Default();
+    if (config.optimize) {
+        compilerConfig.enableOptimizations = true;
+        compilerConfig.enableInactiveFolding = true;
+        compilerConfig.enableCSE = true;
+        compilerConfig.enableAlgebraicSimplification = true;
+    }
+    compilerConfig.collectCompileStats = true;
+
+    std::vector<std::string> modes;
+    if (config.forward) modes.push_back("forward");
+    if (config.gradient) modes.push_back("gradient");
+
+    std::vector<CompileScalingRun> runs;
+    for (const std::string& generator : config.generators) {
+        for (const std::string& mode : modes) {
+            for (const size_t size : config.sizes) {
+                CompileScalingRun best;
+                for (int rep = 0; rep < std::max(config.repetitions, 1); ++rep) {
+                    CompileScalingRun run;
+                    run.generator = generator;
+                    run.mode = mode;
+                    run.requestedNodes = size;
+
+                    resetPeakRss();
+                    const auto recordStart = Clock::now();
+                    Graph graph = generate(generator, size, mode == "gradient");
+                    run.recordMs = std::chrono::duration<double, std::milli>(Clock::now() - recordStart).count();
+                    run.recordPeakRssBytes = peakRssBytes();
+
+                    ForgeEngine engine(compilerConfig);
+                    {
+                        auto kernel = engine.compile(graph);
+                    }
+                    run.stats = engine.getLastCompileStats();
+                    if (rep == 0 || run.stats.totalMs < best.stats.totalMs) best = std::move(run);
+                }
+
+                if (progress) {
+                    *progress << std::left << std::setw(10) << generator << std::setw(9) << mode << std::right
+                              << std::setw(9) << best.stats.graphNodes << " nodes  " << std::fixed << std::setprecision(1)
+                              << std::setw(9) << best.stats.totalMs << " ms  ";
+                    for (const auto& phase : best.stats.phases) {
+                        *progress << phase.name << '=' << std::setprecision(1) << phase.timeMs << "ms/"
+                                  << (phase.peakRssBytes >> 20) << "MB ";
+                    }
+                    *progress << std::endl;
+                }
+                runs.push_back(std::move(best));
+            }
+        }
+    }
+    return runs;
+}
+
+/** @brief Worst consecutive-size exponent per generator, mode and phase */
+inline std::vector<CompileScalingVerdict> analyzeCompileScaling(const std::vector<CompileScalingRun>& runs,
+                                                                const CompileScalingConfig& config) {
+    using compile_scaling_detail::phaseMs;
+
+    std::map<std::pair<std::string, std::string>, std::vector<const CompileScalingRun*>> series;
+    for (const auto& run : runs) series[{run.generator, run.mode}].push_back(&run);
+
+    std::vector<CompileScalingVerdict> verdicts;
+    for (auto& [key, points] : series) {
+        std::sort(points.begin(), points.end(), [](const CompileScalingRun* x, const CompileScalingRun* y) {
+            return x->stats.graphNodes < y->stats.graphNodes;
+        });
+        std::vector<std::string> phases{"total"};
+        for (const auto& phase : points.front()->stats.phases) phases.push_back(phase.name);
+
+        for (const std::string& phase : phases) {
+            CompileScalingVerdict verdict;
+            verdict.generator = key.first;
+            verdict.mode = key.second;
+            verdict.phase = phase;
+            bool rated = false;
+            for (size_t i = 1; i < points.size(); ++i) {
+                const double n1 = static_cast<double>(points[i - 1]->stats.graphNodes);
+                const double n2 = static_cast<double>(points[i]->stats.graphNodes);
+                const double t1 = phaseMs(*points[i - 1], phase);
+                const double t2 = phaseMs(*points[i], phase);
+                if (n2 <= n1 || t1 < config.minPhaseMs || t2 <= 0.0) continue;
+                const double exponent = std::log(t2 / t1) / std::log(n2 / n1);
+                if (!rated || exponent > verdict.exponent) {
+                    verdict.exponent = exponent;
+                    verdict.fromNodes = points[i - 1]->stats.graphNodes;
+                    verdict.toNodes = points[i]->stats.graphNodes;
+                    rated = true;
+                }
+            }
+            if (!rated) continue;
+            verdict.superlinear = verdict.exponent > config.superlinearExponent;
+            verdicts.push_back(verdict);
+        }
+    }
+    return verdicts;
+}
+
+inline nlohmann::json compileScalingToJson(const std::vector<CompileScalingRun>& runs,
+                                           const std::vector<CompileScalingVerdict>& verdicts) {
+    nlohmann::json doc;
+    doc["schema"] = "forge-compile-scaling/1";
+    doc["runs"] = nlohmann::json::array();
+    for (const auto& run : runs) {
+        nlohmann::json phases = nlohmann::json::array();
+        for (const auto& phase : run.stats.phases) {
+            phases.push_back({{"name", phase.name},
+                              {"timeMs", phase.timeMs},
+                              {"nsPerNode", phase.timeMs * 1e6 / std::max<size_t>(run.stats.graphNodes, 1)},
+                              {"rssBytes", phase.rssBytes},
+                              {"peakRssBytes", phase.peakRssBytes}});
+        }
+        doc["runs"].push_back({{"generator", run.generator},
+                               {"mode", run.mode},
+                               {"requestedNodes", run.requestedNodes},
+                               {"graphNodes", run.stats.graphNodes},
+                               {"workingNodes", run.stats.workingNodes},
+                               {"codeSize", run.stats.codeSize},
+                               {"recordMs", run.recordMs},
+                               {"recordPeakRssBytes", run.recordPeakRssBytes},
+                               {"totalMs", run.stats.totalMs},
+                               {"perPhasePeaks", run.stats.perPhasePeaks},
+                               {"phases", phases}});
+    }
+    doc["scaling"] = nlohmann::json::array();
+    for (const auto& v : verdicts) {
+        doc["scaling"].push_back({{"generator", v.generator},
+                                  {"mode", v.mode},
+                                  {"phase", v.phase},
+                                  {"exponent", v.exponent},
+                                  {"fromNodes", v.fromNodes},
+                                  {"toNodes", v.toNodes},
+                                  {"superlinear", v.superlinear}});
+    }
+    return doc;
+}
+
+inline void printCompileScaling(const std::vector<CompileScalingVerdict>& verdicts, std::ostream& out) {
+    out << "=== Compile scaling (exponent 1.0 = linear) ===" << std::endl;
+    for (const auto& v : verdicts) {
+        out << std::left << std::setw(10) << v.generator << std::setw(9) << v.mode << std::setw(10) << v.phase
+            << std::right << std::fixed << std::setprecision(2) << std::setw(6) << v.exponent << "  ("
+            << v.fromNodes << " -> " << v.toNodes << " nodes)" << (v.superlinear ? "  SUPERLINEAR" : "") << std::endl;
+    }
+}
+
+} // namespace tools
+} // namespace forge
@@ -0,0 +1,104 @@
+// Command line driver for the compile-time scalability benchmark (compile_scaling_benchmark.hpp)
+//
+// Exit status: 0 = ok, 1 = a phase scales superlinearly (--fail-superlinear), 2 = usage or I/O error
+
+#include "compile_scaling_benchmark.hpp"
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --out FILE             write runs and scaling exponents as JSON\n"
+              << "  --sizes 1000,10000     node counts (default 1K..1M)\n"
+              << "  --max-nodes N          decades from 1K up to N (e.g. 10000000)\n"
+              << "  --generators A,B       synthetic, bigGraph (default: both)\n"
+              << "  --reps N               repetitions per size, fastest is kept\n"
+              << "  --exponent X           superlinear threshold (default 1.15)\n"
+              << "  --min-ms X             do not rate phases faster than X ms\n"
+              << "  --no-optimize          compile without graph optimizations\n"
+              << "  --no-forward | --no-gradient\n"
+              << "  --fail-superlinear     exit with 1 when any phase is superlinear\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    using namespace forge::tools;
+
+    CompileScalingConfig config;
+    std::string outPath;
+    bool failSuperlinear = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                printUsage(argv[0]);
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+        if (arg == "--out") outPath = next();
+        else if (arg == "--sizes") {
+            config.sizes.clear();
+            for (const auto& size : splitList(next())) config.sizes.push_back(std::strtoull(size.c_str(), nullptr, 10));
+        }
+        else if (arg == "--max-nodes") {
+            const size_t maxNodes = std::strtoull(next().c_str(), nullptr, 10);
+            config.sizes.clear();
+            for (size_t size = 1000; size <= maxNodes; size *= 10) config.sizes.push_back(size);
+        }
+        else if (arg == "--generators") config.generators = splitList(next());
+        else if (arg == "--reps") config.repetitions = std::atoi(next().c_str());
+        else if (arg == "--exponent") config.superlinearExponent = std::atof(next().c_str());
+        else if (arg == "--min-ms") config.minPhaseMs = std::atof(next().c_str());
+        else if (arg == "--no-optimize") config.optimize = false;
+        else if (arg == "--no-forward") config.forward = false;
+        else if (arg == "--no-gradient") config.gradient = false;
+        else if (arg == "--fail-superlinear") failSuperlinear = true;
+        else {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+    if (config.sizes.empty()) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    std::vector<CompileScalingRun> runs;
+    try {
+        runs = runCompileScaling(config);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 2;
+    }
+    const auto verdicts = analyzeCompileScaling(runs, config);
+    printCompileScaling(verdicts, std::cout);
+
+    if (!outPath.empty()) {
+        std::ofstream out(outPath);
+        out << compileScalingToJson(runs, verdicts).dump(2) << std::endl;
+        if (!out) {
+            std::cerr << "Cannot write " << outPath << std::endl;
+            return 2;
+        }
+    }
+
+    bool superlinear = false;
+    for (const auto& verdict : verdicts) superlinear = superlinear || verdict.superlinear;
+    return failSuperlinear && superlinear ? 1 : 0;
+}
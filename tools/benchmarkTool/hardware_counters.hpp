@@ -0,0 +1,228 @@
+#pragma once
+
+// Hardware performance counters for the benchmark runners (Linux perf_event_open)
+//
+// HardwareCounters counts the calling thread's user-mode cycles, instructions,
+// branch misses and L1D / L2 / LLC load misses between start() and stop() and
+// returns them per evaluation. The counters are opened as two groups (core
+// events and cache events) so each group is scheduled as a whole; when the
+// PMU multiplexes them, values are scaled by time_enabled / time_running.
+//
+// Everything degrades gracefully: a counter the kernel, CPU, hypervisor or
+// perf_event_paranoid setting refuses reads as NaN, and on other platforms
+// every sample is unavailable. L2 misses use a raw event and are only counted
+// on Intel (L2_RQSTS.MISS) and AMD Zen (L2CacheReqStat IC+DC miss).
+//
+//   HardwareCounters counters;
+//   counters.start();
+//   for (int i = 0; i < n; ++i) kernel->execute(*buffer);
+//   HardwareCounterSample perEval = counters.stop(n);
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+#endif
+
+namespace forge {
+namespace tools {
+
+// Counts per evaluation; NaN where a counter is unavailable
+struct HardwareCounterSample {
+    bool available = false;  // At least one counter was counted
+    double cycles = std::numeric_limits<double>::quiet_NaN();
+    double instructions = std::numeric_limits<double>::quiet_NaN();
+    double branchMisses = std::numeric_limits<double>::quiet_NaN();
+    double l1dMisses = std::numeric_limits<double>::quiet_NaN();
+    double l2Misses = std::numeric_limits<double>::quiet_NaN();
+    double llcMisses = std::numeric_limits<double>::quiet_NaN();
+
+    double ipc() const { return instructions / cycles; }
+
+    // Misses per thousand instructions: the usual way to compare kernels of different sizes
+    double mpki(double misses) const { return 1000.0 * misses / instructions; }
+};
+
+class HardwareCounters {
+public:
+    enum Event { Cycles, Instructions, BranchMisses, L1DMisses, L2Misses, LLCMisses, EventCount };
+
+    HardwareCounters() {
+#ifdef __linux__
+        openGroup({Cycles, Instructions, BranchMisses});
+        openGroup({L1DMisses, L2Misses, LLCMisses});
+#endif
+    }
+
+    ~HardwareCounters() {
+#ifdef __linux__
+        for (const Group& group : groups_) {
+            for (int fd : group.fds) close(fd);
+        }
+#endif
+    }
+
+    HardwareCounters(const HardwareCounters&) = delete;
+    HardwareCounters& operator=(const HardwareCounters&) = delete;
+
+    // True if any counter could be opened
+    bool available() const { return !groups_.empty(); }
+
+    // Why the core counters are missing (empty if they are open)
+    const std::string& unavailableReason() const { return reason_; }
+
+    void start() {
+#ifdef __linux__
+        for (const Group& group : groups_) {
+            ioctl(group.fds.front(), PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(group.fds.front(), PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+
+    // Stop counting and divide the counts by the number of evaluations since start()
+    HardwareCounterSample stop(double evaluations = 1.0) {
+        HardwareCounterSample sample;
+#ifdef __linux__
+        double values[EventCount];
+        for (double& value : values) value = std::numeric_limits<double>::quiet_NaN();
+        for (const Group& group : groups_) {
+            ioctl(group.fds.front(), PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+            // PERF_FORMAT_GROUP | TOTAL_TIME_ENABLED | TOTAL_TIME_RUNNING: nr, enabled, running, values[nr]
+            std::vector<uint64_t> data(3 + group.events.size());
+            const ssize_t expected = static_cast<ssize_t>(data.size() * sizeof(uint64_t));
+            if (read(group.fds.front(), data.data(), expected) != expected || data[2] == 0) continue;
+            const double scale = static_cast<double>(data[1]) / static_cast<double>(data[2]);
+            for (size_t i = 0; i < group.events.size() && i < data[0]; ++i) {
+                values[group.events[i]] = static_cast<double>(data[3 + i]) * scale / evaluations;
+            }
+            sample.available = true;
+        }
+        sample.cycles = values[Cycles];
+        sample.instructions = values[Instructions];
+        sample.branchMisses = values[BranchMisses];
+        sample.l1dMisses = values[L1DMisses];
+        sample.l2Misses = values[L2Misses];
+        sample.llcMisses = values[LLCMisses];
+#else
+        (void)evaluations;
+#endif
+        return sample;
+    }
+
+private:
+    struct Group {
+        std::vector<int> fds;       // fds.front() is the group leader
+        std::vector<Event> events;  // Event of each fd, in read order
+    };
+
+#ifdef __linux__
+    static bool eventAttr(Event event, perf_event_attr& attr) {
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        const uint64_t readMiss = (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        switch (event) {
+            case Cycles: attr.type = PERF_TYPE_HARDWARE; attr.config = PERF_COUNT_HW_CPU_CYCLES; return true;
+            case Instructions: attr.type = PERF_TYPE_HARDWARE; attr.config = PERF_COUNT_HW_INSTRUCTIONS; return true;
+            case BranchMisses: attr.type = PERF_TYPE_HARDWARE; attr.config = PERF_COUNT_HW_BRANCH_MISSES; return true;
+            case L1DMisses: attr.type = PERF_TYPE_HW_CACHE; attr.config = PERF_COUNT_HW_CACHE_L1D | readMiss; return true;
+            case LLCMisses: attr.type = PERF_TYPE_HW_CACHE; attr.config = PERF_COUNT_HW_CACHE_LL | readMiss; return true;
+            case L2Misses: {
+                // No generic L2 event: use the vendor's raw encoding (umask << 8 | event)
+                const std::string vendor = cpuVendor();
+                attr.type = PERF_TYPE_RAW;
+                if (vendor == "GenuineIntel") attr.config = 0x3F24;       // L2_RQSTS.MISS
+                else if (vendor == "AuthenticAMD") attr.config = 0x0964;  // L2CacheReqStat: IcFillMiss | LsRdBlkC
+                else return false;
+                return true;
+            }
+            default: return false;
+        }
+    }
+
+    static std::string cpuVendor() {
+#if defined(__x86_64__) || defined(__i386__)
+        unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (!__get_cpuid(0, &eax, &ebx, &ecx, &edx)) return std::string();
+        char vendor[13];
+        std::memcpy(vendor, &ebx, 4);
+        std::memcpy(vendor + 4, &edx, 4);
+        std::memcpy(vendor + 8, &ecx, 4);
+        vendor[12] = '\0';
+        return vendor;
+#else
+        return std::string();
+#endif
+    }
+
+    void openGroup(const std::vector<Event>& events) {
+        Group group;
+        for (Event event : events) {
+            perf_event_attr attr;
+            if (!eventAttr(event, attr)) continue;
+            const bool leader = group.fds.empty();
+            attr.disabled = leader ? 1 : 0;
+            attr.exclude_kernel = 1;  // Allowed with perf_event_paranoid <= 2
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader ? -1 : group.fds.front(), 0));
+            if (fd < 0) {
+                if (event == Cycles) reason_ = std::string("perf_event_open: ") + std::strerror(errno);
+                continue;
+            }
+            group.fds.push_back(fd);
+            group.events.push_back(event);
+        }
+        if (!group.fds.empty()) groups_.push_back(std::move(group));
+    }
+#endif
+
+    std::vector<Group> groups_;
+#ifdef __linux__
+    std::string reason_;
+#else
+    std::string reason_ = "hardware counters require Linux perf_event_open";
+#endif
+};
+
+// One line per sample: "cycles 1234.0  instr 2345.0  IPC 1.90  L1D 0.3/ki  L2 0.1/ki  LLC n/a  br-miss 0.0/ki"
+inline void printHardwareCounters(const HardwareCounterSample& sample, std::ostream& out) {
+    if (!sample.available) {
+        out << "counters unavailable";
+        return;
+    }
+    auto field = [&](const char* name, double value, bool perKilo) {
+        out << name << ' ';
+        if (std::isnan(value)) out << "n/a";
+        else if (perKilo) out << std::fixed << std::setprecision(2) << sample.mpki(value) << "/ki";
+        else out << std::fixed << std::setprecision(1) << value;
+        out << "  ";
+    };
+    field("cycles", sample.cycles, false);
+    field("instr", sample.instructions, false);
+    out << "IPC ";
+    if (std::isnan(sample.ipc())) out << "n/a";
+    else out << std::fixed << std::setprecision(2) << sample.ipc();
+    out << "  ";
+    field("L1D", sample.l1dMisses, true);
+    field("L2", sample.l2Misses, true);
+    field("LLC", sample.llcMisses, true);
+    field("br-miss", sample.branchMisses, true);
+}
+
+} // namespace tools
+} // namespace forge
@@ -0,0 +1,412 @@
+#pragma once
+
+// Per-opcode microbenchmarks: forward and adjoint cost of every OpCode on
+// every available backend, at several register-pressure levels, with JSON
+// output and a baseline comparison for regression gates.
+//
+// Each kernel holds `chains` independent dependency chains of `chainLength`
+// steps, interleaved so that all chains are live at once. With one chain the
+// time per step is the op's latency; with more chains it approaches its
+// throughput while the register allocator works under pressure. A step is
+// the op applied to the previous value of its chain; ops whose plain
+// recurrence would diverge or that do not produce a double (Exp, Log, Tan,
+// comparisons, If) run with a companion op named in the result.
+//
+//   forge_opcode_bench --out current.json
+//   forge_opcode_bench --out current.json --baseline farm_baseline.json --threshold 0.2
+//   forge_opcode_bench --compare farm_baseline.json current.json
+//
+// Not covered: Input/constant nodes (no code), ArrayIndex and Call (they
+// need array and function-body fixtures rather than a chain).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "../../src/graph/graph.hpp"
+#include "../../src/compiler/forge_engine.hpp"
+#include "../../src/compiler/interfaces/node_value_buffer.hpp"
+#include "../../src/compiler/x86/common/compiler_config.hpp"
+#include "../../src/compiler/x86/common/instruction_set_factory.hpp"
+
+namespace forge {
+namespace tools {
+
+struct OpcodeBenchmarkConfig {
+    std::vector<std::string> ops;            // Empty: every benchmarked opcode
+    std::vector<std::string> backends;       // Empty: every backend this CPU runs
+    std::vector<int> registerPressure = {1, 4, 12};  // Independent chains per kernel
+    int chainLength = 64;                    // Steps per chain
+    int warmupRuns = 20;
+    int measureRuns = 200;                   // Kernel executions per repetition
+    int repetitions = 5;                     // Reported time is the median repetition
+    bool forward = true;
+    bool adjoint = true;                     // Differentiable ops only
+};
+
+struct OpcodeBenchmarkResult {
+    std::string backend;
+    std::string op;
+    std::string companion;                   // Extra op per step ("" for plain chains)
+    std::string mode;                        // "forward" or "adjoint"
+    int chains = 0;
+    int chainLength = 0;
+    int vectorWidth = 1;
+    double nsPerKernel = 0.0;
+    double nsPerStep = 0.0;                  // nsPerKernel / (chains * chainLength)
+    double nsPerLaneStep = 0.0;              // nsPerStep / vectorWidth
+
+    // Identifies the measurement across runs
+    std::string key() const {
+        return backend + "/" + op + "/" + mode + "/" + std::to_string(chains);
+    }
+};
+
+struct OpcodeBenchmarkRegression {
+    std::string key;
+    double baselineNs = 0.0;                 // nsPerStep
+    double currentNs = 0.0;
+    double ratio = 0.0;                      // current / baseline
+};
+
+namespace opcode_benchmark_detail {
+
+inline NodeId addOp(Graph& graph, OpCode op, NodeId a, NodeId b = UINT32_MAX, NodeId c = UINT32_MAX) {
+    Node node{};
+    node.op = op;
+    node.a = a;
+    node.b = b;
+    node.c = c;
+    return graph.addNode(node);
+}
+
+inline NodeId addIntConstant(Graph& graph, double value) {
+    Node node{};
+    node.op = OpCode::IntConstant;
+    node.imm = value;
+    node.isActive = false;
+    return graph.addNode(node);
+}
+
+// One chain step: next value from the previous value x and the chain constant k
+using StepFunction = std::function<NodeId(Graph&, NodeId x, NodeId k)>;
+
+enum class ConstantKind { Double, Int };
+
+struct OpcodeSpec {
+    const char* name;
+    const char* companion;
+    double input;          // Initial chain value
+    double constant;       // k
+    ConstantKind constantKind;
+    bool differentiable;
+    StepFunction step;
+};
+
+inline StepFunction unary(OpCode op) {
+    return [op](Graph& g, NodeId x, NodeId) { return addOp(g, op, x); };
+}
+
+inline StepFunction binary(OpCode op) {
+    return [op](Graph& g, NodeId x, NodeId k) { return addOp(g, op, x, k); };
+}
+
+// If(cmp(x, k), x, k): keeps comparisons and selects on the chain
+inline StepFunction select(OpCode cmp, OpCode ifOp = OpCode::If) {
+    return [cmp, ifOp](Graph& g, NodeId x, NodeId k) { return addOp(g, ifOp, addOp(g, cmp, x, k), x, k); };
+}
+
+// Bool chains run on b = CmpLT(x, k) and return to doubles through If at the end (see buildKernelGraph)
+inline StepFunction boolean(OpCode op) {
+    return [op](Graph& g, NodeId b, NodeId b0) { return op == OpCode::BoolNot ? addOp(g, op, b) : addOp(g, op, b, b0); };
+}
+
+inline const std::vector<OpcodeSpec>& opcodeSpecs() {
+    using K = ConstantKind;
+    static const std::vector<OpcodeSpec> specs = {
+        {"Add", "", 1.0, 1e-3, K::Double, true, binary(OpCode::Add)},
+        {"Sub", "", 1.0, 1e-3, K::Double, true, binary(OpCode::Sub)},
+        {"Mul", "", 1.0, 0.999999, K::Double, true, binary(OpCode::Mul)},
+        {"Div", "", 1.0, 1.000001, K::Double, true, binary(OpCode::Div)},
+        {"Neg", "", 1.0, 0.0, K::Double, true, unary(OpCode::Neg)},
+        {"Abs", "", -1.0, 0.0, K::Double, true, unary(OpCode::Abs)},
+        {"Square", "", 1.0, 0.0, K::Double, true, unary(OpCode::Square)},
+        {"Recip", "", 2.0, 0.0, K::Double, true, unary(OpCode::Recip)},
+        {"Mod", "", 1.5, 10.0, K::Double, true, binary(OpCode::Mod)},
+        {"Exp", "Neg", 0.5, 0.0, K::Double, true,
+         [](Graph& g, NodeId x, NodeId) { return addOp(g, OpCode::Exp, addOp(g, OpCode::Neg, x)); }},
+        {"Log", "Add", 1.0, 2.0, K::Double, true,
+         [](Graph& g, NodeId x, NodeId k) { return addOp(g, OpCode::Log, addOp(g, OpCode::Add, x, k)); }},
+        {"Sqrt", "", 2.0, 0.0, K::Double, true, unary(OpCode::Sqrt)},
+        {"Pow", "", 2.0, 0.5, K::Double, true, binary(OpCode::Pow)},
+        {"Sin", "", 1.0, 0.0, K::Double, true, unary(OpCode::Sin)},
+        {"Cos", "", 1.0, 0.0, K::Double, true, unary(OpCode::Cos)},
+        {"Tan", "Mul", 0.5, 0.5, K::Double, true,
+         [](Graph& g, NodeId x, NodeId k) { return addOp(g, OpCode::Tan, addOp(g, OpCode::Mul, x, k)); }},
+        {"Min", "", 1.0, 2.0, K::Double, true, binary(OpCode::Min)},
+        {"Max", "", 1.0, 0.5, K::Double, true, binary(OpCode::Max)},
+        {"If", "CmpLT", 1.0, 2.0, K::Double, true, select(OpCode::CmpLT)},
+        {"CmpLT", "If", 1.0, 2.0, K::Double, false, select(OpCode::CmpLT)},
+        {"CmpLE", "If", 1.0, 2.0, K::Double, false, select(OpCode::CmpLE)},
+        {"CmpGT", "If", 1.0, 2.0, K::Double, false, select(OpCode::CmpGT)},
+        {"CmpGE", "If", 1.0, 2.0, K::Double, false, select(OpCode::CmpGE)},
+        {"CmpEQ", "If", 1.0, 2.0, K::Double, false, select(OpCode::CmpEQ)},
+        {"CmpNE", "If", 1.0, 2.0, K::Double, false, select(OpCode::CmpNE)},
+        {"BoolAnd", "", 1.0, 2.0, K::Double, false, boolean(OpCode::BoolAnd)},
+        {"BoolOr", "", 1.0, 2.0, K::Double, false, boolean(OpCode::BoolOr)},
+        {"BoolNot", "", 1.0, 2.0, K::Double, false, boolean(OpCode::BoolNot)},
+        {"BoolEq", "", 1.0, 2.0, K::Double, false, boolean(OpCode::BoolEq)},
+        {"BoolNe", "", 1.0, 2.0, K::Double, false, boolean(OpCode::BoolNe)},
+        {"IntAdd", "", 3.0, 1.0, K::Int, false, binary(OpCode::IntAdd)},
+        {"IntSub", "", 3.0, 1.0, K::Int, false, binary(OpCode::IntSub)},
+        {"IntMul", "", 3.0, 1.0, K::Int, false, binary(OpCode::IntMul)},
+        {"IntDiv", "", 3.0, 1.0, K::Int, false, binary(OpCode::IntDiv)},
+        {"IntMod", "", 3.0, 1000.0, K::Int, false, binary(OpCode::IntMod)},
+        {"IntNeg", "", 3.0, 0.0, K::Int, false, unary(OpCode::IntNeg)},
+        {"IntCmpLT", "IntIf", 3.0, 5.0, K::Int, false, select(OpCode::IntCmpLT, OpCode::IntIf)},
+        {"IntCmpLE", "IntIf", 3.0, 5.0, K::Int, false, select(OpCode::IntCmpLE, OpCode::IntIf)},
+        {"IntCmpGT", "IntIf", 3.0, 5.0, K::Int, false, select(OpCode::IntCmpGT, OpCode::IntIf)},
+        {"IntCmpGE", "IntIf", 3.0, 5.0, K::Int, false, select(OpCode::IntCmpGE, OpCode::IntIf)},
+        {"IntCmpEQ", "IntIf", 3.0, 5.0, K::Int, false, select(OpCode::IntCmpEQ, OpCode::IntIf)},
+        {"IntCmpNE", "IntIf", 3.0, 5.0, K::Int, false, select(OpCode::IntCmpNE, OpCode::IntIf)},
+        {"IntIf", "IntCmpLT", 3.0, 5.0, K::Int, false, select(OpCode::IntCmpLT, OpCode::IntIf)},
+    };
+    return specs;
+}
+
+inline bool isBoolSpec(const OpcodeSpec& spec) {
+    return std::string(spec.name).compare(0, 4, "Bool") == 0;
+}
+
+// Interleaved chains; inputs are nodes 0..chains-1
+inline Graph buildKernelGraph(const OpcodeSpec& spec, int chains, int chainLength, bool adjoint) {
+    Graph graph;
+    std::vector<NodeId> values;
+    for (int c = 0; c < chains; ++c) {
+        values.push_back(graph.addInput());
+        if (adjoint) {
+            graph.diff_inputs.push_back(values.back());
+            graph.nodes[values.back()].needsGradient = true;
+        }
+    }
+    const NodeId k = spec.constantKind == ConstantKind::Int ? addIntConstant(graph, spec.constant)
+                                                           : graph.addConstant(spec.constant);
+    std::vector<NodeId> seeds = values;
+    if (isBoolSpec(spec)) {
+        for (NodeId& value : values) value = addOp(graph, OpCode::CmpLT, value, k);
+    }
+    const std::vector<NodeId> b0 = values;
+
+    for (int step = 0; step < chainLength; ++step) {
+        for (int c = 0; c < chains; ++c) {
+            const size_t first = graph.nodes.size();
+            values[c] = spec.step(graph, values[c], isBoolSpec(spec) ? b0[c] : k);
+            if (adjoint) {
+                for (size_t n = first; n < graph.nodes.size(); ++n) graph.nodes[n].needsGradient = true;
+            }
+        }
+    }
+
+    for (int c = 0; c < chains; ++c) {
+        NodeId out = values[c];
+        if (isBoolSpec(spec)) out = addOp(graph, OpCode::If, out, seeds[c], k);
+        graph.markOutput(out);
+    }
+    return graph;
+}
+
+inline bool cpuRuns(const std::string& backend) {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    if (backend.find("AVX2") != std::string::npos) return __builtin_cpu_supports("avx2");
+#endif
+    (void)backend;
+    return true;
+}
+
+inline CompilerConfig configFor(const std::string& backend) {
+    CompilerConfig config = CompilerConfig::Default();
+    if (backend == "SSE2-Scalar") {
+        config.instructionSet = CompilerConfig::InstructionSet::SSE2_SCALAR;
+    } else if (backend == "AVX2-Packed") {
+        config.instructionSet = CompilerConfig::InstructionSet::AVX2_PACKED;
+    } else {
+        config.useNamedInstructionSet = true;
+        config.instructionSetName = backend;
+    }
+    return config;
+}
+
+} // namespace opcode_benchmark_detail
+
+/** @brief Names of backends available in this process that the CPU can execute */
+inline std::vector<std::string> availableOpcodeBenchmarkBackends() {
+    std::vector<std::string> names = InstructionSetFactory::getAvailableInstructionSets();
+#ifdef FORGE_BUNDLE_AVX2
+    if (std::find(names.begin(), names.end(), "AVX2-Packed") == names.end()) names.push_back("AVX2-Packed");
+#endif
+    names.erase(std::remove_if(names.begin(), names.end(),
+                               [](const std::string& name) { return !opcode_benchmark_detail::cpuRuns(name); }),
+                names.end());
+    return names;
+}
+
+/** @brief Names of all benchmarked opcodes */
+inline std::vector<std::string> opcodeBenchmarkOps() {
+    std::vector<std::string> names;
+    for (const auto& spec : opcode_benchmark_detail::opcodeSpecs()) names.push_back(spec.name);
+    return names;
+}
+
+/**
+ * @brief Run the suite
+ * @param progress Receives one line per measurement (nullptr for silence)
+ * @throws std::runtime_error for unknown op names (through compile errors otherwise)
+ */
+inline std::vector<OpcodeBenchmarkResult> runOpcodeBenchmarks(const OpcodeBenchmarkConfig& config,
+                                                              std::ostream* progress = &std::cout) {
+    using namespace opcode_benchmark_detail;
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<const OpcodeSpec*> specs;
+    for (const auto& spec : opcodeSpecs()) {
+        if (config.ops.empty() || std::find(config.ops.begin(), config.ops.end(), spec.name) != config.ops.end()) {
+            specs.push_back(&spec);
+        }
+    }
+    for (const auto& name : config.ops) {
+        if (std::none_of(specs.begin(), specs.end(), [&](const OpcodeSpec* s) { return name == s->name; })) {
+            throw std::runtime_error("Unknown opcode for benchmark: " + name);
+        }
+    }
+    const std::vector<std::string> backends = config.backends.empty() ? availableOpcodeBenchmarkBackends() : config.backends;
+
+    std::vector<OpcodeBenchmarkResult> results;
+    for (const std::string& backend : backends) {
+        for (const OpcodeSpec* spec : specs) {
+            for (const bool adjoint : {false, true}) {
+                if (adjoint ? !(config.adjoint && spec->differentiable) : !config.forward) continue;
+                for (const int chains : config.registerPressure) {
+                    Graph graph = buildKernelGraph(*spec, chains, config.chainLength, adjoint);
+                    ForgeEngine engine(configFor(backend));
+                    auto kernel = engine.compile(graph);
+                    auto buffer = NodeValueBufferFactory::create(graph, *kernel);
+                    for (int c = 0; c < chains; ++c) buffer->setValue(static_cast<NodeId>(c), spec->input);
+
+                    double* values = buffer->getValuesPtr();
+                    double* gradients = buffer->getGradientsPtr();
+                    const size_t count = buffer->getNumNodes();
+                    for (int i = 0; i < config.warmupRuns; ++i) kernel->executeDirect(values, gradients, count);
+
+                    std::vector<double> samples;
+                    for (int r = 0; r < config.repetitions; ++r) {
+                        const auto start = Clock::now();
+                        for (int i = 0; i < config.measureRuns; ++i) kernel->executeDirect(values, gradients, count);
+                        const auto end = Clock::now();
+                        samples.push_back(std::chrono::duration<double, std::nano>(end - start).count() /
+                                          std::max(config.measureRuns, 1));
+                    }
+                    std::sort(samples.begin(), samples.end());
+
+                    OpcodeBenchmarkResult result;
+                    result.backend = backend;
+                    result.op = spec->name;
+                    result.companion = spec->companion;
+                    result.mode = adjoint ? "adjoint" : "forward";
+                    result.chains = chains;
+                    result.chainLength = config.chainLength;
+                    result.vectorWidth = buffer->getVectorWidth();
+                    result.nsPerKernel = samples.empty() ? 0.0 : samples[samples.size() / 2];
+                    result.nsPerStep = result.nsPerKernel / (static_cast<double>(chains) * config.chainLength);
+                    result.nsPerLaneStep = result.nsPerStep / result.vectorWidth;
+                    results.push_back(result);
+
+                    if (progress) {
+                        *progress << std::left << std::setw(14) << backend << std::setw(10) << result.op
+                                  << std::setw(8) << result.mode << " chains=" << std::setw(3) << chains
+                                  << std::right << std::fixed << std::setprecision(3) << std::setw(10)
+                                  << result.nsPerStep << " ns/step" << std::setw(10) << result.nsPerLaneStep
+                                  << " ns/lane-step" << std::endl;
+                    }
+                }
+            }
+        }
+    }
+    return results;
+}
+
+inline nlohmann::json opcodeBenchmarksToJson(const std::vector<OpcodeBenchmarkResult>& results,
+                                             const OpcodeBenchmarkConfig& config) {
+    nlohmann::json doc;
+    doc["schema"] = "forge-opcode-benchmark/1";
+    doc["config"] = {{"chainLength", config.chainLength},
+                     {"registerPressure", config.registerPressure},
+                     {"warmupRuns", config.warmupRuns},
+                     {"measureRuns", config.measureRuns},
+                     {"repetitions", config.repetitions}};
+    doc["results"] = nlohmann::json::array();
+    for (const auto& r : results) {
+        doc["results"].push_back({{"key", r.key()},
+                                  {"backend", r.backend},
+                                  {"op", r.op},
+                                  {"companion", r.companion},
+                                  {"mode", r.mode},
+                                  {"chains", r.chains},
+                                  {"chainLength", r.chainLength},
+                                  {"vectorWidth", r.vectorWidth},
+                                  {"nsPerKernel", r.nsPerKernel},
+                                  {"nsPerStep", r.nsPerStep},
+                                  {"nsPerLaneStep", r.nsPerLaneStep}});
+    }
+    return doc;
+}
+
+/**
+ * @brief Measurements whose nsPerStep grew by more than `threshold` (0.2 = 20%)
+ *
+ * Entries present in only one document are ignored. Steps faster than
+ * `minNs` in the baseline are skipped: they are dominated by timer noise.
+ */
+inline std::vector<OpcodeBenchmarkRegression> compareOpcodeBenchmarks(const nlohmann::json& baseline,
+                                                                      const nlohmann::json& current,
+                                                                      double threshold = 0.10, double minNs = 0.0) {
+    std::map<std::string, double> baselineNs;
+    for (const auto& entry : baseline.at("results")) {
+        baselineNs[entry.at("key").get<std::string>()] = entry.at("nsPerStep").get<double>();
+    }
+
+    std::vector<OpcodeBenchmarkRegression> regressions;
+    for (const auto& entry : current.at("results")) {
+        const std::string key = entry.at("key").get<std::string>();
+        auto it = baselineNs.find(key);
+        if (it == baselineNs.end() || it->second <= 0.0 || it->second < minNs) continue;
+        const double now = entry.at("nsPerStep").get<double>();
+        const double ratio = now / it->second;
+        if (ratio > 1.0 + threshold) regressions.push_back({key, it->second, now, ratio});
+    }
+    std::sort(regressions.begin(), regressions.end(),
+              [](const OpcodeBenchmarkRegression& x, const OpcodeBenchmarkRegression& y) { return x.ratio > y.ratio; });
+    return regressions;
+}
+
+inline void printOpcodeRegressions(const std::vector<OpcodeBenchmarkRegression>& regressions, std::ostream& out) {
+    if (regressions.empty()) {
+        out << "No regressions" << std::endl;
+        return;
+    }
+    out << regressions.size() << " regression(s):" << std::endl;
+    for (const auto& r : regressions) {
+        out << "  " << std::left << std::setw(40) << r.key << std::right << std::fixed << std::setprecision(3)
+            << std::setw(10) << r.baselineNs << " -> " << std::setw(10) << r.currentNs << " ns/step  (+"
+            << std::setprecision(1) << (r.ratio - 1.0) * 100.0 << "%)" << std::endl;
+    }
+}
+
+} // namespace tools
+} // namespace forge
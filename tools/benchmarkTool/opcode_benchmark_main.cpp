@@ -0,0 +1,137 @@
+// Command line driver for the per-opcode microbenchmarks (opcode_benchmark.hpp)
+//
+// Exit status: 0 = ok, 1 = regressions against the baseline, 2 = usage or I/O error
+
+#include "opcode_benchmark.hpp"
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+bool readJson(const std::string& path, nlohmann::json& doc) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Cannot open " << path << std::endl;
+        return false;
+    }
+    try {
+        in >> doc;
+    } catch (const std::exception& e) {
+        std::cerr << "Cannot parse " << path << ": " << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --out FILE             write results as JSON\n"
+              << "  --baseline FILE        compare results with a stored run\n"
+              << "  --compare BASE CUR     compare two stored runs without measuring\n"
+              << "  --threshold X          regression if ns/step grows by more than X (default 0.10)\n"
+              << "  --min-ns X             ignore baseline steps faster than X ns\n"
+              << "  --ops A,B              opcodes (default: all, see --list)\n"
+              << "  --backends A,B         backends (default: all this CPU runs)\n"
+              << "  --pressure 1,4,12      independent chains per kernel\n"
+              << "  --chain N --runs N --reps N\n"
+              << "  --quick                short chains and few runs (smoke test)\n"
+              << "  --no-forward | --no-adjoint\n"
+              << "  --list                 print opcodes and backends\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    using namespace forge::tools;
+
+    OpcodeBenchmarkConfig config;
+    std::string outPath;
+    std::string baselinePath;
+    std::string comparePaths[2];
+    double threshold = 0.10;
+    double minNs = 0.0;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                printUsage(argv[0]);
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+        if (arg == "--out") outPath = next();
+        else if (arg == "--baseline") baselinePath = next();
+        else if (arg == "--compare") { comparePaths[0] = next(); comparePaths[1] = next(); }
+        else if (arg == "--threshold") threshold = std::atof(next().c_str());
+        else if (arg == "--min-ns") minNs = std::atof(next().c_str());
+        else if (arg == "--ops") config.ops = splitList(next());
+        else if (arg == "--backends") config.backends = splitList(next());
+        else if (arg == "--pressure") {
+            config.registerPressure.clear();
+            for (const auto& level : splitList(next())) config.registerPressure.push_back(std::atoi(level.c_str()));
+        }
+        else if (arg == "--chain") config.chainLength = std::atoi(next().c_str());
+        else if (arg == "--runs") config.measureRuns = std::atoi(next().c_str());
+        else if (arg == "--reps") config.repetitions = std::atoi(next().c_str());
+        else if (arg == "--quick") {
+            config.chainLength = 16;
+            config.warmupRuns = 2;
+            config.measureRuns = 20;
+            config.repetitions = 3;
+            config.registerPressure = {1, 8};
+        }
+        else if (arg == "--no-forward") config.forward = false;
+        else if (arg == "--no-adjoint") config.adjoint = false;
+        else if (arg == "--list") {
+            std::cout << "Opcodes:";
+            for (const auto& op : opcodeBenchmarkOps()) std::cout << ' ' << op;
+            std::cout << "\nBackends:";
+            for (const auto& backend : availableOpcodeBenchmarkBackends()) std::cout << ' ' << backend;
+            std::cout << std::endl;
+            return 0;
+        }
+        else {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    nlohmann::json current;
+    nlohmann::json baseline;
+    if (!comparePaths[0].empty()) {
+        if (!readJson(comparePaths[0], baseline) || !readJson(comparePaths[1], current)) return 2;
+    } else {
+        if (!baselinePath.empty() && !readJson(baselinePath, baseline)) return 2;
+        try {
+            current = opcodeBenchmarksToJson(runOpcodeBenchmarks(config), config);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 2;
+        }
+        if (!outPath.empty()) {
+            std::ofstream out(outPath);
+            out << current.dump(2) << std::endl;
+            if (!out) {
+                std::cerr << "Cannot write " << outPath << std::endl;
+                return 2;
+            }
+        }
+    }
+
+    if (baseline.is_null()) return 0;
+    const auto regressions = compareOpcodeBenchmarks(baseline, current, threshold, minNs);
+    printOpcodeRegressions(regressions, std::cout);
+    return regressions.empty() ? 0 : 1;
+}
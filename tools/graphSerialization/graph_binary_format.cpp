@@ -0,0 +1,449 @@
+#include "graph_binary_format.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace forge {
+
+// Node records are used in place, so forge::Node must have the record layout
+static_assert(sizeof(Node) == binary_graph::kNodeRecordSize, "Node layout differs from the binary node record");
+static_assert(offsetof(Node, op) == 0 && offsetof(Node, dst) == 4 && offsetof(Node, a) == 8 &&
+              offsetof(Node, b) == 12 && offsetof(Node, c) == 16 && offsetof(Node, flags) == 20 &&
+              offsetof(Node, imm) == 24 && offsetof(Node, isActive) == 32 && offsetof(Node, isDead) == 33 &&
+              offsetof(Node, needsGradient) == 34,
+              "Node layout differs from the binary node record");
+static_assert(sizeof(OpCode) == 2 && sizeof(bool) == 1, "Node layout differs from the binary node record");
+
+namespace {
+
+using namespace binary_graph;
+
+constexpr size_t kGraphEntrySize = 64;  // Four {offset, count} sections
+
+struct Section {
+    uint64_t offset = 0;
+    uint64_t count = 0;
+};
+
+struct GraphSections {
+    Section nodes;
+    Section constants;
+    Section outputs;
+    Section diffInputs;
+};
+
+bool littleEndianHost() {
+    const uint16_t probe = 1;
+    uint8_t first = 0;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+void requireLittleEndianHost() {
+    if (!littleEndianHost()) {
+        throw std::runtime_error("Binary graph files require a little-endian host");
+    }
+}
+
+uint64_t alignUp(uint64_t value) {
+    return (value + kSectionAlignment - 1) & ~(kSectionAlignment - 1);
+}
+
+template <typename T>
+T readAt(const uint8_t* data, uint64_t offset) {
+    T value;
+    std::memcpy(&value, data + offset, sizeof(T));
+    return value;
+}
+
+template <typename T>
+void putAt(uint8_t* data, uint64_t offset, T value) {
+    std::memcpy(data + offset, &value, sizeof(T));
+}
+
+// ---------------------------------------------------------------------------
+// Writing
+// ---------------------------------------------------------------------------
+
+// Emits the file through write(const void*, size_t); returns the file size
+template <typename Write>
+uint64_t writeBinary(const Graph& graph, Write&& write) {
+    requireLittleEndianHost();
+
+    std::vector<const Graph*> graphs{&graph};
+    for (const Graph& function : graph.functions) graphs.push_back(&function);
+
+    // Layout: header, graph table, then the sections of each graph in order
+    const uint64_t tableOffset = kHeaderSize;
+    uint64_t offset = alignUp(tableOffset + graphs.size() * kGraphEntrySize);
+    std::vector<GraphSections> layout(graphs.size());
+    auto place = [&offset](Section& section, uint64_t count, uint64_t elementSize) {
+        section.offset = offset;
+        section.count = count;
+        offset = alignUp(offset + count * elementSize);
+    };
+    for (size_t g = 0; g < graphs.size(); ++g) {
+        place(layout[g].nodes, graphs[g]->nodes.size(), kNodeRecordSize);
+        place(layout[g].constants, graphs[g]->constPool.size(), sizeof(double));
+        place(layout[g].outputs, graphs[g]->outputs.size(), sizeof(NodeId));
+        place(layout[g].diffInputs, graphs[g]->diff_inputs.size(), sizeof(NodeId));
+    }
+    const uint64_t fileSize = offset;
+
+    uint64_t written = 0;
+    auto emit = [&](const void* bytes, uint64_t size) {
+        if (size > 0) write(bytes, static_cast<size_t>(size));
+        written += size;
+    };
+    auto padTo = [&](uint64_t target) {
+        static const uint8_t zeros[kSectionAlignment] = {};
+        while (written < target) emit(zeros, std::min<uint64_t>(target - written, kSectionAlignment));
+    };
+
+    uint8_t header[kHeaderSize] = {};
+    std::memcpy(header, kMagic, sizeof(kMagic));
+    putAt<uint32_t>(header, 8, kVersion);
+    putAt<uint32_t>(header, 12, kHeaderSize);
+    putAt<uint32_t>(header, 16, kNodeRecordSize);
+    putAt<uint32_t>(header, 20, static_cast<uint32_t>(graphs.size()));
+    putAt<uint64_t>(header, 24, fileSize);
+    putAt<uint64_t>(header, 32, tableOffset);
+    emit(header, sizeof(header));
+
+    for (const GraphSections& sections : layout) {
+        uint8_t entry[kGraphEntrySize] = {};
+        const Section all[4] = {sections.nodes, sections.constants, sections.outputs, sections.diffInputs};
+        for (int s = 0; s < 4; ++s) {
+            putAt<uint64_t>(entry, s * 16, all[s].offset);
+            putAt<uint64_t>(entry, s * 16 + 8, all[s].count);
+        }
+        emit(entry, sizeof(entry));
+    }
+
+    // Node records are built field by field so padding is always zero
+    constexpr size_t kBatch = 4096;
+    std::vector<uint8_t> records;
+    for (size_t g = 0; g < graphs.size(); ++g) {
+        const Graph& current = *graphs[g];
+        padTo(layout[g].nodes.offset);
+        for (size_t first = 0; first < current.nodes.size(); first += kBatch) {
+            const size_t count = std::min(kBatch, current.nodes.size() - first);
+            records.assign(count * kNodeRecordSize, 0);
+            for (size_t i = 0; i < count; ++i) {
+                const Node& node = current.nodes[first + i];
+                uint8_t* record = records.data() + i * kNodeRecordSize;
+                putAt<uint16_t>(record, 0, static_cast<uint16_t>(node.op));
+                putAt<uint32_t>(record, 4, node.dst);
+                putAt<uint32_t>(record, 8, node.a);
+                putAt<uint32_t>(record, 12, node.b);
+                putAt<uint32_t>(record, 16, node.c);
+                putAt<uint32_t>(record, 20, node.flags);
+                putAt<double>(record, 24, node.imm);
+                record[32] = node.isActive ? 1 : 0;
+                record[33] = node.isDead ? 1 : 0;
+                record[34] = node.needsGradient ? 1 : 0;
+            }
+            emit(records.data(), records.size());
+        }
+        padTo(layout[g].constants.offset);
+        emit(current.constPool.data(), current.constPool.size() * sizeof(double));
+        padTo(layout[g].outputs.offset);
+        emit(current.outputs.data(), current.outputs.size() * sizeof(NodeId));
+        padTo(layout[g].diffInputs.offset);
+        emit(current.diff_inputs.data(), current.diff_inputs.size() * sizeof(NodeId));
+    }
+    padTo(fileSize);
+    return fileSize;
+}
+
+// ---------------------------------------------------------------------------
+// Reading
+// ---------------------------------------------------------------------------
+
+void checkSection(const Section& section, uint64_t elementSize, uint64_t fileSize, const char* name) {
+    if (section.offset % kSectionAlignment != 0 || section.offset > fileSize ||
+        section.count > (fileSize - section.offset) / elementSize) {
+        throw std::runtime_error(std::string("Binary graph: ") + name + " section out of bounds");
+    }
+}
+
+// Checks the header and section bounds; returns the sections of every graph
+std::vector<GraphSections> readLayout(const uint8_t* data, size_t size) {
+    requireLittleEndianHost();
+    if (size < kHeaderSize || std::memcmp(data, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("Binary graph: not a binary graph file");
+    }
+    const uint32_t version = readAt<uint32_t>(data, 8);
+    if (version != kVersion) {
+        throw std::runtime_error("Binary graph: unsupported version " + std::to_string(version));
+    }
+    if (readAt<uint32_t>(data, 12) != kHeaderSize || readAt<uint32_t>(data, 16) != kNodeRecordSize) {
+        throw std::runtime_error("Binary graph: unexpected header or node record size");
+    }
+    const uint32_t graphCount = readAt<uint32_t>(data, 20);
+    const uint64_t fileSize = readAt<uint64_t>(data, 24);
+    const uint64_t tableOffset = readAt<uint64_t>(data, 32);
+    if (fileSize != size) {
+        throw std::runtime_error("Binary graph: file size mismatch (truncated file?)");
+    }
+    if (graphCount == 0 || tableOffset > size || graphCount > (size - tableOffset) / kGraphEntrySize) {
+        throw std::runtime_error("Binary graph: graph table out of bounds");
+    }
+
+    std::vector<GraphSections> layout(graphCount);
+    for (uint32_t g = 0; g < graphCount; ++g) {
+        const uint64_t entry = tableOffset + static_cast<uint64_t>(g) * kGraphEntrySize;
+        Section* all[4] = {&layout[g].nodes, &layout[g].constants, &layout[g].outputs, &layout[g].diffInputs};
+        for (int s = 0; s < 4; ++s) {
+            all[s]->offset = readAt<uint64_t>(data, entry + s * 16);
+            all[s]->count = readAt<uint64_t>(data, entry + s * 16 + 8);
+        }
+        checkSection(layout[g].nodes, kNodeRecordSize, size, "node");
+        checkSection(layout[g].constants, sizeof(double), size, "constant");
+        checkSection(layout[g].outputs, sizeof(NodeId), size, "output");
+        checkSection(layout[g].diffInputs, sizeof(NodeId), size, "diff input");
+        if (layout[g].nodes.count >= UINT32_MAX) {
+            throw std::runtime_error("Binary graph: too many nodes");
+        }
+    }
+    return layout;
+}
+
+// Checks node contents on the raw records (bool fields must be 0 or 1 before
+// a record may be read as a Node)
+void validateGraph(const uint8_t* data, const GraphSections& sections, size_t functionCount) {
+    const uint64_t n = sections.nodes.count;
+    const uint8_t* records = data + sections.nodes.offset;
+    auto validOperand = [n](NodeId operand) { return operand < n || operand == UINT32_MAX; };
+    for (uint64_t id = 0; id < n; ++id) {
+        const uint8_t* record = records + id * kNodeRecordSize;
+        const uint16_t op = readAt<uint16_t>(record, 0);
+        if (op > static_cast<uint16_t>(OpCode::CallResult) || record[32] > 1 || record[33] > 1 || record[34] > 1) {
+            throw std::runtime_error("Binary graph: invalid node " + std::to_string(id));
+        }
+        const NodeId operands[3] = {readAt<uint32_t>(record, 8), readAt<uint32_t>(record, 12), readAt<uint32_t>(record, 16)};
+        for (int k = 0; k < operandCount(static_cast<OpCode>(op)); ++k) {
+            if (!validOperand(operands[k])) {
+                throw std::runtime_error("Binary graph: operand out of range in node " + std::to_string(id));
+            }
+        }
+        const double imm = readAt<double>(record, 24);
+        const OpCode code = static_cast<OpCode>(op);
+        if ((code == OpCode::Constant && !(imm >= 0.0 && imm < static_cast<double>(sections.constants.count))) ||
+            (code == OpCode::Call && !(imm >= 0.0 && imm < static_cast<double>(functionCount)))) {
+            throw std::runtime_error("Binary graph: index out of range in node " + std::to_string(id));
+        }
+    }
+    auto checkIds = [&](const Section& section, const char* name) {
+        for (uint64_t i = 0; i < section.count; ++i) {
+            if (readAt<uint32_t>(data, section.offset + i * sizeof(NodeId)) >= n) {
+                throw std::runtime_error(std::string("Binary graph: ") + name + " out of range");
+            }
+        }
+    };
+    checkIds(sections.outputs, "output");
+    checkIds(sections.diffInputs, "diff input");
+}
+
+// data must be 8-byte aligned (sections are 64-byte aligned within the file)
+GraphView viewOf(const uint8_t* data, const GraphSections& sections) {
+    GraphView view;
+    view.nodes = reinterpret_cast<const Node*>(data + sections.nodes.offset);
+    view.nodeCount = static_cast<size_t>(sections.nodes.count);
+    view.constPool = reinterpret_cast<const double*>(data + sections.constants.offset);
+    view.constCount = static_cast<size_t>(sections.constants.count);
+    view.outputs = reinterpret_cast<const NodeId*>(data + sections.outputs.offset);
+    view.outputCount = static_cast<size_t>(sections.outputs.count);
+    view.diffInputs = reinterpret_cast<const NodeId*>(data + sections.diffInputs.offset);
+    view.diffInputCount = static_cast<size_t>(sections.diffInputs.count);
+    return view;
+}
+
+template <typename T>
+void copySection(std::vector<T>& out, const uint8_t* data, const Section& section) {
+    out.resize(static_cast<size_t>(section.count));
+    if (!out.empty()) std::memcpy(out.data(), data + section.offset, out.size() * sizeof(T));
+}
+
+// Works on any alignment of data
+Graph copyOf(const uint8_t* data, const GraphSections& sections) {
+    Graph graph;
+    copySection(graph.nodes, data, sections.nodes);
+    copySection(graph.constPool, data, sections.constants);
+    copySection(graph.outputs, data, sections.outputs);
+    copySection(graph.diff_inputs, data, sections.diffInputs);
+    return graph;
+}
+
+} // anonymous namespace
+
+std::vector<uint8_t> serializeGraphToBinary(const Graph& graph) {
+    std::vector<uint8_t> bytes;
+    writeBinary(graph, [&bytes](const void* data, size_t size) {
+        const uint8_t* begin = static_cast<const uint8_t*>(data);
+        bytes.insert(bytes.end(), begin, begin + size);
+    });
+    return bytes;
+}
+
+Graph deserializeGraphFromBinary(const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    std::vector<GraphSections> layout = readLayout(bytes, size);
+    for (const GraphSections& sections : layout) {
+        validateGraph(bytes, sections, layout.size() - 1);
+    }
+    Graph graph = copyOf(bytes, layout[0]);
+    for (size_t g = 1; g < layout.size(); ++g) {
+        graph.functions.push_back(copyOf(bytes, layout[g]));
+    }
+    return graph;
+}
+
+bool saveGraphToBinaryFile(const Graph& graph, const std::string& filename) {
+    try {
+        std::ofstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+        writeBinary(graph, [&file](const void* data, size_t size) {
+            file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        });
+        return static_cast<bool>(file);
+    } catch (...) {
+        return false;
+    }
+}
+
+Graph loadGraphFromBinaryFile(const std::string& filename) {
+    return MappedGraphFile(filename).toGraph();
+}
+
+// ---------------------------------------------------------------------------
+// MappedGraphFile
+// ---------------------------------------------------------------------------
+
+MappedGraphFile::MappedGraphFile(const std::string& filename, bool validate) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+    fileHandle_ = file;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        unmap();
+        throw std::runtime_error("Cannot map empty file: " + filename);
+    }
+    size_ = static_cast<size_t>(fileSize.QuadPart);
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        unmap();
+        throw std::runtime_error("Cannot map file: " + filename);
+    }
+    mappingHandle_ = mapping;
+    data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!data_) {
+        unmap();
+        throw std::runtime_error("Cannot map file: " + filename);
+    }
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot map empty file: " + filename);
+    }
+    size_ = static_cast<size_t>(info.st_size);
+    void* address = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // The mapping keeps the file referenced
+    if (address == MAP_FAILED) {
+        size_ = 0;
+        throw std::runtime_error("Cannot map file: " + filename);
+    }
+    data_ = static_cast<const uint8_t*>(address);
+#endif
+
+    try {
+        std::vector<GraphSections> layout = readLayout(data_, size_);
+        if (validate) {
+            for (const GraphSections& sections : layout) {
+                validateGraph(data_, sections, layout.size() - 1);
+            }
+        }
+        view_ = viewOf(data_, layout[0]);
+        for (size_t g = 1; g < layout.size(); ++g) {
+            functions_.push_back(copyOf(data_, layout[g]));
+        }
+        view_.functions = &functions_;
+    } catch (...) {
+        unmap();
+        throw;
+    }
+}
+
+MappedGraphFile::~MappedGraphFile() {
+    unmap();
+}
+
+MappedGraphFile::MappedGraphFile(MappedGraphFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedGraphFile& MappedGraphFile::operator=(MappedGraphFile&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        data_ = other.data_;
+        size_ = other.size_;
+#ifdef _WIN32
+        fileHandle_ = other.fileHandle_;
+        mappingHandle_ = other.mappingHandle_;
+        other.fileHandle_ = nullptr;
+        other.mappingHandle_ = nullptr;
+#endif
+        functions_ = std::move(other.functions_);
+        view_ = other.view_;
+        view_.functions = &functions_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.view_ = GraphView{};
+    }
+    return *this;
+}
+
+void MappedGraphFile::unmap() {
+#ifdef _WIN32
+    if (data_) UnmapViewOfFile(data_);
+    if (mappingHandle_) CloseHandle(static_cast<HANDLE>(mappingHandle_));
+    if (fileHandle_) CloseHandle(static_cast<HANDLE>(fileHandle_));
+    mappingHandle_ = nullptr;
+    fileHandle_ = nullptr;
+#else
+    if (data_) ::munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    view_ = GraphView{};
+}
+
+} // namespace forge
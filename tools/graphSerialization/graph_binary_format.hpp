@@ -0,0 +1,122 @@
+#pragma once
+
+#include "../../src/graph/graph.hpp"
+#include "../../src/graph/graph_view.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace forge {
+
+/**
+ * @brief Binary graph format (version 1)
+ *
+ * A little-endian file of fixed-layout sections that can be memory-mapped
+ * and handed to GraphOptimizer as a GraphView without parsing:
+ *
+ *   Header (64 bytes)
+ *     0   char[8]  magic "FORGEGRB"
+ *     8   u32      version (1)
+ *     12  u32      header size (64)
+ *     16  u32      node record size (40)
+ *     20  u32      graph count (1 + number of function bodies)
+ *     24  u64      file size
+ *     32  u64      offset of the graph table
+ *     40  u8[24]   reserved, zero
+ *   Graph table: one entry per graph (main graph first, then Graph::functions
+ *   in order), each four {u64 offset, u64 count} sections:
+ *     nodes, constants (f64), outputs (u32), diff inputs (u32)
+ *   Sections start on 64-byte boundaries.
+ *
+ * A node record is the in-memory layout of forge::Node, padding zeroed:
+ *   0 u16 op, 2 u16 zero, 4 u32 dst, 8 u32 a, 12 u32 b, 16 u32 c,
+ *   20 u32 flags, 24 f64 imm, 32 u8 isActive, 33 u8 isDead,
+ *   34 u8 needsGradient, 35 u8[5] zero
+ *
+ * Reading and writing require a little-endian host.
+ */
+namespace binary_graph {
+constexpr char kMagic[8] = {'F', 'O', 'R', 'G', 'E', 'G', 'R', 'B'};
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kHeaderSize = 64;
+constexpr uint32_t kNodeRecordSize = 40;
+constexpr uint64_t kSectionAlignment = 64;
+} // namespace binary_graph
+
+/**
+ * @brief Serialize a Graph (including its function bodies) to the binary format
+ */
+std::vector<uint8_t> serializeGraphToBinary(const Graph& graph);
+
+/**
+ * @brief Reconstruct a Graph from binary data
+ *
+ * @throws std::runtime_error if the data is not a valid binary graph
+ */
+Graph deserializeGraphFromBinary(const void* data, size_t size);
+
+/**
+ * @brief Save a Graph to a binary file
+ *
+ * @return true if successful, false on I/O error
+ */
+bool saveGraphToBinaryFile(const Graph& graph, const std::string& filename);
+
+/**
+ * @brief Load a Graph from a binary file
+ *
+ * @throws std::runtime_error if the file cannot be read or is not a valid binary graph
+ */
+Graph loadGraphFromBinaryFile(const std::string& filename);
+
+/**
+ * @brief Read-only memory mapping of a binary graph file
+ *
+ * The nodes, constants, outputs and diff inputs of the main graph are used
+ * in place through view(); function bodies (small by construction) are
+ * copied out. The view stays valid as long as the MappedGraphFile lives.
+ *
+ * @code
+ * MappedGraphFile file("scenario.fgb");
+ * GraphOptimizer optimizer;
+ * auto result = optimizer.optimizeWithMapping(file.view());
+ * @endcode
+ */
+class MappedGraphFile {
+public:
+    /**
+     * @param filename Binary graph file
+     * @param validate Check every node's opcode, flags and operand bounds
+     *                 (one pass over the nodes); the header and section bounds
+     *                 are always checked
+     * @throws std::runtime_error if the file cannot be mapped or is invalid
+     */
+    explicit MappedGraphFile(const std::string& filename, bool validate = true);
+    ~MappedGraphFile();
+
+    MappedGraphFile(const MappedGraphFile&) = delete;
+    MappedGraphFile& operator=(const MappedGraphFile&) = delete;
+    MappedGraphFile(MappedGraphFile&& other) noexcept;
+    MappedGraphFile& operator=(MappedGraphFile&& other) noexcept;
+
+    const GraphView& view() const { return view_; }
+    size_t fileSize() const { return size_; }
+
+    /** @brief Copy the mapped graph into an owning Graph */
+    Graph toGraph() const { return view_.toGraph(); }
+
+private:
+    void unmap();
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* fileHandle_ = nullptr;
+    void* mappingHandle_ = nullptr;
+#endif
+    std::vector<Graph> functions_;
+    GraphView view_;
+};
+
+} // namespace forge
@@ -213,7 +213,6 @@ public:
             // SSE2 Warmup
             for (int i = 0; i < config_.warmupIterations; ++i) {
                 sse2Buffer->setValue(sse2InputNode, input);
-                sse2Buffer->clearGradients();
                 sse2Kernel->execute(*sse2Buffer);
                 volatile double dummy = sse2Buffer->getValue(sse2OutputNode);
                 (void)dummy;
@@ -223,7 +222,6 @@ public:
             auto sse2Start = high_resolution_clock::now();
             for (int i = 0; i < config_.timingIterations; ++i) {
                 sse2Buffer->setValue(sse2InputNode, input);
-                sse2Buffer->clearGradients();
                 sse2Kernel->execute(*sse2Buffer);
                 result.tapeResult = sse2Buffer->getValue(sse2OutputNode);
                 result.tapeDerivative = sse2Buffer->getGradient(sse2InputNode);
@@ -276,7 +274,6 @@ public:
                         // AVX2 Warmup
                         for (int i = 0; i < config_.warmupIterations; ++i) {
                             avx2Buffer->setLanes(avx2InputNode, batch);
-                            avx2Buffer->clearGradients();
                             avx2Kernel->execute(*avx2Buffer);
                             double dummyVec[4];
                             avx2Buffer->getLanes(avx2OutputNode, dummyVec);
@@ -288,7 +285,6 @@ public:
                         auto avx2Start = high_resolution_clock::now();
                         for (int i = 0; i < config_.timingIterations; ++i) {
                             avx2Buffer->setLanes(avx2InputNode, batch);
-                            avx2Buffer->clearGradients();
                             avx2Kernel->execute(*avx2Buffer);
                             double avx2Vec[4];
                             avx2Buffer->getLanes(avx2OutputNode, avx2Vec);
@@ -307,7 +303,6 @@ public:
                         // Verify all 4 vectorized lanes against native finite differences
                         bool allVectorLanesPassed = true;
                         avx2Buffer->setLanes(avx2InputNode, batch);
-                        avx2Buffer->clearGradients();
                         avx2Kernel->execute(*avx2Buffer);
                         double finalAvx2Vec[4];
                         avx2Buffer->getLanes(avx2OutputNode, finalAvx2Vec);
@@ -354,7 +349,6 @@ public:
                         double inputData[4] = {input, input, input, input};
                         for (int i = 0; i < config_.warmupIterations; ++i) {
                             avx2Buffer->setLanes(avx2InputNode, inputData);
-                            avx2Buffer->clearGradients();
                             avx2Kernel->execute(*avx2Buffer);
                             double outputData[4];
                             avx2Buffer->getLanes(avx2OutputNode, outputData);
@@ -366,7 +360,6 @@ public:
                         auto avx2Start = high_resolution_clock::now();
                         for (int i = 0; i < config_.timingIterations; ++i) {
                             avx2Buffer->setLanes(avx2InputNode, inputData);
-                            avx2Buffer->clearGradients();
                             avx2Kernel->execute(*avx2Buffer);
                             double outputData[4];
                             avx2Buffer->getLanes(avx2OutputNode, outputData);
@@ -176,7 +176,6 @@ private:
             for (size_t i = 0; i < numInputs_; ++i) {
                 buffer->setValue(graph.diff_inputs[i], input[i]);
             }
-            buffer->clearGradients();
             
             // Execute to compute gradients
             kernel->execute(*buffer);
@@ -0,0 +1,74 @@
+// This file is part of Forge <https://github.com/da-roth/forge>
+//
+// See LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+/**
+ * @file forge_trace_decode.cpp
+ * @brief Offline decoder for binary runtime trace dumps
+ *
+ * Prints dumps written by forge::writeTraceDump() in the format of
+ * printTraceRecords():
+ *
+ *   forge_trace_decode trace.bin             all rings
+ *   forge_trace_decode trace.bin --thread 3  one ring (0 = shared ring)
+ *   forge_trace_decode trace.bin --summary   record counts only
+ */
+
+#include "compiler/runtime_trace.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <trace dump> [--thread <id>] [--summary]" << std::endl;
+        return 2;
+    }
+
+    bool summary = false;
+    bool filterThread = false;
+    uint32_t thread = 0;
+    for (int i = 2; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--summary") == 0) {
+            summary = true;
+        } else if (std::strcmp(argv[i], "--thread") == 0 && i + 1 < argc) {
+            filterThread = true;
+            thread = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            std::cerr << "Unknown argument: " << argv[i] << std::endl;
+            return 2;
+        }
+    }
+
+    std::vector<forge::TraceDumpRing> rings;
+    try {
+        rings = forge::readTraceDump(std::string(argv[1]));
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (filterThread) {
+        std::vector<forge::TraceDumpRing> selected;
+        for (auto& ring : rings) {
+            if (ring.threadId == thread) selected.push_back(std::move(ring));
+        }
+        rings = std::move(selected);
+    }
+
+    if (summary) {
+        for (const auto& ring : rings) {
+            std::cout << (ring.threadId == 0 ? std::string("shared") : "thread " + std::to_string(ring.threadId))
+                      << ": " << ring.records.size() << " records (" << ring.written << " written, capacity "
+                      << ring.capacity << ")" << std::endl;
+        }
+        return 0;
+    }
+
+    forge::printTraceDump(rings, std::cout);
+    return 0;
+}
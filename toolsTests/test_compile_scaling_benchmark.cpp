@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+#include "../tools/benchmarkTool/compile_scaling_benchmark.hpp"
+
+using namespace forge::tools;
+
+TEST(CompileScalingBenchmarkTest, GeneratorsReachRequestedSize) {
+    using namespace compile_scaling_detail;
+    for (const bool gradient : {false, true}) {
+        const forge::Graph synthetic = syntheticGraph(3000, gradient);
+        EXPECT_GE(synthetic.size(), 3000u);
+        EXPECT_LT(synthetic.size(), 3010u);
+        EXPECT_EQ(synthetic.outputs.size(), 1u);
+        EXPECT_EQ(synthetic.diff_inputs.empty(), !gradient);
+
+        const forge::Graph big = bigGraphStyle(3000, gradient);
+        EXPECT_GE(big.size(), 3000u);
+        EXPECT_LT(big.size(), 3100u);
+        EXPECT_EQ(big.diff_inputs.empty(), !gradient);
+    }
+    EXPECT_THROW(generate("unknown", 100, false), std::runtime_error);
+}
+
+TEST(CompileScalingBenchmarkTest, ReportsPhasesAndExponents) {
+    CompileScalingConfig config;
+    config.sizes = {500, 5000};
+    config.minPhaseMs = 0.0;
+    const auto runs = runCompileScaling(config, nullptr);
+    ASSERT_EQ(runs.size(), 2u * 2u * 2u);  // generators x modes x sizes
+    for (const auto& run : runs) {
+        EXPECT_GE(run.stats.graphNodes, run.requestedNodes);
+        EXPECT_NE(run.stats.phase("optimize"), nullptr);
+        EXPECT_NE(run.stats.phase("runtime"), nullptr);
+        EXPECT_GT(run.stats.totalMs, 0.0);
+    }
+
+    const auto verdicts = analyzeCompileScaling(runs, config);
+    EXPECT_FALSE(verdicts.empty());
+    for (const auto& verdict : verdicts) {
+        EXPECT_LT(verdict.fromNodes, verdict.toNodes);
+        EXPECT_EQ(verdict.superlinear, verdict.exponent > config.superlinearExponent);
+    }
+
+    const nlohmann::json doc = compileScalingToJson(runs, verdicts);
+    EXPECT_EQ(doc["schema"], "forge-compile-scaling/1");
+    ASSERT_EQ(doc["runs"].size(), runs.size());
+    EXPECT_EQ(doc["runs"][0]["phases"].size(), runs[0].stats.phases.size());
+    EXPECT_EQ(doc["scaling"].size(), verdicts.size());
+}
@@ -0,0 +1,235 @@
+#include <gtest/gtest.h>
+#include "../tools/graphSerialization/graph_binary_format.hpp"
+#include "../tools/graphSerialization/graph_serialization.hpp"
+#include "../src/graph/graph_optimizer.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace forge;
+
+class GraphBinaryFormatTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        for (const auto& file : files_) std::remove(file.c_str());
+    }
+
+    std::string tempFile(const std::string& name) {
+        files_.push_back("test_graph_binary_" + name + ".fgb");
+        return files_.back();
+    }
+
+    static NodeId add(Graph& g, OpCode op, NodeId a, NodeId b = 0) {
+        Node node{};
+        node.op = op;
+        node.a = a;
+        node.b = b;
+        node.isActive = true;
+        node.needsGradient = g.nodes[a].needsGradient;
+        return g.addNode(node);
+    }
+
+    // x*2 + exp(y) with a uniform input, special constants and a dead node
+    static Graph sampleGraph() {
+        Graph g;
+        NodeId x = g.addInput();
+        NodeId y = g.addInput();
+        g.nodes[x].needsGradient = true;
+        g.diff_inputs.push_back(x);
+        g.markUniform(y);
+        NodeId two = g.addConstant(2.0);
+        g.addConstant(std::numeric_limits<double>::quiet_NaN());
+        g.addConstant(-std::numeric_limits<double>::infinity());
+        NodeId dead = add(g, OpCode::Sin, y);
+        g.nodes[dead].isDead = true;
+        g.markOutput(add(g, OpCode::Add, add(g, OpCode::Mul, x, two), add(g, OpCode::Exp, y)));
+        return g;
+    }
+
+    static void expectSameGraph(const Graph& expected, const Graph& actual) {
+        ASSERT_EQ(expected.nodes.size(), actual.nodes.size());
+        for (size_t i = 0; i < expected.nodes.size(); ++i) {
+            const Node& e = expected.nodes[i];
+            const Node& a = actual.nodes[i];
+            EXPECT_EQ(e.op, a.op) << "node " << i;
+            EXPECT_EQ(e.dst, a.dst) << "node " << i;
+            EXPECT_EQ(e.a, a.a) << "node " << i;
+            EXPECT_EQ(e.b, a.b) << "node " << i;
+            EXPECT_EQ(e.c, a.c) << "node " << i;
+            EXPECT_EQ(e.flags, a.flags) << "node " << i;
+            EXPECT_EQ(0, std::memcmp(&e.imm, &a.imm, sizeof(double))) << "node " << i;
+            EXPECT_EQ(e.isActive, a.isActive) << "node " << i;
+            EXPECT_EQ(e.isDead, a.isDead) << "node " << i;
+            EXPECT_EQ(e.needsGradient, a.needsGradient) << "node " << i;
+        }
+        ASSERT_EQ(expected.constPool.size(), actual.constPool.size());
+        EXPECT_EQ(0, std::memcmp(expected.constPool.data(), actual.constPool.data(),
+                                 expected.constPool.size() * sizeof(double)));
+        EXPECT_EQ(expected.outputs, actual.outputs);
+        EXPECT_EQ(expected.diff_inputs, actual.diff_inputs);
+        ASSERT_EQ(expected.functions.size(), actual.functions.size());
+        for (size_t f = 0; f < expected.functions.size(); ++f) {
+            expectSameGraph(expected.functions[f], actual.functions[f]);
+        }
+    }
+
+private:
+    std::vector<std::string> files_;
+};
+
+TEST_F(GraphBinaryFormatTest, RoundTripPreservesEveryField) {
+    Graph original = sampleGraph();
+    Graph body;
+    NodeId p = body.addInput();
+    body.markOutput(add(body, OpCode::Square, p));
+    original.functions.push_back(body);
+    NodeId call = original.addCall(0, {0});
+    original.markOutput(call);
+
+    std::vector<uint8_t> bytes = serializeGraphToBinary(original);
+    EXPECT_EQ(bytes.size() % binary_graph::kSectionAlignment, 0u);
+    expectSameGraph(original, deserializeGraphFromBinary(bytes.data(), bytes.size()));
+
+    std::string file = tempFile("roundtrip");
+    ASSERT_TRUE(saveGraphToBinaryFile(original, file));
+    expectSameGraph(original, loadGraphFromBinaryFile(file));
+}
+
+TEST_F(GraphBinaryFormatTest, EmptyGraphRoundTrips) {
+    Graph empty;
+    std::vector<uint8_t> bytes = serializeGraphToBinary(empty);
+    Graph loaded = deserializeGraphFromBinary(bytes.data(), bytes.size());
+    EXPECT_TRUE(loaded.nodes.empty());
+    EXPECT_TRUE(loaded.outputs.empty());
+}
+
+TEST_F(GraphBinaryFormatTest, MappedFileFeedsOptimizerDirectly) {
+    Graph original = sampleGraph();
+    std::string file = tempFile("mapped");
+    ASSERT_TRUE(saveGraphToBinaryFile(original, file));
+
+    MappedGraphFile mapped(file);
+    const GraphView& view = mapped.view();
+    ASSERT_EQ(view.nodeCount, original.nodes.size());
+    EXPECT_EQ(view.nodes[view.outputs[0]].op, OpCode::Add);
+    EXPECT_EQ(view.nodes[1].flags, NodeFlags::Uniform);
+    expectSameGraph(original, mapped.toGraph());
+
+    GraphOptimizer fromView;
+    GraphOptimizer fromGraph;
+    auto viewResult = fromView.optimizeWithMapping(view);
+    auto graphResult = fromGraph.optimizeWithMapping(original);
+    expectSameGraph(graphResult.optimizedTape, viewResult.optimizedTape);
+    EXPECT_EQ(graphResult.originalToOptimizedMapping, viewResult.originalToOptimizedMapping);
+
+    // Moving keeps the view (and its function table) valid
+    MappedGraphFile moved = std::move(mapped);
+    EXPECT_EQ(moved.view().nodeCount, original.nodes.size());
+    ASSERT_NE(moved.view().functions, nullptr);
+    EXPECT_TRUE(moved.view().functions->empty());
+    EXPECT_EQ(mapped.view().nodeCount, 0u);
+}
+
+TEST_F(GraphBinaryFormatTest, RejectsInvalidData) {
+    std::vector<uint8_t> bytes = serializeGraphToBinary(sampleGraph());
+
+    std::vector<uint8_t> badMagic = bytes;
+    badMagic[0] = 'X';
+    EXPECT_THROW(deserializeGraphFromBinary(badMagic.data(), badMagic.size()), std::runtime_error);
+
+    std::vector<uint8_t> truncated(bytes.begin(), bytes.end() - 64);
+    EXPECT_THROW(deserializeGraphFromBinary(truncated.data(), truncated.size()), std::runtime_error);
+
+    std::vector<uint8_t> badVersion = bytes;
+    badVersion[8] = 99;
+    EXPECT_THROW(deserializeGraphFromBinary(badVersion.data(), badVersion.size()), std::runtime_error);
+
+    // Point the last node's first operand past the end of the graph
+    uint64_t nodeOffset = 0;
+    std::memcpy(&nodeOffset, bytes.data() + binary_graph::kHeaderSize, sizeof(nodeOffset));
+    std::vector<uint8_t> badOperand = bytes;
+    const size_t last = sampleGraph().nodes.size() - 1;
+    const uint32_t outOfRange = 1000;
+    std::memcpy(badOperand.data() + nodeOffset + last * binary_graph::kNodeRecordSize + 8, &outOfRange, sizeof(outOfRange));
+    EXPECT_THROW(deserializeGraphFromBinary(badOperand.data(), badOperand.size()), std::runtime_error);
+
+    std::string file = tempFile("corrupt");
+    {
+        std::ofstream out(file, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(badOperand.data()), static_cast<std::streamsize>(badOperand.size()));
+    }
+    EXPECT_THROW(MappedGraphFile{file}, std::runtime_error);
+    EXPECT_NO_THROW(MappedGraphFile(file, false));  // Only the layout is checked
+    EXPECT_THROW(MappedGraphFile{"does_not_exist.fgb"}, std::runtime_error);
+}
+
+// Load-time benchmark: JSON vs binary copy vs memory mapping.
+// FORGE_BINARY_GRAPH_BENCH_NODES overrides the node count.
+TEST_F(GraphBinaryFormatTest, LoadTimeBenchmark) {
+    size_t nodeCount = 200000;
+    if (const char* env = std::getenv("FORGE_BINARY_GRAPH_BENCH_NODES")) {
+        nodeCount = static_cast<size_t>(std::strtoull(env, nullptr, 10));
+    }
+
+    Graph graph;
+    NodeId x = graph.addInput();
+    NodeId acc = x;
+    while (graph.nodes.size() < nodeCount) {
+        NodeId c = graph.addConstant(1.0 + static_cast<double>(graph.nodes.size() % 7));
+        acc = add(graph, graph.nodes.size() % 3 == 0 ? OpCode::Mul : OpCode::Add, acc, c);
+    }
+    graph.markOutput(acc);
+
+    using Clock = std::chrono::high_resolution_clock;
+    auto ms = [](Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    };
+
+    std::string binaryFile = tempFile("bench");
+    std::string jsonFile = binaryFile + ".json";
+    ASSERT_TRUE(saveGraphToBinaryFile(graph, binaryFile));
+    ASSERT_TRUE(saveGraphToFile(graph, jsonFile, false));
+
+    auto start = Clock::now();
+    Graph fromJson = loadGraphFromFile(jsonFile);
+    double jsonMs = ms(start);
+
+    start = Clock::now();
+    Graph fromBinary = loadGraphFromBinaryFile(binaryFile);
+    double binaryMs = ms(start);
+
+    start = Clock::now();
+    size_t mappedNodes = 0;
+    {
+        MappedGraphFile mapped(binaryFile);
+        mappedNodes = mapped.view().nodeCount;
+    }
+    double mappedMs = ms(start);
+
+    start = Clock::now();
+    {
+        MappedGraphFile mapped(binaryFile, false);
+        mappedNodes = mapped.view().nodeCount;
+    }
+    double mappedUncheckedMs = ms(start);
+    std::remove(jsonFile.c_str());
+
+    EXPECT_EQ(fromJson.nodes.size(), graph.nodes.size());
+    EXPECT_EQ(fromBinary.nodes.size(), graph.nodes.size());
+    EXPECT_EQ(mappedNodes, graph.nodes.size());
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "  Load " << graph.nodes.size() << " nodes:\n"
+              << "    JSON:                     " << jsonMs << " ms\n"
+              << "    Binary (copy):            " << binaryMs << " ms\n"
+              << "    Binary (mmap, validated): " << mappedMs << " ms\n"
+              << "    Binary (mmap, layout):    " << mappedUncheckedMs << " ms" << std::endl;
+}
@@ -0,0 +1,33 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <sstream>
+#include "../tools/benchmarkTool/hardware_counters.hpp"
+
+using namespace forge::tools;
+
+TEST(HardwareCountersTest, CountsLoopOrDegradesGracefully) {
+    HardwareCounters counters;
+    counters.start();
+    volatile double sink = 0.0;
+    for (int i = 0; i < 100000; ++i) sink = sink + 1.0;
+    const HardwareCounterSample sample = counters.stop(1000.0);
+
+    std::ostringstream text;
+    printHardwareCounters(sample, text);
+
+    if (!counters.available()) {
+        // No PMU access (container, VM, perf_event_paranoid, non-Linux): nothing is reported
+        EXPECT_FALSE(counters.unavailableReason().empty());
+        EXPECT_FALSE(sample.available);
+        EXPECT_TRUE(std::isnan(sample.cycles));
+        EXPECT_TRUE(std::isnan(sample.ipc()));
+        EXPECT_EQ(text.str(), "counters unavailable");
+        return;
+    }
+
+    ASSERT_TRUE(sample.available);
+    // At least one add per iteration, scaled to 100 iterations per evaluation
+    if (!std::isnan(sample.instructions)) EXPECT_GE(sample.instructions, 100.0);
+    if (!std::isnan(sample.cycles)) EXPECT_GT(sample.cycles, 0.0);
+    EXPECT_NE(text.str().find("IPC"), std::string::npos);
+}
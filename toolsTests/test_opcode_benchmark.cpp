@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include "../tools/benchmarkTool/opcode_benchmark.hpp"
+
+using namespace forge::tools;
+
+namespace {
+
+OpcodeBenchmarkConfig smokeConfig() {
+    OpcodeBenchmarkConfig config;
+    config.ops = {"Add", "Exp", "CmpLT", "BoolNot", "IntAdd"};
+    config.registerPressure = {1, 6};
+    config.chainLength = 8;
+    config.warmupRuns = 1;
+    config.measureRuns = 5;
+    config.repetitions = 1;
+    return config;
+}
+
+} // namespace
+
+TEST(OpcodeBenchmarkTest, EveryBackendOpModeAndPressureLevelIsMeasured) {
+    const OpcodeBenchmarkConfig config = smokeConfig();
+    const auto results = runOpcodeBenchmarks(config, nullptr);
+    const auto backends = availableOpcodeBenchmarkBackends();
+    ASSERT_FALSE(backends.empty());
+
+    // Forward for all five ops, adjoint for the two differentiable ones
+    EXPECT_EQ(results.size(), backends.size() * (5 + 2) * config.registerPressure.size());
+    for (const auto& result : results) {
+        EXPECT_GT(result.nsPerKernel, 0.0) << result.key();
+        EXPECT_DOUBLE_EQ(result.nsPerStep, result.nsPerKernel / (result.chains * config.chainLength));
+        EXPECT_FALSE(result.op == "CmpLT" && result.mode == "adjoint");
+    }
+
+    const nlohmann::json doc = opcodeBenchmarksToJson(results, config);
+    ASSERT_EQ(doc["results"].size(), results.size());
+    EXPECT_EQ(doc["results"][0]["key"], results[0].key());
+    EXPECT_EQ(doc["config"]["chainLength"], config.chainLength);
+}
+
+TEST(OpcodeBenchmarkTest, CompareFlagsOnlySlowdownsAboveThreshold) {
+    nlohmann::json baseline = {{"results", nlohmann::json::array({
+        {{"key", "SSE2-Scalar/Exp/forward/1"}, {"nsPerStep", 10.0}},
+        {{"key", "SSE2-Scalar/Add/forward/1"}, {"nsPerStep", 1.0}},
+        {{"key", "SSE2-Scalar/Sin/forward/1"}, {"nsPerStep", 8.0}},
+    })}};
+    nlohmann::json current = {{"results", nlohmann::json::array({
+        {{"key", "SSE2-Scalar/Exp/forward/1"}, {"nsPerStep", 12.5}},  // +25%
+        {{"key", "SSE2-Scalar/Add/forward/1"}, {"nsPerStep", 1.1}},   // +10%
+        {{"key", "SSE2-Scalar/Cos/forward/1"}, {"nsPerStep", 99.0}},  // Not in the baseline
+    })}};
+
+    const auto regressions = compareOpcodeBenchmarks(baseline, current, 0.20);
+    ASSERT_EQ(regressions.size(), 1u);
+    EXPECT_EQ(regressions[0].key, "SSE2-Scalar/Exp/forward/1");
+    EXPECT_DOUBLE_EQ(regressions[0].ratio, 1.25);
+
+    EXPECT_EQ(compareOpcodeBenchmarks(baseline, current, 0.05).size(), 2u);
+    EXPECT_EQ(compareOpcodeBenchmarks(baseline, current, 0.05, 5.0).size(), 1u);  // Add below the noise floor
+}
+
+TEST(OpcodeBenchmarkTest, UnknownOpcodeIsRejected) {
+    OpcodeBenchmarkConfig config = smokeConfig();
+    config.ops = {"Exq"};
+    EXPECT_THROW(runOpcodeBenchmarks(config, nullptr), std::runtime_error);
+}